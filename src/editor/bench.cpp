@@ -0,0 +1,669 @@
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_concurrency/task_graph.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_log.hpp"
+#include "erhe_geometry/operation/catmull_clark_subdivision.hpp"
+#include "erhe_geometry/operation/dual.hpp"
+#include "erhe_geometry/operation/sqrt3_subdivision.hpp"
+#include "erhe_geometry/operation/subdivide.hpp"
+#include "erhe_geometry/operation/truncate.hpp"
+#include "erhe_geometry/shapes/torus.hpp"
+#include "erhe_log/log.hpp"
+#include "erhe_message_bus/message_bus.hpp"
+#include "erhe_physics/icollision_shape.hpp"
+#include "erhe_physics/irigid_body.hpp"
+#include "erhe_physics/iworld.hpp"
+#include "erhe_physics/physics_log.hpp"
+#include "erhe_scene/node.hpp"
+#include "erhe_scene/scene.hpp"
+#include "erhe_scene/scene_host.hpp"
+#include "erhe_scene/scene_log.hpp"
+#include "erhe_scene/scene_message_bus.hpp"
+
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto str(const bool value) -> const char*
+{
+    return value ? "true" : "false";
+}
+
+class Options
+{
+public:
+    Options(int argc, char** argv)
+    {
+        cxxopts::Options options{"erhe-bench", "Erhe benchmarks"};
+
+        options.add_options("General")
+            ("threads",     "Thread pool size, 0 for default", cxxopts::value<int>()->default_value("0"), "<count>")
+            ("repetitions", "Number of measured repetitions", cxxopts::value<int>()->default_value("5"), "<count>");
+
+        options.add_options("Thread pool")
+            ("thread-pool",            "Run thread pool and task graph benchmark", cxxopts::value<bool>()->default_value(str(thread_pool)))
+            ("thread-pool-task-count", "Number of tasks per repetition", cxxopts::value<int>()->default_value("1000000"), "<count>");
+
+        options.add_options("Geometry")
+            ("geometry",             "Run serial and parallel geometry operation benchmark", cxxopts::value<bool>()->default_value(str(geometry)))
+            ("geometry-torus-steps", "Torus major axis steps; minor axis uses half", cxxopts::value<int>()->default_value("256"), "<count>");
+
+        options.add_options("Scene")
+            ("scene-transforms",            "Run node transform update benchmark for deep and wide hierarchies", cxxopts::value<bool>()->default_value(str(scene_transforms)))
+            ("scene-transforms-node-count", "Number of nodes in each hierarchy", cxxopts::value<int>()->default_value("100000"), "<count>");
+
+        options.add_options("Message bus")
+            ("message-bus",               "Run queued message throughput benchmark", cxxopts::value<bool>()->default_value(str(message_bus)))
+            ("message-bus-message-count", "Number of messages per repetition", cxxopts::value<int>()->default_value("1000000"), "<count>");
+
+        options.add_options("Physics")
+            ("physics-load",            "Run static rigid body load benchmark with body count and ten times body count", cxxopts::value<bool>()->default_value(str(physics_load)))
+            ("physics-load-body-count", "Number of static rigid bodies in the smaller world", cxxopts::value<int>()->default_value("10000"), "<count>");
+
+        try {
+            auto arguments = options.parse(argc, argv);
+
+            threads                     = arguments["threads"                    ].as<int>();
+            repetitions                 = arguments["repetitions"                ].as<int>();
+            thread_pool                 = arguments["thread-pool"                ].as<bool>();
+            thread_pool_task_count      = arguments["thread-pool-task-count"     ].as<int>();
+            geometry                    = arguments["geometry"                   ].as<bool>();
+            geometry_torus_steps        = arguments["geometry-torus-steps"       ].as<int>();
+            scene_transforms            = arguments["scene-transforms"           ].as<bool>();
+            scene_transforms_node_count = arguments["scene-transforms-node-count"].as<int>();
+            message_bus                 = arguments["message-bus"                ].as<bool>();
+            message_bus_message_count   = arguments["message-bus-message-count"  ].as<int>();
+            physics_load                = arguments["physics-load"               ].as<bool>();
+            physics_load_body_count     = arguments["physics-load-body-count"    ].as<int>();
+        } catch (const std::exception& e) {
+            fmt::print(
+                "Error parsing command line argumenst: {}",
+                e.what()
+            );
+        }
+    }
+
+    int  threads                    {0};
+    int  repetitions                {5};
+    bool thread_pool                {false};
+    int  thread_pool_task_count     {1000000};
+    bool geometry                   {false};
+    int  geometry_torus_steps       {256};
+    bool scene_transforms           {false};
+    int  scene_transforms_node_count{100000};
+    bool message_bus                {false};
+    int  message_bus_message_count  {1000000};
+    bool physics_load               {false};
+    int  physics_load_body_count    {10000};
+};
+
+// Runs body repetitions times and prints best and average time, and
+// items per second of the best run.
+template <typename F>
+void measure(const char* label, const int repetitions, const std::size_t item_count, F&& body)
+{
+    double best_time = 0.0;
+    double sum_time  = 0.0;
+    const int count  = (std::max)(1, repetitions);
+    for (int i = 0; i < count; ++i) {
+        const auto start_time = Clock::now();
+        body();
+        const std::chrono::duration<double> duration = Clock::now() - start_time;
+        sum_time  += duration.count();
+        best_time = (i == 0) ? duration.count() : (std::min)(best_time, duration.count());
+    }
+    fmt::print(
+        "{:<40} best {:9.3f} ms, avg {:9.3f} ms, {:12.0f} items/s\n",
+        label,
+        best_time * 1000.0,
+        (sum_time / count) * 1000.0,
+        static_cast<double>(item_count) / best_time
+    );
+}
+
+// Measures task overhead: empty tasks submitted to the global queue,
+// parallel for split through worker local deques, and a task graph where
+// ready successors are spawned to local deques and stolen.
+void run_thread_pool_benchmark(const Options& options, erhe::concurrency::Thread_pool& thread_pool)
+{
+    using namespace erhe::concurrency;
+
+    const std::size_t task_count = static_cast<std::size_t>((std::max)(1, options.thread_pool_task_count));
+    fmt::print("thread pool: {} workers, {} tasks\n", thread_pool.size(), task_count);
+
+    std::atomic<std::size_t> counter{0};
+
+    measure("enqueue (global queue)", options.repetitions, task_count, [&]() {
+        Concurrent_queue queue{thread_pool, "bench enqueue"};
+        for (std::size_t i = 0; i < task_count; ++i) {
+            queue.enqueue([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        queue.wait();
+    });
+
+    measure("enqueue_range grain 1 (local deques)", options.repetitions, task_count, [&]() {
+        Concurrent_queue queue{thread_pool, "bench range"};
+        queue.enqueue_range(0, task_count, 1, [&counter](std::size_t) { counter.fetch_add(1, std::memory_order_relaxed); });
+        queue.wait();
+    });
+
+    // Graph is built once and run repeatedly, as in a frame loop
+    constexpr std::size_t fan_out = 64;
+    Task_graph graph{thread_pool, "bench graph"};
+    const std::size_t group_count = (std::max)(std::size_t{1}, task_count / (fan_out + 1));
+    Task_graph_node* previous_join = nullptr;
+    for (std::size_t group = 0; group < group_count; ++group) {
+        Task_graph_node& fork = graph.add([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+        Task_graph_node& join = graph.add([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+        if (previous_join != nullptr) {
+            graph.precede(*previous_join, fork);
+        }
+        for (std::size_t i = 0; i < fan_out; ++i) {
+            Task_graph_node& node = graph.add([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+            graph.precede(fork, node);
+            graph.precede(node, join);
+        }
+        previous_join = &join;
+    }
+    measure("task graph fork / join 64", options.repetitions, graph.size(), [&]() {
+        graph.run();
+        graph.wait();
+    });
+
+    fmt::print("thread pool: {} tasks executed\n", counter.load());
+}
+
+// Compares values of one attribute, if both collections have it as
+// Value_type. Values must be bitwise equal, not just close.
+template <typename Value_type, typename Key_type>
+auto compare_attribute(
+    const erhe::geometry::Property_map_collection<Key_type>& lhs,
+    const erhe::geometry::Property_map_collection<Key_type>& rhs,
+    const erhe::geometry::Property_map_descriptor&           descriptor,
+    const uint32_t                                           key_count,
+    std::string&                                             out_mismatch
+) -> bool
+{
+    const auto* lhs_map = lhs.template find<Value_type>(descriptor);
+    const auto* rhs_map = rhs.template find<Value_type>(descriptor);
+    if ((lhs_map == nullptr) && (rhs_map == nullptr)) {
+        return true;
+    }
+    if ((lhs_map == nullptr) || (rhs_map == nullptr)) {
+        out_mismatch = fmt::format("{} present in one result only", descriptor.name);
+        return false;
+    }
+    for (uint32_t i = 0; i < key_count; ++i) {
+        const Key_type key{i};
+        const bool     lhs_has = lhs_map->has(key);
+        if (lhs_has != rhs_map->has(key)) {
+            out_mismatch = fmt::format("{} presence differs at {}", descriptor.name, i);
+            return false;
+        }
+        if (lhs_has && (std::memcmp(&lhs_map->values[i], &rhs_map->values[i], sizeof(Value_type)) != 0)) {
+            out_mismatch = fmt::format("{} value differs at {}", descriptor.name, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Key_type>
+auto compare_attributes(
+    const erhe::geometry::Property_map_collection<Key_type>&   lhs,
+    const erhe::geometry::Property_map_collection<Key_type>&   rhs,
+    std::initializer_list<erhe::geometry::Property_map_descriptor> descriptors,
+    const uint32_t                                             key_count,
+    std::string&                                               out_mismatch
+) -> bool
+{
+    if (lhs.size() != rhs.size()) {
+        out_mismatch = fmt::format("attribute map count {} != {}", lhs.size(), rhs.size());
+        return false;
+    }
+    for (const erhe::geometry::Property_map_descriptor& descriptor : descriptors) {
+        if (
+            !compare_attribute<float      >(lhs, rhs, descriptor, key_count, out_mismatch) ||
+            !compare_attribute<glm::vec2  >(lhs, rhs, descriptor, key_count, out_mismatch) ||
+            !compare_attribute<glm::vec3  >(lhs, rhs, descriptor, key_count, out_mismatch) ||
+            !compare_attribute<glm::vec4  >(lhs, rhs, descriptor, key_count, out_mismatch) ||
+            !compare_attribute<uint32_t   >(lhs, rhs, descriptor, key_count, out_mismatch) ||
+            !compare_attribute<glm::uvec4 >(lhs, rhs, descriptor, key_count, out_mismatch)
+        ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns empty string if geometries have identical counts, topology and
+// attribute values, otherwise description of the first difference.
+auto compare_geometry(const erhe::geometry::Geometry& lhs, const erhe::geometry::Geometry& rhs) -> std::string
+{
+    using namespace erhe::geometry;
+
+    if (
+        (lhs.get_point_count         () != rhs.get_point_count         ()) ||
+        (lhs.get_polygon_count       () != rhs.get_polygon_count       ()) ||
+        (lhs.get_corner_count        () != rhs.get_corner_count        ()) ||
+        (lhs.get_polygon_corner_count() != rhs.get_polygon_corner_count()) ||
+        (lhs.get_edge_count          () != rhs.get_edge_count          ())
+    ) {
+        return fmt::format(
+            "counts differ: points {} / {}, polygons {} / {}, corners {} / {}, edges {} / {}",
+            lhs.get_point_count  (), rhs.get_point_count  (),
+            lhs.get_polygon_count(), rhs.get_polygon_count(),
+            lhs.get_corner_count (), rhs.get_corner_count (),
+            lhs.get_edge_count   (), rhs.get_edge_count   ()
+        );
+    }
+
+    for (Polygon_id polygon_id = 0, end = lhs.get_polygon_count(); polygon_id < end; ++polygon_id) {
+        const Polygon& lhs_polygon = lhs.polygons[polygon_id];
+        const Polygon& rhs_polygon = rhs.polygons[polygon_id];
+        if (lhs_polygon.corner_count != rhs_polygon.corner_count) {
+            return fmt::format("polygon {} corner count {} != {}", polygon_id, lhs_polygon.corner_count, rhs_polygon.corner_count);
+        }
+        for (uint32_t i = 0; i < lhs_polygon.corner_count; ++i) {
+            const Corner_id lhs_corner_id = lhs.polygon_corners[lhs_polygon.first_polygon_corner_id + i];
+            const Corner_id rhs_corner_id = rhs.polygon_corners[rhs_polygon.first_polygon_corner_id + i];
+            if (lhs.corners[lhs_corner_id].point_id != rhs.corners[rhs_corner_id].point_id) {
+                return fmt::format("polygon {} corner {} point differs", polygon_id, i);
+            }
+        }
+    }
+
+    for (Edge_id edge_id = 0, end = lhs.get_edge_count(); edge_id < end; ++edge_id) {
+        if ((lhs.edges[edge_id].a != rhs.edges[edge_id].a) || (lhs.edges[edge_id].b != rhs.edges[edge_id].b)) {
+            return fmt::format("edge {} differs", edge_id);
+        }
+    }
+
+    std::string mismatch;
+    const bool attributes_match =
+        compare_attributes(
+            lhs.point_attributes(), rhs.point_attributes(),
+            {
+                c_point_locations, c_point_normals, c_point_normals_smooth, c_point_texcoords, c_point_tangents,
+                c_point_bitangents, c_point_colors, c_point_joint_indices, c_point_joint_weights, c_point_aniso_control
+            },
+            lhs.get_point_count(), mismatch
+        ) &&
+        compare_attributes(
+            lhs.corner_attributes(), rhs.corner_attributes(),
+            {
+                c_corner_normals, c_corner_texcoords, c_corner_tangents, c_corner_bitangents,
+                c_corner_colors, c_corner_aniso_control, c_corner_indices
+            },
+            lhs.get_corner_count(), mismatch
+        ) &&
+        compare_attributes(
+            lhs.polygon_attributes(), rhs.polygon_attributes(),
+            {
+                c_polygon_centroids, c_polygon_normals, c_polygon_tangents, c_polygon_bitangents,
+                c_polygon_colors, c_polygon_aniso_control, c_polygon_ids_vec3, c_polygon_ids_uint
+            },
+            lhs.get_polygon_count(), mismatch
+        );
+    return attributes_match ? std::string{} : mismatch;
+}
+
+// Runs each geometry operation which has a parallel mode, without and
+// with the thread pool, on a torus. Outputs must be identical.
+void run_geometry_benchmark(const Options& options, erhe::concurrency::Thread_pool& thread_pool)
+{
+    using namespace erhe::geometry;
+    using Serial_operation   = auto (*)(Geometry&) -> Geometry;
+    using Parallel_operation = auto (*)(Geometry&, erhe::concurrency::Thread_pool&) -> Geometry;
+
+    struct Entry
+    {
+        const char*        name;
+        Serial_operation   serial;
+        Parallel_operation parallel;
+    };
+    const Entry entries[] = {
+        { "catmull_clark_subdivision", &operation::catmull_clark_subdivision, &operation::catmull_clark_subdivision },
+        { "sqrt3_subdivision",         &operation::sqrt3_subdivision,         &operation::sqrt3_subdivision         },
+        { "subdivide",                 &operation::subdivide,                 &operation::subdivide                 },
+        { "dual",                      &operation::dual,                      &operation::dual                      },
+        { "truncate",                  &operation::truncate,                  &operation::truncate                  }
+    };
+
+    const int major_steps = (std::max)(8, options.geometry_torus_steps);
+    const int minor_steps = (std::max)(4, major_steps / 2);
+    Geometry  source      = shapes::make_torus(1.0, 0.25, major_steps, minor_steps);
+    source.build_edges();
+    fmt::print(
+        "geometry: torus {} x {}, {} points, {} polygons, {} workers\n",
+        major_steps, minor_steps, source.get_point_count(), source.get_polygon_count(), thread_pool.size()
+    );
+
+    for (const Entry& entry : entries) {
+        std::unique_ptr<Geometry> serial_result;
+        std::unique_ptr<Geometry> parallel_result;
+        measure(fmt::format("{} serial", entry.name).c_str(), options.repetitions, source.get_polygon_count(), [&]() {
+            serial_result = std::make_unique<Geometry>(entry.serial(source));
+        });
+        measure(fmt::format("{} parallel", entry.name).c_str(), options.repetitions, source.get_polygon_count(), [&]() {
+            parallel_result = std::make_unique<Geometry>(entry.parallel(source, thread_pool));
+        });
+        const std::string mismatch = compare_geometry(*serial_result, *parallel_result);
+        if (!mismatch.empty()) {
+            fmt::print("geometry: {} serial and parallel results differ: {}\n", entry.name, mismatch);
+        }
+    }
+}
+
+// Minimal scene host; nodes must be registered to a scene for the scene
+// to track their transforms.
+class Bench_scene_host : public erhe::scene::Scene_host
+{
+public:
+    Bench_scene_host()
+        : m_scene{std::make_unique<erhe::scene::Scene>(m_scene_message_bus, "bench scene", this)}
+    {
+    }
+    ~Bench_scene_host() noexcept override
+    {
+        m_scene.reset();
+    }
+
+    auto get_host_name   () const -> const char* override { return "bench"; }
+    auto get_hosted_scene() -> erhe::scene::Scene* override { return m_scene.get(); }
+    void register_node    (const std::shared_ptr<erhe::scene::Node>& node) override { if (m_scene) { m_scene->register_node(node); } }
+    void unregister_node  (const std::shared_ptr<erhe::scene::Node>& node) override { if (m_scene) { m_scene->unregister_node(node); } }
+    void register_camera  (const std::shared_ptr<erhe::scene::Camera>&) override {}
+    void unregister_camera(const std::shared_ptr<erhe::scene::Camera>&) override {}
+    void register_mesh    (const std::shared_ptr<erhe::scene::Mesh>&  ) override {}
+    void unregister_mesh  (const std::shared_ptr<erhe::scene::Mesh>&  ) override {}
+    void register_skin    (const std::shared_ptr<erhe::scene::Skin>&  ) override {}
+    void unregister_skin  (const std::shared_ptr<erhe::scene::Skin>&  ) override {}
+    void register_light   (const std::shared_ptr<erhe::scene::Light>& ) override {}
+    void unregister_light (const std::shared_ptr<erhe::scene::Light>& ) override {}
+
+private:
+    erhe::scene::Scene_message_bus      m_scene_message_bus;
+    std::unique_ptr<erhe::scene::Scene> m_scene;
+};
+
+// Builds a deep hierarchy (8 chains) and a wide hierarchy (sqrt(n) nodes
+// under root, each with sqrt(n) children), then measures
+// Scene::update_node_transforms() without and with the thread pool when
+// every node is dirty (top level nodes moved) and when 1% of leaf nodes
+// have moved.
+void run_scene_transforms_benchmark(const Options& options, erhe::concurrency::Thread_pool& thread_pool)
+{
+    using namespace erhe::scene;
+
+    const std::size_t node_count = static_cast<std::size_t>((std::max)(16, options.scene_transforms_node_count));
+
+    struct Hierarchy
+    {
+        const char* name;
+        std::size_t group_count;
+        std::size_t group_size; // nodes per group, including top level node
+        bool        deep;
+    };
+    const std::size_t wide_group_count = (std::max)(std::size_t{1}, static_cast<std::size_t>(std::sqrt(static_cast<double>(node_count))));
+    const Hierarchy hierarchies[] = {
+        { "deep", 8,                node_count / 8,                true  },
+        { "wide", wide_group_count, node_count / wide_group_count, false }
+    };
+
+    for (const Hierarchy& hierarchy : hierarchies) {
+        Bench_scene_host                   host;
+        Scene&                             scene = *host.get_hosted_scene();
+        std::vector<std::shared_ptr<Node>> top_nodes;
+        std::vector<std::shared_ptr<Node>> leaf_nodes;
+        const glm::mat4                    offset = glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.01f, 0.0f});
+        for (std::size_t group = 0; group < hierarchy.group_count; ++group) {
+            std::shared_ptr<Node> top = std::make_shared<Node>("top");
+            top->set_parent(scene.get_root_node());
+            top_nodes.push_back(top);
+            std::shared_ptr<Node> parent = top;
+            for (std::size_t i = 1; i < hierarchy.group_size; ++i) {
+                std::shared_ptr<Node> node = std::make_shared<Node>("node");
+                node->set_parent(parent);
+                node->set_parent_from_node(offset);
+                leaf_nodes.push_back(node);
+                if (hierarchy.deep) {
+                    parent = node;
+                }
+            }
+        }
+        scene.update_node_transforms();
+        const std::size_t total_node_count = hierarchy.group_count * hierarchy.group_size;
+        fmt::print(
+            "scene transforms: {} hierarchy, {} nodes, {} top level nodes, {} workers\n",
+            hierarchy.name, total_node_count, hierarchy.group_count, thread_pool.size()
+        );
+
+        float angle = 0.0f;
+        const auto move_top_nodes = [&]() {
+            angle += 0.01f;
+            const glm::mat4 rotation = glm::rotate(glm::mat4{1.0f}, angle, glm::vec3{0.0f, 1.0f, 0.0f});
+            for (const std::shared_ptr<Node>& node : top_nodes) {
+                node->set_parent_from_node(rotation);
+            }
+        };
+        const std::size_t sparse_stride = 100;
+        const auto move_some_leaf_nodes = [&]() {
+            angle += 0.01f;
+            const glm::mat4 transform = glm::rotate(offset, angle, glm::vec3{0.0f, 1.0f, 0.0f});
+            for (std::size_t i = 0; i < leaf_nodes.size(); i += sparse_stride) {
+                leaf_nodes[i]->set_parent_from_node(transform);
+            }
+        };
+
+        measure(fmt::format("{} all dirty serial", hierarchy.name).c_str(), options.repetitions, total_node_count, [&]() {
+            move_top_nodes();
+            scene.update_node_transforms(nullptr);
+        });
+        measure(fmt::format("{} all dirty parallel", hierarchy.name).c_str(), options.repetitions, total_node_count, [&]() {
+            move_top_nodes();
+            scene.update_node_transforms(&thread_pool);
+        });
+        measure(fmt::format("{} 1% dirty serial", hierarchy.name).c_str(), options.repetitions, total_node_count, [&]() {
+            move_some_leaf_nodes();
+            scene.update_node_transforms(nullptr);
+        });
+        measure(fmt::format("{} 1% dirty parallel", hierarchy.name).c_str(), options.repetitions, total_node_count, [&]() {
+            move_some_leaf_nodes();
+            scene.update_node_transforms(&thread_pool);
+        });
+        measure(fmt::format("{} clean", hierarchy.name).c_str(), options.repetitions, total_node_count, [&]() {
+            scene.update_node_transforms(&thread_pool);
+        });
+    }
+}
+
+class Bench_message
+{
+public:
+    uint64_t key  {0};
+    uint64_t value{0};
+};
+
+// Measures queued message throughput: a single producer with update()
+// after every full ring, producers on all thread pool workers while the
+// owning thread keeps calling update(), and coalesced batches where
+// messages share 256 keys.
+void run_message_bus_benchmark(const Options& options, erhe::concurrency::Thread_pool& thread_pool)
+{
+    using Message_bus = erhe::message_bus::Message_bus<Bench_message>;
+
+    const std::size_t message_count = static_cast<std::size_t>((std::max)(1, options.message_bus_message_count));
+    const std::size_t batch_size    = Message_bus::c_default_queue_capacity;
+    fmt::print("message bus: {} messages, {} workers\n", message_count, thread_pool.size());
+
+    std::size_t delivered_count = 0;
+    const auto receiver = [&delivered_count](Bench_message&) { ++delivered_count; };
+
+    {
+        Message_bus message_bus;
+        message_bus.add_receiver(receiver);
+        measure("queue + update, single producer", options.repetitions, message_count, [&]() {
+            for (std::size_t i = 0; i < message_count; ++i) {
+                message_bus.queue_message(Bench_message{.key = 0, .value = i});
+                if ((i % batch_size) == (batch_size - 1)) {
+                    message_bus.update();
+                }
+            }
+            message_bus.update();
+        });
+    }
+
+    {
+        Message_bus message_bus;
+        message_bus.add_receiver(receiver);
+        measure("queue + update, all workers producing", options.repetitions, message_count, [&]() {
+            const std::size_t target_count = delivered_count + message_count;
+            erhe::concurrency::Concurrent_queue queue{thread_pool, "bench message bus"};
+            queue.enqueue_range(0, message_count, batch_size, [&message_bus](const std::size_t first, const std::size_t last) {
+                for (std::size_t i = first; i < last; ++i) {
+                    message_bus.queue_message(Bench_message{.key = 0, .value = i});
+                }
+            });
+            while (delivered_count < target_count) {
+                message_bus.update();
+            }
+            queue.wait();
+        });
+    }
+
+    {
+        Message_bus message_bus;
+        message_bus.add_receiver(receiver);
+        message_bus.set_coalesce_function(
+            [](const Bench_message& message) -> uint64_t {
+                return message.key;
+            }
+        );
+        delivered_count = 0;
+        measure("queue + update, coalesced to 256 keys", options.repetitions, message_count, [&]() {
+            for (std::size_t i = 0; i < message_count; ++i) {
+                message_bus.queue_message(Bench_message{.key = 1 + (i & 255u), .value = i});
+                if ((i % batch_size) == (batch_size - 1)) {
+                    message_bus.update();
+                }
+            }
+            message_bus.update();
+        });
+        fmt::print("message bus: {} coalesced messages delivered\n", delivered_count);
+    }
+}
+
+// Measures loading a world of static boxes on a grid, as when loading a
+// scene: rigid body creation followed by adding bodies one at a time or
+// with a single add_rigid_bodies() call. One simulation step is included,
+// as it optimizes the broad phase if bodies were added one at a time.
+void run_physics_load_benchmark(const Options& options, erhe::concurrency::Thread_pool& thread_pool)
+{
+    using namespace erhe::physics;
+
+    const std::size_t body_counts[] = {
+        static_cast<std::size_t>((std::max)(1, options.physics_load_body_count)),
+        static_cast<std::size_t>((std::max)(1, options.physics_load_body_count)) * 10
+    };
+    const std::shared_ptr<ICollision_shape> box_shape = ICollision_shape::create_box_shape_shared(glm::vec3{0.5f, 0.5f, 0.5f});
+
+    for (const std::size_t body_count : body_counts) {
+        fmt::print("physics load: {} static bodies, {} workers\n", body_count, thread_pool.size());
+
+        const std::size_t grid_size = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(body_count))));
+        std::vector<glm::vec3> positions;
+        positions.reserve(body_count);
+        for (std::size_t i = 0; i < body_count; ++i) {
+            positions.emplace_back(
+                2.0f * static_cast<float>(i % grid_size),
+                0.0f,
+                2.0f * static_cast<float>(i / grid_size)
+            );
+        }
+
+        for (const bool batched : { false, true }) {
+            measure(batched ? "create + add_rigid_bodies + step" : "create + add_rigid_body + step", options.repetitions, body_count, [&]() {
+                std::unique_ptr<IWorld> world = IWorld::create_unique();
+                std::vector<std::shared_ptr<IRigid_body>> rigid_bodies;
+                std::vector<IRigid_body*>                 rigid_body_pointers;
+                rigid_bodies       .reserve(body_count);
+                rigid_body_pointers.reserve(body_count);
+                for (const glm::vec3& position : positions) {
+                    const IRigid_body_create_info create_info{
+                        .collision_shape = box_shape,
+                        .debug_label     = "box",
+                        .motion_mode     = Motion_mode::e_static
+                    };
+                    rigid_bodies.push_back(world->create_rigid_body_shared(create_info, position));
+                    rigid_body_pointers.push_back(rigid_bodies.back().get());
+                }
+                if (batched) {
+                    world->add_rigid_bodies(rigid_body_pointers);
+                } else {
+                    for (IRigid_body* rigid_body : rigid_body_pointers) {
+                        world->add_rigid_body(rigid_body);
+                    }
+                }
+                world->update_fixed_step(1.0 / 60.0);
+                world->remove_rigid_bodies(rigid_body_pointers);
+            });
+        }
+    }
+}
+
+} // anonymous namespace
+
+auto main(int argc, char** argv) -> int
+{
+    Options options{argc, argv};
+
+    erhe::log::console_init();
+    erhe::log::log_to_console();
+    erhe::log::initialize_log_sinks();
+    erhe::geometry::initialize_logging();
+    erhe::scene::initialize_logging();
+    erhe::physics::initialize_logging();
+
+    const std::size_t thread_count = (options.threads > 0)
+        ? static_cast<std::size_t>(options.threads)
+        : erhe::concurrency::Thread_pool::get_default_size();
+    erhe::concurrency::Thread_pool thread_pool{thread_count};
+    erhe::concurrency::Thread_pool::set_default(&thread_pool);
+
+    if (options.thread_pool) {
+        run_thread_pool_benchmark(options, thread_pool);
+    }
+    if (options.geometry) {
+        run_geometry_benchmark(options, thread_pool);
+    }
+    if (options.scene_transforms) {
+        run_scene_transforms_benchmark(options, thread_pool);
+    }
+    if (options.message_bus) {
+        run_message_bus_benchmark(options, thread_pool);
+    }
+    if (options.physics_load) {
+        run_physics_load_benchmark(options, thread_pool);
+    }
+
+    erhe::concurrency::Thread_pool::set_default(nullptr);
+    return EXIT_SUCCESS;
+}
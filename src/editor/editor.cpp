@@ -55,6 +55,7 @@
 
 #include "erhe_commands/commands.hpp"
 #include "erhe_commands/commands_log.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_file/file_log.hpp"
 #include "erhe_geometry/geometry_log.hpp"
@@ -162,6 +163,9 @@ public:
         m_time.update();
         m_editor_message_bus.update(); // Flushes queued messages
 
+        // Physics thread may step while applying physics updates and rendering
+        m_editor_scenes.end_physics_access();
+
         // Apply physics updates
         m_editor_scenes.after_physics_simulation_steps();
 
@@ -170,6 +174,7 @@ public:
         // Rendering
         m_graphics_instance.shader_monitor.update_once_per_frame();
         m_mesh_memory.gl_buffer_transfer_queue.flush();
+        m_mesh_memory.compact();
 
         m_editor_rendering.begin_frame(); // tests renderdoc capture start
 
@@ -413,9 +418,19 @@ public:
 
         fill_editor_context();
 
+        // Per mesh render list records and skin joint palettes are updated on the thread pool
+        erhe::concurrency::Thread_pool& thread_pool = erhe::concurrency::Thread_pool::get_default();
+        m_forward_renderer.get_render_list ().set_thread_pool(&thread_pool);
+        m_shadow_renderer .get_render_list ().set_thread_pool(&thread_pool);
+        m_forward_renderer.get_joint_buffer().set_thread_pool(&thread_pool);
+        m_shadow_renderer .get_joint_buffer().set_thread_pool(&thread_pool);
+
         const auto& physics_section = erhe::configuration::get_ini_file_section("erhe.ini", "physics");
-        physics_section.get("static_enable",  m_editor_settings.physics.static_enable);
-        physics_section.get("dynamic_enable", m_editor_settings.physics.dynamic_enable);
+        physics_section.get("static_enable",      m_editor_settings.physics.static_enable);
+        physics_section.get("dynamic_enable",     m_editor_settings.physics.dynamic_enable);
+        physics_section.get("thread_enable",      m_editor_settings.physics.thread_enable);
+        physics_section.get("tick_rate",          m_editor_settings.physics.tick_rate);
+        physics_section.get("max_catch_up_steps", m_editor_settings.physics.max_catch_up_steps);
         if (!m_editor_settings.physics.static_enable) {
             m_editor_settings.physics.dynamic_enable = false;
         }
@@ -557,6 +572,9 @@ public:
         ERHE_PROFILE_FUNCTION();
 
         m_run_started = true;
+        if (m_editor_settings.physics.thread_enable) {
+            m_editor_scenes.start_physics_thread();
+        }
         float wait_time = m_editor_context.use_sleep ? m_editor_context.sleep_margin : 0.0f;
         // TODO: https://registry.khronos.org/OpenGL/extensions/NV/GLX_NV_delay_before_swap.txt
         // Also:
@@ -565,6 +583,9 @@ public:
         //  - Wait to avoid presenting frames faster than display refreshrate
         while (!m_close_requested) {
             m_context_window.poll_events(wait_time);
+
+            // Input events, tools and operations may access physics; ends in tick()
+            m_editor_scenes.begin_physics_access();
             {
                 ERHE_PROFILE_SCOPE("dispatch events");
                 auto& input_events = m_context_window.get_input_events();
@@ -576,6 +597,7 @@ public:
 
             ERHE_PROFILE_FRAME_END
         }
+        m_editor_scenes.stop_physics_thread();
         m_run_stopped = true;
     }
 
@@ -724,11 +746,26 @@ void run_editor()
         }
     }
 
+    // Shared by editor, physics jobs and BVH builds; must outlive Editor
+    std::size_t thread_count{0};
+    {
+        const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "threading");
+        ini.get("thread_count", thread_count);
+        if (thread_count == 0) {
+            thread_count = erhe::concurrency::Thread_pool::get_default_size();
+        }
+    }
+    erhe::concurrency::Thread_pool thread_pool{thread_count};
+    erhe::concurrency::Thread_pool::set_default(&thread_pool);
+    log_startup->info("Thread pool with {} workers", thread_count);
+
     {
         ERHE_PROFILE_SCOPE("Construct and run Editor");
         Editor editor{};
         editor.run();
     }
+
+    erhe::concurrency::Thread_pool::set_default(nullptr);
 }
 
 } // namespace editor
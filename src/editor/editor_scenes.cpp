@@ -6,11 +6,15 @@
 #include "tools/tools.hpp"
 #include "scene/scene_root.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_physics/iworld.hpp"
+#include "erhe_profile/profile.hpp"
 #include "erhe_scene/scene.hpp"
 
 #include <imgui/imgui.h>
 
+#include <algorithm>
+
 namespace editor
 {
 
@@ -20,6 +24,119 @@ Editor_scenes::Editor_scenes(Editor_context& editor_context, Time& time)
 {
 }
 
+Editor_scenes::~Editor_scenes() noexcept
+{
+    stop_physics_thread();
+}
+
+void Editor_scenes::start_physics_thread()
+{
+    if (m_physics_thread.joinable()) {
+        return;
+    }
+    const float tick_rate = std::max(m_context.editor_settings->physics.tick_rate, 1.0f);
+    m_physics_dt          = 1.0 / static_cast<double>(tick_rate);
+    m_physics_thread_stop.store(false);
+    m_physics_thread = std::thread{
+        [this]() {
+            physics_thread_main();
+        }
+    };
+    log_scene->info("Physics thread started, {} steps per second", tick_rate);
+}
+
+void Editor_scenes::stop_physics_thread()
+{
+    if (!m_physics_thread.joinable()) {
+        return;
+    }
+    m_physics_thread_stop.store(true);
+    m_physics_thread.join();
+    log_scene->info("Physics thread stopped");
+}
+
+void Editor_scenes::begin_physics_access()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Physics thread does not start another step while access is requested
+    m_physics_access_requested.store(true);
+    m_physics_mutex.lock();
+    m_physics_access_requested.store(false);
+    m_physics_access_requested.notify_all();
+}
+
+void Editor_scenes::end_physics_access()
+{
+    m_physics_mutex.unlock();
+}
+
+auto Editor_scenes::is_physics_thread_running() const -> bool
+{
+    return m_physics_thread.joinable();
+}
+
+auto Editor_scenes::get_physics_step_count() const -> uint64_t
+{
+    return m_physics_step_count.load(std::memory_order_relaxed);
+}
+
+auto Editor_scenes::get_physics_dropped_steps() const -> uint64_t
+{
+    return m_physics_dropped_steps.load(std::memory_order_relaxed);
+}
+
+auto Editor_scenes::is_physics_enabled() const -> bool
+{
+    return
+        m_context.editor_settings->physics.static_enable &&
+        m_context.editor_settings->physics.dynamic_enable;
+}
+
+void Editor_scenes::physics_thread_main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto step_duration      = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{m_physics_dt});
+    const int  max_catch_up_steps = std::max(m_context.editor_settings->physics.max_catch_up_steps, 1);
+    auto       next_step_time     = Clock::now() + step_duration;
+
+    while (!m_physics_thread_stop.load()) {
+        std::this_thread::sleep_until(next_step_time);
+
+        int step_count = 0;
+        while ((next_step_time <= Clock::now()) && (step_count < max_catch_up_steps)) {
+            ERHE_PROFILE_SCOPE("physics thread step");
+
+            // Let main thread in between steps; it owns physics between
+            // begin_physics_access() and end_physics_access()
+            m_physics_access_requested.wait(true);
+            {
+                const std::lock_guard<std::mutex> physics_lock{m_physics_mutex};
+                const std::lock_guard<std::mutex> scene_roots_lock{m_mutex};
+                if (is_physics_enabled()) {
+                    for (Scene_root* scene_root : m_scene_roots) {
+                        scene_root->apply_physics_edits();
+                        scene_root->update_physics_simulation_fixed_step(m_physics_dt);
+                        scene_root->capture_physics_states(next_step_time);
+                    }
+                }
+            }
+            next_step_time += step_duration;
+            ++step_count;
+        }
+        m_physics_step_count.fetch_add(step_count, std::memory_order_relaxed);
+
+        // Drop time which could not be simulated, instead of catching up later
+        const auto now = Clock::now();
+        if (next_step_time <= now) {
+            const auto behind = now - next_step_time;
+            m_physics_dropped_steps.fetch_add(1 + static_cast<uint64_t>(behind / step_duration), std::memory_order_relaxed);
+            next_step_time = now + step_duration;
+        }
+    }
+}
+
 void Editor_scenes::register_scene_root(Scene_root* scene_root)
 {
     std::lock_guard<std::mutex> lock{m_mutex};
@@ -55,10 +172,7 @@ void Editor_scenes::update_physics_simulation_fixed_step(const Time_context& tim
 {
     ERHE_PROFILE_FUNCTION();
 
-    if (
-        !m_context.editor_settings->physics.static_enable ||
-        !m_context.editor_settings->physics.dynamic_enable
-    ) {
+    if (!is_physics_enabled() || is_physics_thread_running()) {
         return;
     }
 
@@ -71,12 +185,13 @@ void Editor_scenes::before_physics_simulation_steps()
 {
     ERHE_PROFILE_FUNCTION();
 
-    if (!m_context.editor_settings->physics.static_enable || !m_context.editor_settings->physics.dynamic_enable) {
+    if (!is_physics_enabled()) {
         return;
     }
 
+    const bool include_dynamic_bodies = !is_physics_thread_running();
     for (const auto& scene_root : m_scene_roots) {
-        scene_root->before_physics_simulation_steps();
+        scene_root->before_physics_simulation_steps(include_dynamic_bodies);
     }
 }
 
@@ -85,11 +200,11 @@ void Editor_scenes::update_node_transforms()
     ERHE_PROFILE_FUNCTION();
 
     for (const auto& scene_root : m_scene_roots) {
-        scene_root->get_scene().update_node_transforms();
+        scene_root->get_scene().update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
     }
 
     // Not in m_scene_roots
-    m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms();
+    m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 }
 
 void Editor_scenes::update_fixed_step(const Time_context& time_context)
@@ -103,12 +218,22 @@ void Editor_scenes::after_physics_simulation_steps()
 {
     ERHE_PROFILE_FUNCTION();
 
-    if (!m_context.editor_settings->physics.static_enable || !m_context.editor_settings->physics.dynamic_enable) {
+    if (!is_physics_enabled()) {
+        return;
+    }
+
+    if (!is_physics_thread_running()) {
+        for (const auto& scene_root : m_scene_roots) {
+            scene_root->after_physics_simulation_steps();
+        }
         return;
     }
 
+    // Called after end_physics_access(); reads published states while the
+    // physics thread may be stepping.
+    const auto now = std::chrono::steady_clock::now();
     for (const auto& scene_root : m_scene_roots) {
-        scene_root->after_physics_simulation_steps();
+        scene_root->apply_physics_states(now, m_physics_dt);
     }
 }
 
@@ -2,8 +2,12 @@
 
 #include "time.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace editor
@@ -13,10 +17,35 @@ class Editor_context;
 class Scene_root;
 class Time;
 
+// Physics is either stepped from Time fixed step updates, or, when the
+// physics thread is running, by a separate thread at its own tick rate.
+//
+// With the physics thread, the main thread owns physics (worlds, rigid
+// bodies, Node_physics) between begin_physics_access() and
+// end_physics_access(); the physics thread steps only outside that window
+// (typically while the main thread renders). The physics thread holds the
+// physics lock for one step at a time, so begin_physics_access() waits for
+// at most one step.
+//
+// After each step, body states are published through Scene_root. The main
+// thread sets node transforms interpolated between the last two published
+// states in after_physics_simulation_steps(), outside the access window and
+// without waiting for the physics thread. Nodes of dynamic bodies which have
+// been moved on the main thread are queued as edits, which the physics
+// thread applies before its next step.
 class Editor_scenes : public Update_fixed_step
 {
 public:
     Editor_scenes(Editor_context& editor_context, Time& time);
+    ~Editor_scenes() noexcept override;
+
+    void start_physics_thread();
+    void stop_physics_thread ();
+    void begin_physics_access();
+    void end_physics_access  ();
+    [[nodiscard]] auto is_physics_thread_running() const -> bool;
+    [[nodiscard]] auto get_physics_step_count   () const -> uint64_t;
+    [[nodiscard]] auto get_physics_dropped_steps() const -> uint64_t;
 
     void register_scene_root                 (Scene_root* scene_root);
     void unregister_scene_root               (Scene_root* scene_root);
@@ -35,9 +64,20 @@ public:
     void imgui();
 
 private:
-    Editor_context&          m_context;
-    std::mutex               m_mutex;
-    std::vector<Scene_root*> m_scene_roots;
+    [[nodiscard]] auto is_physics_enabled() const -> bool;
+    void physics_thread_main();
+
+    Editor_context&                       m_context;
+    std::mutex                            m_mutex;
+    std::vector<Scene_root*>              m_scene_roots;
+
+    std::thread                           m_physics_thread;
+    std::mutex                            m_physics_mutex;
+    std::atomic<bool>                     m_physics_thread_stop     {false};
+    std::atomic<bool>                     m_physics_access_requested{false};
+    double                                m_physics_dt              {1.0 / 240.0};
+    std::atomic<uint64_t>                 m_physics_step_count      {0};
+    std::atomic<uint64_t>                 m_physics_dropped_steps   {0};
 };
 
 } // namespace editor
@@ -24,8 +24,11 @@ class Physics_settings
 {
 public:
     // Physics
-    bool static_enable {true};
-    bool dynamic_enable{true};
+    bool  static_enable     {true};
+    bool  dynamic_enable    {true};
+    bool  thread_enable     {true};   // step physics on a separate thread
+    float tick_rate         {240.0f}; // simulation steps per second
+    int   max_catch_up_steps{4};      // steps per physics thread wakeup, excess time is dropped
 };
 
 class Graphics_preset
@@ -17,7 +17,9 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <vector>
 
 class Peer
 {
@@ -162,18 +164,22 @@ public:
         auto& tail  = erhe::log::get_tail_store_log();
         //auto& frame = erhe::log::get_frame_store_log();
 
-        auto& tail_entries = tail->get_log();
+        std::vector<erhe::log::Log_index_entry> tail_index;
+        tail.get_index(tail_index);
         const auto visible_count = (std::min)(
             static_cast<size_t>(10),
-            tail_entries.size()
+            tail_index.size()
         );
+        erhe::log::Entry entry;
         for (
-            auto i = tail_entries.rbegin(),
-            end = tail_entries.rbegin() + visible_count;
+            auto i = tail_index.rbegin(),
+            end = tail_index.rbegin() + visible_count;
             i != end;
             ++i
         ) {
-            auto& entry = *i;
+            if (!tail.get_entry(i->serial, entry)) {
+                continue;
+            }
             s.append(Term::color_fg(Term::Color::Name::Blue));
             s.append(entry.timestamp.c_str());
             s.append(Term::color_fg(Term::Color::Name::Gray));
@@ -413,16 +419,26 @@ public:
         options.add_options("Terminal configuration")
             ("terminal",        "Enable terminal", cxxopts::value<bool>()->default_value(str(terminal)));
 
+        options.add_options("Benchmark configuration")
+            ("benchmark",               "Run loopback throughput and latency benchmark at listen address and port", cxxopts::value<bool>()->default_value(str(benchmark)))
+            ("benchmark-message-size",  "Benchmark message payload size", cxxopts::value<int>()->default_value("256"), "<bytes>")
+            ("benchmark-message-count", "Number of messages for throughput benchmark", cxxopts::value<int>()->default_value("1000000"), "<count>")
+            ("benchmark-round-trips",   "Number of round trips for latency benchmark", cxxopts::value<int>()->default_value("10000"), "<count>");
+
         try {
             auto arguments = options.parse(argc, argv);
 
-            terminal        = arguments["terminal"       ].as<bool>();
-            run_client      = arguments["client"         ].as<bool>();
-            connect_address = arguments["connect-address"].as<std::string>();
-            connect_port    = arguments["connect-port"   ].as<int>();
-            run_server      = arguments["server"         ].as<bool>();
-            listen_address  = arguments["listen-address" ].as<std::string>();
-            listen_port     = arguments["listen-port"    ].as<int>();
+            terminal                = arguments["terminal"               ].as<bool>();
+            run_client              = arguments["client"                 ].as<bool>();
+            connect_address         = arguments["connect-address"        ].as<std::string>();
+            connect_port            = arguments["connect-port"           ].as<int>();
+            run_server              = arguments["server"                 ].as<bool>();
+            listen_address          = arguments["listen-address"         ].as<std::string>();
+            listen_port             = arguments["listen-port"            ].as<int>();
+            benchmark               = arguments["benchmark"              ].as<bool>();
+            benchmark_message_size  = arguments["benchmark-message-size" ].as<int>();
+            benchmark_message_count = arguments["benchmark-message-count"].as<int>();
+            benchmark_round_trips   = arguments["benchmark-round-trips"  ].as<int>();
         } catch (const std::exception& e) {
             fmt::print(
                 "Error parsing command line argumenst: {}",
@@ -438,8 +454,143 @@ public:
     bool        run_server{false};
     std::string listen_address;
     int         listen_port;
+    bool        benchmark{false};
+    int         benchmark_message_size;
+    int         benchmark_message_count;
+    int         benchmark_round_trips;
 };
 
+// Runs server and client in this process, connected through loopback.
+// Latency is measured with ping-pong round trips (server echoes each
+// message), throughput by streaming messages from client to server.
+auto run_benchmark(const Options& options) -> int
+{
+    using Clock = std::chrono::steady_clock;
+
+    erhe::net::Server server;
+    erhe::net::Client client;
+
+    bool        echo                 {true};
+    std::size_t server_message_count {0};
+    std::size_t server_byte_count    {0};
+    std::size_t client_message_count {0};
+    server.set_receive_handler(
+        [&](const uint8_t* data, const std::size_t length) {
+            ++server_message_count;
+            server_byte_count += length;
+            if (echo) {
+                server.broadcast(data, length);
+            }
+        }
+    );
+    client.set_receive_handler(
+        [&](const uint8_t*, const std::size_t) {
+            ++client_message_count;
+        }
+    );
+
+    if (!server.listen(options.listen_address.c_str(), options.listen_port)) {
+        fmt::print("benchmark: listen failed\n");
+        return EXIT_FAILURE;
+    }
+    if (!client.connect(options.listen_address.c_str(), options.listen_port)) {
+        fmt::print("benchmark: connect failed\n");
+        return EXIT_FAILURE;
+    }
+    const auto poll = [&](const int timeout_ms) {
+        client.poll(timeout_ms);
+        server.poll(timeout_ms);
+    };
+    const auto connect_deadline = Clock::now() + std::chrono::seconds{5};
+    while (
+        (client.get_state() != erhe::net::Socket::State::CONNECTED) ||
+        (server.get_client_count() == 0)
+    ) {
+        if (Clock::now() > connect_deadline) {
+            fmt::print("benchmark: connect timed out\n");
+            return EXIT_FAILURE;
+        }
+        poll(1);
+    }
+
+    const std::size_t    message_size = static_cast<std::size_t>((std::max)(1, options.benchmark_message_size));
+    std::vector<uint8_t> message(message_size, uint8_t{0x5a});
+
+    // Latency
+    const std::size_t  round_trip_count = static_cast<std::size_t>((std::max)(1, options.benchmark_round_trips));
+    std::vector<float> round_trip_times;
+    round_trip_times.reserve(round_trip_count);
+    for (std::size_t i = 0; i < round_trip_count; ++i) {
+        const std::size_t expected_count = client_message_count + 1;
+        const auto        start_time     = Clock::now();
+        if (!client.send(message.data(), message.size())) {
+            fmt::print("benchmark: send failed\n");
+            return EXIT_FAILURE;
+        }
+        while (client_message_count < expected_count) {
+            if (client.get_state() != erhe::net::Socket::State::CONNECTED) {
+                fmt::print("benchmark: connection lost\n");
+                return EXIT_FAILURE;
+            }
+            poll(0);
+        }
+        const std::chrono::duration<float, std::micro> round_trip_time = Clock::now() - start_time;
+        round_trip_times.push_back(round_trip_time.count());
+    }
+    std::sort(round_trip_times.begin(), round_trip_times.end());
+    float round_trip_time_sum = 0.0f;
+    for (const float t : round_trip_times) {
+        round_trip_time_sum += t;
+    }
+    fmt::print(
+        "latency:    {} round trips of {} bytes: min {:.1f} us, avg {:.1f} us, p50 {:.1f} us, p99 {:.1f} us\n",
+        round_trip_count,
+        message_size,
+        round_trip_times.front(),
+        round_trip_time_sum / static_cast<float>(round_trip_count),
+        round_trip_times[round_trip_count / 2],
+        round_trip_times[(round_trip_count * 99) / 100]
+    );
+
+    // Throughput
+    constexpr std::size_t send_queue_high_water_mark = 1024 * 1024;
+    echo                 = false;
+    server_message_count = 0;
+    server_byte_count    = 0;
+    const std::size_t message_count = static_cast<std::size_t>((std::max)(1, options.benchmark_message_count));
+    std::size_t       sent_count    = 0;
+    const auto        start_time    = Clock::now();
+    while (server_message_count < message_count) {
+        while (
+            (sent_count < message_count) &&
+            (client.get_send_queue_size() < send_queue_high_water_mark)
+        ) {
+            if (!client.send(message.data(), message.size())) {
+                break;
+            }
+            ++sent_count;
+        }
+        if (client.get_state() != erhe::net::Socket::State::CONNECTED) {
+            fmt::print("benchmark: connection lost\n");
+            return EXIT_FAILURE;
+        }
+        poll(0);
+    }
+    const std::chrono::duration<double> duration = Clock::now() - start_time;
+    fmt::print(
+        "throughput: {} messages of {} bytes in {:.3f} s: {:.0f} messages/s, {:.1f} MB/s\n",
+        message_count,
+        message_size,
+        duration.count(),
+        static_cast<double>(message_count) / duration.count(),
+        static_cast<double>(server_byte_count) / (duration.count() * 1024.0 * 1024.0)
+    );
+
+    client.disconnect();
+    server.disconnect();
+    return EXIT_SUCCESS;
+}
+
 auto main(int argc, char** argv) -> int
 {
     std::unique_ptr<Server_peer>    server_peer;
@@ -472,6 +623,10 @@ auto main(int argc, char** argv) -> int
     erhe::net::initialize_logging();
     erhe::net::initialize_net();
 
+    if (options.benchmark) {
+        return run_benchmark(options);
+    }
+
     erhe::net::Client client;
     erhe::net::Server server;
 
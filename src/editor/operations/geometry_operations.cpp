@@ -1,5 +1,6 @@
 #include "operations/geometry_operations.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/operation/ambo.hpp"
 #include "erhe_geometry/operation/catmull_clark_subdivision.hpp"
@@ -28,7 +29,11 @@ auto Catmull_clark_subdivision_operation::describe() const -> std::string
 Catmull_clark_subdivision_operation::Catmull_clark_subdivision_operation(Mesh_operation_parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::catmull_clark_subdivision);
+    make_entries(
+        [](erhe::geometry::Geometry& source) {
+            return erhe::geometry::operation::catmull_clark_subdivision(source, erhe::concurrency::Thread_pool::get_default());
+        }
+    );
 }
 
 auto Sqrt3_subdivision_operation::describe() const -> std::string
@@ -39,7 +44,11 @@ auto Sqrt3_subdivision_operation::describe() const -> std::string
 Sqrt3_subdivision_operation::Sqrt3_subdivision_operation(Mesh_operation_parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::sqrt3_subdivision);
+    make_entries(
+        [](erhe::geometry::Geometry& source) {
+            return erhe::geometry::operation::sqrt3_subdivision(source, erhe::concurrency::Thread_pool::get_default());
+        }
+    );
 }
 
 auto Triangulate_operation::describe() const -> std::string
@@ -83,7 +92,11 @@ auto Subdivide_operation::describe() const -> std::string
 Subdivide_operation::Subdivide_operation(Mesh_operation_parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::subdivide);
+    make_entries(
+        [](erhe::geometry::Geometry& source) {
+            return erhe::geometry::operation::subdivide(source, erhe::concurrency::Thread_pool::get_default());
+        }
+    );
 }
 
 auto Meta_operation::describe() const -> std::string
@@ -116,7 +129,11 @@ auto Dual_operation::describe() const -> std::string
 Dual_operation::Dual_operation(Mesh_operation_parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::dual);
+    make_entries(
+        [](erhe::geometry::Geometry& source) {
+            return erhe::geometry::operation::dual(source, erhe::concurrency::Thread_pool::get_default());
+        }
+    );
 }
 
 auto Ambo_operation::describe() const -> std::string
@@ -138,7 +155,11 @@ auto Truncate_operation::describe() const -> std::string
 Truncate_operation::Truncate_operation(Mesh_operation_parameters&& context)
     : Mesh_operation{std::move(context)}
 {
-    make_entries(erhe::geometry::operation::truncate);
+    make_entries(
+        [](erhe::geometry::Geometry& source) {
+            return erhe::geometry::operation::truncate(source, erhe::concurrency::Thread_pool::get_default());
+        }
+    );
 }
 
 auto Reverse_operation::describe() const -> std::string
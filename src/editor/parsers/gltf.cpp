@@ -5,12 +5,14 @@
 #include "scene/content_library.hpp"
 #include "scene/scene_root.hpp"
 
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_graphics/texture.hpp"
 #include "erhe_gltf/gltf.hpp"
 #include "erhe_gltf/image_transfer.hpp"
 #include "erhe_primitive/build_info.hpp"
 #include "erhe_primitive/primitive.hpp"
+#include "erhe_primitive/triangle_soup.hpp"
 #include "erhe_scene/animation.hpp"
 #include "erhe_scene/camera.hpp"
 #include "erhe_scene/light.hpp"
@@ -21,6 +23,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -82,6 +85,11 @@ void import_gltf(
     root_node->enable_flag_bits(erhe::Item_flags::content | erhe::Item_flags::show_in_ui);
     root_node->set_parent(temp_scene_root_node); // Will be moved to final scene later
 
+    erhe::concurrency::Thread_pool& thread_pool = erhe::concurrency::Thread_pool::get_default();
+    if (build_info.thread_pool == nullptr) {
+        build_info.thread_pool = &thread_pool;
+    }
+
     erhe::gltf::Image_transfer image_transfer{graphics_instance};
     erhe::gltf::Gltf_parse_arguments parse_arguments{
         .graphics_instance = graphics_instance,
@@ -89,6 +97,11 @@ void import_gltf(
         .root_node         = root_node,
         .mesh_layer_id     = scene_root.layers().content()->id,
         .path              = path,
+        .thread_pool       = &thread_pool,
+        .progress_callback = [](const std::string_view stage, const std::size_t done, const std::size_t total) {
+            log_parsers->debug("glTF import {} {} / {}", stage, done, total);
+        },
+        .use_image_cache   = true
     };
     erhe::gltf::Gltf_data gltf_data = erhe::gltf::parse_gltf(parse_arguments);
 
@@ -140,8 +153,12 @@ void import_gltf(
     bool add_default_light = false;
     log_parsers->info("Processing {} nodes", gltf_data.nodes.size());
 
+    // Node meshes are clones which share primitive shapes; each shape is
+    // processed once.
     size_t mesh_count = 0;
     size_t primitive_count = 0;
+    std::vector<erhe::primitive::Primitive*> unique_primitives;
+    std::unordered_set<const erhe::primitive::Primitive_render_shape*> unique_shapes;
     for (const auto& node : gltf_data.nodes) {
         if (!node) {
             continue;
@@ -151,9 +168,47 @@ void import_gltf(
             ++mesh_count;
             std::vector<erhe::primitive::Primitive>& primitives = mesh->get_mutable_primitives();
             primitive_count += primitives.size();
+            for (erhe::primitive::Primitive& primitive : primitives) {
+                if (unique_shapes.insert(primitive.render_shape.get()).second) {
+                    unique_primitives.push_back(&primitive);
+                }
+            }
+        }
+    }
+    log_parsers->info(
+        "Processing {} nodes, {} meshes, {} primitives, {} unique primitives",
+        gltf_data.nodes.size(), mesh_count, primitive_count, unique_primitives.size()
+    );
+
+    // Geometry and raytrace are CPU only and built on the thread pool
+    {
+        erhe::concurrency::Concurrent_queue queue{thread_pool, "gltf geometry"};
+        queue.enqueue_range(0, unique_primitives.size(), 1, [&unique_primitives](const std::size_t i) {
+            erhe::primitive::Primitive& primitive = *unique_primitives[i];
+
+            // Ensure geometry exists
+            ERHE_VERIFY(primitive.make_geometry());
+
+            // Ensure raytrace exists
+            ERHE_VERIFY(primitive.make_raytrace());
+        });
+        queue.wait();
+    }
+
+    // Renderable meshes write to GPU buffers and are built on this thread
+    for (erhe::primitive::Primitive* primitive : unique_primitives) {
+        // Morph target deltas are indexed by triangle soup vertex, so those
+        // primitives keep soup vertex order.
+        const bool has_morph_targets =
+            primitive->render_shape &&
+            primitive->render_shape->get_triangle_soup() &&
+            primitive->render_shape->get_triangle_soup()->morph_targets;
+        if (has_morph_targets) {
+            ERHE_VERIFY(primitive->make_renderable_mesh(build_info.buffer_info));
+        } else {
+            ERHE_VERIFY(primitive->make_renderable_mesh(build_info, erhe::primitive::Normal_style::corner_normals));
         }
     }
-    log_parsers->info("Processing {} nodes, {} meshes, {} primitives", gltf_data.nodes.size(), mesh_count, primitive_count);
 
     for (const auto& node : gltf_data.nodes) {
         if (!node) {
@@ -174,19 +229,6 @@ void import_gltf(
 
         auto mesh = erhe::scene::get_mesh(node.get());
         if (mesh) {
-            // TODO Defer geometry / raytrace / renderable mesh generation
-            std::vector<erhe::primitive::Primitive>& primitives = mesh->get_mutable_primitives();
-            for (erhe::primitive::Primitive& primitive : primitives) {
-                // Ensure geometry exists
-                ERHE_VERIFY(primitive.make_geometry());
-
-                // Ensure raytrace exists
-                ERHE_VERIFY(primitive.make_raytrace());
-
-                // Ensure renderable mesh exists
-                ERHE_VERIFY(primitive.make_renderable_mesh(build_info, erhe::primitive::Normal_style::corner_normals));
-            }
-
             mesh->update_rt_primitives();
         }
 
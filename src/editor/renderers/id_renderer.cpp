@@ -93,6 +93,7 @@ Id_renderer::Id_renderer(
     , m_camera_buffers       {graphics_instance, program_interface.camera_interface}
     , m_draw_indirect_buffers{graphics_instance}
     , m_primitive_buffers    {graphics_instance, program_interface.primitive_interface}
+    , m_morph_buffers        {graphics_instance, program_interface.morph_interface}
     //{
     //const auto reverse_depth = graphics_instance.configuration.reverse_depth;
 
@@ -122,6 +123,7 @@ Id_renderer::Id_renderer(
 #undef REVERSE_DEPTH
 {
     create_id_frame_resources();
+    m_primitive_buffers.set_morph_buffer(&m_morph_buffers);
 
     const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "id_renderer");
     ini.get("enabled", enabled);
@@ -149,6 +151,7 @@ void Id_renderer::next_frame()
     m_camera_buffers       .next_frame();
     m_draw_indirect_buffers.next_frame();
     m_primitive_buffers    .next_frame();
+    m_morph_buffers        .next_frame();
 
     m_current_id_frame_resource_slot = (m_current_id_frame_resource_slot + 1) % s_frame_resources_count;
 }
@@ -259,6 +262,7 @@ void Id_renderer::render(const std::span<const std::shared_ptr<erhe::scene::Mesh
 
     const erhe::primitive::Primitive_mode primitive_mode{erhe::primitive::Primitive_mode::polygon_fill};
     std::size_t primitive_count{0};
+    const auto morph_range                = m_morph_buffers.update({&meshes, 1});
     const auto primitive_range            = m_primitive_buffers.update(meshes, primitive_mode, id_filter, settings, primitive_count, true);
     const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, primitive_mode, id_filter);
     if (draw_indirect_buffer_range.draw_indirect_count == 0) {
@@ -268,6 +272,7 @@ void Id_renderer::render(const std::span<const std::shared_ptr<erhe::scene::Mesh
         log_render->warn("primitive_range != draw_indirect_buffer_range.draw_indirect_count");
     }
 
+    m_morph_buffers        .bind(morph_range);
     m_primitive_buffers    .bind(primitive_range);
     m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
 
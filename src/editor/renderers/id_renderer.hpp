@@ -3,6 +3,7 @@
 #include "erhe_graphics/gpu_timer.hpp"
 #include "erhe_renderer/draw_indirect_buffer.hpp"
 #include "erhe_scene_renderer/camera_buffer.hpp"
+#include "erhe_scene_renderer/morph_buffer.hpp"
 #include "erhe_scene_renderer/primitive_buffer.hpp"
 
 #include "erhe_graphics/pipeline.hpp"
@@ -121,6 +122,7 @@ private:
     erhe::scene_renderer::Camera_buffer           m_camera_buffers;
     erhe::renderer::Draw_indirect_buffer          m_draw_indirect_buffers;
     erhe::scene_renderer::Primitive_buffer        m_primitive_buffers;
+    erhe::scene_renderer::Morph_buffer            m_morph_buffers;
 
     erhe::graphics::Pipeline                      m_pipeline;
     erhe::graphics::Pipeline                      m_selective_depth_clear_pipeline;
@@ -27,8 +27,19 @@ auto Mesh_memory::get_index_buffer_size() const -> std::size_t
     return static_cast<std::size_t>(index_buffer_size) * mega;
 }
 
+auto Mesh_memory::get_staging_buffer_size() const -> std::size_t
+{
+    int staging_buffer_size{16}; // in megabytes
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "mesh_memory");
+    ini.get("staging_buffer_size", staging_buffer_size);
+    std::size_t kilo = 1024;
+    std::size_t mega = 1024 * kilo;
+    return static_cast<std::size_t>(staging_buffer_size) * mega;
+}
+
 Mesh_memory::Mesh_memory(erhe::graphics::Instance& graphics_instance, erhe::scene_renderer::Program_interface& program_interface)
     : graphics_instance{graphics_instance}
+    , gl_buffer_transfer_queue{graphics_instance, get_staging_buffer_size()}
     , vertex_format{
         erhe::graphics::Vertex_attribute::position_float3(),
         erhe::graphics::Vertex_attribute::normal0_float3(),
@@ -70,6 +81,33 @@ Mesh_memory::Mesh_memory(erhe::graphics::Instance& graphics_instance, erhe::scen
 {
     gl_vertex_buffer.set_debug_label("Mesh Memory Vertex");
     gl_index_buffer .set_debug_label("Mesh Memory Index");
+
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "mesh_memory");
+    ini.get("compact_fragmentation_percent", m_compact_fragmentation_percent);
+}
+
+void Mesh_memory::compact(erhe::graphics::Buffer& buffer)
+{
+    // Fragmentation is the share of free bytes outside the largest free block
+    const auto statistics = buffer.get_statistics();
+    if (
+        (m_compact_fragmentation_percent <= 0) ||
+        (statistics.free_block_count < 2) ||
+        (statistics.free_byte_count == 0)
+    ) {
+        return;
+    }
+    const std::size_t fragmented_byte_count = statistics.free_byte_count - statistics.largest_free_byte_count;
+    if (fragmented_byte_count * 100 < statistics.free_byte_count * static_cast<std::size_t>(m_compact_fragmentation_percent)) {
+        return;
+    }
+    gl_buffer_transfer_queue.compact(buffer);
+}
+
+void Mesh_memory::compact()
+{
+    compact(gl_vertex_buffer);
+    compact(gl_index_buffer);
 }
 
 } // namespace editor
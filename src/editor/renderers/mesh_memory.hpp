@@ -29,6 +29,10 @@ class Mesh_memory
 public:
     Mesh_memory(erhe::graphics::Instance& graphics_instance, erhe::scene_renderer::Program_interface& program_interface);
 
+    // Compacts vertex and index buffers when they are fragmented. Must be
+    // called right after gl_buffer_transfer_queue.flush(), before rendering.
+    void compact();
+
     erhe::graphics::Instance&             graphics_instance;
     erhe::graphics::Buffer_transfer_queue gl_buffer_transfer_queue;
     erhe::graphics::Vertex_format         vertex_format;
@@ -44,6 +48,10 @@ public:
 private:
     [[nodiscard]] auto get_vertex_buffer_size() const -> std::size_t;
     [[nodiscard]] auto get_index_buffer_size() const -> std::size_t;
+    [[nodiscard]] auto get_staging_buffer_size() const -> std::size_t;
+    void compact(erhe::graphics::Buffer& buffer);
+
+    int m_compact_fragmentation_percent{50};
 };
 
 } // namespace editor
@@ -7,6 +7,7 @@
 #include "renderers/mesh_memory.hpp"
 #include "scene/scene_view.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_gl/command_info.hpp"
 #include "erhe_gl/wrapper_functions.hpp"
 #include "erhe_geometry/shapes/regular_polygon.hpp"
@@ -112,7 +113,8 @@ void Rendertarget_mesh::resize_rendertarget(erhe::graphics::Instance& graphics_i
         m_material,
         erhe::primitive::Build_info{
             .primitive_types{ .fill_triangles = true },
-            .buffer_info = mesh_memory.buffer_info
+            .buffer_info = mesh_memory.buffer_info,
+            .thread_pool = &erhe::concurrency::Thread_pool::get_default()
         },
         erhe::primitive::Normal_style::polygon_normals
     };
@@ -14,6 +14,16 @@ void main()
         world_from_node          = primitive.primitives[gl_DrawID].world_from_node;
         world_from_node_cofactor = primitive.primitives[gl_DrawID].world_from_node_cofactor;
     } else {
+#if defined(ERHE_COMPACT_JOINT_PALETTE)
+        mat3x4 world_from_bind_rows =
+            a_weights.x * joint.joints[int(a_joints.x) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind +
+            a_weights.y * joint.joints[int(a_joints.y) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind +
+            a_weights.z * joint.joints[int(a_joints.z) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind +
+            a_weights.w * joint.joints[int(a_joints.w) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind;
+        world_from_node = mat4(transpose(world_from_bind_rows));
+        mat3 m = mat3(world_from_node);
+        world_from_node_cofactor = mat4(cross(m[1], m[2]), 0.0, cross(m[2], m[0]), 0.0, cross(m[0], m[1]), 0.0, 0.0, 0.0, 0.0, 1.0);
+#else
         world_from_node =
             a_weights.x * joint.joints[int(a_joints.x) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind +
             a_weights.y * joint.joints[int(a_joints.y) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind +
@@ -24,13 +34,24 @@ void main()
             a_weights.y * joint.joints[int(a_joints.y) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind_cofactor +
             a_weights.z * joint.joints[int(a_joints.z) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind_cofactor +
             a_weights.w * joint.joints[int(a_joints.w) + primitive.primitives[gl_DrawID].base_joint_index].world_from_bind_cofactor;
+#endif
+    }
+
+    vec3 node_position = a_position;
+    vec3 node_normal   = a_normal;
+    vec3 node_tangent  = a_tangent.xyz;
+    if (primitive.primitives[gl_DrawID].morph_factor > 0.5) {
+        int morph_vertex_index = gl_VertexID + primitive.primitives[gl_DrawID].morph_vertex_offset;
+        node_position += morph.vertices[morph_vertex_index].position.xyz;
+        node_normal   += morph.vertices[morph_vertex_index].normal.xyz;
+        node_tangent  += morph.vertices[morph_vertex_index].tangent.xyz;
     }
 
     mat4 clip_from_world = camera.cameras[0].clip_from_world;
-    vec3 normal          = normalize(vec3(world_from_node_cofactor * vec4(a_normal,      0.0)));
-    vec3 tangent         = normalize(vec3(world_from_node_cofactor * vec4(a_tangent.xyz, 0.0)));
+    vec3 normal          = normalize(vec3(world_from_node_cofactor * vec4(node_normal,   0.0)));
+    vec3 tangent         = normalize(vec3(world_from_node_cofactor * vec4(node_tangent,  0.0)));
     vec3 bitangent       = normalize(cross(normal, tangent)) * a_tangent.w;
-    vec4 position        = world_from_node * vec4(a_position, 1.0);
+    vec4 position        = world_from_node * vec4(node_position, 1.0);
 
     v_TBN            = mat3(tangent, bitangent, normal);
     v_position       = position;
@@ -5,15 +5,29 @@ void main()
     if (primitive.primitives[gl_DrawID].skinning_factor < 0.5) {
         world_from_node = primitive.primitives[gl_DrawID].world_from_node;
     } else {
+#if defined(ERHE_COMPACT_JOINT_PALETTE)
+        mat3x4 world_from_bind_rows =
+            a_weights.x * joint.joints[int(a_joints.x)].world_from_bind +
+            a_weights.y * joint.joints[int(a_joints.y)].world_from_bind +
+            a_weights.z * joint.joints[int(a_joints.z)].world_from_bind +
+            a_weights.w * joint.joints[int(a_joints.w)].world_from_bind;
+        world_from_node = mat4(transpose(world_from_bind_rows));
+#else
         world_from_node =
             a_weights.x * joint.joints[int(a_joints.x)].world_from_bind +
             a_weights.y * joint.joints[int(a_joints.y)].world_from_bind +
             a_weights.z * joint.joints[int(a_joints.z)].world_from_bind +
             a_weights.w * joint.joints[int(a_joints.w)].world_from_bind;
+#endif
+    }
+
+    vec3 node_position = a_position;
+    if (primitive.primitives[gl_DrawID].morph_factor > 0.5) {
+        node_position += morph.vertices[gl_VertexID + primitive.primitives[gl_DrawID].morph_vertex_offset].position.xyz;
     }
 
     mat4 clip_from_world   = light_block.lights[light_control_block.light_index].clip_from_world;
-    vec4 position_in_world = world_from_node * vec4(a_position, 1.0);
+    vec4 position_in_world = world_from_node * vec4(node_position, 1.0);
     gl_Position = clip_from_world * position_in_world;
 }
 
@@ -3,9 +3,14 @@ out flat uint v_material_index;
 
 void main()
 {
+    vec3 node_position = a_position;
+    if (primitive.primitives[gl_DrawID].morph_factor > 0.5) {
+        node_position += morph.vertices[gl_VertexID + primitive.primitives[gl_DrawID].morph_vertex_offset].position.xyz;
+    }
+
     mat4 world_from_node = primitive.primitives[gl_DrawID].world_from_node;
     mat4 clip_from_world = camera.cameras[0].clip_from_world;
-    vec4 position        = world_from_node * vec4(a_position, 1.0);
+    vec4 position        = world_from_node * vec4(node_position, 1.0);
     v_position       = position.xyz;
     gl_Position      = clip_from_world * position;
     v_material_index = primitive.primitives[gl_DrawID].material_index;
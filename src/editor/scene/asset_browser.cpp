@@ -13,6 +13,7 @@
 #include "scene/scene_root.hpp"
 #include "windows/item_tree_window.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_physics/iworld.hpp"
@@ -86,7 +87,8 @@ void Scene_open_operation::execute(Editor_context& context)
                     .corner_points   = true,
                     .centroid_points = true
                 },
-                .buffer_info = context.mesh_memory->buffer_info
+                .buffer_info = context.mesh_memory->buffer_info,
+                .thread_pool = &erhe::concurrency::Thread_pool::get_default()
             },
             *m_scene_root.get(),
             m_path
@@ -287,7 +289,8 @@ auto Asset_browser::try_import(const std::shared_ptr<Asset_file_gltf>& gltf) ->
                     .corner_points   = true,
                     .centroid_points = true
                 },
-                .buffer_info = m_context.mesh_memory->buffer_info
+                .buffer_info = m_context.mesh_memory->buffer_info,
+                .thread_pool = &erhe::concurrency::Thread_pool::get_default()
             },
             *m_context.scene_builder->get_scene_root().get(),
             gltf->get_source_path()
@@ -118,18 +118,18 @@ void Frame_controller::handle_node_update(erhe::scene::Node* old_node, erhe::sce
     get_transform_from_node(new_node);
 }
 
+// Nodes in a scene notify attachments from Scene::update_node_transforms(),
+// after update() has returned. Notification caused by update() itself is
+// skipped; writing the transform back here would mark the node dirty
+// again, and it would be updated and notified every frame.
 void Frame_controller::handle_node_transform_update()
 {
-    if (m_transform_update) {
+    if (m_pending_transform_write) {
+        m_pending_transform_write = false;
         return;
     }
 
-    auto* node = get_node();
-    if (node == nullptr) {
-        return;
-    }
-    get_transform_from_node(node);
-    update();
+    get_transform_from_node(get_node());
 }
 
 void Frame_controller::reset()
@@ -171,9 +171,8 @@ void Frame_controller::update()
         return;
     }
 
-    m_transform_update = true;
+    m_pending_transform_write = true;
     node->set_world_from_node(erhe::scene::Trs_transform{m_position, m_orientation});
-    m_transform_update = false;
 }
 
 auto Frame_controller::get_axis_x() const -> vec3
@@ -205,21 +204,31 @@ void Frame_controller::tick(std::chrono::steady_clock::time_point timestamp)
 
     const float speed = move_speed + speed_modifier.get_velocity();
 
+    bool translated = false;
     if (translate_x.get_tick_distance() != 0.0f) {
         m_position += get_axis_x() * translate_x.get_tick_distance() * speed;
+        translated = true;
     }
 
     if (translate_y.get_tick_distance() != 0.0f) {
         m_position += get_axis_y() * translate_y.get_tick_distance() * speed;
+        translated = true;
     }
 
     if (translate_z.get_tick_distance() != 0.0f) {
         m_position += get_axis_z() * translate_z.get_tick_distance() * speed;
+        translated = true;
     }
 
-    apply_rotation(rotate_x.get_value(), rotate_y.get_value(), 0.0f);
-
-    update();
+    // Node is left untouched when nothing moved, so that a still camera
+    // does not dirty its node every frame
+    const float rx = rotate_x.get_value();
+    const float ry = rotate_y.get_value();
+    if ((rx != 0.0f) || (ry != 0.0f)) {
+        apply_rotation(rx, ry, 0.0f);
+    } else if (translated) {
+        update();
+    }
 }
 
 void Frame_controller::apply_rotation(float rx, float ry, float rz)
@@ -77,7 +77,7 @@ public:
 private:
     glm::vec3 m_position;
     glm::mat4 m_orientation;
-    bool      m_transform_update{false};
+    bool      m_pending_transform_write{false}; // set by update(), cleared by the notification it causes
 };
 
 auto is_frame_controller(const erhe::Item_base* item) -> bool;
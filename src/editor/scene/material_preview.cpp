@@ -8,6 +8,7 @@
 #include "scene/scene_root.hpp"
 #include "scene/content_library.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_graphics/instance.hpp"
 #include "erhe_imgui/imgui_renderer.hpp"
 #include "erhe_geometry/geometry.hpp"
@@ -198,7 +199,8 @@ void Material_preview::make_preview_scene(Mesh_memory& mesh_memory)
                 ),
                 erhe::primitive::Build_info{
                     .primitive_types = { .fill_triangles = true },
-                    .buffer_info     = mesh_memory.buffer_info
+                    .buffer_info     = mesh_memory.buffer_info,
+                    .thread_pool     = &erhe::concurrency::Thread_pool::get_default()
                 },
                 dummy,
                 erhe::primitive::Normal_style::corner_normals
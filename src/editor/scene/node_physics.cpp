@@ -118,19 +118,139 @@ void Node_physics::after_physics_simulation()
 
     const auto transform = m_rigid_body->get_world_transform();
     const glm::vec3 world_position = glm::vec3{transform * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}};
+    m_body_active     = m_rigid_body->is_active();
+    m_linear_velocity = m_body_active ? m_rigid_body->get_linear_velocity() : glm::vec3{0.0f};
 
     if (world_position.y < -100.0f) {
-        const glm::vec3 respawn_location{0.0f, 8.0f, 0.0f};
-        m_rigid_body->set_world_transform (erhe::physics::Transform{glm::mat3{1.0f}, respawn_location});
-        m_rigid_body->set_linear_velocity (glm::vec3{0.0f, 0.0f, 0.0f});
-        m_rigid_body->set_angular_velocity(glm::vec3{0.0f, 0.0f, 0.0f});
-        const glm::mat4 matrix = erhe::math::create_translation<float>(respawn_location);
-        get_node()->set_world_from_node(matrix);
+        respawn();
     } else {
         get_node()->set_world_from_node(transform);
     }
 }
 
+void Node_physics::respawn()
+{
+    const glm::vec3 respawn_location{0.0f, 8.0f, 0.0f};
+    m_rigid_body->set_world_transform (erhe::physics::Transform{glm::mat3{1.0f}, respawn_location});
+    m_rigid_body->set_linear_velocity (glm::vec3{0.0f, 0.0f, 0.0f});
+    m_rigid_body->set_angular_velocity(glm::vec3{0.0f, 0.0f, 0.0f});
+    const glm::mat4 matrix = erhe::math::create_translation<float>(respawn_location);
+    get_node()->set_world_from_node(matrix);
+    m_physics_state_count = 0;
+}
+
+auto Node_physics::capture_physics_state(Node_physics_state& out_state) -> bool
+{
+    if (!m_rigid_body || (m_rigid_body->get_motion_mode() != Motion_mode::e_dynamic)) {
+        m_physics_state_count = 0;
+        return false;
+    }
+
+    // Sleeping bodies do not move; collapse states so that interpolation is a no-op
+    if (!m_rigid_body->is_active() && (m_physics_state_count > 0)) {
+        m_previous_state = m_current_state;
+    } else {
+        const glm::mat4 transform = m_rigid_body->get_world_transform();
+        m_previous_state = m_current_state;
+        m_current_state  = Physics_state{
+            .position    = glm::vec3{transform[3]},
+            .orientation = glm::quat_cast(glm::mat3{transform})
+        };
+        if (m_physics_state_count == 0) {
+            m_previous_state = m_current_state;
+        }
+    }
+    m_physics_state_count = 2;
+
+    const bool active = m_rigid_body->is_active();
+    out_state = Node_physics_state{
+        .node_physics         = this,
+        .previous_position    = m_previous_state.position,
+        .previous_orientation = m_previous_state.orientation,
+        .position             = m_current_state.position,
+        .orientation          = m_current_state.orientation,
+        .linear_velocity      = active ? m_rigid_body->get_linear_velocity() : glm::vec3{0.0f},
+        .active               = active,
+        .edit_serial          = m_applied_edit_serial
+    };
+    return true;
+}
+
+void Node_physics::apply_edit(
+    const glm::vec3& position,
+    const glm::quat& orientation,
+    const bool       reset_velocity,
+    const uint64_t   edit_serial
+)
+{
+    if (m_rigid_body) {
+        m_rigid_body->set_world_transform(erhe::physics::Transform{glm::mat3_cast(orientation), position});
+        if (reset_velocity) {
+            m_rigid_body->set_linear_velocity (glm::vec3{0.0f, 0.0f, 0.0f});
+            m_rigid_body->set_angular_velocity(glm::vec3{0.0f, 0.0f, 0.0f});
+        }
+    }
+    m_physics_state_count = 0;
+    m_applied_edit_serial = edit_serial;
+}
+
+void Node_physics::apply_physics_state(const Node_physics_state& state, const float alpha)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(m_node != nullptr);
+
+    const glm::vec3 position    = glm::mix  (state.previous_position,    state.position,    alpha);
+    const glm::quat orientation = glm::slerp(state.previous_orientation, state.orientation, alpha);
+    set_applied_transform(erhe::math::create_translation<float>(position) * glm::mat4_cast(orientation));
+    m_linear_velocity = state.linear_velocity;
+    m_body_active     = state.active;
+}
+
+auto Node_physics::get_linear_velocity() const -> glm::vec3
+{
+    return m_linear_velocity;
+}
+
+auto Node_physics::is_body_active() const -> bool
+{
+    return m_body_active;
+}
+
+void Node_physics::set_applied_transform(const glm::mat4& world_from_node)
+{
+    ERHE_VERIFY(m_node != nullptr);
+
+    m_node->set_world_from_node(world_from_node);
+    m_applied_parent_from_node = m_node->parent_from_node();
+    m_has_applied_transform    = true;
+}
+
+void Node_physics::accept_transform_edit()
+{
+    ERHE_VERIFY(m_node != nullptr);
+
+    m_applied_parent_from_node = m_node->parent_from_node();
+}
+
+auto Node_physics::is_transform_edited() const -> bool
+{
+    return
+        m_has_applied_transform &&
+        (m_node != nullptr) &&
+        (m_node->parent_from_node() != m_applied_parent_from_node);
+}
+
+auto Node_physics::make_edit_serial() -> uint64_t
+{
+    return ++m_edit_serial;
+}
+
+auto Node_physics::get_edit_serial() const -> uint64_t
+{
+    return m_edit_serial;
+}
+
 auto Node_physics::get_rigid_body() -> IRigid_body*
 {
     return (m_physics_world != nullptr) ? m_rigid_body.get() : nullptr;
@@ -3,6 +3,9 @@
 #include "erhe_scene/node_attachment.hpp"
 #include "erhe_physics/irigid_body.hpp"
 
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include <functional>
 
 namespace erhe {
@@ -14,6 +17,22 @@ namespace erhe::physics {
 
 namespace editor {
 
+class Node_physics;
+
+// Body state captured by the physics thread after a simulation step
+class Node_physics_state
+{
+public:
+    Node_physics* node_physics        {nullptr};
+    glm::vec3     previous_position   {0.0f};
+    glm::quat     previous_orientation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3     position            {0.0f};
+    glm::quat     orientation         {1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3     linear_velocity     {0.0f};
+    bool          active              {false};
+    uint64_t      edit_serial         {0}; // Last main thread edit applied to the body
+};
+
 class Node_physics
     : public erhe::Item<
         erhe::Item_base,
@@ -46,6 +65,39 @@ public:
     void before_physics_simulation();
     void after_physics_simulation();
 
+    // Physics thread: called after each simulation step, keeps the last two
+    // body states. Returns false for bodies which are not dynamic.
+    [[nodiscard]] auto capture_physics_state(Node_physics_state& out_state) -> bool;
+
+    // Physics thread: moves the body to a transform set from the main
+    // thread, and restarts state capture from there.
+    void apply_edit(const glm::vec3& position, const glm::quat& orientation, bool reset_velocity, uint64_t edit_serial);
+
+    // Main thread: sets node transform interpolated between the two states;
+    // alpha 0.0 is the previous state, 1.0 the current state.
+    void apply_physics_state(const Node_physics_state& state, float alpha);
+
+    // Main thread: true if node transform has been changed by something
+    // else than apply_physics_state() since it was last called
+    [[nodiscard]] auto is_transform_edited() const -> bool;
+
+    // Main thread: edits are numbered so that captured states from before
+    // the edit was applied by the physics thread can be ignored
+    [[nodiscard]] auto make_edit_serial() -> uint64_t;
+    [[nodiscard]] auto get_edit_serial () const -> uint64_t;
+
+    // Main thread: sets node transform as if it was set by apply_physics_state()
+    void set_applied_transform(const glm::mat4& world_from_node);
+
+    // Main thread: current node transform is no longer considered edited
+    void accept_transform_edit();
+
+    // Main thread: body velocity and activity from the latest applied state,
+    // for use while the physics thread may be stepping and the rigid body
+    // must not be read. Zero / false for bodies which are not dynamic.
+    [[nodiscard]] auto get_linear_velocity() const -> glm::vec3;
+    [[nodiscard]] auto is_body_active     () const -> bool;
+
     void set_physics_world(erhe::physics::IWorld* value);
     [[nodiscard]] auto get_physics_world() const -> erhe::physics::IWorld*;
 
@@ -54,9 +106,31 @@ public:
     erhe::physics::Motion_mode physics_motion_mode{erhe::physics::Motion_mode::e_dynamic};
 
 private:
+    class Physics_state
+    {
+    public:
+        glm::vec3 position   {0.0f};
+        glm::quat orientation{1.0f, 0.0f, 0.0f, 0.0f};
+    };
+
+    void respawn();
+
     erhe::physics::IWorld*                      m_physics_world{nullptr};
     erhe::physics::IRigid_body_create_info      m_create_info;
     std::shared_ptr<erhe::physics::IRigid_body> m_rigid_body;
+
+    // Physics thread
+    Physics_state                               m_previous_state;
+    Physics_state                               m_current_state;
+    int                                         m_physics_state_count{0}; // 0..2
+    uint64_t                                    m_applied_edit_serial{0};
+
+    // Main thread
+    uint64_t                                    m_edit_serial{0};
+    bool                                        m_has_applied_transform{false};
+    glm::mat4                                   m_applied_parent_from_node{1.0f};
+    glm::vec3                                   m_linear_velocity{0.0f};
+    bool                                        m_body_active{false};
 };
 
 auto is_physics(const erhe::Item_base* item) -> bool;
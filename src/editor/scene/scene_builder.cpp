@@ -21,6 +21,7 @@
 
 #include "SkylineBinPack.h" // RectangleBinPack
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
@@ -147,7 +148,10 @@ Scene_builder::Scene_builder(
     );
     setup_lights   ();
     make_brushes   (editor_settings, mesh_memory);
-    add_room       ();
+
+    m_scene_root->begin_physics_body_batch();
+    add_room();
+    m_scene_root->end_physics_body_batch();
 }
 
 void Scene_builder::add_rendertarget_viewports(int count)
@@ -367,7 +371,8 @@ auto Scene_builder::build_info(Mesh_memory& mesh_memory) -> erhe::primitive::Bui
             .corner_points   = true,
             .centroid_points = true
         },
-        .buffer_info = mesh_memory.buffer_info
+        .buffer_info = mesh_memory.buffer_info,
+        .thread_pool = &erhe::concurrency::Thread_pool::get_default()
     };
 }
 
@@ -399,11 +404,7 @@ void Scene_builder::make_brushes(Editor_settings& editor_settings, Mesh_memory&
 
     const bool parallel_initialization = false; //// TODO
     if (parallel_initialization) {
-        const std::size_t thread_count = std::min(
-            8U,
-            std::max(std::thread::hardware_concurrency() - 0, 1U)
-        );
-        execution_queue = std::make_unique<Parallel_task_queue>("scene builder", thread_count);
+        execution_queue = std::make_unique<Parallel_task_queue>(erhe::concurrency::Thread_pool::get_default(), "scene builder");
     } else {
         execution_queue = std::make_unique<Serial_task_queue>();
     }
@@ -774,6 +775,7 @@ void Scene_builder::add_torus_chain(const Make_mesh_config& config, bool connect
     };
 
     const std::shared_ptr<Brush>& brush = m_torus_brush;
+    m_scene_root->begin_physics_body_batch();
     for (int i = 0; i < config.instance_count; ++i) {
         const Instance_create_info brush_instance_create_info{
             .node_flags      = Item_flags::show_in_ui | Item_flags::visible | Item_flags::content,
@@ -788,6 +790,7 @@ void Scene_builder::add_torus_chain(const Make_mesh_config& config, bool connect
         instance_node->set_parent(m_scene_root->get_scene().get_root_node());
         x = x + x_stride;
     }
+    m_scene_root->end_physics_body_batch();
 }
 
 void Scene_builder::make_mesh_nodes(const Make_mesh_config& config, std::vector<std::shared_ptr<Brush>>& brushes)
@@ -890,6 +893,7 @@ void Scene_builder::make_mesh_nodes(const Make_mesh_config& config, std::vector<
         ERHE_VERIFY(!materials.empty());
         ERHE_VERIFY(visible_material_count > 0);
 
+        m_scene_root->begin_physics_body_batch();
         for (auto& entry : pack_entries) {
             // TODO this will lock up if there are no visible materials
             do {
@@ -935,6 +939,7 @@ void Scene_builder::make_mesh_nodes(const Make_mesh_config& config, std::vector<
             m_scene_root->get_scene().sanity_check();
 #endif
         }
+        m_scene_root->end_physics_body_batch();
     }
 }
 
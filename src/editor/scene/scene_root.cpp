@@ -515,12 +515,17 @@ void Scene_root::register_node_physics(const std::shared_ptr<Node_physics>& node
     {
         m_node_physics.push_back(node_physics);
         m_node_physics_sorted = false;
+        ++m_node_physics_generation;
     }
 
     node_physics->set_physics_world(m_physics_world.get());
     erhe::physics::IRigid_body* rigid_body = node_physics->get_rigid_body();
     if (rigid_body != nullptr) {
-        m_physics_world->add_rigid_body(node_physics->get_rigid_body());
+        if (m_physics_body_batch_depth > 0) {
+            m_physics_body_batch.push_back(rigid_body);
+        } else {
+            m_physics_world->add_rigid_body(rigid_body);
+        }
     }
 }
 
@@ -541,22 +546,57 @@ void Scene_root::unregister_node_physics(const std::shared_ptr<Node_physics>& no
     } else {
         m_node_physics.erase(i, m_node_physics.end());
         m_node_physics_sorted = false;
+        ++m_node_physics_generation;
     }
 
     erhe::physics::IRigid_body* rigid_body = node_physics->get_rigid_body();
     if (rigid_body != nullptr) {
-        m_physics_world->remove_rigid_body(node_physics->get_rigid_body());
+        const auto j = std::find(m_physics_body_batch.begin(), m_physics_body_batch.end(), rigid_body);
+        if (j != m_physics_body_batch.end()) {
+            m_physics_body_batch.erase(j);
+        } else {
+            m_physics_world->remove_rigid_body(rigid_body);
+        }
     }
     node_physics->set_physics_world(nullptr);
 }
 
-void Scene_root::before_physics_simulation_steps()
+void Scene_root::begin_physics_body_batch()
+{
+    ++m_physics_body_batch_depth;
+}
+
+void Scene_root::end_physics_body_batch()
 {
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(m_physics_body_batch_depth > 0);
+    if (--m_physics_body_batch_depth > 0) {
+        return;
+    }
+    if (m_physics_world && !m_physics_body_batch.empty()) {
+        log_physics->debug("Adding {} rigid bodies", m_physics_body_batch.size());
+        m_physics_world->add_rigid_bodies(m_physics_body_batch);
+    }
+    m_physics_body_batch.clear();
+}
+
+// Dynamic bodies are excluded with physics thread, as their nodes are
+// interpolated and would move the bodies back in time. Edited dynamic
+// bodies are moved through apply_physics_edits() instead.
+void Scene_root::before_physics_simulation_steps(const bool include_dynamic_bodies)
+{
+    // Published states follow this order, parent nodes before child nodes
+    sort_node_physics();
+
     for (const auto& node_physics : m_node_physics) {
         auto* rigid_body = node_physics->get_rigid_body();
         if (rigid_body == nullptr) {
             continue;
         }
+        if (!include_dynamic_bodies && (rigid_body->get_motion_mode() == erhe::physics::Motion_mode::e_dynamic)) {
+            continue;
+        }
         node_physics->before_physics_simulation();
     }
 }
@@ -574,6 +614,127 @@ void Scene_root::after_physics_simulation_steps()
         return;
     }
 
+    sort_node_physics();
+
+    for (const auto& node_physics : m_node_physics) {
+        auto* rigid_body = node_physics->get_rigid_body();
+        if (rigid_body) {
+            if (rigid_body->is_active()) {
+                node_physics->after_physics_simulation();
+            }
+        }
+    }
+}
+
+void Scene_root::apply_physics_edits()
+{
+    if (!m_physics_world) {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock{m_physics_edit_mutex};
+        std::swap(m_physics_edits, m_physics_edits_to_apply);
+    }
+    for (const Physics_edit& edit : m_physics_edits_to_apply) {
+        // Node_physics is only removed within the physics access window, so
+        // it cannot be released by the main thread while this step runs.
+        const std::shared_ptr<Node_physics> node_physics = edit.node_physics.lock();
+        if (node_physics && (node_physics->get_rigid_body() != nullptr)) {
+            node_physics->apply_edit(edit.position, edit.orientation, edit.reset_velocity, edit.edit_serial);
+        }
+    }
+    m_physics_edits_to_apply.clear();
+}
+
+void Scene_root::capture_physics_states(const std::chrono::steady_clock::time_point time)
+{
+    if (!m_physics_world) {
+        return;
+    }
+
+    Physics_snapshot& snapshot = m_physics_snapshots.get_write_buffer();
+    snapshot.time                    = time;
+    snapshot.node_physics_generation = m_node_physics_generation;
+    snapshot.states.clear();
+    Node_physics_state state;
+    for (const auto& node_physics : m_node_physics) {
+        if (node_physics->capture_physics_state(state)) {
+            snapshot.states.push_back(state);
+        }
+    }
+    m_physics_snapshots.publish();
+}
+
+void Scene_root::queue_physics_edit(Node_physics& node_physics, const glm::mat4& world_from_node, const bool reset_velocity)
+{
+    const glm::mat3 basis{world_from_node};
+    const glm::mat3 rotation{glm::normalize(basis[0]), glm::normalize(basis[1]), glm::normalize(basis[2])};
+    const std::lock_guard<std::mutex> lock{m_physics_edit_mutex};
+    m_physics_edits.push_back(
+        Physics_edit{
+            .node_physics   = std::static_pointer_cast<Node_physics>(node_physics.shared_from_this()),
+            .position       = glm::vec3{world_from_node[3]},
+            .orientation    = glm::quat_cast(rotation),
+            .reset_velocity = reset_velocity,
+            .edit_serial    = node_physics.make_edit_serial()
+        }
+    );
+}
+
+void Scene_root::apply_physics_states(const std::chrono::steady_clock::time_point now, const double dt)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!m_physics_world) {
+        return;
+    }
+
+    // States captured before Node_physics were added or removed may refer to
+    // removed Node_physics; wait for states of the current set.
+    const Physics_snapshot* const snapshot = m_physics_snapshots.get_read_buffer();
+    if ((snapshot == nullptr) || (snapshot->node_physics_generation != m_node_physics_generation)) {
+        return;
+    }
+
+    const std::chrono::duration<double> time_since_state = now - snapshot->time;
+    const float alpha = static_cast<float>(std::clamp(time_since_state.count() / dt, 0.0, 1.0));
+    for (const Node_physics_state& state : snapshot->states) {
+        Node_physics&            node_physics = *state.node_physics;
+        const erhe::scene::Node* node         = node_physics.get_node();
+        if (node == nullptr) {
+            continue;
+        }
+
+        // Node was moved by undo / redo, an operation or properties; move the body there
+        if (node_physics.is_transform_edited()) {
+            const std::shared_ptr<erhe::scene::Node> parent = node->get_parent_node();
+            const glm::mat4 world_from_node = parent
+                ? parent->world_from_node() * node->parent_from_node()
+                : node->parent_from_node();
+            queue_physics_edit(node_physics, world_from_node, false);
+            node_physics.accept_transform_edit();
+            continue;
+        }
+
+        // Keep node where it was edited until the physics thread has applied the edit
+        if (state.edit_serial < node_physics.get_edit_serial()) {
+            continue;
+        }
+
+        if (state.position.y < -100.0f) {
+            const glm::mat4 respawn_transform = erhe::math::create_translation<float>(glm::vec3{0.0f, 8.0f, 0.0f});
+            node_physics.set_applied_transform(respawn_transform);
+            queue_physics_edit(node_physics, respawn_transform, true);
+            continue;
+        }
+
+        node_physics.apply_physics_state(state, alpha);
+    }
+}
+
+void Scene_root::sort_node_physics()
+{
     // Sort nodes, so that parent transforms are updated before child nodes
     if (!m_node_physics_sorted) {
         std::sort(
@@ -590,15 +751,6 @@ void Scene_root::after_physics_simulation_steps()
         );
         m_node_physics_sorted = true;
     }
-
-    for (const auto& node_physics : m_node_physics) {
-        auto* rigid_body = node_physics->get_rigid_body();
-        if (rigid_body) {
-            if (rigid_body->is_active()) {
-                node_physics->after_physics_simulation();
-            }
-        }
-    }
 }
 
 auto Scene_root::layers() -> Scene_layers&
@@ -3,8 +3,10 @@
 
 #include "scene/collision_generator.hpp"
 #include "scene/frame_controller.hpp"
+#include "scene/node_physics.hpp"
 
 #include "erhe_commands/command.hpp"
+#include "erhe_concurrency/triple_buffer.hpp"
 #include "erhe_gl/wrapper_enums.hpp"
 #include "erhe_message_bus/message_bus.hpp"
 #include "erhe_primitive/material.hpp"
@@ -15,6 +17,7 @@
 #include "erhe_scene/scene_message_bus.hpp"
 #include "erhe_math/math_util.hpp"
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -157,10 +160,32 @@ public:
     void register_node_physics  (const std::shared_ptr<Node_physics>& node_physics);
     void unregister_node_physics(const std::shared_ptr<Node_physics>& node_physics);
 
-    void before_physics_simulation_steps     ();
+    // Rigid bodies of Node_physics registered between begin and end are
+    // added to the physics world with a single add_rigid_bodies() call,
+    // which is much faster than adding them one by one when building or
+    // loading a scene. Batches can be nested.
+    void begin_physics_body_batch();
+    void end_physics_body_batch  ();
+
+    void before_physics_simulation_steps     (bool include_dynamic_bodies);
     void update_physics_simulation_fixed_step(double dt);
     void after_physics_simulation_steps      ();
 
+    // With physics thread, dynamic bodies are not accessed by the main thread
+    // outside the physics access window:
+    // - apply_physics_edits() runs on the physics thread before each step,
+    //   moving bodies whose nodes were edited on the main thread
+    // - capture_physics_states() runs on the physics thread after each step
+    //   and publishes body states
+    // - apply_physics_states() runs on the main thread, sets node transforms
+    //   from the latest published states without waiting for the physics
+    //   thread, and queues edits for nodes changed since the last call
+    // Node_physics must be registered and unregistered only within the
+    // physics access window.
+    void apply_physics_edits   ();
+    void capture_physics_states(std::chrono::steady_clock::time_point time);
+    void apply_physics_states  (std::chrono::steady_clock::time_point now, double dt);
+
     [[nodiscard]] auto layers            () -> Scene_layers&;
     [[nodiscard]] auto layers            () const -> const Scene_layers&;
     [[nodiscard]] auto get_physics_world () -> erhe::physics::IWorld&;
@@ -182,7 +207,27 @@ public:
     void sanity_check();
 
 private:
+    class Physics_snapshot
+    {
+    public:
+        std::chrono::steady_clock::time_point time{};
+        uint64_t                              node_physics_generation{0};
+        std::vector<Node_physics_state>       states;
+    };
+
+    class Physics_edit
+    {
+    public:
+        std::weak_ptr<Node_physics> node_physics;
+        glm::vec3                   position      {0.0f};
+        glm::quat                   orientation   {1.0f, 0.0f, 0.0f, 0.0f};
+        bool                        reset_velocity{false};
+        uint64_t                    edit_serial   {0};
+    };
+
     [[nodiscard]] auto get_node_rt_mask(erhe::scene::Node* node) -> uint32_t;
+    void sort_node_physics ();
+    void queue_physics_edit(Node_physics& node_physics, const glm::mat4& world_from_node, bool reset_velocity);
 
     // Live longest
     mutable std::mutex                              m_mutex;
@@ -195,6 +240,13 @@ private:
     // Must live longer than m_scene for example
     bool                                            m_node_physics_sorted{false};
     std::vector<std::shared_ptr<Node_physics>>      m_node_physics;
+    uint64_t                                        m_node_physics_generation{0}; // changes when m_node_physics changes
+    int                                             m_physics_body_batch_depth{0};
+    std::vector<erhe::physics::IRigid_body*>        m_physics_body_batch;
+    erhe::concurrency::Triple_buffer<Physics_snapshot> m_physics_snapshots;
+    std::mutex                                      m_physics_edit_mutex;
+    std::vector<Physics_edit>                       m_physics_edits;
+    std::vector<Physics_edit>                       m_physics_edits_to_apply; // physics thread
     std::vector<std::shared_ptr<Rendertarget_mesh>> m_rendertarget_meshes;
 
     std::vector<std::shared_ptr<erhe::Item_base>>   m_physics_disabled_nodes;
@@ -18,6 +18,7 @@
 #include "tools/tools.hpp"
 #include "tools/transform/transform_tool.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_imgui/imgui_helpers.hpp"
 #include "erhe_rendergraph/rendergraph.hpp"
 #include "erhe_rendergraph/rendergraph_node.hpp"
@@ -145,9 +146,9 @@ void Viewport_scene_view::execute_rendergraph_node()
         return;
     }
 
-    scene_root->get_scene().update_node_transforms();
+    scene_root->get_scene().update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 
-    m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms();
+    m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 
     m_context.editor_message_bus->send_message(
         Editor_message{
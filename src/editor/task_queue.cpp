@@ -6,9 +6,8 @@ ITask_queue::~ITask_queue()
 {
 }
 
-Parallel_task_queue::Parallel_task_queue(const std::string_view name, std::size_t thread_count)
-    : m_thread_pool{thread_count}
-    , m_queue      {m_thread_pool, name}
+Parallel_task_queue::Parallel_task_queue(erhe::concurrency::Thread_pool& thread_pool, const std::string_view name)
+    : m_queue{thread_pool, name}
 {
 }
 
@@ -23,7 +22,7 @@ void Serial_task_queue::wait()
 
 void Parallel_task_queue::enqueue(std::function<void()>&& func)
 {
-    m_queue.enqueue(func);
+    m_queue.enqueue(std::move(func));
 }
 
 void Parallel_task_queue::wait()
@@ -22,13 +22,12 @@ public:
 class Parallel_task_queue : public ITask_queue
 {
 public:
-    Parallel_task_queue(const std::string_view name, std::size_t thread_count);
+    Parallel_task_queue(erhe::concurrency::Thread_pool& thread_pool, const std::string_view name);
 
     void enqueue(std::function<void()>&& func) override;
     void wait   () override;
 
 private:
-    erhe::concurrency::Thread_pool      m_thread_pool;
     erhe::concurrency::Concurrent_queue m_queue;
 };
 
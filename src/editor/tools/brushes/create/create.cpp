@@ -17,6 +17,7 @@
 #include "tools/selection_tool.hpp"
 #include "tools/tools.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_imgui/imgui_helpers.hpp"
 #include "erhe_imgui/imgui_renderer.hpp"
 #include "erhe_imgui/imgui_window.hpp"
@@ -154,7 +155,8 @@ void Create::imgui()
                 .name            = m_brush_name,
                 .build_info      = erhe::primitive::Build_info{
                     .primitive_types = { .fill_triangles = true, .edge_lines = true, .corner_points = true, .centroid_points = true },
-                    .buffer_info     = m_context.mesh_memory->buffer_info
+                    .buffer_info     = m_context.mesh_memory->buffer_info,
+                    .thread_pool     = &erhe::concurrency::Thread_pool::get_default()
                 },
                 .normal_style    = m_normal_style,
                 .density         = m_density,
@@ -239,7 +241,8 @@ void Create::imgui()
                         .name            = m_brush_name,
                         .build_info      = erhe::primitive::Build_info{
                             .primitive_types = { .fill_triangles = true, .edge_lines = true, .corner_points = true, .centroid_points = true },
-                            .buffer_info     = m_context.mesh_memory->buffer_info
+                            .buffer_info     = m_context.mesh_memory->buffer_info,
+                            .thread_pool     = &erhe::concurrency::Thread_pool::get_default()
                         },
                         .normal_style    = m_normal_style,
                         .geometry        = source_geometry,
@@ -791,7 +791,9 @@ void Debug_visualizations::physics_nodes_visualization(const Render_context& con
             if (rigid_body == nullptr) {
                 continue;
             }
-            const glm::mat4 m = rigid_body->get_world_transform();
+            // Physics thread may be stepping; body state is read from the
+            // node, which has the latest published body transform
+            const glm::mat4 m = node->world_from_node();
 
             const glm::vec4 p4_in_world  = m * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
             const glm::vec3 p3_in_window = context.viewport.project_to_screen_space(
@@ -841,7 +843,7 @@ void Debug_visualizations::physics_nodes_visualization(const Render_context& con
             }
             {
                 const glm::vec4 cyan{0.0f, 1.0f, 1.0f, 0.5f};
-                const glm::vec3 velocity = rigid_body->get_linear_velocity();
+                const glm::vec3 velocity = node_physics->get_linear_velocity();
                 line_renderer.add_lines( m, cyan, {{ O, 4.0f * velocity }} );
             }
 
@@ -12,6 +12,7 @@
 
 #include "erhe_commands/input_arguments.hpp"
 #include "erhe_commands/commands.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_profile/profile.hpp"
@@ -580,7 +581,7 @@ void Fly_camera_tool::set_camera(erhe::scene::Camera* const camera, erhe::scene:
     if (node != nullptr) {
         auto* scene_root = static_cast<Scene_root*>(node->node_data.host);
         if (scene_root != nullptr) {
-            scene_root->get_scene().update_node_transforms();
+            scene_root->get_scene().update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
         } else {
             log_fly_camera->warn("node does not have scene root");
         }
@@ -19,6 +19,7 @@
 #endif
 
 #include "erhe_commands/commands.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_graphics/texture.hpp"
 #include "erhe_item/item.hpp"
@@ -339,7 +340,8 @@ void Hotbar::init_radial_menu(Mesh_memory& mesh_memory, Scene_root&  scene_root)
                 *disc_geometry_shared.get(),
                 erhe::primitive::Build_info{
                     .primitive_types = { .fill_triangles = true },
-                    .buffer_info     = mesh_memory.buffer_info
+                    .buffer_info     = mesh_memory.buffer_info,
+                    .thread_pool     = &erhe::concurrency::Thread_pool::get_default()
                 },
                 dummy
             ),
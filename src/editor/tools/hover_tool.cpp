@@ -6,6 +6,7 @@
 #include "editor_message_bus.hpp"
 #include "renderers/render_context.hpp"
 #include "scene/node_physics.hpp"
+#include "scene/scene_root.hpp"
 #include "scene/viewport_scene_view.hpp"
 #include "tools/grid.hpp"
 #include "tools/tools.hpp"
@@ -16,6 +17,7 @@
 #include "erhe_renderer/text_renderer.hpp"
 #include "erhe_log/log_glm.hpp"
 #include "erhe_physics/irigid_body.hpp"
+#include "erhe_physics/iworld.hpp"
 #include "erhe_scene/mesh.hpp"
 #include "erhe_defer/defer.hpp"
 #include "erhe_profile/profile.hpp"
@@ -109,6 +111,25 @@ void Hover_tool::imgui()
         const std::string text = fmt::format("Ray Direction: {}", direction.value());
         ImGui::TextUnformatted(text.c_str());
     }
+
+    // Physics broad phase answers the same ray; bodies only, no polygon detail
+    const std::shared_ptr<Scene_root> scene_root = scene_view->get_scene_root();
+    if (!origin.has_value() || !direction.has_value() || !scene_root) {
+        return;
+    }
+    const erhe::physics::Query_ray ray{
+        .origin    = origin.value(),
+        .direction = direction.value()
+    };
+    const std::optional<erhe::physics::Query_hit> physics_hit = scene_root->get_physics_world().ray_cast(ray);
+    ImGui::Text("Physics: %s", physics_hit.has_value() ? physics_hit->rigid_body->get_debug_label() : "");
+    if (physics_hit.has_value()) {
+        const std::string text = fmt::format(
+            "Physics Position: {} Normal: {} Distance: {}",
+            physics_hit->position, physics_hit->normal, physics_hit->distance
+        );
+        ImGui::TextUnformatted(text.c_str());
+    }
 }
 
 [[nodiscard]] auto get_text_color_from_slot(std::size_t slot)
@@ -354,7 +354,7 @@ void Paint_tool::paint_vertex(
             continue;
         }
         const erhe::primitive::Buffer_mesh& buffer_mesh = primitive.render_shape->get_renderable_mesh();
-        const std::size_t range_byte_offset = buffer_mesh.vertex_buffer_range.byte_offset;
+        const std::size_t range_byte_offset = buffer_mesh.vertex_buffer_range.get_byte_offset();
         if (attribute->data_type == erhe::dataformat::Format::format_32_vec4_float) {
             buffer.resize(sizeof(float) * 4);
             auto* const ptr = reinterpret_cast<float*>(buffer.data());
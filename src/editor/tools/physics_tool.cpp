@@ -15,12 +15,14 @@
 #include "erhe_commands/commands.hpp"
 #include "erhe_renderer/line_renderer.hpp"
 #include "erhe_log/log_glm.hpp"
+#include "erhe_math/math_util.hpp"
 #include "erhe_physics/iconstraint.hpp"
 #include "erhe_physics/icollision_shape.hpp"
 #include "erhe_physics/iworld.hpp"
 #include "erhe_raytrace/iscene.hpp"
 #include "erhe_raytrace/ray.hpp"
 #include "erhe_scene/mesh.hpp"
+#include "erhe_scene/node.hpp"
 #include "erhe_bit/bit_helpers.hpp"
 #include "erhe_profile/profile.hpp"
 
@@ -327,6 +329,7 @@ auto Physics_tool::acquire_target() -> bool
 
 void Physics_tool::move_drag_point_instant(glm::vec3 position)
 {
+    m_drag_point_position_in_world = position;
     m_constraint_world_point_rigid_body->set_motion_mode(erhe::physics::Motion_mode::e_kinematic_non_physical);
     m_constraint_world_point_rigid_body->set_world_transform(
         erhe::physics::Transform{
@@ -338,6 +341,7 @@ void Physics_tool::move_drag_point_instant(glm::vec3 position)
 
 void Physics_tool::move_drag_point_kinematic(glm::vec3 position)
 {
+    m_drag_point_position_in_world = position;
     m_constraint_world_point_rigid_body->set_motion_mode(erhe::physics::Motion_mode::e_kinematic_physical);
     m_constraint_world_point_rigid_body->set_world_transform(
         erhe::physics::Transform{
@@ -525,7 +529,7 @@ void Physics_tool::tool_render(const Render_context& context)
     constexpr glm::vec3 axis_z{0.0f, 0.0f, 1.0f};
 
     if (m_show_drag_body && m_constraint_world_point_rigid_body) {
-        const glm::mat4 m = m_constraint_world_point_rigid_body->get_world_transform();
+        const glm::mat4 m = erhe::math::create_translation<float>(m_drag_point_position_in_world);
         const glm::vec4 half_red  {0.5f, 0.0f, 0.0f, 0.5f};
         const glm::vec4 half_green{0.0f, 0.5f, 0.0f, 0.5f};
         const glm::vec4 half_blue {0.0f, 0.0f, 0.5f, 0.5f};
@@ -609,8 +613,7 @@ void Physics_tool::tool_properties(erhe::imgui::Imgui_window&)
     ImGui::Text("Distance: %f",    m_target_distance);
     ImGui::Text("Target Size: %f", m_target_mesh_size);
     if (m_target_constraint) {
-        const glm::mat4 transform = m_constraint_world_point_rigid_body->get_world_transform();
-        std::string constraint_position      = fmt::format("{}", glm::vec3{transform * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}});
+        std::string constraint_position      = fmt::format("{}", m_drag_point_position_in_world);
         std::string node_position            = fmt::format("{}", m_grab_position_in_node);
         std::string collision_shape_position = fmt::format("{}", m_grab_position_in_collision_shape);
         std::string world_position           = fmt::format("{}", m_goal_position_in_world);
@@ -620,17 +623,18 @@ void Physics_tool::tool_properties(erhe::imgui::Imgui_window&)
         ImGui::Text("Grab point in World: %s", world_position.c_str());
     }
     if (m_target_node_physics) {
-        auto* rigid_body = m_target_node_physics->get_rigid_body();
-        if (rigid_body != nullptr) {
-            const glm::mat4 transform = rigid_body->get_world_transform();
-            std::string pos = fmt::format("{}", glm::vec3{transform * glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}});
+        // Physics thread may be stepping; body state is read from the node
+        auto*       rigid_body = m_target_node_physics->get_rigid_body();
+        const auto* node       = m_target_node_physics->get_node();
+        if ((rigid_body != nullptr) && (node != nullptr)) {
+            std::string pos = fmt::format("{}", glm::vec3{node->position_in_world()});
             const auto motion_mode = rigid_body->get_motion_mode();
             const auto i = static_cast<int>(motion_mode);
             ImGui::Text("Target Node Pos: %s", pos.c_str());
             ImGui::Text("Target motion mode: %s", erhe::physics::c_motion_mode_strings[i]);
             const float mass = rigid_body->get_mass();
             ImGui::Text("Target Mass: %.2f", mass);
-            const bool is_active = rigid_body->is_active();
+            const bool is_active = m_target_node_physics->is_body_active();
             ImGui::Text("Target Is Active: %s", is_active ? "true" : "false");
         }
     }
@@ -108,6 +108,7 @@ private:
     glm::vec3                                   m_grab_position_in_collision_shape{0.0f, 0.0f, 0.0f}; // Where object drag started in local node space
     glm::vec3                                   m_grab_position_world             {0.0f, 0.0f, 0.0f}; // Where object drag started in world space
     glm::vec3                                   m_goal_position_in_world          {0.0f, 0.0f, 0.0f}; // Goal position for drag point in world space
+    glm::vec3                                   m_drag_point_position_in_world    {0.0f, 0.0f, 0.0f}; // Last position set to drag point body, which is not read back while physics thread steps
 
     erhe::physics::IWorld*                      m_physics_world{nullptr};
     std::unique_ptr<erhe::physics::IConstraint> m_target_constraint;
@@ -15,6 +15,7 @@
 #include "tools/transform/rotate_tool.hpp"
 #include "tools/transform/scale_tool.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_imgui/imgui_helpers.hpp"
 #include "erhe_geometry/shapes/box.hpp"
 #include "erhe_geometry/shapes/cone.hpp"
@@ -416,7 +417,8 @@ Handle_visualizations::Part::Part(
             .primitive_types{
                 .fill_triangles = true
             },
-            .buffer_info = mesh_memory.buffer_info
+            .buffer_info = mesh_memory.buffer_info,
+            .thread_pool = &erhe::concurrency::Thread_pool::get_default()
         },
         erhe::primitive::Normal_style::corner_normals
     );
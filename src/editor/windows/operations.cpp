@@ -10,6 +10,7 @@
 #include "tools/selection_tool.hpp"
 
 #include "erhe_commands/commands.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_imgui/imgui_helpers.hpp"
 #include "erhe_imgui/imgui_renderer.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
@@ -97,7 +98,8 @@ auto Operations::mesh_context() -> Mesh_operation_parameters
                 .corner_points   = true,
                 .centroid_points = true
             },
-            .buffer_info     = m_context.mesh_memory->buffer_info
+            .buffer_info     = m_context.mesh_memory->buffer_info,
+            .thread_pool     = &erhe::concurrency::Thread_pool::get_default()
         }
     };
 }
@@ -313,7 +315,8 @@ void Operations::merge()
                                 .corner_points   = true,
                                 .centroid_points = true
                             },
-                            .buffer_info    = m_context.mesh_memory->buffer_info
+                            .buffer_info    = m_context.mesh_memory->buffer_info,
+                            .thread_pool    = &erhe::concurrency::Thread_pool::get_default()
                         }
                     }
                 )
@@ -63,6 +63,14 @@ void Physics_window::imgui()
         return;
     }
 
+    if (m_context.editor_scenes->is_physics_thread_running()) {
+        ImGui::Text(
+            "Physics thread steps: %llu, dropped: %llu",
+            static_cast<unsigned long long>(m_context.editor_scenes->get_physics_step_count()),
+            static_cast<unsigned long long>(m_context.editor_scenes->get_physics_dropped_steps())
+        );
+    }
+
     const auto& scene_roots = m_context.editor_scenes->get_scene_roots();
     for (const auto& scene_root : scene_roots) {
         if (!ImGui::TreeNodeEx(scene_root->get_name().c_str())) {
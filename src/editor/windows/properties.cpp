@@ -15,6 +15,7 @@
 #include "windows/animation_curve.hpp"
 #include "windows/brdf_slice.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_defer/defer.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_imgui/imgui_helpers.hpp"
@@ -57,11 +58,14 @@ Properties::Properties(erhe::imgui::Imgui_renderer& imgui_renderer, erhe::imgui:
     : Imgui_window{imgui_renderer, imgui_windows, "Properties", "properties"}
     , m_context   {editor_context}
 {
+    m_animation_batch.set_thread_pool(&erhe::concurrency::Thread_pool::get_default());
 }
 
 #if defined(ERHE_GUI_LIBRARY_IMGUI)
-void Properties::animation_properties(erhe::scene::Animation& animation) const
+void Properties::animation_properties(const std::shared_ptr<erhe::scene::Animation>& animation_in)
 {
+    erhe::scene::Animation& animation = *animation_in.get();
+
     static float time       = 0.0f;
     static float start_time = 0.0f;
     static float end_time   = 5.0f;
@@ -98,7 +102,15 @@ void Properties::animation_properties(erhe::scene::Animation& animation) const
         return;
     }
 
-    animation.apply(time);
+    // Batch tracks are rebuilt when another animation is selected
+    if (m_batch_animation != animation_in) {
+        m_animation_batch.clear();
+        m_animation_batch.add(animation_in);
+        m_batch_animation = animation_in;
+    }
+    m_animation_batch.set_time(0, time);
+    m_animation_batch.evaluate();
+    m_animation_batch.commit();
     m_context.editor_message_bus->send_message(
         Editor_message{
             .update_flags = Message_flag_bit::c_flag_bit_animation_update
@@ -114,7 +126,7 @@ void Properties::animation_properties(erhe::scene::Animation& animation) const
     if (scene == nullptr) {
         return;
     }
-    scene->update_node_transforms();
+    scene->update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 }
 
 void Properties::camera_properties(erhe::scene::Camera& camera) const
@@ -810,7 +822,7 @@ void Properties::imgui()
 
     const auto selected_animation = m_context.selection->get<erhe::scene::Animation>();
     if (selected_animation) {
-        animation_properties(*selected_animation.get());
+        animation_properties(selected_animation);
     }
 
     const auto selected_skin = m_context.selection->get<erhe::scene::Skin>();
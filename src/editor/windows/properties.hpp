@@ -2,6 +2,7 @@
 
 #include "erhe_imgui/imgui_window.hpp"
 
+#include "erhe_scene/animation_batch.hpp"
 #include "erhe_scene/transform.hpp"
 
 #include <vector>
@@ -48,7 +49,7 @@ public:
     void on_end  () override;
 
 private:
-    void animation_properties         (erhe::scene::Animation& animation) const;
+    void animation_properties         (const std::shared_ptr<erhe::scene::Animation>& animation);
     void camera_properties            (erhe::scene::Camera& camera) const;
     void light_properties             (erhe::scene::Light& light) const;
     void texture_properties           (const std::shared_ptr<erhe::graphics::Texture>& texture) const;
@@ -65,7 +66,9 @@ private:
     void item_flags                   (const std::shared_ptr<erhe::Item_base>& item);
     void item_properties              (const std::shared_ptr<erhe::Item_base>& item);
 
-    Editor_context& m_context;
+    Editor_context&                         m_context;
+    erhe::scene::Animation_batch            m_animation_batch;
+    std::shared_ptr<erhe::scene::Animation> m_batch_animation;
 };
 
 } // namespace editor
@@ -4,6 +4,7 @@
 #include "scene/scene_root.hpp"
 #include "renderers/mesh_memory.hpp"
 
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_graphics/buffer_transfer_queue.hpp"
 #include "erhe_geometry/shapes/torus.hpp"
 #include "erhe_primitive/primitive_builder.hpp"
@@ -36,7 +37,8 @@ Controller_visualization::Controller_visualization(erhe::scene::Node* view_root,
             controller_geometry,
             erhe::primitive::Build_info{
                 .primitive_types = {.fill_triangles = true },
-                .buffer_info = mesh_memory.buffer_info
+                .buffer_info = mesh_memory.buffer_info,
+                .thread_pool = &erhe::concurrency::Thread_pool::get_default()
             },
             dummy, // TODO make element mappings optional
             erhe::primitive::Normal_style::corner_normals
@@ -17,6 +17,7 @@
 
 #include "erhe_bit/bit_helpers.hpp"
 #include "erhe_commands/commands.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_rendergraph/rendergraph.hpp"
 #include "erhe_renderer/line_renderer.hpp"
@@ -416,9 +417,9 @@ void Headset_view::render_headset()
 #if 1
                 std::shared_ptr<Scene_root> scene_root = get_scene_root();
                 ERHE_VERIFY(scene_root);
-                scene_root->get_scene().update_node_transforms();
+                scene_root->get_scene().update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 #endif
-                m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms();
+                m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms(&erhe::concurrency::Thread_pool::get_default());
 
                 // TODO Consider multiple scene view being able to be (hover) active
                 //      (viewport window and headset view).
@@ -2,7 +2,11 @@
 
 #include "erhe_concurrency/thread_pool.hpp"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string_view>
+#include <type_traits>
 
 namespace erhe::concurrency {
 
@@ -24,8 +28,14 @@ namespace erhe::concurrency {
         // TODO: do your stuff here..
     });
 
+    // submit parallel for as a single task
+    q.enqueue_range(0, polygon_count, 256, [&](std::size_t first, std::size_t last)
+    {
+        // TODO: process polygons [first, last)
+    });
+
     // wait until the queue is drained
-    q.wait(); // cooperative, blocking (helps pool until all tasks are complete)
+    q.wait(); // cooperative, blocking (helps pool, parks when there is no work to help with)
 
 */
 class Concurrent_queue
@@ -47,18 +57,85 @@ public:
     template <class F, class... Args>
     void enqueue(F&& f, Args&&... args)
     {
+        if constexpr (sizeof...(Args) == 0) {
+            m_pool.enqueue(&m_queue, Task_function{std::forward<F>(f)});
+        } else {
+            m_pool.enqueue(
+                &m_queue,
+                Task_function{
+                    [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable
+                    {
+                        std::invoke(f, args...);
+                    }
+                }
+            );
+        }
+    }
+
+    // Parallel for over [begin, end). The whole range is submitted as a single
+    // task, which splits itself in halves (aligned to grain) until the size of
+    // the range is at most grain. Split off halves are spawned to the local
+    // deque of the executing worker, where idle workers can steal them.
+    //
+    // f is called either as f(std::size_t first, std::size_t last) once per
+    // chunk, or as f(std::size_t i) once for each index.
+    template <class F>
+    void enqueue_range(const std::size_t begin, const std::size_t end, const std::size_t grain, F&& f)
+    {
+        if (begin >= end) {
+            return;
+        }
+        using Body = std::decay_t<F>;
+        std::shared_ptr<Body> body = std::make_shared<Body>(std::forward<F>(f));
+        const std::size_t chunk_size = (grain > 0) ? grain : 1;
         m_pool.enqueue(
             &m_queue,
-            std::bind(
-                std::forward<F>(f),
-                std::forward<Args>(args)...
-            )
+            Task_function{
+                [queue = &m_queue, body = std::move(body), begin, end, chunk_size]() mutable
+                {
+                    execute_range<Body>(queue, std::move(body), begin, end, chunk_size);
+                }
+            }
         );
     }
 
     void steal ();
     void cancel();
     void wait  ();
+
+private:
+    template <class Body>
+    static void execute_range(
+        Thread_pool::Queue*   queue,
+        std::shared_ptr<Body> body,
+        const std::size_t     first,
+        std::size_t           last,
+        const std::size_t     chunk_size
+    )
+    {
+        while (last - first > chunk_size) {
+            const std::size_t chunk_count = (last - first + chunk_size - 1) / chunk_size;
+            const std::size_t middle      = first + (chunk_count / 2) * chunk_size;
+            queue->pool->spawn(
+                queue,
+                Task_function{
+                    [queue, body, middle, last, chunk_size]() mutable
+                    {
+                        execute_range<Body>(queue, std::move(body), middle, last, chunk_size);
+                    }
+                }
+            );
+            last = middle;
+        }
+
+        if constexpr (std::is_invocable_v<Body&, std::size_t, std::size_t>) {
+            (*body)(first, last);
+        } else {
+            for (std::size_t i = first; i < last; ++i) {
+                (*body)(i);
+            }
+        }
+    }
 };
 
 } // namespace erhe::concurrency
@@ -0,0 +1,84 @@
+#include "erhe_concurrency/task_function.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace erhe::concurrency {
+
+namespace {
+
+// Blocks are carved from one static arena, and freed blocks go to a process
+// wide lock-free free list (Treiber stack). Any thread can release a block
+// allocated by any other thread, which is the normal case: tasks are created
+// by the submitter and destroyed by the worker which executed them. Arena is
+// zero initialized static storage, so pages are only committed once used,
+// and it is never destroyed, so blocks can be released during exit.
+constexpr std::uint32_t arena_block_count = 8192;
+constexpr std::uint32_t null_block_index  = ~std::uint32_t{0};
+
+alignas(64) unsigned char s_arena[arena_block_count * Task_storage_pool::block_size];
+
+// Head packs block index (low 32 bits) and an ABA tag (high 32 bits) which
+// is incremented on every pop and push.
+alignas(64) std::atomic<std::uint64_t> s_free_head{null_block_index};
+alignas(64) std::atomic<std::uint32_t> s_arena_used_count{0};
+
+// Free list links are kept apart from the blocks. A popping thread may read
+// the link of a block which another thread has already popped and is using
+// (its CAS then fails), so links must not share memory with block contents.
+std::atomic<std::uint32_t> s_next[arena_block_count];
+
+auto get_block(const std::uint32_t index) -> unsigned char*
+{
+    return s_arena + static_cast<std::size_t>(index) * Task_storage_pool::block_size;
+}
+
+}
+
+auto Task_storage_pool::allocate() -> void*
+{
+    std::uint64_t head = s_free_head.load(std::memory_order_acquire);
+    for (;;) {
+        const std::uint32_t index = static_cast<std::uint32_t>(head);
+        if (index == null_block_index) {
+            break;
+        }
+        const std::uint64_t tag  = (head >> 32) + 1;
+        const std::uint32_t next = s_next[index].load(std::memory_order_relaxed);
+        if (s_free_head.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acquire, std::memory_order_acquire)) {
+            return get_block(index);
+        }
+    }
+
+    // Free list is empty, take a fresh block from the arena
+    if (s_arena_used_count.load(std::memory_order_relaxed) < arena_block_count) {
+        const std::uint32_t index = s_arena_used_count.fetch_add(1, std::memory_order_relaxed);
+        if (index < arena_block_count) {
+            return get_block(index);
+        }
+    }
+
+    // Arena exhausted
+    return ::operator new(block_size);
+}
+
+void Task_storage_pool::release(void* const block)
+{
+    unsigned char* const bytes = static_cast<unsigned char*>(block);
+    if ((bytes < s_arena) || (bytes >= s_arena + sizeof(s_arena))) {
+        ::operator delete(block);
+        return;
+    }
+
+    const std::uint32_t index = static_cast<std::uint32_t>((bytes - s_arena) / block_size);
+    std::uint64_t       head  = s_free_head.load(std::memory_order_relaxed);
+    for (;;) {
+        s_next[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+        const std::uint64_t tag = (head >> 32) + 1;
+        if (s_free_head.compare_exchange_weak(head, (tag << 32) | index, std::memory_order_release, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+} // namespace erhe::concurrency
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace erhe::concurrency {
+
+// Fixed size blocks for callables which do not fit inline in Task_function.
+// Blocks come from a static arena with a shared lock-free free list, so
+// steady state task submission does not touch the global heap, regardless
+// of which thread allocates and which thread releases a block.
+class Task_storage_pool
+{
+public:
+    static constexpr std::size_t block_size = 256;
+
+    [[nodiscard]] static auto allocate() -> void*;
+    static void release(void* block);
+};
+
+/*
+    Task_function is a move-only replacement for std::function<void()> used
+    for tasks in Thread_pool. Callables up to inline_capacity bytes are stored
+    inline, larger ones up to Task_storage_pool::block_size bytes are stored in
+    pooled blocks, and only callables larger than that use the global heap.
+*/
+class Task_function
+{
+public:
+    static constexpr std::size_t inline_capacity = 48;
+
+    Task_function() noexcept = default;
+
+    template <
+        typename F,
+        typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, Task_function> &&
+            std::is_invocable_v<std::decay_t<F>&>
+        >
+    >
+    Task_function(F&& f) // NOLINT(google-explicit-constructor) implicit like std::function
+    {
+        using Callable = std::decay_t<F>;
+        if constexpr (fits_inline<Callable>()) {
+            new (static_cast<void*>(m_storage)) Callable(std::forward<F>(f));
+            m_ops = &s_inline_ops<Callable>;
+        } else {
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "over-aligned tasks are not supported");
+            void* block = (sizeof(Callable) <= Task_storage_pool::block_size)
+                ? Task_storage_pool::allocate()
+                : ::operator new(sizeof(Callable));
+            new (block) Callable(std::forward<F>(f));
+            *reinterpret_cast<void**>(m_storage) = block;
+            m_ops = &s_external_ops<Callable>;
+        }
+    }
+
+    Task_function(Task_function&& other) noexcept
+    {
+        move_from(other);
+    }
+
+    auto operator=(Task_function&& other) noexcept -> Task_function&
+    {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    Task_function(const Task_function&) = delete;
+    auto operator=(const Task_function&) -> Task_function& = delete;
+
+    ~Task_function() noexcept
+    {
+        reset();
+    }
+
+    void operator()()
+    {
+        m_ops->invoke(m_storage);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+    void reset() noexcept
+    {
+        if (m_ops != nullptr) {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke )(void* storage);
+        void (*move   )(void* destination, void* source) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Callable>
+    static constexpr auto fits_inline() -> bool
+    {
+        return
+            (sizeof(Callable) <= inline_capacity) &&
+            (alignof(Callable) <= alignof(std::max_align_t)) &&
+            std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+    template <typename Callable>
+    static constexpr Ops s_inline_ops{
+        [](void* storage) {
+            (*std::launder(static_cast<Callable*>(storage)))();
+        },
+        [](void* destination, void* source) noexcept {
+            Callable* callable = std::launder(static_cast<Callable*>(source));
+            new (destination) Callable(std::move(*callable));
+            callable->~Callable();
+        },
+        [](void* storage) noexcept {
+            std::launder(static_cast<Callable*>(storage))->~Callable();
+        }
+    };
+
+    template <typename Callable>
+    static constexpr Ops s_external_ops{
+        [](void* storage) {
+            (*static_cast<Callable*>(*static_cast<void**>(storage)))();
+        },
+        [](void* destination, void* source) noexcept {
+            *static_cast<void**>(destination) = *static_cast<void**>(source);
+        },
+        [](void* storage) noexcept {
+            void* block = *static_cast<void**>(storage);
+            static_cast<Callable*>(block)->~Callable();
+            if constexpr (sizeof(Callable) <= Task_storage_pool::block_size) {
+                Task_storage_pool::release(block);
+            } else {
+                ::operator delete(block);
+            }
+        }
+    };
+
+    void move_from(Task_function& other) noexcept
+    {
+        if (other.m_ops != nullptr) {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[inline_capacity];
+    const Ops*                              m_ops{nullptr};
+};
+
+} // namespace erhe::concurrency
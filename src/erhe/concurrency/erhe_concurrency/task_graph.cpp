@@ -0,0 +1,107 @@
+#include "erhe_concurrency/task_graph.hpp"
+
+namespace erhe::concurrency {
+
+Task_graph_node::Task_graph_node(Task_graph* const graph, Task_function&& func)
+    : m_graph{graph}
+    , m_func {std::move(func)}
+{
+}
+
+Task_graph::Task_graph(Thread_pool& thread_pool, const std::string_view name)
+    : m_pool {thread_pool}
+    , m_queue{&m_pool, static_cast<int>(Priority::NORMAL), name}
+{
+}
+
+Task_graph::~Task_graph() noexcept
+{
+    wait();
+}
+
+auto Task_graph::add(Task_function&& func) -> Task_graph_node&
+{
+    Task_graph_node& node = m_nodes.emplace_back(this, std::move(func));
+    node.invoke = &Task_graph::invoke;
+    node.queue  = &m_queue;
+    return node;
+}
+
+void Task_graph::precede(Task_graph_node& before, Task_graph_node& after)
+{
+    before.m_successors.push_back(&after);
+    ++after.m_predecessor_count;
+}
+
+auto Task_graph::size() const -> std::size_t
+{
+    return m_nodes.size();
+}
+
+void Task_graph::run()
+{
+    // All pending counts must be reset before any task is started
+    for (Task_graph_node& node : m_nodes) {
+        node.m_pending_count.store(node.m_predecessor_count, std::memory_order_relaxed);
+    }
+    for (Task_graph_node& node : m_nodes) {
+        if (node.m_predecessor_count == 0) {
+            spawn(&node);
+        }
+    }
+}
+
+void Task_graph::invoke(Thread_pool::Local_task* const task)
+{
+    Task_graph_node* const node = static_cast<Task_graph_node*>(task);
+    node->m_graph->execute(node);
+}
+
+void Task_graph::spawn(Task_graph_node* node)
+{
+    m_pool.spawn(node);
+}
+
+void Task_graph::execute(Task_graph_node* node)
+{
+    // Continuation loop: the last successor made ready by this node is
+    // executed directly, others are spawned to the local deque where idle
+    // workers can steal them.
+    while (node != nullptr) {
+        node->m_func();
+
+        Task_graph_node* continuation = nullptr;
+        for (Task_graph_node* successor : node->m_successors) {
+            if (successor->m_pending_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                continue;
+            }
+            if (continuation != nullptr) {
+                spawn(continuation);
+            }
+            continuation = successor;
+        }
+
+        if ((continuation != nullptr) && m_queue.cancelled.load()) {
+            break;
+        }
+        node = continuation;
+    }
+}
+
+void Task_graph::cancel()
+{
+    m_pool.cancel(&m_queue);
+}
+
+void Task_graph::wait()
+{
+    m_pool.wait(&m_queue);
+}
+
+void Task_graph::clear()
+{
+    wait();
+    m_nodes.clear();
+}
+
+} // namespace erhe::concurrency
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <atomic>
+#include <deque>
+#include <string_view>
+#include <vector>
+
+namespace erhe::concurrency {
+
+class Task_graph;
+
+// Node is the Local_task spawned to the pool, so releasing successors
+// does not allocate.
+class Task_graph_node : public Thread_pool::Local_task
+{
+public:
+    Task_graph_node(Task_graph* graph, Task_function&& func);
+
+    Task_graph_node(const Task_graph_node&) = delete;
+    auto operator=(const Task_graph_node&) -> Task_graph_node& = delete;
+
+private:
+    friend class Task_graph;
+
+    Task_graph*                   m_graph;
+    Task_function                 m_func;
+    std::vector<Task_graph_node*> m_successors;
+    int                           m_predecessor_count{0};
+    std::atomic<int>              m_pending_count    {0};
+};
+
+/*
+    Task_graph is API to submit tasks with dependencies into the Thread_pool.
+    Tasks are added to the graph, dependencies are declared with precede(),
+    and the whole graph is executed with run(). A task becomes ready when all
+    its predecessors have completed. Ready successors are pushed to the local
+    deque of the worker which completed the predecessor, and one of them is
+    continued directly on the same worker without going through any queue.
+
+    Usage example:
+
+    Task_graph graph{thread_pool, "scene load"};
+
+    auto& load_a = graph.add([]{ ... });
+    auto& load_b = graph.add([]{ ... });
+    auto& link   = graph.add([]{ ... });
+    graph.precede(load_a, link);
+    graph.precede(load_b, link);
+
+    graph.run();
+    graph.wait(); // cooperative, blocking (helps pool, parks when idle)
+
+    Graph can be run again after wait() has returned. Nodes must not be added
+    or linked while the graph is running.
+*/
+class Task_graph
+{
+public:
+    explicit Task_graph(Thread_pool& thread_pool, std::string_view name = "task_graph");
+    ~Task_graph() noexcept;
+
+    Task_graph(const Task_graph&) = delete;
+    auto operator=(const Task_graph&) -> Task_graph& = delete;
+
+    [[nodiscard]] auto add(Task_function&& func) -> Task_graph_node&;
+
+    // Declares that before must complete before after can start
+    void precede(Task_graph_node& before, Task_graph_node& after);
+
+    void run   ();
+    void cancel();
+    void wait  ();
+    void clear ();
+
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    static void invoke(Thread_pool::Local_task* task);
+
+    void spawn  (Task_graph_node* node);
+    void execute(Task_graph_node* node);
+
+    Thread_pool&                m_pool;
+    Thread_pool::Queue          m_queue;
+    std::deque<Task_graph_node> m_nodes;
+};
+
+} // namespace erhe::concurrency
@@ -6,15 +6,28 @@
 
 namespace erhe::concurrency {
 
-using std::chrono::high_resolution_clock;
-using std::chrono::duration_cast;
-using std::chrono::microseconds;
 using std::chrono::milliseconds;
 
 // ------------------------------------------------------------
 // Thread_pool
 // ------------------------------------------------------------
 
+namespace {
+
+// Identifies the pool and worker the calling thread belongs to, if any
+thread_local const Thread_pool* t_pool         {nullptr};
+thread_local int                t_worker_index {-1};
+
+// Parked threads also wake up periodically as a safety net against a missed
+// notification. This is a backstop only; normal wake up is by notification.
+constexpr auto park_timeout = milliseconds(100);
+
+constexpr int idle_spin_count = 64;
+
+std::atomic<Thread_pool*> s_default_pool{nullptr};
+
+}
+
 struct Thread_pool::Task_queue
 {
     using Task = Thread_pool::Task;
@@ -22,6 +35,170 @@ struct Thread_pool::Task_queue
     moodycamel::ConcurrentQueue<Task> tasks;
 };
 
+// Lock-free Chase-Lev work stealing deque of Local_task pointers, with the
+// C11 memory orderings from Le, Pop, Cohen, Zappa Nardelli: "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013). Owner pushes
+// and pops at the bottom, thieves take from the top with a CAS. The buffer
+// grows when full. Replaced buffers may still be read by thieves, so they are
+// retired instead of freed, and released together with the worker.
+struct Thread_pool::Worker
+{
+    static constexpr std::int64_t initial_capacity = 256;
+
+    class Buffer
+    {
+    public:
+        explicit Buffer(const std::int64_t capacity)
+            : capacity{capacity}
+            , slots   {std::make_unique<std::atomic<Local_task*>[]>(static_cast<std::size_t>(capacity))}
+        {
+        }
+
+        [[nodiscard]] auto get(const std::int64_t index) const -> Local_task*
+        {
+            return slots[static_cast<std::size_t>(index & (capacity - 1))].load(std::memory_order_relaxed);
+        }
+
+        void put(const std::int64_t index, Local_task* const task)
+        {
+            slots[static_cast<std::size_t>(index & (capacity - 1))].store(task, std::memory_order_relaxed);
+        }
+
+        const std::int64_t                          capacity;
+        std::unique_ptr<std::atomic<Local_task*>[]> slots;
+    };
+
+    Worker()
+    {
+        buffers.push_back(std::make_unique<Buffer>(initial_capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only
+    void push(Local_task* const task)
+    {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    [[nodiscard]] auto pop() -> Local_task*
+    {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* const      a = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            // Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Local_task* task = a->get(b);
+        if (t == b) {
+            // Last element, race against thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Any thread. Returns nullptr if empty or if another thread won the race.
+    [[nodiscard]] auto steal() -> Local_task*
+    {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Buffer* const     a    = buffer.load(std::memory_order_acquire);
+        Local_task* const task = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+    auto grow(const Buffer* const old_buffer, const std::int64_t b, const std::int64_t t) -> Buffer*
+    {
+        auto new_buffer = std::make_unique<Buffer>(old_buffer->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            new_buffer->put(i, old_buffer->get(i));
+        }
+        Buffer* const result = new_buffer.get();
+        buffers.push_back(std::move(new_buffer));
+        buffer.store(result, std::memory_order_release);
+        return result;
+    }
+
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
+#endif
+    alignas(64) std::atomic<std::int64_t> top   {0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    alignas(64) std::atomic<Buffer*>      buffer{nullptr};
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+    std::vector<std::unique_ptr<Buffer>>  buffers; // Current and retired, owner only
+};
+
+namespace {
+
+// Runs a task body and accounts it to the queue usage counters, unless
+// the queue has been cancelled. Queue type is deduced, as it is private.
+template <typename Queue_type, typename F>
+void run_task(Queue_type* const queue, F&& f)
+{
+    if (queue->cancelled) {
+        return;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    f();
+    const auto busy_time = std::chrono::steady_clock::now() - start_time;
+
+    Task_usage* const usage = queue->usage;
+    usage->task_count.fetch_add(1, std::memory_order_relaxed);
+    usage->busy_time_ns.fetch_add(
+        static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(busy_time).count()),
+        std::memory_order_relaxed
+    );
+}
+
+// Local_task owning a Task_function, in a Task_storage_pool block
+class Function_local_task : public Thread_pool::Local_task
+{
+public:
+    explicit Function_local_task(Task_function&& func)
+        : func{std::move(func)}
+    {
+        invoke  = [](Local_task* task) { static_cast<Function_local_task*>(task)->func(); };
+        release = [](Local_task* task)
+        {
+            Function_local_task* const function_task = static_cast<Function_local_task*>(task);
+            function_task->~Function_local_task();
+            Task_storage_pool::release(function_task);
+        };
+    }
+
+    Task_function func;
+};
+static_assert(sizeof(Function_local_task) <= Task_storage_pool::block_size);
+
+}
+
 Thread_pool::Thread_pool(size_t size)
     : m_queues      {nullptr}
     , m_static_queue{this, int(Priority::NORMAL), "static"}
@@ -29,6 +206,11 @@ Thread_pool::Thread_pool(size_t size)
 {
     m_queues = new Task_queue[3];
 
+    m_workers.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
     // NOTE: let OS scheduler shuffle tasks as it sees fit
     //       this gives better performance overall UNTIL we have some practical
     //       use for the affinity (eg. dependent tasks using same cache)
@@ -63,8 +245,11 @@ Thread_pool::Thread_pool(size_t size)
 
 Thread_pool::~Thread_pool() noexcept
 {
-    m_stop = true;
-    m_condition.notify_all();
+    {
+        std::lock_guard<std::mutex> lock{m_park_mutex};
+        m_stop = true;
+    }
+    m_park_condition.notify_all();
 
     for (auto& thread : m_threads) {
         thread.join();
@@ -82,34 +267,123 @@ int Thread_pool::size() const
     return int(m_threads.size());
 }
 
-void Thread_pool::thread(size_t threadID)
+auto Thread_pool::current_worker_index() const -> int
+{
+    return (t_pool == this) ? t_worker_index : -1;
+}
+
+auto Thread_pool::get_task_usage(const std::string_view name) -> Task_usage&
+{
+    std::lock_guard<std::mutex> lock{m_usage_mutex};
+    for (Task_usage& usage : m_usages) {
+        if (usage.name == name) {
+            return usage;
+        }
+    }
+    return m_usages.emplace_back(name);
+}
+
+auto Thread_pool::get_task_usages() const -> std::vector<const Task_usage*>
+{
+    std::lock_guard<std::mutex> lock{m_usage_mutex};
+    std::vector<const Task_usage*> result;
+    result.reserve(m_usages.size());
+    for (const Task_usage& usage : m_usages) {
+        result.push_back(&usage);
+    }
+    return result;
+}
+
+void Thread_pool::set_default(Thread_pool* const thread_pool)
+{
+    s_default_pool.store(thread_pool);
+}
+
+auto Thread_pool::get_default() -> Thread_pool&
+{
+    Thread_pool* const thread_pool = s_default_pool.load();
+    if (thread_pool != nullptr) {
+        return *thread_pool;
+    }
+    static Thread_pool fallback_pool{get_default_size()};
+    return fallback_pool;
+}
+
+auto Thread_pool::get_default_size() -> std::size_t
 {
-    static_cast<void>(threadID);
+    // Calling thread helps while waiting, so leave one hardware thread for it
+    const unsigned int hardware_concurrency = std::thread::hardware_concurrency();
+    return (hardware_concurrency > 1) ? static_cast<std::size_t>(hardware_concurrency - 1) : 1;
+}
 
-    auto time0 = high_resolution_clock::now();
+void Thread_pool::thread(const size_t thread_index)
+{
+    t_pool         = this;
+    t_worker_index = static_cast<int>(thread_index);
 
+    int idle_count = 0;
     while (!m_stop.load(std::memory_order_relaxed)) {
+        // Epoch must be sampled before looking for work, so that work
+        // submitted after the scan is never missed when parking.
+        const std::uint64_t epoch = m_work_epoch.load();
         if (dequeue_and_process()) {
-            // remember the last time we processed a task
-            time0 = high_resolution_clock::now();
-        } else {
-            const auto time1   = high_resolution_clock::now();
-            const auto elapsed = time1 - time0;
-            if (elapsed >= microseconds(1200)) {
-                std::unique_lock<std::mutex> lock{m_queue_mutex};
-
-                m_condition.wait_for(lock, milliseconds(120));
-            } else { // if (elapsed >= microseconds(2))
-                std::this_thread::yield();
-            }
-            //else {
-            //    pause();
-            //}
+            idle_count = 0;
+            continue;
         }
+
+        // Short bounded spin before parking avoids a sleep / wake up round
+        // trip when tasks are submitted in quick succession.
+        if (idle_count < idle_spin_count) {
+            ++idle_count;
+            std::this_thread::yield();
+            continue;
+        }
+        park(epoch, nullptr);
+    }
+
+    t_pool         = nullptr;
+    t_worker_index = -1;
+}
+
+void Thread_pool::park(const std::uint64_t epoch, const std::atomic<int>* counter)
+{
+    std::unique_lock<std::mutex> lock{m_park_mutex};
+
+    ++m_parked_count;
+    m_park_condition.wait_for(
+        lock,
+        park_timeout,
+        [this, epoch, counter]
+        {
+            return
+                m_stop.load(std::memory_order_relaxed) ||
+                (m_work_epoch.load() != epoch) ||
+                ((counter != nullptr) && (counter->load() == 0));
+        }
+    );
+    --m_parked_count;
+}
+
+void Thread_pool::notify_work()
+{
+    m_work_epoch.fetch_add(1);
+    if (m_parked_count.load() > 0) {
+        // Taking the lock ensures a parking thread is either already waiting,
+        // or will see the new epoch when it evaluates the wait predicate.
+        { std::lock_guard<std::mutex> lock{m_park_mutex}; }
+        m_park_condition.notify_one();
+    }
+}
+
+void Thread_pool::notify_drained()
+{
+    if (m_parked_count.load() > 0) {
+        { std::lock_guard<std::mutex> lock{m_park_mutex}; }
+        m_park_condition.notify_all();
     }
 }
 
-void Thread_pool::enqueue(Queue* queue, std::function<void()>&& func)
+void Thread_pool::enqueue(Queue* queue, Task_function&& func)
 {
     Task task;
     task.queue = queue;
@@ -118,35 +392,152 @@ void Thread_pool::enqueue(Queue* queue, std::function<void()>&& func)
     ++queue->task_counter;
     m_queues[queue->priority].tasks.enqueue(std::move(task));
 
-    m_condition.notify_one();
+    notify_work();
 }
 
-bool Thread_pool::dequeue_and_process()
+void Thread_pool::spawn(Local_task* const task)
+{
+    const int worker_index = current_worker_index();
+    if (worker_index < 0) {
+        // Not a worker of this pool, there is no local deque to push to
+        enqueue(
+            task->queue,
+            [task]()
+            {
+                task->invoke(task);
+                if (task->release != nullptr) {
+                    task->release(task);
+                }
+            }
+        );
+        return;
+    }
+
+    ++task->queue->task_counter;
+    m_workers[static_cast<size_t>(worker_index)]->push(task);
+
+    notify_work();
+}
+
+void Thread_pool::spawn(Queue* queue, Task_function&& func)
+{
+    if (current_worker_index() < 0) {
+        enqueue(queue, std::move(func));
+        return;
+    }
+
+    Function_local_task* const task = new (Task_storage_pool::allocate()) Function_local_task{std::move(func)};
+    task->queue = queue;
+    spawn(task);
+}
+
+auto Thread_pool::try_pop_local() -> Local_task*
+{
+    const int worker_index = current_worker_index();
+    if (worker_index < 0) {
+        return nullptr;
+    }
+
+    return m_workers[static_cast<size_t>(worker_index)]->pop();
+}
+
+auto Thread_pool::try_pop_global(Task& task) -> bool
 {
     // scan task queues in priority order
     for (size_t priority = 0; priority < 3; ++priority) {
-        Task task;
         if (m_queues[priority].tasks.try_dequeue(task)) {
-            Queue* const queue = task.queue;
+            return true;
+        }
+    }
+    return false;
+}
 
-            // check if the task is cancelled
-            if (!queue->cancelled) {
-                // process task
-                task.func();
-            }
+auto Thread_pool::try_steal() -> Local_task*
+{
+    const size_t worker_count = m_workers.size();
+    if (worker_count == 0) {
+        return nullptr;
+    }
 
-            --queue->task_counter;
-            return true;
+    // Start from the next worker, so that thieves spread out over victims
+    const int    worker_index = current_worker_index();
+    const size_t start        = (worker_index < 0) ? 0 : static_cast<size_t>(worker_index) + 1;
+    for (size_t i = 0; i < worker_count; ++i) {
+        const size_t victim_index = (start + i) % worker_count;
+        if (static_cast<int>(victim_index) == worker_index) {
+            continue;
+        }
+        Local_task* const task = m_workers[victim_index]->steal();
+        if (task != nullptr) {
+            return task;
         }
     }
+    return nullptr;
+}
+
+void Thread_pool::execute(Task& task)
+{
+    Queue* const queue = task.queue;
+    run_task(queue, task.func);
+
+    // Queue may be destroyed by a waiter as soon as counter reaches zero
+    if (queue->task_counter.fetch_sub(1) == 1) {
+        notify_drained();
+    }
+}
+
+void Thread_pool::execute(Local_task* const task)
+{
+    Queue* const queue = task->queue;
+    run_task(
+        queue,
+        [task]()
+        {
+            task->invoke(task);
+        }
+    );
+    if (task->release != nullptr) {
+        task->release(task);
+    }
+
+    if (queue->task_counter.fetch_sub(1) == 1) {
+        notify_drained();
+    }
+}
+
+bool Thread_pool::dequeue_and_process()
+{
+    Local_task* local_task = try_pop_local();
+    if (local_task != nullptr) {
+        execute(local_task);
+        return true;
+    }
+
+    Task task;
+    if (try_pop_global(task)) {
+        execute(task);
+        return true;
+    }
+
+    local_task = try_steal();
+    if (local_task != nullptr) {
+        execute(local_task);
+        return true;
+    }
 
     return false;
 }
 
 void Thread_pool::wait(Queue* queue)
 {
-    while (queue->task_counter > 0) {
-        dequeue_and_process();
+    // Cooperative: help executing tasks while there is work available,
+    // and park instead of spinning when there is nothing to do.
+    while (queue->task_counter.load() > 0) {
+        const std::uint64_t epoch = m_work_epoch.load();
+        if (dequeue_and_process()) {
+            continue;
+        }
+        park(epoch, &queue->task_counter);
     }
 }
 
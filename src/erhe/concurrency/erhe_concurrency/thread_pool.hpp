@@ -1,8 +1,12 @@
 #pragma once
 
+#include "erhe_concurrency/task_function.hpp"
+
 #include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -11,6 +15,40 @@
 
 namespace erhe::concurrency {
 
+// Utilisation counters for tasks of one subsystem. Queues with the same name
+// share counters, so short lived queues accumulate into the same entry.
+// Busy time of a task includes time spent helping other tasks while waiting.
+class Task_usage
+{
+public:
+    explicit Task_usage(const std::string_view usage_name) : name{usage_name} {}
+
+    std::string name;
+
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
+#endif
+    alignas(64) std::atomic<std::uint64_t> task_count  {0};
+    std::atomic<std::uint64_t>             busy_time_ns{0};
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+};
+
+/*
+    Thread_pool executes tasks submitted through Concurrent_queue and Task_graph.
+
+    Tasks submitted from outside of the pool go to global queues, one for each
+    priority. Tasks spawned from a worker thread (for example successors released
+    by a Task_graph task) go to the worker local lock-free Chase-Lev deque. Worker
+    pops from the bottom of its own deque (LIFO, cache warm), and idle workers
+    steal from the top of other workers deques (FIFO, oldest and largest work
+    first).
+
+    Idle workers and waiters park on a condition variable. They are woken up
+    when new work is submitted, or when a queue they are waiting for drains.
+*/
 class Thread_pool
 {
 private:
@@ -18,12 +56,14 @@ private:
     auto operator=(const Thread_pool&) -> Thread_pool = delete;
 
     friend class Concurrent_queue;
+    friend class Task_graph;
 
     struct Queue
     {
         Thread_pool* pool;
         int          priority;
         std::string  name;
+        Task_usage*  usage;
 
 #if defined(_MSC_VER)
 #   pragma warning(push)
@@ -39,51 +79,98 @@ private:
             : pool    {pool}
             , priority{priority}
             , name    {name}
+            , usage   {&pool->get_task_usage(name)}
         {
         }
     };
 
     struct Task
     {
-        Queue*                queue;
-        std::function<void()> func;
+        Queue*        queue;
+        Task_function func;
     };
 
 public:
+    // Task for worker local deques. Object must stay alive until it has been
+    // executed, after which release is called if set (also when cancelled).
+    // Task_graph nodes are Local_tasks, so spawning ready successors does not
+    // allocate.
+    class Local_task
+    {
+    public:
+        void   (*invoke )(Local_task* task){nullptr};
+        void   (*release)(Local_task* task){nullptr};
+        Queue* queue                       {nullptr};
+    };
+
     explicit Thread_pool(std::size_t size);
     ~Thread_pool() noexcept;
 
     int size() const;
 
-    void enqueue(std::function<void()>&& func)
+    void enqueue(Task_function&& func)
     {
         enqueue(&m_static_queue, std::move(func));
     }
 
+    // Returns index of the calling worker thread in this pool, or -1
+    // if the calling thread is not a worker of this pool.
+    [[nodiscard]] auto current_worker_index() const -> int;
+
+    // Returns counters for queues with the given name, creating them if needed
+    [[nodiscard]] auto get_task_usage (std::string_view name) -> Task_usage&;
+    [[nodiscard]] auto get_task_usages() const -> std::vector<const Task_usage*>;
+
+    // Process wide pool for subsystems which are not given a pool explicitly,
+    // such as physics jobs and BVH builds. Application can install its own
+    // pool with set_default(), which must outlive its use. Otherwise a pool
+    // of get_default_size() workers is created on first use.
+    static void set_default(Thread_pool* thread_pool);
+    [[nodiscard]] static auto get_default     () -> Thread_pool&;
+    [[nodiscard]] static auto get_default_size() -> std::size_t;
+
 protected:
-    void thread             (size_t threadID);
-    void enqueue            (Queue* queue, std::function<void()>&& func);
+    void thread             (size_t thread_index);
+    void enqueue            (Queue* queue, Task_function&& func);
+    void spawn              (Local_task* task);
+    void spawn              (Queue* queue, Task_function&& func);
     bool dequeue_and_process();
     void cancel             (Queue* queue);
     void wait               (Queue* queue);
 
 private:
     struct Task_queue;
+    struct Worker;
+
+    [[nodiscard]] auto try_pop_local  () -> Local_task*;
+    [[nodiscard]] auto try_pop_global (Task& task) -> bool;
+    [[nodiscard]] auto try_steal      () -> Local_task*;
+    void execute                      (Task& task);
+    void execute                      (Local_task* task);
+    void park                         (std::uint64_t epoch, const std::atomic<int>* counter);
+    void notify_work                  ();
+    void notify_drained               ();
+
     alignas(64) Task_queue* m_queues;
 
 #if defined(_MSC_VER)
 #   pragma warning(push)
 #   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
 #endif
-    alignas(64) std::atomic<bool> m_stop { false };
+    alignas(64) std::atomic<bool>          m_stop         { false };
+    alignas(64) std::atomic<std::uint64_t> m_work_epoch   { 0 };
+    alignas(64) std::atomic<int>           m_parked_count { 0 };
 #if defined(_MSC_VER)
 #   pragma warning(pop)
 #endif
 
-    std::mutex               m_queue_mutex;
-    std::condition_variable  m_condition;
-    Queue                    m_static_queue;
-    std::vector<std::thread> m_threads;
+    std::mutex                           m_park_mutex;
+    std::condition_variable              m_park_condition;
+    mutable std::mutex                   m_usage_mutex;
+    std::deque<Task_usage>               m_usages;
+    Queue                                m_static_queue;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread>             m_threads;
 };
 
 enum class Priority
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace erhe::concurrency {
+
+// Lock-free single producer, single consumer buffer for passing the latest
+// version of a value between two threads.
+//
+// The producer fills its back buffer and publishes it, the consumer takes
+// the most recently published buffer. This is a double buffer with one
+// spare slot, so that the producer never writes to the buffer which the
+// consumer is reading, and neither side waits for the other. Versions
+// published between two reads are skipped.
+template <typename T>
+class Triple_buffer
+{
+public:
+    // Producer thread only
+    [[nodiscard]] auto get_write_buffer() -> T&
+    {
+        return m_buffers[m_write_index];
+    }
+
+    void publish()
+    {
+        const uint32_t previous = m_shared_index.exchange(m_write_index | c_fresh_bit, std::memory_order_acq_rel);
+        m_write_index = previous & c_index_mask;
+    }
+
+    // Consumer thread only. Returns the most recently published buffer, or
+    // nullptr if nothing has been published yet. The buffer remains valid
+    // until the next call.
+    [[nodiscard]] auto get_read_buffer() -> const T*
+    {
+        if ((m_shared_index.load(std::memory_order_relaxed) & c_fresh_bit) != 0) {
+            const uint32_t previous = m_shared_index.exchange(m_read_index, std::memory_order_acq_rel);
+            m_read_index = previous & c_index_mask;
+            m_has_read   = true;
+        }
+        return m_has_read ? &m_buffers[m_read_index] : nullptr;
+    }
+
+private:
+    static constexpr uint32_t c_index_mask = 0x3u;
+    static constexpr uint32_t c_fresh_bit  = 0x4u;
+
+    std::array<T, 3>                  m_buffers;
+    alignas(64) std::atomic<uint32_t> m_shared_index{1};
+    alignas(64) uint32_t              m_write_index {0}; // producer
+    alignas(64) uint32_t              m_read_index  {2}; // consumer
+    bool                              m_has_read    {false};
+};
+
+} // namespace erhe::concurrency
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace erhe::geometry {
+
+// Dense bitset stored in 64-bit words. Used for Property_map presence.
+// Bits past size() in the last word are always zero, so counting and
+// iteration can work on whole words.
+class Dense_bitset
+{
+public:
+    using Word = uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    [[nodiscard]] static constexpr auto word_count(const std::size_t bit_count) -> std::size_t
+    {
+        return (bit_count + word_bits - 1) / word_bits;
+    }
+
+    void clear()
+    {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    void reserve(const std::size_t bit_count)
+    {
+        m_words.reserve(word_count(bit_count));
+    }
+
+    // New bits are cleared
+    void resize(const std::size_t bit_count)
+    {
+        m_words.resize(word_count(bit_count), Word{0});
+        m_size = bit_count;
+        clear_tail();
+    }
+
+    [[nodiscard]] auto size () const -> std::size_t { return m_size; }
+    [[nodiscard]] auto empty() const -> bool        { return m_size == 0; }
+
+    [[nodiscard]] auto test(const std::size_t i) const -> bool
+    {
+        return (m_words[i / word_bits] >> (i % word_bits)) & Word{1};
+    }
+
+    void set(const std::size_t i)
+    {
+        m_words[i / word_bits] |= (Word{1} << (i % word_bits));
+    }
+
+    void reset(const std::size_t i)
+    {
+        m_words[i / word_bits] &= ~(Word{1} << (i % word_bits));
+    }
+
+    void assign(const std::size_t i, const bool value)
+    {
+        if (value) {
+            set(i);
+        } else {
+            reset(i);
+        }
+    }
+
+    // Number of set bits
+    [[nodiscard]] auto count() const -> std::size_t
+    {
+        std::size_t result = 0;
+        for (const Word word : m_words) {
+            result += static_cast<std::size_t>(std::popcount(word));
+        }
+        return result;
+    }
+
+    // Appends bits of other after bits of this
+    void append(const Dense_bitset& other)
+    {
+        const std::size_t shift = m_size % word_bits;
+        if (shift == 0) {
+            m_words.insert(m_words.end(), other.m_words.begin(), other.m_words.end());
+        } else {
+            for (const Word word : other.m_words) {
+                m_words.back() |= (word << shift);
+                m_words.push_back(word >> (word_bits - shift));
+            }
+        }
+        m_size += other.m_size;
+        m_words.resize(word_count(m_size));
+        clear_tail();
+    }
+
+    // Calls op(i) for each set bit, in increasing order
+    template <typename Op>
+    void for_each_set(Op&& op) const
+    {
+        for (std::size_t word_index = 0, end = m_words.size(); word_index < end; ++word_index) {
+            Word word = m_words[word_index];
+            while (word != 0) {
+                const std::size_t bit = static_cast<std::size_t>(std::countr_zero(word));
+                op(word_index * word_bits + bit);
+                word &= word - 1;
+            }
+        }
+    }
+
+    [[nodiscard]] auto words()       -> std::span<Word>       { return m_words; }
+    [[nodiscard]] auto words() const -> std::span<const Word> { return m_words; }
+
+private:
+    void clear_tail()
+    {
+        const std::size_t tail = m_size % word_bits;
+        if (tail != 0) {
+            m_words.back() &= (Word{1} << tail) - 1;
+        }
+    }
+
+    std::vector<Word> m_words;
+    std::size_t       m_size{0};
+};
+
+} // namespace erhe::geometry
@@ -0,0 +1,128 @@
+#include "erhe_geometry/edge_index.hpp"
+#include "erhe_verify/verify.hpp"
+
+namespace erhe::geometry {
+
+namespace {
+
+constexpr std::size_t s_min_capacity = 64;
+
+}
+
+auto Edge_index::make_key(const Point_id a, const Point_id b) -> uint64_t
+{
+    return (static_cast<uint64_t>(a) << 32u) | static_cast<uint64_t>(b);
+}
+
+auto Edge_index::home_slot(const uint64_t key) const -> std::size_t
+{
+    // Fibonacci hashing - top bits of the product are well mixed
+    return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> m_shift);
+}
+
+void Edge_index::clear()
+{
+    m_slots.clear();
+    m_size  = 0;
+    m_shift = 64;
+}
+
+void Edge_index::reserve(const std::size_t edge_count)
+{
+    // Keep load factor at or below 1/2
+    std::size_t capacity = s_min_capacity;
+    while (capacity < 2 * edge_count) {
+        capacity *= 2;
+    }
+    if (capacity > m_slots.size()) {
+        rehash(capacity);
+    }
+}
+
+void Edge_index::rehash(const std::size_t capacity)
+{
+    ERHE_VERIFY((capacity & (capacity - 1)) == 0);
+
+    std::vector<Slot> old_slots = std::move(m_slots);
+    m_slots.assign(capacity, Slot{});
+    m_shift = 64;
+    for (std::size_t i = capacity; i > 1; i >>= 1) {
+        --m_shift;
+    }
+
+    const std::size_t mask = capacity - 1;
+    for (const Slot& old_slot : old_slots) {
+        if (old_slot.edge_id == null_edge) {
+            continue;
+        }
+        std::size_t i = home_slot(old_slot.key);
+        while (m_slots[i].edge_id != null_edge) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = old_slot;
+    }
+}
+
+auto Edge_index::insert(const Point_id a, const Point_id b, const Edge_id edge_id) -> Edge_id
+{
+    ERHE_VERIFY(a < b);
+    ERHE_VERIFY(edge_id != null_edge);
+
+    if (2 * (m_size + 1) > m_slots.size()) {
+        rehash(m_slots.empty() ? s_min_capacity : 2 * m_slots.size());
+    }
+
+    const uint64_t    key  = make_key(a, b);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t i = home_slot(key);
+    for (;;) {
+        Slot& slot = m_slots[i];
+        if (slot.edge_id == null_edge) {
+            slot.key     = key;
+            slot.edge_id = edge_id;
+            ++m_size;
+            return edge_id;
+        }
+        if (slot.key == key) {
+            return slot.edge_id;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+auto Edge_index::find(const Point_id a, const Point_id b) const -> Edge_id
+{
+    if (m_size == 0) {
+        return null_edge;
+    }
+
+    const uint64_t    key  = make_key(a, b);
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t i = home_slot(key);
+    for (;;) {
+        const Slot& slot = m_slots[i];
+        if (slot.edge_id == null_edge) {
+            return null_edge;
+        }
+        if (slot.key == key) {
+            return slot.edge_id;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void Edge_index::remap(const std::vector<Edge_id>& old_to_new)
+{
+    for (Slot& slot : m_slots) {
+        if (slot.edge_id != null_edge) {
+            slot.edge_id = old_to_new[slot.edge_id];
+        }
+    }
+}
+
+auto Edge_index::size() const -> std::size_t
+{
+    return m_size;
+}
+
+} // namespace erhe::geometry
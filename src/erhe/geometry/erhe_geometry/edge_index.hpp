@@ -0,0 +1,51 @@
+#pragma once
+
+#include "erhe_geometry/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace erhe::geometry {
+
+// Open addressing hash table from ordered point pair (a < b) to Edge_id.
+// Used by Geometry::find_edge() and Geometry::build_edges() instead of
+// linear scans over Geometry::edges.
+class Edge_index
+{
+public:
+    static constexpr Edge_id null_edge = std::numeric_limits<Edge_id>::max();
+
+    void clear  ();
+    void reserve(std::size_t edge_count);
+
+    // Inserts edge_id for the point pair unless the pair is already present.
+    // Returns the edge id stored for the pair.
+    auto insert(Point_id a, Point_id b, Edge_id edge_id) -> Edge_id;
+
+    // Returns null_edge if the point pair is not present
+    [[nodiscard]] auto find(Point_id a, Point_id b) const -> Edge_id;
+
+    // Replaces every stored edge id e with old_to_new[e]
+    void remap(const std::vector<Edge_id>& old_to_new);
+
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    struct Slot
+    {
+        uint64_t key    {0};
+        Edge_id  edge_id{null_edge};
+    };
+
+    [[nodiscard]] static auto make_key(Point_id a, Point_id b) -> uint64_t;
+    [[nodiscard]] auto home_slot(uint64_t key) const -> std::size_t;
+    void rehash(std::size_t capacity);
+
+    std::vector<Slot> m_slots;
+    std::size_t       m_size {0};
+    unsigned int      m_shift{64};
+};
+
+} // namespace erhe::geometry
@@ -61,6 +61,7 @@ Geometry::Geometry(Geometry&& other) noexcept
     , m_next_edge_polygon_id              {other.m_next_edge_polygon_id     }
     , m_polygon_corner_polygon            {other.m_polygon_corner_polygon   }
     , m_edge_polygon_edge                 {other.m_edge_polygon_edge        }
+    , m_edge_index                        {std::move(other.m_edge_index    )}
     , m_point_property_map_collection     {std::move(other.m_point_property_map_collection)}
     , m_corner_property_map_collection    {std::move(other.m_corner_property_map_collection)}
     , m_polygon_property_map_collection   {std::move(other.m_polygon_property_map_collection)}
@@ -242,101 +243,140 @@ auto Geometry::has_edges() const -> bool
     return false;
 }
 
-void Geometry::build_edges(bool is_manifold)
+void Geometry::build_edges()
 {
     ERHE_PROFILE_FUNCTION();
 
+    // Shared and non-shared edges are found in the same pass using the edge
+    // index, so manifold and non-manifold geometry are handled alike.
+
     if (has_edges()) {
         return;
     }
 
     edges.clear();
-    m_next_edge_id = 0;
+    m_edge_index.clear();
+    m_next_edge_id         = 0;
+    m_next_edge_polygon_id = 0;
 
     log_build_edges->trace("{} build_edges() : {} polygons", name, m_next_polygon_id);
 
-    //const erhe::log::Indenter scope_indent;
-    std::size_t polygon_index{0};
+    // Polygon edges (prev corner point -> corner point) which refer to
+    // the unique edges. Forward edges go from lower to higher point id.
+    struct Polygon_edge
+    {
+        Edge_id    edge_id;
+        Polygon_id polygon_id;
+        bool       forward;
+    };
+    struct Unique_edge
+    {
+        Point_id a;
+        Point_id b;
+        uint32_t forward_count {0};
+        uint32_t backward_count{0};
+    };
 
-    std::size_t polygon_edge_count = 0;
+    std::vector<Polygon_edge> polygon_edges;
+    std::vector<Unique_edge>  unique_edges;
+    std::vector<Edge_id>      forward_order;
+    polygon_edges.reserve(m_next_polygon_corner_id);
+    unique_edges .reserve(m_next_polygon_corner_id / 2 + 1);
+    forward_order.reserve(m_next_polygon_corner_id / 2 + 1);
+    m_edge_index .reserve(m_next_polygon_corner_id / 2 + 1);
 
     std::size_t non_manifold_edge_count = 0;
-    // First pass - shared edges
     {
-        ERHE_PROFILE_SCOPE("first pass");
-
-        for_each_polygon([&](auto& i) {
-            //const erhe::log::Indenter scope_indent;
+        ERHE_PROFILE_SCOPE("collect");
 
-            i.polygon.for_each_corner_neighborhood(*this, [&](auto& j) {
+        for_each_polygon_const([&](auto& i) {
+            i.polygon.for_each_corner_neighborhood_const(*this, [&](auto& j) {
                 const Point_id a = j.prev_corner.point_id;
                 const Point_id b = j.corner.point_id;
-                ++polygon_edge_count;
                 if (a == b) {
                     //log_build_edges->warn("Bad edge {} - {}", a, b);
                     ++non_manifold_edge_count;
                     return;
                 }
-                if (a < b) { // This does not work for non-shared edges going wrong direction
-                    const Edge_id edge_id = make_edge(a, b);
-                    const Point&  pa      = points[a];
-                    make_edge_polygon(edge_id, i.polygon_id);
-                    ERHE_VERIFY(pa.corner_count > 0);
-                    pa.for_each_corner_const(*this, [&](auto& k) {
-                         const Polygon_id polygon_id_in_point = k.corner.polygon_id;
-                         const Polygon&   polygon_in_point    = polygons[polygon_id_in_point];
-                         const Corner_id  prev_corner_id      = polygon_in_point.prev_corner(*this, k.corner_id);
-                         const Corner&    prev_corner         = corners[prev_corner_id];
-                         const Point_id   prev_point_id       = prev_corner.point_id;
-                         if (prev_point_id == b) {
-                             make_edge_polygon(edge_id, polygon_id_in_point);
-                             ++polygon_index;
-                         }
-                    });
+                const bool     forward       = a < b;
+                const Point_id low           = forward ? a : b;
+                const Point_id high          = forward ? b : a;
+                const Edge_id  new_unique_id = static_cast<Edge_id>(unique_edges.size());
+                const Edge_id  unique_id     = m_edge_index.insert(low, high, new_unique_id);
+                if (unique_id == new_unique_id) {
+                    unique_edges.push_back(Unique_edge{.a = low, .b = high});
                 }
+                Unique_edge& unique_edge = unique_edges[unique_id];
+                if (forward) {
+                    if (unique_edge.forward_count == 0) {
+                        forward_order.push_back(unique_id);
+                    }
+                    ++unique_edge.forward_count;
+                } else {
+                    ++unique_edge.backward_count;
+                }
+                polygon_edges.push_back(Polygon_edge{unique_id, i.polygon_id, forward});
             });
         });
     }
 
-    // Second pass - non-shared edges wrong direction or non-manifold wrong direction
-    if (!is_manifold || (get_edge_count() != polygon_edge_count / 2)) {
-        ERHE_PROFILE_SCOPE("second pass");
+    // Edges which have a forward polygon edge are numbered first, in the
+    // order their first forward polygon edge was seen. Edges which only
+    // go backward come after those.
+    std::vector<Edge_id> unique_to_edge(unique_edges.size(), Edge_index::null_edge);
+    {
+        ERHE_PROFILE_SCOPE("order");
 
-        for_each_polygon([&](auto& i) {
-            //const erhe::log::Indenter scope_indent;
+        Edge_id next_edge_id = 0;
+        for (const Edge_id unique_id : forward_order) {
+            unique_to_edge[unique_id] = next_edge_id++;
+        }
+        for (Edge_id unique_id = 0, end = static_cast<Edge_id>(unique_edges.size()); unique_id < end; ++unique_id) {
+            if (unique_edges[unique_id].forward_count == 0) {
+                unique_to_edge[unique_id] = next_edge_id++;
+            }
+        }
+        m_edge_index.remap(unique_to_edge);
+    }
 
-            i.polygon.for_each_corner_neighborhood(*this, [&](auto& j) {
-                const Point_id a_ = j.prev_corner.point_id;
-                const Point_id b_ = j.corner.point_id;
-                if (a_ == b_) {
-                    return;
-                }
+    // Polygons of each edge are stored contiguously, polygons with the
+    // forward polygon edge first and polygons going backward after.
+    std::vector<Edge_polygon_id> forward_cursor (unique_edges.size());
+    std::vector<Edge_polygon_id> backward_cursor(unique_edges.size());
+    {
+        ERHE_PROFILE_SCOPE("edges");
+
+        const std::size_t edge_count = unique_edges.size();
+        edges.resize(edge_count);
+        for (Edge_id unique_id = 0; unique_id < edge_count; ++unique_id) {
+            const Unique_edge& unique_edge = unique_edges[unique_id];
+            Edge& edge = edges[unique_to_edge[unique_id]];
+            edge.a             = unique_edge.a;
+            edge.b             = unique_edge.b;
+            edge.polygon_count = unique_edge.forward_count + unique_edge.backward_count;
+        }
+        for (Edge& edge : edges) {
+            edge.first_edge_polygon_id = m_next_edge_polygon_id;
+            m_next_edge_polygon_id += edge.polygon_count;
+        }
+        for (Edge_id unique_id = 0; unique_id < edge_count; ++unique_id) {
+            const Edge& edge = edges[unique_to_edge[unique_id]];
+            forward_cursor [unique_id] = edge.first_edge_polygon_id;
+            backward_cursor[unique_id] = edge.first_edge_polygon_id + unique_edges[unique_id].forward_count;
+        }
+        m_next_edge_id = static_cast<Edge_id>(edge_count);
+    }
 
-                auto edge = find_edge(a_, b_);
-                if (!edge) {
-                    // ERHE_VERIFY(b < a); This does not hold for non-manifold objects
-                    {
-                        const Point_id a = std::max(a_, b_);
-                        const Point_id b = std::min(a_, b_);
-                        const Edge_id edge_id = make_edge(b, a); // Swapped a, b because b < a
-                        const Point&  pb      = points[b];
-                        make_edge_polygon(edge_id, i.polygon_id);
-                        ERHE_VERIFY(pb.corner_count > 0);
-                        pb.for_each_corner_const(*this, [&](auto& k) {
-                             const Polygon_id polygon_id_in_point = k.corner.polygon_id;
-                             const Polygon&   polygon_in_point    = polygons[polygon_id_in_point];
-                             const Corner_id  prev_corner_id      = polygon_in_point.prev_corner(*this, k.corner_id);
-                             const Corner&    prev_corner         = corners[prev_corner_id];
-                             const Point_id   prev_point_id       = prev_corner.point_id;
-                             if (prev_point_id == a) {
-                                 make_edge_polygon(edge_id, polygon_id_in_point);
-                                 ++polygon_index;
-                             }
-                        });
-                    }
-                }
-            });
-        });
+    {
+        ERHE_PROFILE_SCOPE("edge polygons");
+
+        edge_polygons.resize(m_next_edge_polygon_id);
+        for (const Polygon_edge& polygon_edge : polygon_edges) {
+            Edge_polygon_id& cursor = polygon_edge.forward
+                ? forward_cursor [polygon_edge.edge_id]
+                : backward_cursor[polygon_edge.edge_id];
+            edge_polygons[cursor++] = polygon_edge.polygon_id;
+        }
     }
 
     if (non_manifold_edge_count > 0) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "erhe_geometry/edge_index.hpp"
 #include "erhe_geometry/property_map.hpp"
 #include "erhe_geometry/property_map_collection.hpp"
 #include "erhe_geometry/types.hpp"
@@ -474,17 +475,25 @@ public:
     auto get_polygon_corner_count() const -> uint32_t { return m_next_polygon_corner_id; }
     auto get_edge_count          () const -> uint32_t { return m_next_edge_id; }
 
-    [[nodiscard]] auto find_edge(Point_id a, Point_id b) -> std::optional<Edge>
+    [[nodiscard]] auto find_edge_id(Point_id a, Point_id b) const -> std::optional<Edge_id>
     {
         if (b < a) {
             std::swap(a, b);
         }
-        for (const auto& edge : edges) {
-            if (edge.a == a && edge.b == b) {
-                return edge;
-            }
+        const Edge_id edge_id = m_edge_index.find(a, b);
+        if (edge_id == Edge_index::null_edge) {
+            return {};
         }
-        return {};
+        return edge_id;
+    }
+
+    [[nodiscard]] auto find_edge(const Point_id a, const Point_id b) const -> std::optional<Edge>
+    {
+        const auto edge_id = find_edge_id(a, b);
+        if (!edge_id.has_value()) {
+            return {};
+        }
+        return edges[edge_id.value()];
     }
 
     // Allocates new Corner / Corner_id
@@ -656,7 +665,7 @@ public:
 
     void make_point_corners();
 
-    void build_edges(bool is_manifold = true);
+    void build_edges();
 
     [[nodiscard]] auto has_edges() const -> bool;
 
@@ -802,6 +811,7 @@ public:
     Edge_polygon_id                 m_next_edge_polygon_id     {0};
     Polygon_id                      m_polygon_corner_polygon   {0};
     Edge_id                         m_edge_polygon_edge        {0};
+    Edge_index                      m_edge_index;
     Point_property_map_collection   m_point_property_map_collection;
     Corner_property_map_collection  m_corner_property_map_collection;
     Polygon_property_map_collection m_polygon_property_map_collection;
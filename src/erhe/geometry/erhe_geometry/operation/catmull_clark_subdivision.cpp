@@ -20,8 +20,8 @@ namespace erhe::geometry::operation {
 //
 // For each corner in the old polygon, add one quad
 // (centroid, previous edge 'edge midpoint', corner, next edge 'edge midpoint')
-Catmull_clark_subdivision::Catmull_clark_subdivision(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Catmull_clark_subdivision::Catmull_clark_subdivision(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -31,16 +31,24 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(Geometry& src, Geometry& de
     {
         ERHE_PROFILE_SCOPE("initial points");
 
-        source.for_each_point_const([&](auto& i) {
-            const auto n = static_cast<float>(i.point.corner_count);
-            if (i.point.corner_count >= 3) {
-                // n = 0   -> centroid points, safe to skip
-                // n = 1,2 -> ?
-                // n = 3   -> ?
-                const float weight = (n - 3.0f) / n;
-                make_new_point_from_point(weight, i.point_id);
-            } else {
-                make_new_point_from_point(1.0f, i.point_id);
+        const uint32_t point_count     = source.get_point_count();
+        const Point_id first_new_point = make_new_points(point_count);
+        point_old_to_new.resize(point_count);
+        parallel_for(point_count, [&](const std::size_t first, const std::size_t last) {
+            for (Point_id point_id = static_cast<Point_id>(first); point_id < last; ++point_id) {
+                const Point&   point     = source.points[point_id];
+                const Point_id new_point = first_new_point + point_id;
+                const auto     n         = static_cast<float>(point.corner_count);
+                point_old_to_new[point_id] = new_point;
+                if (point.corner_count >= 3) {
+                    // n = 0   -> centroid points, safe to skip
+                    // n = 1,2 -> ?
+                    // n = 3   -> ?
+                    const float weight = (n - 3.0f) / n;
+                    add_point_source(new_point, weight, point_id);
+                } else {
+                    add_point_source(new_point, 1.0f, point_id);
+                }
             }
         });
     }
@@ -86,11 +94,14 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(Geometry& src, Geometry& de
     {
         ERHE_PROFILE_SCOPE("face points");
 
+        // Centroid points only depend on their own polygon
+        make_polygon_centroids();
+
+        // Sources are appended to shared points in polygon order, so this
+        // pass stays serial to keep the result deterministic.
         source.for_each_polygon_const([&](auto& i) {
             const Polygon& src_polygon = source.polygons[i.polygon_id];
 
-            make_new_point_from_polygon_centroid(i.polygon_id);
-
             // Add polygon centroids (F) to all corners' point sources
             // F = average F of all n face points for faces touching P
             //  F    <- because F is average of all centroids, it adds extra /n
@@ -140,4 +151,14 @@ auto catmull_clark_subdivision(Geometry& source) -> Geometry
     };
 }
 
+auto catmull_clark_subdivision(Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> Geometry
+{
+    return Geometry{
+        fmt::format("catmull_clark({})", source.name),
+        [&source, &thread_pool](auto& result) {
+            Catmull_clark_subdivision operation{source, result, &thread_pool};
+        }
+    };
+}
+
 } // namespace erhe::geometry::operation
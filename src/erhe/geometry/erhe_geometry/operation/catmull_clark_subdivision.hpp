@@ -7,9 +7,10 @@ namespace erhe::geometry::operation {
 class Catmull_clark_subdivision : public Geometry_operation
 {
 public:
-    Catmull_clark_subdivision(Geometry& src, Geometry& destination);
+    Catmull_clark_subdivision(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool = nullptr);
 };
 
 [[nodiscard]] auto catmull_clark_subdivision(erhe::geometry::Geometry& source) -> erhe::geometry::Geometry;
+[[nodiscard]] auto catmull_clark_subdivision(erhe::geometry::Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -7,8 +7,13 @@
 
 namespace erhe::geometry::operation {
 
-Dual::Dual(Geometry& source, Geometry& destination, bool post_process)
-    : Geometry_operation{source, destination}
+Dual::Dual(
+    Geometry&                       source,
+    Geometry&                       destination,
+    const bool                      post_process,
+    erhe::concurrency::Thread_pool* thread_pool
+)
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -38,5 +43,15 @@ auto dual(Geometry& source) -> Geometry
     };
 }
 
+auto dual(Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> Geometry
+{
+    return Geometry{
+        fmt::format("dual({})", source.name),
+        [&source, &thread_pool](auto& result) {
+            Dual operation{source, result, true, &thread_pool};
+        }
+    };
+}
+
 
 } // namespace erhe::geometry::operation
@@ -8,9 +8,15 @@ namespace erhe::geometry::operation {
 class Dual : public Geometry_operation
 {
 public:
-    Dual(Geometry& source, Geometry& destination, bool post_process = true);
+    Dual(
+        Geometry&                       source,
+        Geometry&                       destination,
+        bool                            post_process = true,
+        erhe::concurrency::Thread_pool* thread_pool  = nullptr
+    );
 };
 
 [[nodiscard]] auto dual(erhe::geometry::Geometry& source) -> erhe::geometry::Geometry;
+[[nodiscard]] auto dual(erhe::geometry::Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -1,9 +1,12 @@
 #include "erhe_geometry/operation/geometry_operation.hpp"
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
+#include <algorithm>
+
 namespace erhe::geometry::operation {
 
 void Geometry_operation::post_processing()
@@ -19,13 +22,56 @@ void Geometry_operation::post_processing()
     destination.compute_tangents();
 }
 
+void Geometry_operation::parallel_for(
+    const std::size_t                                                count,
+    const std::function<void(std::size_t first, std::size_t last)>& body
+)
+{
+    if (count == 0) {
+        return;
+    }
+    if ((m_thread_pool == nullptr) || (count <= s_parallel_grain)) {
+        body(0, count);
+        return;
+    }
+
+    erhe::concurrency::Concurrent_queue queue{*m_thread_pool, "geometry_operation"};
+    queue.enqueue_range(0, count, s_parallel_grain, body);
+    queue.wait();
+}
+
+auto Geometry_operation::make_new_points(const std::size_t count) -> Point_id
+{
+    const Point_id first_new_point = destination.get_point_count();
+    destination.reserve_points(static_cast<std::size_t>(first_new_point) + count);
+    for (std::size_t i = 0; i < count; ++i) {
+        destination.make_point();
+    }
+    const std::size_t end = static_cast<std::size_t>(first_new_point) + count;
+    if (new_point_sources.size() < end) {
+        new_point_sources.resize(end);
+    }
+    if (new_point_corner_sources.size() < end) {
+        new_point_corner_sources.resize(end);
+    }
+    return first_new_point;
+}
+
 void Geometry_operation::make_points_from_points()
 {
     ERHE_PROFILE_FUNCTION();
 
-    point_old_to_new.reserve(source.get_point_count());
-    source.for_each_point_const([&](auto& i) {
-        make_new_point_from_point(i.point_id);
+    const uint32_t point_count     = source.get_point_count();
+    const Point_id first_new_point = make_new_points(point_count);
+    if (point_old_to_new.size() < point_count) {
+        point_old_to_new.resize(point_count);
+    }
+    parallel_for(point_count, [&](const std::size_t first, const std::size_t last) {
+        for (Point_id old_point = static_cast<Point_id>(first); old_point < last; ++old_point) {
+            const Point_id new_point = first_new_point + old_point;
+            point_old_to_new[old_point] = new_point;
+            add_point_source(new_point, 1.0f, old_point);
+        }
     });
 }
 
@@ -33,45 +79,58 @@ void Geometry_operation::make_polygon_centroids()
 {
     ERHE_PROFILE_FUNCTION();
 
-    old_polygon_centroid_to_new_points.reserve(source.get_polygon_count());
-    source.for_each_polygon_const([&](auto& i) {
-        make_new_point_from_polygon_centroid(i.polygon_id);
+    const uint32_t polygon_count   = source.get_polygon_count();
+    const Point_id first_new_point = make_new_points(polygon_count);
+    if (old_polygon_centroid_to_new_points.size() < polygon_count) {
+        old_polygon_centroid_to_new_points.resize(polygon_count);
+    }
+    parallel_for(polygon_count, [&](const std::size_t first, const std::size_t last) {
+        for (Polygon_id old_polygon = static_cast<Polygon_id>(first); old_polygon < last; ++old_polygon) {
+            const Point_id new_point = first_new_point + old_polygon;
+            old_polygon_centroid_to_new_points[old_polygon] = new_point;
+            add_polygon_centroid(new_point, 1.0f, old_polygon);
+        }
     });
 }
 
 void Geometry_operation::reserve_edge_to_new_points()
 {
-    const uint32_t point_count = source.get_point_count();
-    m_old_edge_to_new_points.resize(static_cast<std::size_t>(point_count) * s_max_edge_point_slots);
-    std::fill(
-        begin(m_old_edge_to_new_points),
-        end(m_old_edge_to_new_points),
-        std::numeric_limits<uint32_t>::max()
-    );
+    // Operation keeps its own point pair index, so source edges are not
+    // needed and the source operand is not modified.
+    m_edge_to_new_points_index.clear();
+    m_edge_to_new_points_index.reserve(source.get_corner_count() / 2);
+    m_old_edge_to_new_points.clear();
+    m_old_edge_to_new_points.reserve(source.get_corner_count() / 2);
 }
 
 auto Geometry_operation::find_or_make_point_from_edge(const Point_id point_a, const Point_id point_b, const std::size_t count) -> Point_id
 {
-    const Point_id a = std::min(point_a, point_b);
-    const Point_id b = std::max(point_a, point_b);
-
-    for (uint32_t slot = a * s_max_edge_point_slots, end = slot + s_max_edge_point_slots; slot < end;) {
-        Point_id& edge_b       = m_old_edge_to_new_points[slot++];
-        Point_id& new_point_id = m_old_edge_to_new_points[slot++];
-        if (edge_b == std::numeric_limits<uint32_t>::max()) {
-            edge_b       = b;
-            new_point_id = destination.make_point();
-            // log_geometry.trace("created edge {} - {} point {}\n", a, b, new_point_id);
-            for (std::size_t i = 1; i < count; ++i) {
-                destination.make_point();
-            }
-            return new_point_id;
-        }
-        if (edge_b == b) {
-            return new_point_id;
+    const auto make_points = [&]() -> Point_id {
+        const Point_id new_point_id = destination.make_point();
+        // log_geometry.trace("created edge {} - {} point {}\n", point_a, point_b, new_point_id);
+        for (std::size_t i = 1; i < count; ++i) {
+            destination.make_point();
         }
+        return new_point_id;
+    };
+
+    if (point_a == point_b) {
+        // Degenerate edge - not an edge in the index
+        return make_points();
     }
-    ERHE_FATAL("s_max_edge_point_slots too low");
+
+    const Edge_id new_slot = static_cast<Edge_id>(m_old_edge_to_new_points.size());
+    const Edge_id slot     = m_edge_to_new_points_index.insert(
+        std::min(point_a, point_b),
+        std::max(point_a, point_b),
+        new_slot
+    );
+    if (slot != new_slot) {
+        return m_old_edge_to_new_points[slot];
+    }
+    const Point_id new_point_id = make_points();
+    m_old_edge_to_new_points.push_back(new_point_id);
+    return new_point_id;
 }
 
 void Geometry_operation::make_edge_midpoints(const std::initializer_list<float> relative_positions)
@@ -130,50 +189,27 @@ void Geometry_operation::make_edge_midpoints(const std::initializer_list<float>
 
 auto Geometry_operation::get_edge_new_point(const Point_id point_a, const Point_id point_b, const Point_id split_position, const Point_id split_count) const -> Point_id
 {
-    const bool     in_order = point_a < point_b;
-    const Point_id a        = std::min(point_a, point_b);
-    const Point_id b        = std::max(point_a, point_b);
-
-    for (uint32_t slot = a * s_max_edge_point_slots, end = slot + s_max_edge_point_slots; slot < end;) {
-        const Point_id edge_b       = m_old_edge_to_new_points[slot++];
-        const Point_id new_point_id = m_old_edge_to_new_points[slot++];
-        if (edge_b == std::numeric_limits<uint32_t>::max()) {
-            break;
-        }
-        if (edge_b == b) {
-            const auto edge_point = in_order
-                ? new_point_id + split_count - 1 - split_position
-                : new_point_id + split_position;
-            //log_subdivide.trace(
-            //    "Edge {} {} midpoint {}/{} = {}\n",
-            //    point_a,
-            //    point_b,
-            //    split_position,
-            //    split_count,
-            //    edge_point
-            //);
-            return edge_point;
-        }
+    const bool    in_order = point_a < point_b;
+    const Edge_id slot     = (point_a != point_b)
+        ? m_edge_to_new_points_index.find(std::min(point_a, point_b), std::max(point_a, point_b))
+        : Edge_index::null_edge;
+    if (slot != Edge_index::null_edge) {
+        const Point_id new_point_id = m_old_edge_to_new_points[slot];
+        const auto edge_point = in_order
+            ? new_point_id + split_count - 1 - split_position
+            : new_point_id + split_position;
+        //log_subdivide.trace(
+        //    "Edge {} {} midpoint {}/{} = {}\n",
+        //    point_a,
+        //    point_b,
+        //    split_position,
+        //    split_count,
+        //    edge_point
+        //);
+        return edge_point;
     }
 
     log_catmull_clark->error("edge point {}-{} not found", point_a, point_b);
-    // log_catmull_clark.error("point {} edge end points: ", a);
-    // for (
-    //     uint32_t slot = a * s_max_edge_point_slots,
-    //     end = slot + s_max_edge_point_slots;
-    //     slot < end;
-    // )
-    // {
-    //     const Point_id edge_b       = m_old_edge_to_new_points[slot++];
-    //     const Point_id new_point_id = m_old_edge_to_new_points[slot++];
-    //     if (edge_b == std::numeric_limits<uint32_t>::max())
-    //     {
-    //         continue;
-    //     }
-    //     log_catmull_clark.error(" {:3}", edge_b);
-    // }
-    // log_catmull_clark.error("\n");
-
     return Point_id{0};
 }
 
@@ -438,7 +474,10 @@ void Geometry_operation::build_destination_edges_with_sourcing()
         const Point_id new_b       = point_old_to_new[i.edge.b];
         const Point_id new_a_      = std::min(new_a, new_b);
         const Point_id new_b_      = std::max(new_a, new_b);
-        const Edge_id  new_edge_id = destination.make_edge(new_a_, new_b_);
+        const auto     found_edge  = destination.find_edge_id(new_a_, new_b_);
+        const Edge_id  new_edge_id = found_edge.has_value()
+            ? found_edge.value()
+            : destination.make_edge(new_a_, new_b_);
         add_edge_source(new_edge_id, 1.0f, i.edge_id);
         const std::size_t index = static_cast<std::size_t>(i.edge_id);
         if (edge_old_to_new.size() <= index) {
@@ -456,10 +495,20 @@ void Geometry_operation::interpolate_all_property_maps()
     new_polygon_sources.resize(destination.get_polygon_count());
     new_corner_sources .resize(destination.get_corner_count());
     new_edge_sources   .resize(destination.get_edge_count());
-    source.point_attributes()  .interpolate(destination.point_attributes(),   new_point_sources);
-    source.polygon_attributes().interpolate(destination.polygon_attributes(), new_polygon_sources);
-    source.corner_attributes() .interpolate(destination.corner_attributes(),  new_corner_sources);
-    source.edge_attributes()   .interpolate(destination.edge_attributes(),    new_edge_sources);
+
+    Parallel_for interpolate_parallel_for;
+    if (m_thread_pool != nullptr) {
+        interpolate_parallel_for = [this](
+            const std::size_t                                                count,
+            const std::function<void(std::size_t first, std::size_t last)>& body
+        ) {
+            parallel_for(count, body);
+        };
+    }
+    source.point_attributes()  .interpolate(destination.point_attributes(),   new_point_sources,   interpolate_parallel_for);
+    source.polygon_attributes().interpolate(destination.polygon_attributes(), new_polygon_sources, interpolate_parallel_for);
+    source.corner_attributes() .interpolate(destination.corner_attributes(),  new_corner_sources,  interpolate_parallel_for);
+    source.edge_attributes()   .interpolate(destination.edge_attributes(),    new_edge_sources,    interpolate_parallel_for);
 }
 
 } // namespace erhe::geometry::operation
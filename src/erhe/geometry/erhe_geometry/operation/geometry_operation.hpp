@@ -1,10 +1,15 @@
 #pragma once
 
+#include "erhe_geometry/edge_index.hpp"
 #include "erhe_geometry/types.hpp"
 
+#include <functional>
 #include <set>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::geometry {
     class Geometry;
 }
@@ -14,9 +19,17 @@ namespace erhe::geometry::operation {
 class Geometry_operation
 {
 public:
-    Geometry_operation(Geometry& source, Geometry& destination)
-        : source     {source}
-        , destination{destination}
+    // When thread_pool is set, per-point, per-polygon and interpolation
+    // passes are partitioned over the thread pool. New ids are assigned
+    // the same way as in serial execution, so the result is identical.
+    Geometry_operation(
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    )
+        : source       {source}
+        , destination  {destination}
+        , m_thread_pool{thread_pool}
     {
     }
 
@@ -35,10 +48,21 @@ public:
     std::vector<std::vector<std::pair<float, Edge_id   >>> new_edge_sources;
 
 private:
-    static constexpr std::size_t s_max_edge_point_slots = 300;
-    std::vector<Point_id> m_old_edge_to_new_points;
+    static constexpr std::size_t s_parallel_grain = 1024; // must be multiple of 64
+    Edge_index                      m_edge_to_new_points_index; // source point pair to m_old_edge_to_new_points slot
+    std::vector<Point_id>           m_old_edge_to_new_points;   // first new point for each source edge
+    erhe::concurrency::Thread_pool* m_thread_pool{nullptr};
 
 public:
+    // Calls body(first, last) for partitions of [0, count). Partitions are
+    // executed in the thread pool if one is set, otherwise serially.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t first, std::size_t last)>& body);
+
+    // Allocates count consecutive new points to destination and returns
+    // the first one. Source vectors are sized to cover the new points, so
+    // that sources for distinct new points can be added concurrently.
+    [[nodiscard]] auto make_new_points(std::size_t count) -> Point_id;
+
     void post_processing           ();
     void make_points_from_points   ();
     void make_polygon_centroids    ();
@@ -25,6 +25,7 @@ Normalize::Normalize(Geometry& source, Geometry& destination)
     destination.m_next_edge_polygon_id               = source.m_next_edge_polygon_id;
     destination.m_polygon_corner_polygon             = source.m_polygon_corner_polygon;
     destination.m_edge_polygon_edge                  = source.m_edge_polygon_edge;
+    destination.m_edge_index                         = source.m_edge_index;
 
     destination.m_serial                             = source.m_serial                            ;
     destination.m_serial_edges                       = source.m_serial_edges                      ;
@@ -20,6 +20,7 @@ Reverse::Reverse(Geometry& source, Geometry& destination)
     destination.m_next_edge_id                       = source.m_next_edge_id;
     destination.m_next_point_corner_reserve          = source.m_next_point_corner_reserve;
     destination.m_next_polygon_corner_id             = source.m_next_polygon_corner_id;
+    destination.m_edge_index                         = source.m_edge_index;
     destination.m_serial                             = source.m_serial                            ;
     destination.m_serial_edges                       = source.m_serial_edges                      ;
     destination.m_serial_polygon_normals             = source.m_serial_polygon_normals            ;
@@ -21,17 +21,26 @@ namespace erhe::geometry::operation {
 //  (2) S(p) := (1 - alpha_n) p + alpha_n 1/n SUM p_i
 //
 //  (6) alpha_n = (4 - 2 cos(2Pi/n)) / 9
-Sqrt3_subdivision::Sqrt3_subdivision(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Sqrt3_subdivision::Sqrt3_subdivision(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
-    source.for_each_point_const([&](auto& i) {
-        const float    alpha            = (4.0f - 2.0f * std::cos(2.0f * glm::pi<float>() / i.point.corner_count)) / 9.0f;
-        const float    alpha_per_n      = alpha / static_cast<float>(i.point.corner_count);
-        const float    alpha_complement = 1.0f - alpha;
-        const Point_id new_point        = make_new_point_from_point(alpha_complement, i.point_id);
-        add_point_ring(new_point, alpha_per_n, i.point_id);
+    // Refined points only have sources from their own ring
+    const uint32_t point_count     = source.get_point_count();
+    const Point_id first_new_point = make_new_points(point_count);
+    point_old_to_new.resize(point_count);
+    parallel_for(point_count, [&](const std::size_t first, const std::size_t last) {
+        for (Point_id point_id = static_cast<Point_id>(first); point_id < last; ++point_id) {
+            const Point&   point            = source.points[point_id];
+            const float    alpha            = (4.0f - 2.0f * std::cos(2.0f * glm::pi<float>() / point.corner_count)) / 9.0f;
+            const float    alpha_per_n      = alpha / static_cast<float>(point.corner_count);
+            const float    alpha_complement = 1.0f - alpha;
+            const Point_id new_point        = first_new_point + point_id;
+            point_old_to_new[point_id] = new_point;
+            add_point_source(new_point, alpha_complement, point_id);
+            add_point_ring(new_point, alpha_per_n, point_id);
+        }
     });
 
     make_polygon_centroids();
@@ -76,4 +85,14 @@ auto sqrt3_subdivision(Geometry& source) -> Geometry
     );
 }
 
+auto sqrt3_subdivision(Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> Geometry
+{
+    return Geometry(
+        fmt::format("sqrt3({})", source.name),
+        [&source, &thread_pool](auto& result) {
+            Sqrt3_subdivision operation{source, result, &thread_pool};
+        }
+    );
+}
+
 } // namespace erhe::geometry::operation
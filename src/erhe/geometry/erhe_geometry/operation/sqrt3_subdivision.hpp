@@ -7,9 +7,10 @@ namespace erhe::geometry::operation {
 class Sqrt3_subdivision : public Geometry_operation
 {
 public:
-    Sqrt3_subdivision(Geometry& src, Geometry& destination);
+    Sqrt3_subdivision(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool = nullptr);
 };
 
 [[nodiscard]] auto sqrt3_subdivision(erhe::geometry::Geometry& source) -> erhe::geometry::Geometry;
+[[nodiscard]] auto sqrt3_subdivision(erhe::geometry::Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
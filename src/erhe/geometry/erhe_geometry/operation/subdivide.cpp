@@ -10,8 +10,8 @@
 
 namespace erhe::geometry::operation {
 
-Subdivide::Subdivide(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Subdivide::Subdivide(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -74,4 +74,14 @@ auto subdivide(Geometry& source) -> Geometry
     };
 }
 
+auto subdivide(Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> Geometry
+{
+    return Geometry{
+        fmt::format("subdivide({})", source.name),
+        [&source, &thread_pool](auto& result) {
+            Subdivide operation{source, result, &thread_pool};
+        }
+    };
+}
+
 } // namespace erhe::geometry::operation
@@ -8,9 +8,10 @@ namespace erhe::geometry::operation {
 class Subdivide : public Geometry_operation
 {
 public:
-    Subdivide(Geometry& src, Geometry& destination);
+    Subdivide(Geometry& src, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool = nullptr);
 };
 
 [[nodiscard]] auto subdivide(erhe::geometry::Geometry& source) -> erhe::geometry::Geometry;
+[[nodiscard]] auto subdivide(erhe::geometry::Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
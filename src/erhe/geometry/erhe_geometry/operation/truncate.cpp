@@ -11,8 +11,8 @@
 
 namespace erhe::geometry::operation {
 
-Truncate::Truncate(Geometry& source, Geometry& destination)
-    : Geometry_operation{source, destination}
+Truncate::Truncate(Geometry& source, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool)
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -70,4 +70,14 @@ auto truncate(Geometry& source) -> Geometry
     );
 }
 
+auto truncate(Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> Geometry
+{
+    return Geometry(
+        fmt::format("truncate({})", source.name),
+        [&source, &thread_pool](auto& result) {
+            Truncate operation{source, result, &thread_pool};
+        }
+    );
+}
+
 } // namespace erhe::geometry::operation
@@ -7,9 +7,10 @@ namespace erhe::geometry::operation {
 class Truncate : public Geometry_operation
 {
 public:
-    Truncate(Geometry& source, Geometry& destination);
+    Truncate(Geometry& source, Geometry& destination, erhe::concurrency::Thread_pool* thread_pool = nullptr);
 };
 
 [[nodiscard]] auto truncate(erhe::geometry::Geometry& source) -> erhe::geometry::Geometry;
+[[nodiscard]] auto truncate(erhe::geometry::Geometry& source, erhe::concurrency::Thread_pool& thread_pool) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "erhe_geometry/dense_bitset.hpp"
+
 #include <glm/glm.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
 #include <typeinfo>
 #include <vector>
 
@@ -26,6 +30,12 @@ enum class Interpolation_mode : unsigned int {
     normalized_vec3_float, // normalize(transform with cofactor matrix) = normal, tagent, bitangent
 };
 
+// Executes body(first, last) over partitions of [0, count), possibly
+// concurrently. Partition boundaries are multiples of 64 (presence word).
+using Parallel_for = std::function<
+    void(std::size_t count, const std::function<void(std::size_t first, std::size_t last)>& body)
+>;
+
 class Property_map_descriptor
 {
 public:
@@ -55,6 +65,17 @@ public:
         const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
     ) const = 0;
 
+    // Interpolates new keys [first, last) only. Destination must have been
+    // trimmed to key_new_to_olds.size() before. Ranges which do not share
+    // presence words (first and last multiples of 64, or end) can be
+    // interpolated concurrently.
+    virtual void interpolate_range(
+        Property_map_base<Key_type>*                                destination,
+        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+        std::size_t                                                 first,
+        std::size_t                                                 last
+    ) const = 0;
+
     virtual void transform  (const glm::mat4 matrix) = 0;
     virtual void import_from(Property_map_base<Key_type>* source) = 0;
     virtual void import_from(Property_map_base<Key_type>* source, const glm::mat4 transform) = 0;
@@ -93,15 +114,29 @@ public:
         const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
     ) const final;
 
+    void interpolate_range(
+        Property_map_base<Key_type>*                                destination,
+        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+        std::size_t                                                 first,
+        std::size_t                                                 last
+    ) const final;
+
     void transform  (const glm::mat4 matrix) final;
     void import_from(Property_map_base<Key_type>* source) final;
     void import_from(Property_map_base<Key_type>* source, const glm::mat4 transform) final;
     auto constructor(const Property_map_descriptor& descriptor) const -> Property_map_base<Key_type>* final;
 
+    // Number of keys which have a value
+    [[nodiscard]] auto present_count() const -> std::size_t;
+
+    // Bulk access. Values for keys which are not present are unspecified.
+    [[nodiscard]] auto value_span()       -> std::span<Value_type>;
+    [[nodiscard]] auto value_span() const -> std::span<const Value_type>;
+
     static constexpr std::size_t s_grow_size = 4096;
 
     std::vector<Value_type> values;
-    std::vector<bool>       present; // Yes, I know vector<bool> has limitations
+    Dense_bitset            present;
 
 private:
     Property_map_descriptor m_descriptor;
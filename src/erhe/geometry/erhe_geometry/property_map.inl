@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <type_traits>
 
 #if !defined(ERHE_PROFILE_FUNCTION)
@@ -56,13 +57,32 @@ inline void Property_map<Key_type, Value_type>::trim(std::size_t size)
 template <typename Key_type, typename Value_type>
 inline void Property_map<Key_type, Value_type>::remap_keys(const std::vector<Key_type>& key_new_to_old)
 {
-    const auto old_values  = values;
-    const auto old_present = present;
-    for (Key_type new_key = 0, end = static_cast<Key_type>(key_new_to_old.size()); new_key < end; ++new_key) {
-        Key_type old_key = key_new_to_old[new_key];
-        values [new_key] = old_values[old_key];
-        present[new_key] = old_present[old_key];
+    ERHE_PROFILE_FUNCTION();
+
+    // Keys past key_new_to_old.size() keep their old values
+    const std::size_t remap_size = key_new_to_old.size();
+    const std::size_t old_size   = values.size();
+    const std::size_t new_size   = std::max(remap_size, old_size);
+
+    std::vector<Value_type> new_values(new_size);
+    Dense_bitset            new_present;
+    new_present.resize(new_size);
+    const std::span<Dense_bitset::Word> new_words = new_present.words();
+    for (std::size_t new_key = 0; new_key < remap_size; ++new_key) {
+        const std::size_t old_key = static_cast<std::size_t>(key_new_to_old[new_key]);
+        if (old_key >= old_size) {
+            continue;
+        }
+        new_values[new_key] = values[old_key];
+        new_words[new_key / Dense_bitset::word_bits] |=
+            static_cast<Dense_bitset::Word>(present.test(old_key)) << (new_key % Dense_bitset::word_bits);
     }
+    for (std::size_t key = remap_size; key < old_size; ++key) {
+        new_values[key] = values[key];
+        new_present.assign(key, present.test(key));
+    }
+    values  = std::move(new_values);
+    present = std::move(new_present);
 }
 
 template <typename Key_type, typename Value_type>
@@ -76,7 +96,7 @@ inline void Property_map<Key_type, Value_type>::put(Key_type key, Value_type val
         present.resize(i + s_grow_size);
     }
     values[i] = value;
-    present[i] = true;
+    present.set(i);
 }
 
 template <typename Key_type, typename Value_type>
@@ -85,7 +105,7 @@ inline auto Property_map<Key_type, Value_type>::get(Key_type key) const -> Value
     ERHE_PROFILE_FUNCTION();
 
     const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || !present.test(i)) {
         ERHE_FATAL("Value not found");
     }
     return values[i];
@@ -101,7 +121,7 @@ inline void Property_map<Key_type, Value_type>::erase(Key_type key)
         values.resize(i + s_grow_size);
         present.resize(i + s_grow_size);
     }
-    present[i] = false;
+    present.reset(i);
 }
 
 template <typename Key_type, typename Value_type>
@@ -110,7 +130,7 @@ inline auto Property_map<Key_type, Value_type>::maybe_get(Key_type key, Value_ty
     ERHE_PROFILE_FUNCTION();
 
     const std::size_t i = static_cast<size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || !present.test(i)) {
         return false;
     }
     out_value = values[i];
@@ -124,12 +144,30 @@ inline auto Property_map<Key_type, Value_type>::has(Key_type key) const -> bool
     ERHE_PROFILE_FUNCTION();
 
     const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if ((values.size() <= i) || !present.test(i)) {
         return false;
     }
     return true;
 }
 
+template <typename Key_type, typename Value_type>
+inline auto Property_map<Key_type, Value_type>::present_count() const -> std::size_t
+{
+    return present.count();
+}
+
+template <typename Key_type, typename Value_type>
+inline auto Property_map<Key_type, Value_type>::value_span() -> std::span<Value_type>
+{
+    return std::span<Value_type>{values};
+}
+
+template <typename Key_type, typename Value_type>
+inline auto Property_map<Key_type, Value_type>::value_span() const -> std::span<const Value_type>
+{
+    return std::span<const Value_type>{values};
+}
+
 template <typename Key_type, typename Value_type>
 inline auto Property_map<Key_type, Value_type>::constructor(const Property_map_descriptor& descriptor) const -> Property_map_base<Key_type>*
 {
@@ -149,6 +187,23 @@ Property_map<Key_type, Value_type>::interpolate(
 {
     ERHE_PROFILE_FUNCTION();
 
+    // Same steps as a parallel caller: trim, then interpolate_range(), which
+    // leaves maps with interpolation mode none without values.
+    destination_base->trim(key_new_to_olds.size());
+    interpolate_range(destination_base, key_new_to_olds, 0, key_new_to_olds.size());
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::interpolate_range(
+    Property_map_base<Key_type>*                                destination_base,
+    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+    const std::size_t                                           first,
+    const std::size_t                                           last
+) const
+{
+    ERHE_PROFILE_FUNCTION();
+
     auto* destination = dynamic_cast<Property_map<Key_type, Value_type>*>(destination_base);
     if (destination == nullptr) {
         //log_interpolate->error("destination is nullptr");
@@ -160,11 +215,15 @@ Property_map<Key_type, Value_type>::interpolate(
         return;
     }
 
-    for (
-        std::size_t new_key = 0, end = key_new_to_olds.size();
-        new_key < end;
-        ++new_key
-    ) {
+    ERHE_VERIFY(destination->values.size() >= last);
+
+    const std::size_t source_size = values.size();
+    const auto source_has = [this, source_size](const Key_type key) -> bool {
+        const std::size_t i = static_cast<std::size_t>(key);
+        return (i < source_size) && present.test(i);
+    };
+
+    for (std::size_t new_key = first; new_key < last; ++new_key) {
         const std::vector<std::pair<float, Key_type>>& old_keys = key_new_to_olds[new_key];
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "\tkey = {} from", new_key);
@@ -172,7 +231,7 @@ Property_map<Key_type, Value_type>::interpolate(
         for (auto j : old_keys) {
             const Key_type old_key = j.second;
             SPDLOG_LOGGER_TRACE(log_interpolate, "\t\told key {} weight {}", static_cast<unsigned int>(old_key), static_cast<float>(j.first));
-            if (has(old_key)) {
+            if (source_has(old_key)) {
                 sum_weights += j.first;
             }
         }
@@ -189,8 +248,8 @@ Property_map<Key_type, Value_type>::interpolate(
                 const float    weight  = j.first;
                 const Key_type old_key = j.second;
 
-                if (has(old_key)) {
-                    const Value_type old_value = get(old_key);
+                if (source_has(old_key)) {
+                    const Value_type old_value = values[static_cast<std::size_t>(old_key)];
                     SPDLOG_LOGGER_TRACE(log_interpolate, "\told value {} weight {}", old_value, (weight / sum_weights));
                     new_value += static_cast<Value_type>((weight / sum_weights) * static_cast<Value_type>(old_value));
                 } else {
@@ -222,7 +281,9 @@ Property_map<Key_type, Value_type>::interpolate(
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "\tvalue = {}", new_value);
 
-        destination->put(static_cast<Key_type>(new_key), new_value);
+        // Written directly instead of put(), destination is already sized
+        destination->values[new_key] = new_value;
+        destination->present.set(new_key);
     }
 }
 
@@ -254,35 +315,75 @@ template <>           struct transform_properties<glm::vec2> { static const bool
 template <>           struct transform_properties<glm::vec3> { static const bool is_transformable = true;  };
 template <>           struct transform_properties<glm::vec4> { static const bool is_transformable = true;  };
 
-template <typename Key_type, typename Value_type>
-inline void Property_map<Key_type, Value_type>::import_from(Property_map_base<Key_type>* source_base)
+// Bulk transform kernels. Matrix elements are loaded into scalars once,
+// and the loop bodies are branch free straight line float math so that
+// compilers can keep everything in registers and vectorize.
+static inline void transform_vec3_span(
+    const std::span<glm::vec3> values,
+    const glm::mat4&           m,
+    const float                w,
+    const bool                 normalize
+)
 {
-    ERHE_PROFILE_FUNCTION();
-
-    const auto* const source = dynamic_cast<Property_map<Key_type, Value_type>*>(source_base);
-    if (source == nullptr) {
-        //log_attribute_maps->error("source is nullptr");
-        return;
+    const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+    const float m30 = m[3][0] * w, m31 = m[3][1] * w, m32 = m[3][2] * w;
+    glm::vec3* const  data  = values.data();
+    const std::size_t count = values.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x  = data[i].x;
+        const float y  = data[i].y;
+        const float z  = data[i].z;
+        float       tx = m00 * x + m10 * y + m20 * z + m30;
+        float       ty = m01 * x + m11 * y + m21 * z + m31;
+        float       tz = m02 * x + m12 * y + m22 * z + m32;
+        if (normalize) {
+            const float s = 1.0f / std::sqrt(tx * tx + ty * ty + tz * tz);
+            tx *= s;
+            ty *= s;
+            tz *= s;
+        }
+        data[i].x = tx;
+        data[i].y = ty;
+        data[i].z = tz;
     }
-
-    ERHE_VERIFY(values.size() == present.size());
-    ERHE_VERIFY(source->values.size() == source->present.size());
-
-    values .reserve(values.size()  + source->values.size());
-    present.reserve(present.size() + source->present.size());
-    present.insert(present.end(), source->present.begin(), source->present.end());
-    values.insert(values.end(), source->values.begin(), source->values.end());
 }
 
-template <typename Key_type, typename Value_type>
-inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transform)
+// Transforms xyz, w is passed through unmodified
+static inline void transform_vec3_float_span(
+    const std::span<glm::vec4> values,
+    const glm::mat4&           m
+)
 {
-    ERHE_PROFILE_FUNCTION();
-
-    ERHE_VERIFY(values.size() == present.size());
+    const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+    glm::vec4* const  data  = values.data();
+    const std::size_t count = values.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x  = data[i].x;
+        const float y  = data[i].y;
+        const float z  = data[i].z;
+        const float tx = m00 * x + m10 * y + m20 * z;
+        const float ty = m01 * x + m11 * y + m21 * z;
+        const float tz = m02 * x + m12 * y + m22 * z;
+        const float s  = 1.0f / std::sqrt(tx * tx + ty * ty + tz * tz);
+        data[i].x = tx * s;
+        data[i].y = ty * s;
+        data[i].z = tz * s;
+    }
+}
 
+template <typename Value_type>
+inline void transform_span(
+    const std::span<Value_type> values,
+    const Transform_mode        transform_mode,
+    const glm::mat4&            transform
+)
+{
     if constexpr(transform_properties<Value_type>::is_transformable) {
-        switch (m_descriptor.transform_mode) {
+        switch (transform_mode) {
             //using enum Transform_mode;
             default:
             case Transform_mode::none: {
@@ -290,8 +391,12 @@ inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transf
             }
 
             case Transform_mode::position: {
-                for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                    values[i] = apply_transform(values[i], transform, 1.0f);
+                if constexpr (std::is_same_v<Value_type, glm::vec3>) {
+                    transform_vec3_span(values, transform, 1.0f, false);
+                } else {
+                    for (Value_type& value : values) {
+                        value = apply_transform(value, transform, 1.0f);
+                    }
                 }
                 break;
             }
@@ -300,15 +405,7 @@ inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transf
             case Transform_mode::direction: {
                 if constexpr (std::is_same_v<Value_type, glm::vec3>) {
                     const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                        values[i] = glm::normalize(
-                            apply_transform(
-                                values[i],
-                                inverse_transpose_transform,
-                                0.0f
-                            )
-                        );
-                    }
+                    transform_vec3_span(values, inverse_transpose_transform, 0.0f, true);
                 }
                 break;
             }
@@ -317,14 +414,7 @@ inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transf
             case Transform_mode::direction_vec3_float: {
                 if constexpr (std::is_same_v<Value_type, glm::vec4>) {
                     const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                        values[i] = glm::vec4{
-                            glm::normalize(
-                                apply_transform(glm::vec3{values[i]}, inverse_transpose_transform, 0.0f)
-                            ),
-                            values[i].w
-                        };
-                    }
+                    transform_vec3_float_span(values, inverse_transpose_transform);
                 }
                 break;
             }
@@ -333,11 +423,11 @@ inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transf
 }
 
 template <typename Key_type, typename Value_type>
-inline void Property_map<Key_type, Value_type>::import_from(Property_map_base<Key_type>* source_base, const glm::mat4 transform)
+inline void Property_map<Key_type, Value_type>::import_from(Property_map_base<Key_type>* source_base)
 {
     ERHE_PROFILE_FUNCTION();
 
-    auto* source = dynamic_cast<Property_map<Key_type, Value_type>*>(source_base);
+    const auto* const source = dynamic_cast<Property_map<Key_type, Value_type>*>(source_base);
     if (source == nullptr) {
         //log_attribute_maps->error("source is nullptr");
         return;
@@ -346,59 +436,28 @@ inline void Property_map<Key_type, Value_type>::import_from(Property_map_base<Ke
     ERHE_VERIFY(values.size() == present.size());
     ERHE_VERIFY(source->values.size() == source->present.size());
 
-    const auto combined_values_size = values.size()  + source->values.size();
-    const auto combined_present_size = present.size() + source->present.size();
-    values .reserve(combined_values_size);
-    present.reserve(combined_present_size);
-    present.insert(present.end(), source->present.begin(), source->present.end());
-    if constexpr(!transform_properties<Value_type>::is_transformable) {
-        values.insert(values.end(), source->values.begin(), source->values.end());
-    } else {
-        switch (m_descriptor.transform_mode) {
-            //using enum Transform_mode;
-            default:
-            case Transform_mode::none: {
-                values.insert(values.end(), source->values.begin(), source->values.end());
-                break;
-            }
+    values.insert(values.end(), source->values.begin(), source->values.end());
+    present.append(source->present);
+}
 
-            case Transform_mode::position: {
-                for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                    const Value_type source_value = source->values[i];
-                    const Value_type result       = apply_transform(source_value, transform, 1.0f);
-                    values.push_back(result);
-                }
-                break;
-            }
+template <typename Key_type, typename Value_type>
+inline void Property_map<Key_type, Value_type>::transform(const glm::mat4 transform)
+{
+    ERHE_PROFILE_FUNCTION();
 
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction: {
-                if constexpr (std::is_same_v<Value_type, glm::vec3>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                        const Value_type source_value = source->values[i];
-                        const Value_type result       = glm::normalize(apply_transform(source_value, inverse_transpose_transform, 0.0f));
-                        values.push_back(result);
-                    }
-                }
-                break;
-            }
+    ERHE_VERIFY(values.size() == present.size());
 
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction_vec3_float: {
-                if constexpr (std::is_same_v<Value_type, glm::vec4>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                        const Value_type source_value     = source->values[i];
-                        const glm::vec3  transformed_vec3 = glm::normalize(apply_transform(glm::vec3{source_value}, inverse_transpose_transform, 0.0f));
-                        const Value_type result           = glm::vec4{transformed_vec3, source_value.w};
-                        values.push_back(result);
-                    }
-                }
-                break;
-            }
-        }
-    }
+    transform_span<Value_type>(value_span(), m_descriptor.transform_mode, transform);
+}
+
+template <typename Key_type, typename Value_type>
+inline void Property_map<Key_type, Value_type>::import_from(Property_map_base<Key_type>* source_base, const glm::mat4 transform)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t first_imported = values.size();
+    import_from(source_base);
+    transform_span<Value_type>(value_span().subspan(first_imported), m_descriptor.transform_mode, transform);
 }
 
 } // namespace erhe::geometry
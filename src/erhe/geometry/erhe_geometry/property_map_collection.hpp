@@ -72,7 +72,8 @@ public:
     void remap_keys(const std::vector<Key_type>& key_new_to_old);
     void interpolate(
         Property_map_collection<Key_type>&                          destination,
-        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
+        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+        const Parallel_for&                                         parallel_for = {}
     );
 
     void merge_to            (Property_map_collection<Key_type>& source, const glm::mat4 transform);
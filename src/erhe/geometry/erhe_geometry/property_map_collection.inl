@@ -177,10 +177,13 @@ template <typename Key_type>
 inline void
 Property_map_collection<Key_type>::interpolate(
     Property_map_collection<Key_type>&                          destination,
-    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds)
+    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds,
+    const Parallel_for&                                         parallel_for
+)
 {
     ERHE_PROFILE_FUNCTION();
 
+    const std::size_t new_key_count = key_new_to_olds.size();
     for (auto& entry : m_entries) {
         Property_map_base<Key_type>* src_map    = entry.value.get();
         const auto&                  descriptor = src_map->descriptor();
@@ -190,7 +193,18 @@ Property_map_collection<Key_type>::interpolate(
         Property_map_base<Key_type>* destination_map = src_map->constructor(descriptor);
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "interpolating {}", src_map->descriptor().name);
-        src_map->interpolate(destination_map, key_new_to_olds);
+        // Serial and parallel paths run the same steps, so their results match
+        destination_map->trim(new_key_count);
+        if (parallel_for) {
+            parallel_for(
+                new_key_count,
+                [src_map, destination_map, &key_new_to_olds](const std::size_t first, const std::size_t last) {
+                    src_map->interpolate_range(destination_map, key_new_to_olds, first, last);
+                }
+            );
+        } else {
+            src_map->interpolate_range(destination_map, key_new_to_olds, 0, new_key_count);
+        }
 
         destination.insert(destination_map);
     }
@@ -4,16 +4,20 @@
 #include "gltf_log.hpp"
 #include "image_transfer.hpp"
 
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_gl/wrapper_functions.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_graphics/instance.hpp"
+#include "erhe_graphics/image_cache.hpp"
 #include "erhe_graphics/image_loader.hpp"
+#include "erhe_graphics/image_mip_chain.hpp"
 #include "erhe_graphics/sampler.hpp"
 #include "erhe_graphics/texture.hpp"
 #include "erhe_graphics/vertex_attribute.hpp"
 #include "erhe_graphics/vertex_format.hpp"
 #include "erhe_primitive/material.hpp"
+#include "erhe_primitive/morph_targets.hpp"
 #include "erhe_primitive/triangle_soup.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_scene/animation.hpp"
@@ -38,9 +42,12 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <numeric>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -52,6 +59,9 @@ namespace erhe::gltf {
 
 namespace {
 
+constexpr std::size_t s_image_batch_size     {16};
+constexpr std::size_t s_primitive_build_grain{1};
+
 constexpr glm::mat4 mat4_yup_from_zup{
     1.0f, 0.0f, 0.0f, 0.0f,
     0.0f, 0.0f, 1.0f, 0.0f,
@@ -563,12 +573,27 @@ public:
             return;
         }
 
-        log_gltf->trace("parsing images");
-        m_data_out.images.resize(m_asset->images.size());
-        for (std::size_t i = 0, end = m_asset->images.size(); i < end; ++i) {
-            parse_image(i);
+        // Triangle soups are built on the thread pool while images are
+        // decoded and uploaded. Scene graph is assembled on this thread
+        // once all primitives are done.
+        log_gltf->trace("building primitives");
+        collect_primitive_entries();
+        const std::size_t primitive_entry_count = m_primitive_entries.size();
+        std::unique_ptr<erhe::concurrency::Concurrent_queue> primitive_queue;
+        if ((m_arguments.thread_pool != nullptr) && (primitive_entry_count > 1)) {
+            primitive_queue = std::make_unique<erhe::concurrency::Concurrent_queue>(*m_arguments.thread_pool, "gltf primitive build");
+            primitive_queue->enqueue_range(0, primitive_entry_count, s_primitive_build_grain, [this](const std::size_t i) {
+                load_new_primitive_geometry(m_primitive_entries[i]);
+            });
+        } else {
+            for (Primitive_entry& primitive_entry : m_primitive_entries) {
+                load_new_primitive_geometry(primitive_entry);
+            }
         }
 
+        log_gltf->trace("parsing images");
+        parse_images();
+
         log_gltf->trace("parsing samplers");
         m_data_out.samplers.resize(m_asset->samplers.size());
         for (std::size_t i = 0, end = m_asset->samplers.size(); i < end; ++i) {
@@ -593,11 +618,17 @@ public:
             parse_light(i);
         }
 
+        if (primitive_queue) {
+            primitive_queue->wait();
+        }
+        report_progress("primitives", primitive_entry_count, primitive_entry_count);
+
         log_gltf->trace("parsing meshes");
         m_data_out.meshes.resize(m_asset->meshes.size());
         for (std::size_t i = 0, end = m_asset->meshes.size(); i < end; ++i) {
             parse_mesh(i);
         }
+        report_progress("meshes", m_asset->meshes.size(), m_asset->meshes.size());
 
         log_gltf->trace("parsing nodes");
         m_data_out.nodes.resize(m_asset->nodes.size());
@@ -624,6 +655,7 @@ public:
                 parse_node(i, m_arguments.root_node);
             }
         }
+        report_progress("nodes", m_asset->nodes.size(), m_asset->nodes.size());
 
         log_gltf->trace("parsing skins");
         for (std::size_t i = 0, end = m_asset->skins.size(); i < end; ++i) {
@@ -637,9 +669,16 @@ public:
         for (std::size_t i = 0, end = m_asset->animations.size(); i < end; ++i) {
             parse_animation(i);
         }
+        report_progress("animations", m_asset->animations.size(), m_asset->animations.size());
     }
 
 private:
+    void report_progress(const std::string_view stage, const std::size_t done, const std::size_t total) const
+    {
+        if (m_arguments.progress_callback) {
+            m_arguments.progress_callback(stage, done, total);
+        }
+    }
     void trace_info() const
     {
         if (m_asset->assetInfo.has_value()) {
@@ -717,6 +756,16 @@ private:
             );
 
             switch (outputAccessor.type) {
+                case fastgltf::AccessorType::Scalar: {
+                    // Morph target weights, one value per target per keyframe
+                    fastgltf::iterateAccessorWithIndex<float>(
+                        asset, outputAccessor,
+                        [&](float value, std::size_t idx) {
+                           values[idx] = value;
+                        }
+                    );
+                    break;
+                }
                 case fastgltf::AccessorType::Vec3: {
                     fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
                         asset, outputAccessor,
@@ -787,103 +836,94 @@ private:
             //}
 
             const fastgltf::AnimationSampler& sampler = animation.samplers.at(channel.samplerIndex);
+            const std::size_t component_count = (path == erhe::scene::Animation_path::WEIGHTS)
+                ? erhe_animation->samplers.at(channel.samplerIndex).get_weight_count()
+                : get_component_count(path);
             erhe_animation->channels[channel_index] = erhe::scene::Animation_channel{
                 .path           = path,
                 .sampler_index  = channel.samplerIndex,
                 .target         = target_node,
                 .start_position = 0,
                 .value_offset   = (sampler.interpolation == fastgltf::AnimationInterpolation::CubicSpline)
-                    ? get_component_count(path)
+                    ? component_count
                     : 0
             };
         }
         m_data_out.animations[animation_index] = erhe_animation;
     }
-    auto load_image_file(
-        const std::filesystem::path& path,
-        std::string_view             image_name
-    ) -> std::shared_ptr<erhe::graphics::Texture>
+    // Image decoded to CPU memory; decode_image() can run on any thread,
+    // upload_image() must run on the thread with the GL context.
+    class Decoded_image
+    {
+    public:
+        std::string                     name;
+        std::filesystem::path           source_path;
+        erhe::graphics::Image_mip_chain mip_chain;
+        bool                            ok{false};
+    };
+
+    // Decodes encoded image and builds mip chain, or loads both from image cache
+    void decode_encoded_image(const std::span<const std::uint8_t> encoded_data, Decoded_image& decoded_image)
     {
         ERHE_PROFILE_FUNCTION();
 
-        const bool file_is_ok = erhe::file::check_is_existing_non_empty_regular_file("Gltf_parser::load_image_file", path);
-        if (!file_is_ok) {
-            return {};
+        const uint64_t cache_key = m_arguments.use_image_cache ? erhe::graphics::get_image_cache_key(encoded_data) : 0;
+        if (m_arguments.use_image_cache && erhe::graphics::load_cached_image(cache_key, decoded_image.mip_chain)) {
+            log_gltf->trace("Image '{}' loaded from image cache", decoded_image.name);
+            decoded_image.ok = true;
+            return;
         }
 
-        erhe::graphics::Image_info image_info;
+        erhe::graphics::Image_info   image_info;
         erhe::graphics::Image_loader loader;
-
-        if (!loader.open(path, image_info)) {
-            return {};
+        if (!loader.open(encoded_data, image_info)) {
+            log_gltf->error("Failed to parse image '{}'", decoded_image.name);
+            return;
         }
-
-        auto& slot = m_arguments.image_transfer.get_slot();
-
-        erhe::graphics::Texture_create_info texture_create_info{
-            .instance        = m_arguments.graphics_instance,
-            .internal_format = to_gl(image_info.format),
-            .use_mipmaps     = true, //(image_info.level_count > 1),
-            .width           = image_info.width,
-            .height          = image_info.height,
-            .depth           = image_info.depth,
-            .level_count     = image_info.level_count,
-            .row_stride      = image_info.row_stride,
-            .debug_label     = std::string{image_name} // path.filename().string()
-        };
-        const int  mipmap_count    = texture_create_info.calculate_level_count();
-        const bool generate_mipmap = mipmap_count != image_info.level_count;
-        if (generate_mipmap) {
-            texture_create_info.level_count = mipmap_count;
+        if ((image_info.width < 1) || (image_info.height < 1)) {
+            return;
         }
-        std::span<std::uint8_t> span = slot.begin_span_for(image_info.width, image_info.height, texture_create_info.internal_format);
-
-        const bool ok = loader.load(span);
+        std::vector<std::uint8_t> level_0_data(
+            static_cast<std::size_t>(image_info.width) *
+            static_cast<std::size_t>(image_info.height) *
+            erhe::graphics::get_pixel_byte_count(image_info.format)
+        );
+        const bool load_ok = loader.load(level_0_data);
         loader.close();
-        slot.end(ok);
-        if (!ok) {
-            return {};
+        if (!load_ok) {
+            return;
         }
 
-        auto texture = std::make_shared<erhe::graphics::Texture>(texture_create_info);
-        texture->set_source_path(path);
-        texture->set_debug_label(image_name.empty() ? erhe::file::to_string(path) : image_name);
-
-        gl::pixel_store_i(gl::Pixel_store_parameter::unpack_alignment, 1);
-        gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, slot.gl_name());
-        texture->upload(texture_create_info.internal_format, texture_create_info.width, texture_create_info.height);
-        gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, 0);
-
-        if (generate_mipmap) {
-            gl::generate_texture_mipmap(texture->gl_name());
+        erhe::graphics::make_mip_chain(image_info, level_0_data, decoded_image.mip_chain);
+        decoded_image.ok = true;
+        if (m_arguments.use_image_cache) {
+            static_cast<void>(erhe::graphics::save_cached_image(cache_key, decoded_image.mip_chain));
         }
-        return texture;
     }
-    auto load_image_buffer(
-        const std::size_t buffer_view_index,
-        const std::size_t image_index,
-        std::string_view  image_name
-    ) -> std::shared_ptr<erhe::graphics::Texture>
+    void decode_image_file(const std::filesystem::path& path, Decoded_image& decoded_image)
     {
         ERHE_PROFILE_FUNCTION();
 
-        const fastgltf::BufferView&  buffer_view      = m_asset->bufferViews[buffer_view_index];
-        const fastgltf::Buffer&      buffer           = m_asset->buffers.at(buffer_view.bufferIndex);
-        const std::string            buffer_view_name = safe_resource_name(buffer_view.name, "buffer_view", buffer_view_index);
-        const std::string            name             = !image_name.empty() 
-            ? std::string{image_name}
-            : fmt::format("{} image {} {}", m_arguments.path.filename().string(), image_index, buffer_view_name);
-        erhe::graphics::Image_info   image_info;
-        erhe::graphics::Image_loader loader;
+        decoded_image.source_path = path;
+        const std::optional<std::string> encoded_data = erhe::file::read("Gltf_parser::decode_image_file", path);
+        if (!encoded_data.has_value()) {
+            return;
+        }
+        decode_encoded_image(
+            std::span<const std::uint8_t>{
+                reinterpret_cast<const std::uint8_t*>(encoded_data.value().data()),
+                encoded_data.value().size()
+            },
+            decoded_image
+        );
+    }
+    void decode_image_buffer(const std::size_t buffer_view_index, Decoded_image& decoded_image)
+    {
+        ERHE_PROFILE_FUNCTION();
 
-        bool load_ok = false;
-        auto& slot = m_arguments.image_transfer.get_slot();
-        erhe::graphics::Texture_create_info texture_create_info{
-            .instance    = m_arguments.graphics_instance,
-            .debug_label = name
-        };
-        int  mipmap_count    = 0;
-        bool generate_mipmap = false;
+        const fastgltf::BufferView& buffer_view = m_asset->bufferViews[buffer_view_index];
+        const fastgltf::Buffer&     buffer      = m_asset->buffers.at(buffer_view.bufferIndex);
+        decoded_image.source_path = m_arguments.path;
 
         std::visit(
             fastgltf::visitor{
@@ -896,68 +936,20 @@ private:
                         reinterpret_cast<const std::uint8_t*>(data.bytes.data()) + buffer_view.byteOffset,
                         buffer_view.byteLength
                     };
-                    if (!loader.open(image_encoded_buffer_view, image_info)) {
-                        log_gltf->error("Failed to parse image from buffer view '{}'", name);
-                        return;
-                    }
-
-                    texture_create_info.internal_format = to_gl(image_info.format);
-                    texture_create_info.use_mipmaps     = true; //(image_info.level_count > 1),
-                    texture_create_info.width           = image_info.width;
-                    texture_create_info.height          = image_info.height;
-                    texture_create_info.depth           = image_info.depth;
-                    texture_create_info.level_count     = image_info.level_count;
-                    texture_create_info.row_stride      = image_info.row_stride;
-                    texture_create_info.debug_label     = name;
-
-                    mipmap_count    = texture_create_info.calculate_level_count();
-                    generate_mipmap = mipmap_count != image_info.level_count;
-                    if (generate_mipmap) {
-                        texture_create_info.level_count = mipmap_count;
-                    }
-                    std::span<std::uint8_t> span = slot.begin_span_for(image_info.width, image_info.height, texture_create_info.internal_format);
-
-                    load_ok = loader.load(span);
-                    loader.close();
+                    decode_encoded_image(image_encoded_buffer_view, decoded_image);
                 }
             },
             buffer.data
         );
-        slot.end(load_ok);
-        if (!load_ok) {
-            log_gltf->warn(
-                "Image '{}' load failed: image index = {}, width = {}, height = {}",
-                name, image_index, texture_create_info.width, texture_create_info.height
-            );
-            return {};
-        }
-
-        log_gltf->info(
-            "Loaded image '{}': image index = {}, width = {}, height = {}",
-            name, image_index, texture_create_info.width, texture_create_info.height
-        );
-
-        auto texture = std::make_shared<erhe::graphics::Texture>(texture_create_info);
-        texture->set_source_path(m_arguments.path);
-        texture->set_debug_label(name);
-        gl::pixel_store_i(gl::Pixel_store_parameter::unpack_alignment, 1);
-        gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, slot.gl_name());
-        texture->upload(texture_create_info.internal_format, texture_create_info.width, texture_create_info.height);
-        gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, 0);
-
-        if (generate_mipmap) {
-            gl::generate_texture_mipmap(texture->gl_name());
-        }
-        return texture;
     }
-    void parse_image(const std::size_t image_index)
+    void decode_image(const std::size_t image_index, Decoded_image& decoded_image)
     {
         ERHE_PROFILE_FUNCTION();
 
-        const fastgltf::Image& image      = m_asset->images[image_index];
-        const std::string      image_name = safe_resource_name(image.name, "image", image_index);
-        log_gltf->trace("Image: image index = {}, name = {}", image_index, image_name);
-        std::shared_ptr<erhe::graphics::Texture> erhe_texture;
+        const fastgltf::Image& image = m_asset->images[image_index];
+        decoded_image = Decoded_image{};
+        decoded_image.name = safe_resource_name(image.name, "image", image_index);
+        log_gltf->trace("Image: image index = {}, name = {}", image_index, decoded_image.name);
         std::visit(
             fastgltf::visitor {
                 [](auto& arg) {
@@ -965,21 +957,93 @@ private:
                     ERHE_FATAL("TODO Unsupported image source");
                 },
                 [&](const fastgltf::sources::BufferView& buffer_view_source){
-                    erhe_texture = load_image_buffer(buffer_view_source.bufferViewIndex, image_index, image_name);
+                    decode_image_buffer(buffer_view_source.bufferViewIndex, decoded_image);
                 },
                 [&](const fastgltf::sources::URI& uri){
-                    std::filesystem::path relative_path = uri.uri.fspath();
-                    erhe_texture = load_image_file(m_arguments.path.replace_filename(relative_path), image_name);
+                    // Image path is relative to the glTF file
+                    const std::filesystem::path relative_path = uri.uri.fspath();
+                    decode_image_file(std::filesystem::path{m_arguments.path}.replace_filename(relative_path), decoded_image);
                 }
             },
             image.data
         );
+    }
+    void upload_image(const std::size_t image_index, Decoded_image& decoded_image)
+    {
+        ERHE_PROFILE_FUNCTION();
+
+        const erhe::graphics::Image_mip_chain& mip_chain = decoded_image.mip_chain;
+        if (!decoded_image.ok || mip_chain.levels.empty()) {
+            log_gltf->warn("Image '{}' load failed: image index = {}", decoded_image.name, image_index);
+            return;
+        }
+
+        const erhe::graphics::Image_level& level_0 = mip_chain.levels.front();
+        erhe::graphics::Texture_create_info texture_create_info{
+            .instance        = m_arguments.graphics_instance,
+            .internal_format = to_gl(mip_chain.format),
+            .use_mipmaps     = true,
+            .width           = level_0.width,
+            .height          = level_0.height,
+            .depth           = 1,
+            .level_count     = static_cast<int>(mip_chain.levels.size()),
+            .debug_label     = decoded_image.name
+        };
+        auto texture = std::make_shared<erhe::graphics::Texture>(texture_create_info);
+        texture->set_source_path(decoded_image.source_path);
+        texture->set_debug_label(decoded_image.name);
+
+        // Mip levels are generated on CPU, each level is streamed through a transfer slot
+        gl::pixel_store_i(gl::Pixel_store_parameter::unpack_alignment, 1);
+        for (std::size_t level = 0, end = mip_chain.levels.size(); level < end; ++level) {
+            const erhe::graphics::Image_level&  image_level = mip_chain.levels[level];
+            const std::span<const std::uint8_t> level_data  = mip_chain.get_level_data(level);
+            auto& slot = m_arguments.image_transfer.get_slot();
+            std::span<std::uint8_t> span = slot.begin_span_for(image_level.width, image_level.height, texture_create_info.internal_format);
+            ERHE_VERIFY(span.size_bytes() == level_data.size_bytes());
+            std::memcpy(span.data(), level_data.data(), level_data.size_bytes());
+            slot.end(true);
+
+            gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, slot.gl_name());
+            texture->upload(texture_create_info.internal_format, image_level.width, image_level.height, 1, static_cast<int>(level));
+            gl::bind_buffer(gl::Buffer_target::pixel_unpack_buffer, 0);
+        }
+
+        log_gltf->info(
+            "Loaded image '{}': image index = {}, width = {}, height = {}, level count = {}",
+            decoded_image.name, image_index, level_0.width, level_0.height, mip_chain.levels.size()
+        );
+        m_data_out.images[image_index] = texture;
+    }
+    void parse_images()
+    {
+        ERHE_PROFILE_FUNCTION();
 
-        if (erhe_texture) {
-            erhe_texture->set_debug_label(image_name);
-            m_data_out.images.push_back(erhe_texture);
+        // Images are decoded in batches, so that at most one batch of decoded
+        // images is held in memory while uploads are done.
+        const std::size_t image_count = m_asset->images.size();
+        m_data_out.images.resize(image_count);
+        std::vector<Decoded_image> decoded_images(std::min(image_count, s_image_batch_size));
+        for (std::size_t batch_first = 0; batch_first < image_count; batch_first += s_image_batch_size) {
+            const std::size_t batch_last = std::min(batch_first + s_image_batch_size, image_count);
+            const std::size_t batch_size = batch_last - batch_first;
+            if ((m_arguments.thread_pool != nullptr) && (batch_size > 1)) {
+                erhe::concurrency::Concurrent_queue queue{*m_arguments.thread_pool, "gltf image decode"};
+                queue.enqueue_range(0, batch_size, 1, [this, batch_first, &decoded_images](const std::size_t i) {
+                    decode_image(batch_first + i, decoded_images[i]);
+                });
+                queue.wait();
+            } else {
+                for (std::size_t i = 0; i < batch_size; ++i) {
+                    decode_image(batch_first + i, decoded_images[i]);
+                }
+            }
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                upload_image(batch_first + i, decoded_images[i]);
+                decoded_images[i] = Decoded_image{};
+                report_progress("images", batch_first + i + 1, image_count);
+            }
         }
-        m_data_out.images[image_index] = erhe_texture;
     }
     void parse_sampler(const std::size_t sampler_index)
     {
@@ -1086,7 +1150,9 @@ private:
             node.transform
         );
         erhe_node->update_world_from_node();
-        erhe_node->handle_transform_update(erhe::scene::Node_transforms::get_next_serial());
+        if (!erhe_node->mark_transform_dirty()) {
+            erhe_node->handle_transform_update(erhe::scene::Node_transforms::get_next_serial());
+        }
     }
     void parse_camera(const std::size_t camera_index)
     {
@@ -1160,19 +1226,26 @@ private:
         erhe_light->enable_flag_bits(Item_flags::content | Item_flags::visible | Item_flags::show_in_ui);
     }
 
+    // Primitives which use the same accessors share one entry and triangle soup
     class Primitive_entry
     {
     public:
-        std::size_t                                     index_accessor;
+        const fastgltf::Primitive*                      primitive     {nullptr};
+        std::size_t                                     index_accessor{std::numeric_limits<std::size_t>::max()};
         std::vector<std::size_t>                        attribute_accessors;
         std::shared_ptr<erhe::primitive::Triangle_soup> triangle_soup;
     };
-    std::vector<Primitive_entry> m_primitive_entries;
+    std::vector<Primitive_entry>                              m_primitive_entries;
+    std::unordered_map<std::size_t, std::vector<std::size_t>> m_primitive_entries_by_index_accessor;
+    std::vector<std::vector<std::size_t>>                     m_mesh_primitive_entries; // entry index for each mesh primitive
 
-    void load_new_primitive_geometry(const fastgltf::Primitive& primitive, Primitive_entry& primitive_entry)
+    // Only reads asset and writes to the given entry; can be called from worker threads
+    void load_new_primitive_geometry(Primitive_entry& primitive_entry)
     {
         ERHE_PROFILE_FUNCTION();
 
+        ERHE_VERIFY(primitive_entry.primitive != nullptr);
+        const fastgltf::Primitive& primitive = *primitive_entry.primitive;
         primitive_entry.triangle_soup.reset();
 
         if (!primitive.indicesAccessor.has_value()) {
@@ -1247,45 +1320,122 @@ private:
                 accessor.byteOffset
             );
         }
+
+        load_morph_targets(primitive, triangle_soup);
     }
-    auto get_primitive_geometry(const fastgltf::Primitive& primitive, Primitive_entry& primitive_entry)
+
+    void load_morph_targets(const fastgltf::Primitive& primitive, erhe::primitive::Triangle_soup& triangle_soup)
     {
         ERHE_PROFILE_FUNCTION();
 
-        primitive_entry.index_accessor = primitive.indicesAccessor.value();
-        primitive_entry.attribute_accessors.clear();
+        if (primitive.targets.empty()) {
+            return;
+        }
+
+        const std::size_t vertex_count = triangle_soup.get_vertex_count();
+        auto morph_targets = std::make_shared<erhe::primitive::Morph_targets>(vertex_count);
+        std::vector<glm::vec3> position_deltas;
+        std::vector<glm::vec3> normal_deltas;
+        std::vector<glm::vec3> tangent_deltas;
+        for (std::size_t target_index = 0, end = primitive.targets.size(); target_index < end; ++target_index) {
+            position_deltas.clear();
+            normal_deltas  .clear();
+            tangent_deltas .clear();
+            for (const fastgltf::Attribute& attribute : primitive.targets[target_index]) {
+                const std::string_view name = attribute.name;
+                std::vector<glm::vec3>* deltas =
+                    (name == "POSITION") ? &position_deltas :
+                    (name == "NORMAL"  ) ? &normal_deltas   :
+                    (name == "TANGENT" ) ? &tangent_deltas  : nullptr;
+                if (deltas == nullptr) {
+                    log_gltf->warn("Unsupported morph target attribute {}", name);
+                    continue;
+                }
+                const fastgltf::Accessor& accessor = m_asset->accessors[attribute.accessorIndex];
+                if ((accessor.type != fastgltf::AccessorType::Vec3) || (accessor.count != vertex_count)) {
+                    log_gltf->warn("Morph target {} attribute {} has unsupported accessor", target_index, name);
+                    continue;
+                }
+                // Morph target accessors are often sparse; iterateAccessor handles that
+                deltas->resize(vertex_count, glm::vec3{0.0f});
+                fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+                    m_asset.get(), accessor,
+                    [&](fastgltf::math::fvec3 value, std::size_t idx) {
+                        (*deltas)[idx] = glm::vec3{value.x(), value.y(), value.z()};
+                    }
+                );
+            }
+            morph_targets->add_target(fmt::format("target {}", target_index), position_deltas, normal_deltas, tangent_deltas);
+        }
+        log_gltf->trace(
+            "Morph targets: count = {}, vertex count = {}, byte count = {}",
+            morph_targets->get_target_count(),
+            vertex_count,
+            morph_targets->get_byte_count()
+        );
+        triangle_soup.morph_targets = morph_targets;
+    }
+
+    auto get_primitive_entry_index(const fastgltf::Primitive& primitive) -> std::size_t
+    {
+        Primitive_entry primitive_entry;
+        primitive_entry.primitive = &primitive;
+        if (primitive.indicesAccessor.has_value()) {
+            primitive_entry.index_accessor = primitive.indicesAccessor.value();
+        }
         for (std::size_t i = 0, end = primitive.attributes.size(); i < end; ++i) {
             const fastgltf::Attribute& attribute = primitive.attributes[i];
             primitive_entry.attribute_accessors.push_back(attribute.accessorIndex);
         }
+        for (const auto& target : primitive.targets) {
+            for (const fastgltf::Attribute& attribute : target) {
+                primitive_entry.attribute_accessors.push_back(attribute.accessorIndex);
+            }
+        }
 
-        for (const auto& old_entry : m_primitive_entries) {
-            if (old_entry.index_accessor != primitive_entry.index_accessor) continue;
-            if (old_entry.attribute_accessors != primitive_entry.attribute_accessors) continue;
-            // Found existing entry
-            primitive_entry = old_entry;
-            return;
+        std::vector<std::size_t>& candidates = m_primitive_entries_by_index_accessor[primitive_entry.index_accessor];
+        for (const std::size_t entry_index : candidates) {
+            if (m_primitive_entries[entry_index].attribute_accessors == primitive_entry.attribute_accessors) {
+                return entry_index; // Found existing entry
+            }
         }
 
-        load_new_primitive_geometry(primitive, primitive_entry);
+        const std::size_t entry_index = m_primitive_entries.size();
+        m_primitive_entries.push_back(std::move(primitive_entry));
+        candidates.push_back(entry_index);
+        return entry_index;
+    }
+
+    void collect_primitive_entries()
+    {
+        ERHE_PROFILE_FUNCTION();
+
+        m_mesh_primitive_entries.resize(m_asset->meshes.size());
+        for (std::size_t mesh_index = 0, end = m_asset->meshes.size(); mesh_index < end; ++mesh_index) {
+            const fastgltf::Mesh&     mesh          = m_asset->meshes[mesh_index];
+            std::vector<std::size_t>& entry_indices = m_mesh_primitive_entries[mesh_index];
+            entry_indices.clear();
+            for (const fastgltf::Primitive& primitive : mesh.primitives) {
+                entry_indices.push_back(get_primitive_entry_index(primitive));
+            }
+        }
     }
 
     void parse_primitive(
         const std::shared_ptr<erhe::scene::Mesh>& erhe_mesh,
-        const fastgltf::Mesh&                     mesh,
+        const std::size_t                         mesh_index,
         const std::size_t                         primitive_index
     )
     {
         ERHE_PROFILE_FUNCTION();
 
-        const fastgltf::Primitive& primitive = mesh.primitives[primitive_index];
-        std::string name = fmt::format("{}[{}]", mesh.name.c_str(), primitive_index);
+        const fastgltf::Primitive& primitive = m_asset->meshes[mesh_index].primitives[primitive_index];
         std::shared_ptr<erhe::primitive::Material> erhe_material = primitive.materialIndex.has_value()
             ? m_data_out.materials.at(primitive.materialIndex.value())
             : std::shared_ptr<erhe::primitive::Material>{};
 
-        Primitive_entry primitive_entry;
-        get_primitive_geometry(primitive, primitive_entry);
+        // Triangle soup was built in parse_and_build()
+        const Primitive_entry& primitive_entry = m_primitive_entries.at(m_mesh_primitive_entries.at(mesh_index).at(primitive_index));
 
         erhe::primitive::Primitive new_primitive{primitive_entry.triangle_soup};
         erhe_mesh->add_primitive(new_primitive, erhe_material);
@@ -1353,8 +1503,14 @@ private:
             Item_flags::opaque      |
             Item_flags::id
         );
+        std::size_t morph_target_count = 0;
         for (std::size_t i = 0, end = mesh.primitives.size(); i < end; ++i) {
-            parse_primitive(erhe_mesh, mesh, i);
+            parse_primitive(erhe_mesh, mesh_index, i);
+            morph_target_count = std::max(morph_target_count, mesh.primitives[i].targets.size());
+        }
+        if (morph_target_count > 0) {
+            erhe_mesh->morph_weights.assign(mesh.weights.begin(), mesh.weights.end());
+            erhe_mesh->morph_weights.resize(morph_target_count, 0.0f);
         }
     }
 
@@ -1410,6 +1566,10 @@ private:
                 }
                 erhe_mesh->skin = m_data_out.skins[skin_index];
             }
+            if (!node.weights.empty() && !erhe_mesh->morph_weights.empty()) {
+                const std::size_t weight_count = std::min(node.weights.size(), erhe_mesh->morph_weights.size());
+                std::copy(node.weights.begin(), node.weights.begin() + weight_count, erhe_mesh->morph_weights.begin());
+            }
             erhe_node->attach(erhe_mesh);
         }
     }
@@ -1,9 +1,14 @@
 #pragma once
 
-#include <memory>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::geometry {
     class Geometry;
 }
@@ -69,6 +74,9 @@ enum class Coordinate_system : unsigned int {
     Z_up = 1
 };
 
+// Called with stage name, completed item count and total item count
+using Gltf_progress_callback = std::function<void(std::string_view stage, std::size_t done, std::size_t total)>;
+
 struct Gltf_parse_arguments
 {
     erhe::graphics::Instance&                 graphics_instance;
@@ -76,6 +84,9 @@ struct Gltf_parse_arguments
     const std::shared_ptr<erhe::scene::Node>& root_node;
     erhe::scene::Layer_id                     mesh_layer_id;
     std::filesystem::path                     path;
+    erhe::concurrency::Thread_pool*           thread_pool{nullptr};     // Optional, for image decode and primitive build
+    Gltf_progress_callback                    progress_callback;        // Optional, called from the calling thread
+    bool                                      use_image_cache{false}; // Decoded images with mip chains in cache/images/
     Coordinate_system                         coordinate_system{Coordinate_system::Y_up};
 };
 
@@ -12,6 +12,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -64,6 +65,7 @@ void Buffer::allocate_storage()
     capability_check(m_access_mask);
 
     gl::named_buffer_storage(gl_name(), static_cast<GLintptr>(m_capacity_byte_count), nullptr, m_storage_mask);
+    m_allocator = std::make_shared<Offset_allocator>(m_capacity_byte_count);
     if (erhe::bit::test_all_rhs_bits_set(m_storage_mask, gl::Buffer_storage_mask::map_persistent_bit)) {
         map_bytes(0, m_capacity_byte_count, m_access_mask);
     }
@@ -204,9 +206,9 @@ Buffer::Buffer(Buffer&& other) noexcept
     , m_debug_label           {std::move(other.m_debug_label)}
     , m_target                {other.m_target}
     , m_capacity_byte_count   {other.m_capacity_byte_count}
-    , m_next_free_byte        {other.m_next_free_byte}
     , m_storage_mask          {other.m_storage_mask}
     , m_access_mask           {other.m_access_mask}
+    , m_allocator             {std::move(other.m_allocator)}
     , m_map                   {other.m_map}
     , m_map_byte_offset       {other.m_map_byte_offset}
     , m_map_buffer_access_mask{other.m_map_buffer_access_mask}
@@ -221,9 +223,9 @@ auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
     m_debug_label            = std::move(other.m_debug_label);
     m_target                 = other.m_target;
     m_capacity_byte_count    = other.m_capacity_byte_count;
-    m_next_free_byte         = other.m_next_free_byte;
     m_storage_mask           = other.m_storage_mask;
     m_access_mask            = other.m_access_mask;
+    m_allocator              = std::move(other.m_allocator);
     m_map                    = other.m_map;
     m_map_byte_offset        = other.m_map_byte_offset;
     m_map_buffer_access_mask = other.m_map_buffer_access_mask;
@@ -260,20 +262,67 @@ auto Buffer::debug_label() const noexcept -> const std::string&
 auto Buffer::allocate_bytes(const std::size_t byte_count, const std::size_t alignment) noexcept -> std::size_t
 {
     ERHE_VERIFY(alignment > 0);
+    ERHE_VERIFY(m_allocator);
 
-    const std::lock_guard<std::mutex> lock{m_allocate_mutex};
-
-    while ((m_next_free_byte % alignment) != 0) {
-        ++m_next_free_byte;
-    }
-    const auto offset = m_next_free_byte;
-    m_next_free_byte += byte_count;
-    ERHE_VERIFY(m_next_free_byte <= m_capacity_byte_count);
+    const Offset_allocator::Node node = m_allocator->allocate(byte_count, alignment, true);
+    ERHE_VERIFY(node != Offset_allocator::null_node);
+    const auto offset = m_allocator->get_offset(node);
 
     log_buffer->trace("buffer {}: allocated {} bytes at offset {}", gl_name(), byte_count, offset);
     return offset;
 }
 
+auto Buffer::get_allocator() const noexcept -> const std::shared_ptr<Offset_allocator>&
+{
+    return m_allocator;
+}
+
+auto Buffer::get_statistics() const -> Offset_allocator::Statistics
+{
+    if (!m_allocator) {
+        return {};
+    }
+    return m_allocator->get_statistics();
+}
+
+auto Buffer::compact() -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!m_allocator) {
+        return 0;
+    }
+
+    const std::vector<Offset_allocator::Move> moves = m_allocator->compact();
+    for (const Offset_allocator::Move& move : moves) {
+        // Source and destination must not overlap within a single copy.
+        // Copying front to back in chunks no larger than the move distance
+        // only overwrites bytes that have already been copied.
+        const std::size_t distance = move.old_offset - move.new_offset;
+        for (std::size_t done = 0; done < move.byte_count;) {
+            const std::size_t chunk = std::min(distance, move.byte_count - done);
+            gl::copy_named_buffer_sub_data(
+                gl_name(),
+                gl_name(),
+                static_cast<GLintptr  >(move.old_offset + done),
+                static_cast<GLintptr  >(move.new_offset + done),
+                static_cast<GLsizeiptr>(chunk)
+            );
+            done += chunk;
+        }
+    }
+
+    const Offset_allocator::Statistics statistics = m_allocator->get_statistics();
+    log_buffer->debug(
+        "buffer {}: compacted, moved {} allocations, largest free block {} / {} bytes",
+        gl_name(),
+        moves.size(),
+        statistics.largest_free_byte_count,
+        statistics.free_byte_count
+    );
+    return moves.size();
+}
+
 auto Buffer::begin_write(const std::size_t byte_offset, std::size_t byte_count) noexcept -> std::span<std::byte>
 {
     ERHE_VERIFY(gl_name() != 0);
@@ -598,7 +647,10 @@ void Buffer::flush_and_unmap_bytes(const std::size_t byte_count) noexcept
 
 auto Buffer::free_capacity_bytes() const noexcept -> std::size_t
 {
-    return m_capacity_byte_count - m_next_free_byte;
+    if (!m_allocator) {
+        return 0;
+    }
+    return m_allocator->get_statistics().free_byte_count;
 }
 
 auto Buffer::capacity_byte_count() const noexcept -> std::size_t
@@ -606,6 +658,51 @@ auto Buffer::capacity_byte_count() const noexcept -> std::size_t
     return m_capacity_byte_count;
 }
 
+Buffer_allocation::Buffer_allocation(Buffer& buffer, const std::size_t byte_count, const std::size_t alignment)
+    : m_allocator {buffer.get_allocator()}
+    , m_byte_count{byte_count}
+{
+    ERHE_VERIFY(alignment > 0);
+
+    const std::shared_ptr<Offset_allocator> allocator = m_allocator.lock();
+    if (!allocator) {
+        return;
+    }
+    m_node = allocator->allocate(byte_count, alignment, false);
+    if (m_node == Offset_allocator::null_node) {
+        log_buffer->warn("buffer {}: failed to allocate {} bytes", buffer.gl_name(), byte_count);
+    }
+}
+
+Buffer_allocation::~Buffer_allocation() noexcept
+{
+    if (m_node == Offset_allocator::null_node) {
+        return;
+    }
+    const std::shared_ptr<Offset_allocator> allocator = m_allocator.lock();
+    if (allocator) {
+        allocator->free(m_node);
+    }
+}
+
+auto Buffer_allocation::is_valid() const -> bool
+{
+    return m_node != Offset_allocator::null_node;
+}
+
+auto Buffer_allocation::get_byte_offset() const -> std::size_t
+{
+    ERHE_VERIFY(m_node != Offset_allocator::null_node);
+    const std::shared_ptr<Offset_allocator> allocator = m_allocator.lock();
+    ERHE_VERIFY(allocator);
+    return allocator->get_offset(m_node);
+}
+
+auto Buffer_allocation::get_byte_count() const -> std::size_t
+{
+    return m_byte_count;
+}
+
 auto operator==(const Buffer& lhs, const Buffer& rhs) noexcept -> bool
 {
     return lhs.gl_name() == rhs.gl_name();
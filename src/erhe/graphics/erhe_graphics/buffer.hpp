@@ -1,11 +1,12 @@
 #pragma once
 
 #include "erhe_graphics/gl_objects.hpp"
+#include "erhe_graphics/offset_allocator.hpp"
 #include "erhe_graphics/span.hpp"
 
 #include "erhe_dataformat/dataformat.hpp"
 
-#include <mutex>
+#include <memory>
 #include <span>
 #include <string>
 #include <string_view>
@@ -67,8 +68,10 @@ public:
     [[nodiscard]] auto map                () const          -> std::span<std::byte>;
     [[nodiscard]] auto debug_label        () const noexcept -> const std::string&;
     [[nodiscard]] auto capacity_byte_count() const noexcept -> std::size_t;
-    [[nodiscard]] auto allocate_bytes     (std::size_t byte_count, std::size_t alignment = 64) noexcept -> std::size_t;
+    [[nodiscard]] auto allocate_bytes     (std::size_t byte_count, std::size_t alignment = 64) noexcept -> std::size_t; // never moved or freed
     [[nodiscard]] auto free_capacity_bytes() const noexcept -> std::size_t;
+    [[nodiscard]] auto get_allocator      () const noexcept -> const std::shared_ptr<Offset_allocator>&;
+    [[nodiscard]] auto get_statistics     () const          -> Offset_allocator::Statistics;
     [[nodiscard]] auto target             () const noexcept -> gl::Buffer_target;
     [[nodiscard]] auto gl_name            () const noexcept -> unsigned int;
     void unmap                () noexcept;
@@ -97,6 +100,13 @@ public:
         );
     }
 
+    // Moves movable allocations (Buffer_allocation) towards the start of
+    // the buffer, merging free space. Buffer contents are moved with GPU
+    // copies. Must be called from the thread owning the GL context, when
+    // there are no pending transfers to the buffer. Returns number of moved
+    // allocations.
+    auto compact() -> std::size_t;
+
     auto map_all_bytes(const gl::Map_buffer_access_mask access_mask) noexcept -> std::span<std::byte>;
 
     auto map_bytes(
@@ -113,23 +123,43 @@ private:
     void capability_check(gl::Buffer_storage_mask storage_mask);
     void capability_check(gl::Map_buffer_access_mask access_mask);
 
-    Instance&                  m_instance;
-    Gl_buffer                  m_handle;
-    std::string                m_debug_label;
-    gl::Buffer_target          m_target             {gl::Buffer_target::array_buffer};
-    std::size_t                m_capacity_byte_count{0};
-    std::size_t                m_next_free_byte     {0};
-    gl::Buffer_storage_mask    m_storage_mask       {0};
-    gl::Map_buffer_access_mask m_access_mask        {0};
-    std::mutex                 m_allocate_mutex;
+    Instance&                         m_instance;
+    Gl_buffer                         m_handle;
+    std::string                       m_debug_label;
+    gl::Buffer_target                 m_target             {gl::Buffer_target::array_buffer};
+    std::size_t                       m_capacity_byte_count{0};
+    gl::Buffer_storage_mask           m_storage_mask       {0};
+    gl::Map_buffer_access_mask        m_access_mask        {0};
+    std::shared_ptr<Offset_allocator> m_allocator;
 
     // Last MapBuffer
-    std::span<std::byte>       m_map;
-    std::size_t                m_map_byte_offset       {0};
-    gl::Map_buffer_access_mask m_map_buffer_access_mask{0};
+    std::span<std::byte>              m_map;
+    std::size_t                       m_map_byte_offset       {0};
+    gl::Map_buffer_access_mask        m_map_buffer_access_mask{0};
     //std::vector<uint8_t>       m_cpu_copy;
 };
 
+// Movable range of buffer memory. The range is returned to the buffer when
+// the Buffer_allocation is destroyed. The offset can change when the buffer
+// is compacted, so it should be queried with get_byte_offset() when used.
+class Buffer_allocation
+{
+public:
+    Buffer_allocation(Buffer& buffer, std::size_t byte_count, std::size_t alignment = 64);
+    ~Buffer_allocation() noexcept;
+    Buffer_allocation        (const Buffer_allocation&) = delete;
+    void operator=           (const Buffer_allocation&) = delete;
+
+    [[nodiscard]] auto is_valid       () const -> bool;
+    [[nodiscard]] auto get_byte_offset() const -> std::size_t;
+    [[nodiscard]] auto get_byte_count () const -> std::size_t;
+
+private:
+    std::weak_ptr<Offset_allocator> m_allocator;
+    Offset_allocator::Node          m_node      {Offset_allocator::null_node};
+    std::size_t                     m_byte_count{0};
+};
+
 class Buffer_hash
 {
 public:
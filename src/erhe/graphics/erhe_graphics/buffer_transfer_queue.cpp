@@ -3,20 +3,66 @@
 #include "erhe_graphics/buffer_transfer_queue.hpp"
 #include "erhe_gl/enum_bit_mask_operators.hpp"
 #include "erhe_gl/enum_string_functions.hpp"
+#include "erhe_gl/wrapper_functions.hpp"
 #include "erhe_graphics/buffer.hpp"
 #include "erhe_graphics/graphics_log.hpp"
+#include "erhe_graphics/instance.hpp"
 #include "erhe_graphics/scoped_buffer_mapping.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 namespace erhe::graphics {
 
+namespace {
+
+constexpr gl::Buffer_storage_mask staging_storage_mask{
+    gl::Buffer_storage_mask::map_coherent_bit   |
+    gl::Buffer_storage_mask::map_persistent_bit |
+    gl::Buffer_storage_mask::map_write_bit
+};
+constexpr gl::Map_buffer_access_mask staging_access_mask{
+    gl::Map_buffer_access_mask::map_coherent_bit   |
+    gl::Map_buffer_access_mask::map_persistent_bit |
+    gl::Map_buffer_access_mask::map_write_bit
+};
+
+// Reservations are written by producers, keep them cache line aligned.
+// Data staged in flush() is packed so that adjacent entries can be
+// copied with a single copy.
+constexpr std::size_t s_reserve_alignment = 64;
+constexpr std::size_t s_flush_alignment   = 1;
+
+}
+
 Buffer_transfer_queue::Buffer_transfer_queue()
 {
 }
 
+Buffer_transfer_queue::Buffer_transfer_queue(Instance& instance, const std::size_t staging_byte_count)
+{
+    if (!instance.info.use_persistent_buffers || (staging_byte_count == 0)) {
+        log_buffer->info("Buffer_transfer_queue: persistent buffers not in use, staging buffer disabled");
+        return;
+    }
+
+    m_staging_buffer = std::make_unique<Buffer>(
+        instance,
+        gl::Buffer_target::copy_read_buffer,
+        staging_byte_count,
+        staging_storage_mask,
+        staging_access_mask,
+        "Buffer_transfer_queue staging"
+    );
+    m_staging_map = m_staging_buffer->map();
+    ERHE_VERIFY(m_staging_map.size() == staging_byte_count);
+}
+
 Buffer_transfer_queue::~Buffer_transfer_queue() noexcept
 {
     // flush(); TODO causes GL errors in shutdown, investigate
@@ -25,7 +71,17 @@ Buffer_transfer_queue::~Buffer_transfer_queue() noexcept
 void Buffer_transfer_queue::enqueue(Buffer& buffer, const std::size_t offset, std::vector<uint8_t>&& data)
 {
     const std::lock_guard<std::mutex> lock{m_mutex};
+    enqueue_locked(buffer, offset, std::move(data));
+}
 
+void Buffer_transfer_queue::enqueue(Buffer& buffer, const Buffer_allocation& allocation, std::vector<uint8_t>&& data)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    enqueue_locked(buffer, allocation.get_byte_offset(), std::move(data));
+}
+
+void Buffer_transfer_queue::enqueue_locked(Buffer& buffer, const std::size_t offset, std::vector<uint8_t>&& data)
+{
     SPDLOG_LOGGER_TRACE(
         log_buffer,
         "queued buffer {} transfer offset = {} size = {}",
@@ -36,32 +92,315 @@ void Buffer_transfer_queue::enqueue(Buffer& buffer, const std::size_t offset, st
     m_queued.emplace_back(buffer, offset, std::move(data));
 }
 
+auto Buffer_transfer_queue::reserve(Buffer& buffer, const std::size_t offset, const std::size_t byte_count) -> std::span<uint8_t>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return reserve_locked(buffer, offset, byte_count);
+}
+
+auto Buffer_transfer_queue::reserve(Buffer& buffer, const Buffer_allocation& allocation, const std::size_t byte_count) -> std::span<uint8_t>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return reserve_locked(buffer, allocation.get_byte_offset(), byte_count);
+}
+
+auto Buffer_transfer_queue::reserve_locked(Buffer& buffer, const std::size_t offset, const std::size_t byte_count) -> std::span<uint8_t>
+{
+    // Empty span means no reservation was made; nothing to commit
+    if (!m_staging_buffer || (byte_count == 0)) {
+        return {};
+    }
+
+    uint64_t          region{0};
+    const std::size_t staging_offset = allocate_staging(byte_count, s_reserve_alignment, region);
+    if (staging_offset == s_no_staging) {
+        return {};
+    }
+
+    SPDLOG_LOGGER_TRACE(
+        log_buffer,
+        "reserved buffer {} transfer offset = {} size = {} staging offset = {}",
+        buffer.gl_name(),
+        offset,
+        byte_count,
+        staging_offset
+    );
+    m_queued.emplace_back(buffer, offset, byte_count, staging_offset, region);
+    return std::span<uint8_t>{reinterpret_cast<uint8_t*>(m_staging_map.data() + staging_offset), byte_count};
+}
+
+void Buffer_transfer_queue::commit(const std::span<uint8_t> reserved)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    ERHE_VERIFY(!m_staging_map.empty());
+    const std::size_t staging_offset = static_cast<std::size_t>(
+        reinterpret_cast<const std::byte*>(reserved.data()) - m_staging_map.data()
+    );
+    for (auto i = m_queued.rbegin(), end = m_queued.rend(); i != end; ++i) {
+        if (!i->committed && (i->staging_offset == staging_offset)) {
+            ERHE_VERIFY(i->byte_count == reserved.size());
+            i->committed = true;
+            return;
+        }
+    }
+    ERHE_FATAL("Buffer_transfer_queue::commit(): reservation not found");
+}
+
+auto Buffer_transfer_queue::compact(Buffer& buffer) -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Meshes built on worker threads may have reserved or enqueued transfers
+    // since the last flush(); those are flushed first, compaction waits.
+    for (const Transfer_entry& entry : m_queued) {
+        if (entry.target == &buffer) {
+            return 0;
+        }
+    }
+    return buffer.compact();
+}
+
+auto Buffer_transfer_queue::get_statistics() const -> Statistics
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    return m_statistics;
+}
+
+auto Buffer_transfer_queue::allocate_staging(
+    const std::size_t byte_count,
+    const std::size_t alignment,
+    uint64_t&         out_region
+) -> std::size_t
+{
+    const std::size_t capacity = m_staging_map.size();
+    if ((byte_count == 0) || (byte_count > capacity)) {
+        return s_no_staging;
+    }
+
+    // Live regions are [tail, head) when head > tail, and [tail, capacity)
+    // and [0, head) after head has wrapped. head == tail means full unless
+    // there are no regions.
+    std::size_t begin = ((m_staging_head + alignment - 1) / alignment) * alignment;
+    if (m_staging_regions.empty() || (m_staging_head > m_staging_tail)) {
+        if (begin + byte_count > capacity) {
+            begin = 0;
+            if (!m_staging_regions.empty() && (byte_count > m_staging_tail)) {
+                return s_no_staging;
+            }
+        }
+    } else if (begin + byte_count > m_staging_tail) {
+        return s_no_staging;
+    }
+
+    m_staging_regions.push_back(
+        Staging_region{
+            .begin        = begin,
+            .end          = begin + byte_count,
+            .flush_serial = 0
+        }
+    );
+    out_region     = m_staging_region_base + m_staging_regions.size() - 1;
+    m_staging_head = begin + byte_count;
+    return begin;
+}
+
+void Buffer_transfer_queue::retire_staging()
+{
+    while (!m_fences.empty()) {
+        const Fence&          fence  = m_fences.front();
+        const gl::Sync_status status = gl::client_wait_sync(fence.sync, static_cast<gl::Sync_object_mask>(0), 0);
+        if ((status != gl::Sync_status::already_signaled) && (status != gl::Sync_status::condition_satisfied)) {
+            break;
+        }
+        m_completed_serial = fence.flush_serial;
+        gl::delete_sync(fence.sync);
+        m_fences.pop_front();
+    }
+
+    // Regions are retired in allocation order; a region which has not been
+    // committed and flushed yet keeps later regions alive.
+    while (!m_staging_regions.empty()) {
+        const Staging_region& region = m_staging_regions.front();
+        if ((region.flush_serial == 0) || (region.flush_serial > m_completed_serial)) {
+            break;
+        }
+        m_staging_regions.pop_front();
+        ++m_staging_region_base;
+    }
+
+    if (m_staging_regions.empty()) {
+        m_staging_head = 0;
+        m_staging_tail = 0;
+    } else {
+        m_staging_tail = m_staging_regions.front().begin;
+    }
+}
+
+void Buffer_transfer_queue::flush_mapped(const std::span<Transfer_entry> entries)
+{
+    const Transfer_entry& first      = entries.front();
+    const Transfer_entry& last       = entries.back();
+    const std::size_t     byte_count = last.target_offset + last.byte_count - first.target_offset;
+
+    SPDLOG_LOGGER_TRACE(
+        log_buffer,
+        "buffer upload {} {} transfer offset = {} size = {} entries = {}",
+        gl::c_str(first.target->target()),
+        first.target->gl_name(),
+        first.target_offset,
+        byte_count,
+        entries.size()
+    );
+    Scoped_buffer_mapping<uint8_t> scoped_mapping{
+        *first.target,
+        first.target_offset,
+        byte_count,
+        gl::Map_buffer_access_mask::map_invalidate_range_bit |
+        gl::Map_buffer_access_mask::map_write_bit
+    };
+    const auto& destination = scoped_mapping.span();
+    for (const Transfer_entry& entry : entries) {
+        memcpy(destination.data() + (entry.target_offset - first.target_offset), entry.data.data(), entry.byte_count);
+    }
+}
+
 void Buffer_transfer_queue::flush()
 {
     ERHE_PROFILE_FUNCTION();
 
     const std::lock_guard<std::mutex> lock{m_mutex};
 
-    for (const auto& entry : m_queued) {
-        SPDLOG_LOGGER_TRACE(
-            log_buffer,
-            "buffer upload {} {} transfer offset = {} size = {}",
-            gl::c_str(entry.target.target()),
-            entry.target.gl_name(),
-            entry.target_offset,
-            entry.data.size()
+    const auto start_time = std::chrono::steady_clock::now();
+
+    if (m_staging_buffer) {
+        retire_staging();
+    }
+
+    // Reservations which have not been committed yet stay in queue
+    std::vector<Transfer_entry> entries;
+    {
+        std::vector<Transfer_entry> pending;
+        entries.reserve(m_queued.size());
+        for (Transfer_entry& entry : m_queued) {
+            if (entry.committed) {
+                entries.push_back(std::move(entry));
+            } else {
+                pending.push_back(std::move(entry));
+            }
+        }
+        m_queued = std::move(pending);
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    // Group entries by target buffer. Entries for the same buffer keep their
+    // order, so later entries still overwrite earlier overlapping entries.
+    std::stable_sort(
+        entries.begin(),
+        entries.end(),
+        [](const Transfer_entry& lhs, const Transfer_entry& rhs) {
+            return lhs.target->gl_name() < rhs.target->gl_name();
+        }
+    );
+
+    ++m_flush_serial;
+
+    // Move enqueued data to staging buffer when there is room
+    std::size_t staged_byte_count{0};
+    std::size_t total_byte_count {0};
+    for (Transfer_entry& entry : entries) {
+        total_byte_count += entry.byte_count;
+        if (m_staging_buffer && (entry.staging_offset == s_no_staging)) {
+            const std::size_t staging_offset = allocate_staging(entry.byte_count, s_flush_alignment, entry.staging_region);
+            if (staging_offset != s_no_staging) {
+                memcpy(m_staging_map.data() + staging_offset, entry.data.data(), entry.byte_count);
+                entry.staging_offset = staging_offset;
+                entry.data           = std::vector<uint8_t>{};
+            }
+        }
+        if (entry.staging_offset != s_no_staging) {
+            staged_byte_count += entry.byte_count;
+        }
+    }
+
+    // Upload runs of entries which are adjacent in target buffer (and in
+    // staging buffer) with a single copy or mapping
+    std::size_t copy_count{0};
+    bool        used_staging{false};
+    for (std::size_t i = 0, end = entries.size(); i < end;) {
+        const bool  staged = entries[i].staging_offset != s_no_staging;
+        std::size_t j      = i + 1;
+        for (; j < end; ++j) {
+            const Transfer_entry& previous = entries[j - 1];
+            const Transfer_entry& next     = entries[j];
+            if (
+                (next.target != previous.target) ||
+                ((next.staging_offset != s_no_staging) != staged) ||
+                (next.target_offset != previous.target_offset + previous.byte_count) ||
+                (staged && (next.staging_offset != previous.staging_offset + previous.byte_count))
+            ) {
+                break;
+            }
+        }
+
+        const std::span<Transfer_entry> run{entries.data() + i, j - i};
+        if (staged) {
+            const Transfer_entry& first = run.front();
+            const Transfer_entry& last  = run.back();
+            SPDLOG_LOGGER_TRACE(
+                log_buffer,
+                "buffer copy {} {} transfer offset = {} size = {} staging offset = {} entries = {}",
+                gl::c_str(first.target->target()),
+                first.target->gl_name(),
+                first.target_offset,
+                last.target_offset + last.byte_count - first.target_offset,
+                first.staging_offset,
+                run.size()
+            );
+            gl::copy_named_buffer_sub_data(
+                m_staging_buffer->gl_name(),
+                first.target->gl_name(),
+                static_cast<GLintptr>(first.staging_offset),
+                static_cast<GLintptr>(first.target_offset),
+                static_cast<GLsizeiptr>(last.target_offset + last.byte_count - first.target_offset)
+            );
+            for (const Transfer_entry& entry : run) {
+                m_staging_regions[entry.staging_region - m_staging_region_base].flush_serial = m_flush_serial;
+            }
+            used_staging = true;
+        } else {
+            flush_mapped(run);
+        }
+        ++copy_count;
+        i = j;
+    }
+
+    if (used_staging) {
+        m_fences.push_back(
+            Fence{
+                .flush_serial = m_flush_serial,
+                .sync         = gl::fence_sync(gl::Sync_condition::sync_gpu_commands_complete, 0)
+            }
         );
-        Scoped_buffer_mapping<uint8_t> scoped_mapping{
-            entry.target,
-            entry.target_offset,
-            entry.data.size(),
-            gl::Map_buffer_access_mask::map_invalidate_range_bit |
-            gl::Map_buffer_access_mask::map_write_bit
-        };
-        auto& destination = scoped_mapping.span();
-        memcpy(destination.data(), entry.data.data(), entry.data.size());
-    }
-    m_queued.clear();
+    }
+
+    const auto   end_time = std::chrono::steady_clock::now();
+    const double time_ms  = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    ++m_statistics.flush_count;
+    m_statistics.total_byte_count   += total_byte_count;
+    m_statistics.entry_count         = entries.size();
+    m_statistics.copy_count          = copy_count;
+    m_statistics.byte_count          = total_byte_count;
+    m_statistics.staged_byte_count   = staged_byte_count;
+    m_statistics.flush_cpu_time_ms   = time_ms;
+    m_statistics.throughput_mb_per_s = (time_ms > 0.0)
+        ? (static_cast<double>(total_byte_count) / (1024.0 * 1024.0)) / (time_ms / 1000.0)
+        : 0.0;
 }
 
 } // namespace erhe::graphics
@@ -1,55 +1,162 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <vector>
 
+typedef struct __GLsync *GLsync;
+
 namespace erhe::graphics {
 
 class Buffer;
+class Buffer_allocation;
+class Instance;
 
 class Buffer_transfer_queue final
 {
 public:
+    // Without staging buffer, flush() maps target buffers directly
     Buffer_transfer_queue();
+
+    // With staging buffer, data is written to a persistently mapped staging
+    // ring and flush() copies it to target buffers on the GPU. Ring regions
+    // are reused after the GPU has completed the copies (fence).
+    Buffer_transfer_queue(Instance& instance, std::size_t staging_byte_count);
+
     ~Buffer_transfer_queue() noexcept;
     Buffer_transfer_queue(Buffer_transfer_queue&) = delete;
     auto operator=(Buffer_transfer_queue&) -> Buffer_transfer_queue& = delete;
 
+    static constexpr std::size_t s_no_staging = ~std::size_t{0};
+
     class Transfer_entry
     {
     public:
         Transfer_entry(Buffer& target, const std::size_t target_offset, std::vector<uint8_t>&& data)
-            : target       {target}
+            : target       {&target}
             , target_offset{target_offset}
-            , data         {data}
+            , byte_count   {data.size()}
+            , data         {std::move(data)}
         {
         }
 
-        Transfer_entry(Transfer_entry&) = delete;
-        void operator=(Transfer_entry&) = delete;
-
-        Transfer_entry(Transfer_entry&& other) noexcept
-            : target       {other.target}
-            , target_offset{other.target_offset}
-            , data         {std::move(other.data)}
+        Transfer_entry(
+            Buffer&           target,
+            const std::size_t target_offset,
+            const std::size_t byte_count,
+            const std::size_t staging_offset,
+            const uint64_t    staging_region
+        )
+            : target        {&target}
+            , target_offset {target_offset}
+            , byte_count    {byte_count}
+            , staging_offset{staging_offset}
+            , staging_region{staging_region}
+            , committed     {false}
         {
         }
 
-        auto operator=(Transfer_entry&& other) = delete;
+        Buffer*              target        {nullptr};
+        std::size_t          target_offset {0};
+        std::size_t          byte_count    {0};
+        std::size_t          staging_offset{s_no_staging}; // set when data is in staging buffer
+        uint64_t             staging_region{0};
+        bool                 committed     {true};
+        std::vector<uint8_t> data;                         // used when staging_offset is not set
+    };
 
-        Buffer&              target;
-        std::size_t          target_offset{0};
-        std::vector<uint8_t> data;
+    class Statistics
+    {
+    public:
+        std::size_t flush_count       {0};
+        std::size_t total_byte_count  {0};
+        // Last flush
+        std::size_t entry_count       {0};
+        std::size_t copy_count        {0}; // after coalescing adjacent entries
+        std::size_t byte_count        {0};
+        std::size_t staged_byte_count {0}; // bytes copied through staging buffer
+        double      flush_cpu_time_ms {0.0};
+        double      throughput_mb_per_s{0.0};
     };
 
+    // Must be called from the thread owning the GL context
     void flush();
 
     void enqueue(Buffer& buffer, std::size_t offset, std::vector<uint8_t>&& data);
 
+    // Reserves staging memory for byte_count bytes that will be uploaded
+    // to buffer at offset. Data written to the returned span is uploaded
+    // by the first flush() after commit(). Returns an empty span if there
+    // is no staging buffer, not enough free staging memory or byte_count is
+    // zero; use enqueue() then. Empty spans must not be committed. Can be
+    // called from any thread.
+    [[nodiscard]] auto reserve(Buffer& buffer, std::size_t offset, std::size_t byte_count) -> std::span<uint8_t>;
+    void commit(std::span<uint8_t> reserved);
+
+    // As above, with offset taken from allocation while holding the queue
+    // lock, so that compact() cannot move the allocation in between.
+    void enqueue(Buffer& buffer, const Buffer_allocation& allocation, std::vector<uint8_t>&& data);
+    [[nodiscard]] auto reserve(Buffer& buffer, const Buffer_allocation& allocation, std::size_t byte_count) -> std::span<uint8_t>;
+
+    // Compacts buffer with Buffer::compact(). Queued transfers and
+    // reservations hold byte offsets from before compaction, so compaction
+    // is skipped while any transfer to the buffer is queued. Transfers
+    // queued through the Buffer_allocation overloads are safe to queue from
+    // other threads while compacting. Must be called from the thread owning
+    // the GL context, after flush(). Returns number of moved allocations.
+    auto compact(Buffer& buffer) -> std::size_t;
+
+    [[nodiscard]] auto get_statistics() const -> Statistics;
+
 private:
-    std::mutex                  m_mutex;
+    class Copy
+    {
+    public:
+        Buffer*     target        {nullptr};
+        std::size_t target_offset {0};
+        std::size_t staging_offset{0};
+        std::size_t byte_count    {0};
+    };
+
+    class Staging_region
+    {
+    public:
+        std::size_t begin        {0};
+        std::size_t end          {0};
+        uint64_t    flush_serial {0}; // 0 until copies from the region have been submitted
+    };
+
+    class Fence
+    {
+    public:
+        uint64_t flush_serial{0};
+        GLsync   sync        {nullptr};
+    };
+
+    // Returns s_no_staging if there is not enough free staging memory
+    [[nodiscard]] auto allocate_staging(std::size_t byte_count, std::size_t alignment, uint64_t& out_region) -> std::size_t;
+    void retire_staging();
+    void flush_mapped(std::span<Transfer_entry> entries);
+    void enqueue_locked(Buffer& buffer, std::size_t offset, std::vector<uint8_t>&& data);
+    [[nodiscard]] auto reserve_locked(Buffer& buffer, std::size_t offset, std::size_t byte_count) -> std::span<uint8_t>;
+
+    mutable std::mutex          m_mutex;
     std::vector<Transfer_entry> m_queued;
-};
+    Statistics                  m_statistics;
 
+    std::unique_ptr<Buffer>     m_staging_buffer;
+    std::span<std::byte>        m_staging_map;
+    std::size_t                 m_staging_head{0};
+    std::size_t                 m_staging_tail{0};
+    std::deque<Staging_region>  m_staging_regions;
+    uint64_t                    m_staging_region_base{0}; // region id of m_staging_regions.front()
+    std::deque<Fence>           m_fences;
+    uint64_t                    m_flush_serial       {0};
+    uint64_t                    m_completed_serial   {0};
+};
 
 } // namespace erhe::graphics
@@ -0,0 +1,159 @@
+#include "erhe_graphics/image_cache.hpp"
+#include "erhe_graphics/graphics_log.hpp"
+#include "erhe_graphics/image_mip_chain.hpp"
+#include "erhe_hash/hash.hpp"
+#include "erhe_profile/profile.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace erhe::graphics {
+
+namespace {
+
+constexpr uint32_t s_image_cache_magic  {0x43494845u}; // "EHIC"
+constexpr uint32_t s_image_cache_version{1};
+
+class Image_cache_header
+{
+public:
+    uint32_t magic      {s_image_cache_magic};
+    uint32_t version    {s_image_cache_version};
+    uint32_t format     {0};
+    uint32_t level_count{0};
+    uint32_t width      {0};
+    uint32_t height     {0};
+    uint64_t byte_count {0};
+};
+
+[[nodiscard]] auto get_image_cache_path(const uint64_t key) -> std::filesystem::path
+{
+    return std::filesystem::path{"cache"} / "images" / fmt::format("{:016x}", key);
+}
+
+} // anonymous namespace
+
+auto get_image_cache_key(const std::span<const std::uint8_t> encoded_data) -> uint64_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Version is part of the key, so old entries are not reused when
+    // mip chain generation changes.
+    const uint64_t seed = erhe::hash::hash(&s_image_cache_version, sizeof(s_image_cache_version));
+    return erhe::hash::hash(encoded_data.data(), encoded_data.size_bytes(), seed);
+}
+
+auto load_cached_image(const uint64_t key, Image_mip_chain& mip_chain) -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::ifstream in{get_image_cache_path(key), std::ifstream::binary};
+    if (!in) {
+        return false;
+    }
+
+    Image_cache_header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (
+        !in ||
+        (header.magic   != s_image_cache_magic) ||
+        (header.version != s_image_cache_version) ||
+        (header.format  >  static_cast<uint32_t>(Image_format::srgb8_alpha8)) ||
+        (header.width   == 0) ||
+        (header.height  == 0)
+    ) {
+        log_texture->warn("Ignoring invalid image cache entry {:016x}", key);
+        return false;
+    }
+
+    // Rebuild level layout and check that it matches the stored byte count
+    Image_mip_chain loaded;
+    loaded.format = static_cast<Image_format>(header.format);
+    const std::size_t pixel_byte_count = get_pixel_byte_count(loaded.format);
+    std::size_t byte_offset = 0;
+    for (int width = static_cast<int>(header.width), height = static_cast<int>(header.height);;) {
+        const std::size_t byte_count = static_cast<std::size_t>(width) * height * pixel_byte_count;
+        loaded.levels.push_back(
+            Image_level{
+                .width       = width,
+                .height      = height,
+                .byte_offset = byte_offset,
+                .byte_count  = byte_count
+            }
+        );
+        byte_offset += byte_count;
+        if ((width == 1) && (height == 1)) {
+            break;
+        }
+        width  = std::max(width  / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    if ((loaded.levels.size() != header.level_count) || (byte_offset != header.byte_count)) {
+        log_texture->warn("Ignoring invalid image cache entry {:016x}", key);
+        return false;
+    }
+
+    loaded.data.resize(byte_offset);
+    in.read(reinterpret_cast<char*>(loaded.data.data()), static_cast<std::streamsize>(byte_offset));
+    if (!in) {
+        log_texture->warn("Ignoring truncated image cache entry {:016x}", key);
+        return false;
+    }
+    mip_chain = std::move(loaded);
+    return true;
+}
+
+auto save_cached_image(const uint64_t key, const Image_mip_chain& mip_chain) -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (mip_chain.levels.empty()) {
+        return false;
+    }
+
+    const std::filesystem::path path = get_image_cache_path(key);
+    std::error_code error_code;
+    std::filesystem::create_directories(path.parent_path(), error_code);
+    if (error_code) {
+        return false;
+    }
+
+    // Written to temporary file first, so that readers never see partial
+    // entries, even when the same image is saved from several threads.
+    const std::filesystem::path temp_path = std::filesystem::path{path}.replace_extension(
+        fmt::format("{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()))
+    );
+    {
+        std::ofstream out{temp_path, std::ofstream::binary | std::ofstream::trunc};
+        if (!out) {
+            return false;
+        }
+        const Image_cache_header header{
+            .format      = static_cast<uint32_t>(mip_chain.format),
+            .level_count = static_cast<uint32_t>(mip_chain.levels.size()),
+            .width       = static_cast<uint32_t>(mip_chain.levels.front().width),
+            .height      = static_cast<uint32_t>(mip_chain.levels.front().height),
+            .byte_count  = static_cast<uint64_t>(mip_chain.data.size())
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mip_chain.data.data()), static_cast<std::streamsize>(mip_chain.data.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp_path, error_code);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code) {
+        std::filesystem::remove(temp_path, error_code);
+        return false;
+    }
+    return true;
+}
+
+} // namespace erhe::graphics
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace erhe::graphics {
+
+class Image_mip_chain;
+
+// On-disk cache for decoded images with mip chains, in cache/images/.
+// Entries are keyed by hash of the encoded (PNG, JPEG, ...) source bytes,
+// so a cache hit skips decode and mip chain generation. Functions can be
+// called from any thread.
+[[nodiscard]] auto get_image_cache_key(std::span<const std::uint8_t> encoded_data) -> uint64_t;
+[[nodiscard]] auto load_cached_image  (uint64_t key, Image_mip_chain& mip_chain) -> bool;
+auto save_cached_image                (uint64_t key, const Image_mip_chain& mip_chain) -> bool;
+
+} // namespace erhe::graphics
@@ -0,0 +1,169 @@
+#include "erhe_graphics/image_mip_chain.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace erhe::graphics {
+
+namespace {
+
+constexpr std::size_t s_linear_to_srgb_table_size = 4096;
+
+class Srgb_tables
+{
+public:
+    Srgb_tables()
+    {
+        for (std::size_t i = 0; i < srgb_to_linear.size(); ++i) {
+            const float c = static_cast<float>(i) / 255.0f;
+            srgb_to_linear[i] = (c <= 0.04045f)
+                ? c / 12.92f
+                : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (std::size_t i = 0; i < linear_to_srgb.size(); ++i) {
+            const float l = static_cast<float>(i) / static_cast<float>(s_linear_to_srgb_table_size - 1);
+            const float c = (l <= 0.0031308f)
+                ? l * 12.92f
+                : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            linear_to_srgb[i] = static_cast<std::uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    }
+
+    std::array<float, 256>                                 srgb_to_linear;
+    std::array<std::uint8_t, s_linear_to_srgb_table_size> linear_to_srgb;
+};
+
+[[nodiscard]] auto get_srgb_tables() -> const Srgb_tables&
+{
+    static const Srgb_tables tables;
+    return tables;
+}
+
+[[nodiscard]] auto encode(const Srgb_tables& tables, const float value, const bool is_alpha) -> std::uint8_t
+{
+    const float clamped = std::clamp(value, 0.0f, 1.0f);
+    if (is_alpha) {
+        return static_cast<std::uint8_t>(clamped * 255.0f + 0.5f);
+    }
+    return tables.linear_to_srgb[static_cast<std::size_t>(clamped * static_cast<float>(s_linear_to_srgb_table_size - 1) + 0.5f)];
+}
+
+// Channel count is a template parameter so that inner loops have fixed
+// trip count and can be vectorized by the compiler.
+template <std::size_t channel_count>
+void downsample(
+    const float* const source,
+    const int          source_width,
+    const int          source_height,
+    float* const       destination,
+    const int          destination_width,
+    const int          destination_height
+)
+{
+    const std::size_t source_stride = static_cast<std::size_t>(source_width) * channel_count;
+    for (int y = 0; y < destination_height; ++y) {
+        const float* const row_0 = source + static_cast<std::size_t>(std::min(2 * y,     source_height - 1)) * source_stride;
+        const float* const row_1 = source + static_cast<std::size_t>(std::min(2 * y + 1, source_height - 1)) * source_stride;
+        float* const       out   = destination + static_cast<std::size_t>(y) * destination_width * channel_count;
+        for (int x = 0; x < destination_width; ++x) {
+            const std::size_t x0 = static_cast<std::size_t>(std::min(2 * x,     source_width - 1)) * channel_count;
+            const std::size_t x1 = static_cast<std::size_t>(std::min(2 * x + 1, source_width - 1)) * channel_count;
+            for (std::size_t c = 0; c < channel_count; ++c) {
+                out[x * channel_count + c] = 0.25f * (row_0[x0 + c] + row_0[x1 + c] + row_1[x0 + c] + row_1[x1 + c]);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+auto Image_mip_chain::get_level_data(const std::size_t level) const -> std::span<const std::uint8_t>
+{
+    const Image_level& image_level = levels.at(level);
+    ERHE_VERIFY(image_level.byte_offset + image_level.byte_count <= data.size());
+    return std::span<const std::uint8_t>{data.data() + image_level.byte_offset, image_level.byte_count};
+}
+
+auto get_pixel_byte_count(const Image_format format) -> std::size_t
+{
+    switch (format) {
+        case Image_format::srgb8:        return 3;
+        case Image_format::srgb8_alpha8: return 4;
+        default: {
+            ERHE_FATAL("Bad image format");
+        }
+    }
+}
+
+void make_mip_chain(
+    const Image_info&                   image_info,
+    const std::span<const std::uint8_t> level_0_data,
+    Image_mip_chain&                    mip_chain
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t channel_count = get_pixel_byte_count(image_info.format);
+    ERHE_VERIFY(image_info.width >= 1);
+    ERHE_VERIFY(image_info.height >= 1);
+    ERHE_VERIFY(level_0_data.size() >= static_cast<std::size_t>(image_info.width) * image_info.height * channel_count);
+
+    mip_chain.format = image_info.format;
+    mip_chain.levels.clear();
+    std::size_t total_byte_count = 0;
+    for (int width = image_info.width, height = image_info.height;;) {
+        const std::size_t byte_count = static_cast<std::size_t>(width) * height * channel_count;
+        mip_chain.levels.push_back(
+            Image_level{
+                .width       = width,
+                .height      = height,
+                .byte_offset = total_byte_count,
+                .byte_count  = byte_count
+            }
+        );
+        total_byte_count += byte_count;
+        if ((width == 1) && (height == 1)) {
+            break;
+        }
+        width  = std::max(width  / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    mip_chain.data.resize(total_byte_count);
+    std::copy(level_0_data.begin(), level_0_data.begin() + mip_chain.levels.front().byte_count, mip_chain.data.begin());
+
+    const Srgb_tables& tables = get_srgb_tables();
+
+    // Filtering is done in linear space float; each level is encoded back
+    // to 8-bit from the float level so that rounding does not accumulate.
+    const std::size_t  pixel_count = static_cast<std::size_t>(image_info.width) * image_info.height;
+    std::vector<float> source     (pixel_count * channel_count);
+    std::vector<float> destination(pixel_count * channel_count / 2 + channel_count);
+    for (std::size_t i = 0, end = pixel_count * channel_count; i < end; ++i) {
+        const bool is_alpha = (channel_count == 4) && ((i % 4) == 3);
+        source[i] = is_alpha
+            ? static_cast<float>(level_0_data[i]) / 255.0f
+            : tables.srgb_to_linear[level_0_data[i]];
+    }
+
+    for (std::size_t level = 1, end = mip_chain.levels.size(); level < end; ++level) {
+        const Image_level& source_level      = mip_chain.levels[level - 1];
+        const Image_level& destination_level = mip_chain.levels[level];
+        if (channel_count == 4) {
+            downsample<4>(source.data(), source_level.width, source_level.height, destination.data(), destination_level.width, destination_level.height);
+        } else {
+            downsample<3>(source.data(), source_level.width, source_level.height, destination.data(), destination_level.width, destination_level.height);
+        }
+
+        std::uint8_t* const out = mip_chain.data.data() + destination_level.byte_offset;
+        for (std::size_t i = 0, i_end = destination_level.byte_count; i < i_end; ++i) {
+            const bool is_alpha = (channel_count == 4) && ((i % 4) == 3);
+            out[i] = encode(tables, destination[i], is_alpha);
+        }
+        std::swap(source, destination);
+    }
+}
+
+} // namespace erhe::graphics
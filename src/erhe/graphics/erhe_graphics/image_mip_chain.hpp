@@ -0,0 +1,45 @@
+#pragma once
+
+#include "erhe_graphics/image_loader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace erhe::graphics {
+
+class Image_level
+{
+public:
+    int         width      {0};
+    int         height     {0};
+    std::size_t byte_offset{0};
+    std::size_t byte_count {0};
+};
+
+// Image with complete mip chain in CPU memory. Levels are tightly packed
+// 8-bit per channel pixels, stored consecutively in data.
+class Image_mip_chain
+{
+public:
+    [[nodiscard]] auto get_level_data(std::size_t level) const -> std::span<const std::uint8_t>;
+
+    Image_format              format{Image_format::srgb8_alpha8};
+    std::vector<Image_level>  levels;
+    std::vector<std::uint8_t> data;
+};
+
+[[nodiscard]] auto get_pixel_byte_count(Image_format format) -> std::size_t;
+
+// Builds mip chain down to 1x1 from tightly packed level 0 pixels.
+// Each level is a 2x2 box filter of the previous level, with last
+// row / column clamped for odd sizes. Color channels are filtered in
+// linear space, alpha as is. Can be called from any thread.
+void make_mip_chain(
+    const Image_info&             image_info,
+    std::span<const std::uint8_t> level_0_data,
+    Image_mip_chain&              mip_chain
+);
+
+} // namespace erhe::graphics
@@ -0,0 +1,348 @@
+#include "erhe_graphics/offset_allocator.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace erhe::graphics {
+
+namespace {
+
+[[nodiscard]] auto align_up(const std::size_t offset, const std::size_t alignment) -> std::size_t
+{
+    const std::size_t remainder = offset % alignment;
+    return (remainder == 0) ? offset : offset + alignment - remainder;
+}
+
+[[nodiscard]] auto floor_log2(const std::size_t value) -> unsigned int
+{
+    return static_cast<unsigned int>(std::bit_width(value) - 1);
+}
+
+} // anonymous namespace
+
+Offset_allocator::Offset_allocator(const std::size_t capacity_byte_count)
+{
+    for (auto& heads : m_free_heads) {
+        heads.fill(null_node);
+    }
+    m_statistics.capacity_byte_count = capacity_byte_count;
+    if (capacity_byte_count == 0) {
+        return;
+    }
+    const Node node = new_block();
+    m_blocks[node].offset = 0;
+    m_blocks[node].size   = capacity_byte_count;
+    m_first_phys = node;
+    insert_free(node);
+}
+
+void Offset_allocator::mapping_insert(const std::size_t size, unsigned int& fl, unsigned int& sl)
+{
+    if (size < sl_count) {
+        fl = 0;
+        sl = static_cast<unsigned int>(size);
+        return;
+    }
+    const unsigned int log2 = floor_log2(size);
+    sl = static_cast<unsigned int>(size >> (log2 - sl_bits)) ^ sl_count;
+    fl = log2 - sl_bits + 1;
+}
+
+void Offset_allocator::mapping_search(const std::size_t size, unsigned int& fl, unsigned int& sl)
+{
+    // Round up to the next second level class so that any block found
+    // from the class is large enough.
+    std::size_t rounded = size;
+    if (size >= sl_count) {
+        const std::size_t round = (std::size_t{1} << (floor_log2(size) - sl_bits)) - 1;
+        rounded = (size <= std::numeric_limits<std::size_t>::max() - round) ? size + round : size;
+    }
+    mapping_insert(rounded, fl, sl);
+}
+
+auto Offset_allocator::new_block() -> Node
+{
+    if (!m_unused_blocks.empty()) {
+        const Node node = m_unused_blocks.back();
+        m_unused_blocks.pop_back();
+        m_blocks[node] = Block{};
+        return node;
+    }
+    m_blocks.emplace_back();
+    return static_cast<Node>(m_blocks.size() - 1);
+}
+
+void Offset_allocator::release_block(const Node node)
+{
+    m_unused_blocks.push_back(node);
+}
+
+auto Offset_allocator::find_free(const std::size_t size) -> Node
+{
+    unsigned int fl = 0;
+    unsigned int sl = 0;
+    mapping_search(size, fl, sl);
+    if (fl >= fl_count) {
+        return null_node;
+    }
+
+    uint32_t sl_map = m_sl_bitmap[fl] & (~uint32_t{0} << sl);
+    if (sl_map == 0) {
+        const uint64_t fl_map = (fl + 1 < 64) ? (m_fl_bitmap & (~uint64_t{0} << (fl + 1))) : 0;
+        if (fl_map == 0) {
+            return null_node;
+        }
+        fl = static_cast<unsigned int>(std::countr_zero(fl_map));
+        sl_map = m_sl_bitmap[fl];
+    }
+    sl = static_cast<unsigned int>(std::countr_zero(sl_map));
+    return m_free_heads[fl][sl];
+}
+
+void Offset_allocator::insert_free(const Node node)
+{
+    Block& block = m_blocks[node];
+    unsigned int fl = 0;
+    unsigned int sl = 0;
+    mapping_insert(block.size, fl, sl);
+
+    const Node head = m_free_heads[fl][sl];
+    block.used      = false;
+    block.pinned    = false;
+    block.prev_free = null_node;
+    block.next_free = head;
+    if (head != null_node) {
+        m_blocks[head].prev_free = node;
+    }
+    m_free_heads[fl][sl] = node;
+    m_fl_bitmap     |= (uint64_t{1} << fl);
+    m_sl_bitmap[fl] |= (uint32_t{1} << sl);
+    ++m_statistics.free_block_count;
+}
+
+void Offset_allocator::remove_free(const Node node)
+{
+    Block& block = m_blocks[node];
+    unsigned int fl = 0;
+    unsigned int sl = 0;
+    mapping_insert(block.size, fl, sl);
+
+    if (block.prev_free != null_node) {
+        m_blocks[block.prev_free].next_free = block.next_free;
+    }
+    if (block.next_free != null_node) {
+        m_blocks[block.next_free].prev_free = block.prev_free;
+    }
+    if (m_free_heads[fl][sl] == node) {
+        m_free_heads[fl][sl] = block.next_free;
+        if (block.next_free == null_node) {
+            m_sl_bitmap[fl] &= ~(uint32_t{1} << sl);
+            if (m_sl_bitmap[fl] == 0) {
+                m_fl_bitmap &= ~(uint64_t{1} << fl);
+            }
+        }
+    }
+    block.prev_free = null_node;
+    block.next_free = null_node;
+    --m_statistics.free_block_count;
+}
+
+auto Offset_allocator::split(const Node node, const std::size_t size) -> Node
+{
+    const Node remainder = new_block(); // may reallocate m_blocks
+    Block& block = m_blocks[node];
+    Block& tail  = m_blocks[remainder];
+    tail.offset    = block.offset + size;
+    tail.size      = block.size - size;
+    tail.prev_phys = node;
+    tail.next_phys = block.next_phys;
+    if (block.next_phys != null_node) {
+        m_blocks[block.next_phys].prev_phys = remainder;
+    }
+    block.next_phys = remainder;
+    block.size      = size;
+    return remainder;
+}
+
+auto Offset_allocator::allocate(std::size_t byte_count, std::size_t alignment, const bool pinned) -> Node
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    byte_count = std::max(byte_count, std::size_t{1});
+    alignment  = std::max(alignment,  std::size_t{1});
+
+    Node node = find_free(byte_count + alignment - 1);
+    if (node == null_node) {
+        ++m_statistics.failed_allocation_count;
+        return null_node;
+    }
+    remove_free(node);
+
+    // Leading padding stays free; previous physical block is always used
+    // so there is nothing to merge with.
+    const std::size_t padding = align_up(m_blocks[node].offset, alignment) - m_blocks[node].offset;
+    if (padding > 0) {
+        const Node aligned = split(node, padding);
+        insert_free(node);
+        node = aligned;
+    }
+    if (m_blocks[node].size > byte_count) {
+        const Node remainder = split(node, byte_count);
+        insert_free(remainder);
+    }
+
+    Block& block = m_blocks[node];
+    block.used      = true;
+    block.pinned    = pinned;
+    block.alignment = alignment;
+
+    m_statistics.used_byte_count     += block.size;
+    m_statistics.peak_used_byte_count = std::max(m_statistics.peak_used_byte_count, m_statistics.used_byte_count);
+    ++m_statistics.allocation_count;
+    ++m_statistics.total_allocation_count;
+    return node;
+}
+
+void Offset_allocator::free(Node node)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    ERHE_VERIFY(node < m_blocks.size());
+    ERHE_VERIFY(m_blocks[node].used);
+
+    m_statistics.used_byte_count -= m_blocks[node].size;
+    --m_statistics.allocation_count;
+    m_blocks[node].used   = false;
+    m_blocks[node].pinned = false;
+
+    const Node next = m_blocks[node].next_phys;
+    if ((next != null_node) && !m_blocks[next].used) {
+        remove_free(next);
+        m_blocks[node].size     += m_blocks[next].size;
+        m_blocks[node].next_phys = m_blocks[next].next_phys;
+        if (m_blocks[next].next_phys != null_node) {
+            m_blocks[m_blocks[next].next_phys].prev_phys = node;
+        }
+        release_block(next);
+    }
+
+    const Node prev = m_blocks[node].prev_phys;
+    if ((prev != null_node) && !m_blocks[prev].used) {
+        remove_free(prev);
+        m_blocks[prev].size     += m_blocks[node].size;
+        m_blocks[prev].next_phys = m_blocks[node].next_phys;
+        if (m_blocks[node].next_phys != null_node) {
+            m_blocks[m_blocks[node].next_phys].prev_phys = prev;
+        }
+        release_block(node);
+        node = prev;
+    }
+
+    insert_free(node);
+}
+
+auto Offset_allocator::get_offset(const Node node) const -> std::size_t
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return m_blocks[node].offset;
+}
+
+auto Offset_allocator::get_byte_count(const Node node) const -> std::size_t
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return m_blocks[node].size;
+}
+
+auto Offset_allocator::get_statistics() const -> Statistics
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    Statistics statistics = m_statistics;
+    statistics.free_byte_count = statistics.capacity_byte_count - statistics.used_byte_count;
+
+    // Largest free block is in the highest non-empty class
+    if (m_fl_bitmap != 0) {
+        const unsigned int fl = 63u - static_cast<unsigned int>(std::countl_zero(m_fl_bitmap));
+        const unsigned int sl = 31u - static_cast<unsigned int>(std::countl_zero(m_sl_bitmap[fl]));
+        for (Node node = m_free_heads[fl][sl]; node != null_node; node = m_blocks[node].next_free) {
+            statistics.largest_free_byte_count = std::max(statistics.largest_free_byte_count, m_blocks[node].size);
+        }
+    }
+    return statistics;
+}
+
+auto Offset_allocator::compact() -> std::vector<Move>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    std::vector<Move> moves;
+    std::vector<Node> used_nodes;
+    used_nodes.reserve(m_statistics.allocation_count);
+
+    // Slide unpinned allocations down; pinned allocations stay in place
+    std::size_t position = 0;
+    for (Node node = m_first_phys; node != null_node; node = m_blocks[node].next_phys) {
+        Block& block = m_blocks[node];
+        if (!block.used) {
+            release_block(node);
+            continue;
+        }
+        if (!block.pinned) {
+            const std::size_t new_offset = align_up(position, block.alignment);
+            if (new_offset < block.offset) {
+                moves.push_back(
+                    Move{
+                        .old_offset = block.offset,
+                        .new_offset = new_offset,
+                        .byte_count = block.size
+                    }
+                );
+                block.offset = new_offset;
+            }
+        }
+        position = block.offset + block.size;
+        used_nodes.push_back(node);
+    }
+
+    // Rebuild physical list and free lists from the gaps
+    for (auto& heads : m_free_heads) {
+        heads.fill(null_node);
+    }
+    m_sl_bitmap.fill(0);
+    m_fl_bitmap = 0;
+    m_statistics.free_block_count = 0;
+    m_first_phys = null_node;
+
+    Node        prev = null_node;
+    std::size_t end  = 0;
+    const auto link = [&](const Node node) {
+        m_blocks[node].prev_phys = prev;
+        m_blocks[node].next_phys = null_node;
+        if (prev != null_node) {
+            m_blocks[prev].next_phys = node;
+        } else {
+            m_first_phys = node;
+        }
+        prev = node;
+    };
+    const auto link_gap = [&](const std::size_t gap_end) {
+        if (gap_end > end) {
+            const Node gap = new_block();
+            m_blocks[gap].offset = end;
+            m_blocks[gap].size   = gap_end - end;
+            link(gap);
+            insert_free(gap);
+        }
+    };
+    for (const Node node : used_nodes) {
+        link_gap(m_blocks[node].offset);
+        link(node);
+        end = m_blocks[node].offset + m_blocks[node].size;
+    }
+    link_gap(m_statistics.capacity_byte_count);
+
+    return moves;
+}
+
+} // namespace erhe::graphics
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace erhe::graphics {
+
+// Two level segregated fit (TLSF) allocator for ranges of an externally
+// owned resource, such as a GPU buffer. Only offsets are managed; no memory
+// is touched. Allocation and free are O(1). Thread safe.
+//
+// Allocations are identified by node; the offset of a node can change when
+// compact() is called, unless the node is pinned.
+class Offset_allocator
+{
+public:
+    using Node = uint32_t;
+    static constexpr Node null_node = std::numeric_limits<Node>::max();
+
+    class Statistics
+    {
+    public:
+        std::size_t capacity_byte_count      {0};
+        std::size_t used_byte_count          {0};
+        std::size_t peak_used_byte_count     {0};
+        std::size_t free_byte_count          {0};
+        std::size_t largest_free_byte_count  {0};
+        std::size_t allocation_count         {0};
+        std::size_t free_block_count         {0};
+        std::size_t total_allocation_count   {0};
+        std::size_t failed_allocation_count  {0};
+    };
+
+    class Move
+    {
+    public:
+        std::size_t old_offset{0};
+        std::size_t new_offset{0};
+        std::size_t byte_count{0};
+    };
+
+    explicit Offset_allocator(std::size_t capacity_byte_count);
+
+    // Returns null_node if there is no free range large enough.
+    // Alignment does not need to be a power of two.
+    [[nodiscard]] auto allocate(std::size_t byte_count, std::size_t alignment = 1, bool pinned = false) -> Node;
+    void free(Node node);
+
+    [[nodiscard]] auto get_offset    (Node node) const -> std::size_t;
+    [[nodiscard]] auto get_byte_count(Node node) const -> std::size_t;
+    [[nodiscard]] auto get_statistics() const -> Statistics;
+
+    // Moves unpinned allocations towards the start so that free space is
+    // merged. Returns the moves in the order they must be applied; each
+    // move has new_offset < old_offset, and ranges may overlap.
+    [[nodiscard]] auto compact() -> std::vector<Move>;
+
+private:
+    static constexpr unsigned int sl_bits  = 4;
+    static constexpr unsigned int sl_count = 1u << sl_bits;
+    static constexpr unsigned int fl_count = 64 - sl_bits + 1;
+
+    class Block
+    {
+    public:
+        std::size_t offset    {0};
+        std::size_t size      {0};
+        std::size_t alignment {1};
+        Node        prev_phys {null_node};
+        Node        next_phys {null_node};
+        Node        prev_free {null_node};
+        Node        next_free {null_node};
+        bool        used      {false};
+        bool        pinned    {false};
+    };
+
+    static void mapping_insert(std::size_t size, unsigned int& fl, unsigned int& sl);
+    static void mapping_search(std::size_t size, unsigned int& fl, unsigned int& sl);
+
+    [[nodiscard]] auto new_block    () -> Node;
+    void               release_block(Node node);
+    [[nodiscard]] auto find_free    (std::size_t size) -> Node;
+    void               insert_free  (Node node);
+    void               remove_free  (Node node);
+    [[nodiscard]] auto split        (Node node, std::size_t size) -> Node;
+
+    mutable std::mutex                                       m_mutex;
+    std::vector<Block>                                       m_blocks;
+    std::vector<Node>                                        m_unused_blocks;
+    Node                                                     m_first_phys{null_node};
+    uint64_t                                                 m_fl_bitmap {0};
+    std::array<uint32_t, fl_count>                           m_sl_bitmap {};
+    std::array<std::array<Node, sl_count>, fl_count>         m_free_heads{};
+    Statistics                                               m_statistics;
+};
+
+} // namespace erhe::graphics
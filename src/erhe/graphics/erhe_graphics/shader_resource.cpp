@@ -28,6 +28,7 @@ auto glsl_token(const gl::Uniform_type type) -> const char*
         case gl::Uniform_type::float_vec2:         return "vec2     ";
         case gl::Uniform_type::float_vec3:         return "vec3     ";
         case gl::Uniform_type::float_vec4:         return "vec4     ";
+        case gl::Uniform_type::float_mat3x4:       return "mat3x4   ";
         case gl::Uniform_type::float_mat4:         return "mat4     ";
         case gl::Uniform_type::double_:            return "double   ";
         case gl::Uniform_type::double_vec2:        return "dvec2    ";
@@ -150,6 +151,7 @@ auto get_type_details(const gl::Uniform_type type) -> Type_details
         case gl::Uniform_type::float_vec2:                                  return Type_details(type, gl::Uniform_type::float_,             2);
         case gl::Uniform_type::float_vec3:                                  return Type_details(type, gl::Uniform_type::float_,             3);
         case gl::Uniform_type::float_vec4:                                  return Type_details(type, gl::Uniform_type::float_,             4);
+        case gl::Uniform_type::float_mat3x4:                                return Type_details(type, gl::Uniform_type::float_vec4,         3);
         case gl::Uniform_type::float_mat4:                                  return Type_details(type, gl::Uniform_type::float_vec4,         4);
         case gl::Uniform_type::double_:                                     return Type_details(type, gl::Uniform_type::double_,            1);
         case gl::Uniform_type::double_vec2:                                 return Type_details(type, gl::Uniform_type::double_,            2);
@@ -851,6 +853,26 @@ auto Shader_resource::add_vec4(const std::string_view name, const std::optional<
     return new_member;
 }
 
+auto Shader_resource::add_mat3x4(
+    const std::string_view           name,
+    const std::optional<std::size_t> array_size /* = {} */
+) -> Shader_resource*
+{
+    ERHE_VERIFY(is_aggregate(m_type));
+    align_offset_to(4 * 4); // align by 4 * 4 bytes
+    auto* const new_member = m_members.emplace_back(
+        std::make_unique<Shader_resource>(
+            m_instance,
+            name,
+            gl::Uniform_type::float_mat3x4,
+            array_size,
+            this
+        )
+    ).get();
+    m_offset += new_member->size_bytes();
+    return new_member;
+}
+
 auto Shader_resource::add_mat4(
     const std::string_view           name,
     const std::optional<std::size_t> array_size /* = {} */
@@ -174,6 +174,11 @@ public:
         const std::optional<std::size_t> array_size = {}
     ) -> Shader_resource*;
 
+    auto add_mat3x4(
+        const std::string_view           name,
+        const std::optional<std::size_t> array_size = {}
+    ) -> Shader_resource*;
+
     auto add_mat4(
         const std::string_view           name,
         const std::optional<std::size_t> array_size = {}
@@ -545,7 +545,7 @@ auto Texture::is_shown_in_ui() const -> bool
 ////     return i->second;
 //// }
 
-void Texture::upload(const gl::Internal_format internal_format, const int width, const int height, const int depth)
+void Texture::upload(const gl::Internal_format internal_format, const int width, const int height, const int depth, const int level)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -561,17 +561,17 @@ void Texture::upload(const gl::Internal_format internal_format, const int width,
     ERHE_VERIFY(get_format_and_type(m_internal_format, format, type));
     switch (storage_dimensions(m_target)) {
         case 1: {
-            gl::texture_sub_image_1d(gl_name(), 0, 0, width, format, type, nullptr);
+            gl::texture_sub_image_1d(gl_name(), level, 0, width, format, type, nullptr);
             break;
         }
 
         case 2: {
-            gl::texture_sub_image_2d(gl_name(), 0, 0, 0, width, height, format, type, nullptr);
+            gl::texture_sub_image_2d(gl_name(), level, 0, 0, width, height, format, type, nullptr);
             break;
         }
 
         case 3: {
-            gl::texture_sub_image_3d(gl_name(), 0, 0, 0, 0, width, height, depth, format, type, nullptr);
+            gl::texture_sub_image_3d(gl_name(), level, 0, 0, 0, width, height, depth, format, type, nullptr);
             break;
         }
 
@@ -86,41 +86,66 @@ auto get_log_level_color(const spdlog::level::level_enum level) -> uint32_t
     return ImGui::ColorConvertFloat4ToU32(get_log_level_color_vec4(level));
 }
 
-void Logs::log_entry(erhe::log::Entry& entry)
+// Builds the list of rows to show from m_index[first, last); message text
+// is decoded from the log ring only for rows that are actually visible.
+void Logs::filter_index(const std::size_t first, const std::size_t last)
 {
-    if (m_paused && (entry.serial > m_pause_serial)) {
-        return;
+    m_visible_serials.clear();
+    for (std::size_t i = first; i < last; ++i) {
+        const erhe::log::Log_index_entry& entry = m_index[i];
+        if (m_paused && (entry.serial > m_pause_serial)) {
+            continue;
+        }
+        if (entry.level < m_min_level_to_show) {
+            continue;
+        }
+        m_visible_serials.push_back(entry.serial);
     }
-    if (entry.level < m_min_level_to_show) {
-        return;
+}
+
+void Logs::log_entries(erhe::log::Log_store& store, const bool last_on_top)
+{
+    const int row_count = static_cast<int>(m_visible_serials.size());
+    ImGuiListClipper clipper;
+    clipper.Begin(row_count);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const int index = last_on_top ? (row_count - 1 - row) : row;
+            log_entry(store, m_visible_serials[index]);
+        }
     }
+}
 
+void Logs::log_entry(erhe::log::Log_store& store, const uint64_t serial)
+{
     ImGui::TableNextRow();
+    if (!store.get_entry(serial, m_entry)) {
+        // Ring slots have already been reused for newer messages
+        if (ImGui::TableSetColumnIndex(2)) {
+            ImGui::TextColored(ImVec4{0.4f, 0.4f, 0.4f, 1.0f}, "(overwritten)");
+        }
+        return;
+    }
+
     if (ImGui::TableSetColumnIndex(0)) {
-        ImGui::TextColored(ImVec4{0.7f, 0.7f, 0.7f, 1.0f}, "%s", entry.timestamp.c_str());
+        ImGui::TextColored(ImVec4{0.7f, 0.7f, 0.7f, 1.0f}, "%s", m_entry.timestamp.c_str());
     }
     if (ImGui::TableSetColumnIndex(1)) {
-        ImGui::TextUnformatted(entry.logger.c_str());
+        ImGui::TextUnformatted(m_entry.logger.c_str());
     }
     if (ImGui::TableSetColumnIndex(2)) {
-        ImGui::PushStyleColor(ImGuiCol_Text, get_log_level_color(entry.level));
-        ImGui::PushID(static_cast<int>(entry.serial));
-        if (ImGui::Selectable(entry.message.c_str(), entry.selected)) {
-            entry.selected = !entry.selected;
+        ImGui::PushStyleColor(ImGuiCol_Text, get_log_level_color(m_entry.level));
+        ImGui::PushID(static_cast<int>(m_entry.serial));
+        const bool selected = m_selected_serials.contains(m_entry.serial);
+        if (ImGui::Selectable(m_entry.message.c_str(), selected)) {
+            if (selected) {
+                m_selected_serials.erase(m_entry.serial);
+            } else {
+                m_selected_serials.insert(m_entry.serial);
+            }
         }
-        //if (entry.repeat_count > 0)
-        //{
-        //    ImGui::TextColored(
-        //        ImVec4{0.55f, 0.55f, 0.55f, 1.0f},
-        //        "Message repeated %u times",
-        //        entry.repeat_count
-        //    );
-        //}
         ImGui::PopID();
         ImGui::PopStyleColor();
-        if (!m_last_on_top && m_follow && !m_paused) {
-            ImGui::SetScrollHereY();
-        }
     }
 }
 
@@ -282,12 +307,18 @@ void Logs::tail_log_imgui()
     const auto trim_size = static_cast<size_t>(m_tail_buffer_trim_size);
     tail.trim(trim_size);
 
-    auto& tail_entries = tail.get_log();
+    tail.get_index(m_index);
 
     const auto visible_count = (std::min)(
         static_cast<size_t>(m_tail_buffer_show_size),
-        tail_entries.size()
+        m_index.size()
     );
+    if (m_last_on_top) {
+        filter_index(m_index.size() - visible_count, m_index.size());
+    } else {
+        filter_index(0, visible_count);
+    }
+
     ImGui::TableNextRow();
     if (ImGui::TableSetColumnIndex(0)) {
         ImGui::PushFont(m_imgui_renderer.mono_font());
@@ -301,14 +332,9 @@ void Logs::tail_log_imgui()
             ImGui::TableSetupColumn("Logger",    ImGuiTableColumnFlags_WidthFixed, 140.0f);
             ImGui::TableSetupColumn("Message",   ImGuiTableColumnFlags_WidthFixed, 4000.0f - 140.0f - 170.0f);
             ImGui::TableHeadersRow();
-            if (m_last_on_top) {
-                for (auto i = tail_entries.rbegin(), end = tail_entries.rbegin() + visible_count; i != end; ++i) {
-                    log_entry(*i);
-                }
-            } else {
-                for (auto i = tail_entries.begin(), end = tail_entries.begin() + visible_count; i != end; ++i) {
-                    log_entry(*i);
-                }
+            log_entries(tail, m_last_on_top);
+            if (!m_last_on_top && m_follow && !m_paused) {
+                ImGui::SetScrollY(ImGui::GetScrollMaxY());
             }
             ImGui::EndTable();
         }
@@ -322,7 +348,9 @@ void Logs::frame_log_imgui()
 {
     auto& frame = erhe::log::get_frame_store_log();
 
-    auto& frame_entries = frame.get_log();
+    frame.get_index(m_index);
+    filter_index(0, m_index.size());
+
     ImGui::PushFont(m_imgui_renderer.mono_font());
     ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2{0.0f, 0.0f});
     const ImVec2 outer_size{-FLT_MIN, 0.0f};
@@ -334,16 +362,17 @@ void Logs::frame_log_imgui()
         ImGui::TableSetupColumn("Logger",    ImGuiTableColumnFlags_WidthFixed, 140.0f);
         ImGui::TableSetupColumn("Message",   ImGuiTableColumnFlags_WidthFixed, 4000.0f - 140.0f - 170.0f);
         ImGui::TableHeadersRow();
-        for (auto& entry : frame_entries) {
-            log_entry(entry);
-        }
+        log_entries(frame, false);
         ImGui::EndTable();
     }
     ImGui::PopStyleVar();
 
     ImGui::PopFont();
 
-    frame_entries.clear();
+    // Entries drained while this frame was shown are kept for the next frame
+    if (!m_index.empty()) {
+        frame.remove_until(m_index.back().serial);
+    }
 }
 
 } // namespace erhe::imgui
@@ -9,7 +9,7 @@
 
 #include <spdlog/sinks/sink.h>
 
-#include <deque>
+#include <set>
 #include <vector>
 
 namespace spdlog::level {
@@ -47,17 +47,23 @@ public:
 
 private:
     void save_settings();
-    void log_entry(erhe::log::Entry& entry);
-
-    Imgui_renderer&           m_imgui_renderer;
-    Logs_toggle_pause_command m_toggle_pause_command;
-    int                       m_tail_buffer_show_size{10000};
-    int                       m_tail_buffer_trim_size{10000};
-    bool                      m_paused           {false};
-    bool                      m_last_on_top      {false};
-    bool                      m_follow           {false};
-    uint64_t                  m_pause_serial     {0};
-    spdlog::level::level_enum m_min_level_to_show{spdlog::level::trace};
+    void filter_index (std::size_t first, std::size_t last);
+    void log_entries  (erhe::log::Log_store& store, bool last_on_top);
+    void log_entry    (erhe::log::Log_store& store, uint64_t serial);
+
+    Imgui_renderer&                         m_imgui_renderer;
+    Logs_toggle_pause_command               m_toggle_pause_command;
+    int                                     m_tail_buffer_show_size{10000};
+    int                                     m_tail_buffer_trim_size{10000};
+    bool                                    m_paused           {false};
+    bool                                    m_last_on_top      {false};
+    bool                                    m_follow           {false};
+    uint64_t                                m_pause_serial     {0};
+    spdlog::level::level_enum               m_min_level_to_show{spdlog::level::trace};
+    std::vector<erhe::log::Log_index_entry> m_index;
+    std::vector<uint64_t>                   m_visible_serials;
+    std::set<uint64_t>                      m_selected_serials;
+    erhe::log::Entry                        m_entry;
 };
 
 class Log_settings_window : public Imgui_window
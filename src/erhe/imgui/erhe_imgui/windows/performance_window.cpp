@@ -3,6 +3,7 @@
 #include "erhe_imgui/imgui_window.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_imgui/imgui_log.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_graphics/gpu_timer.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_time/timer.hpp"
@@ -12,6 +13,7 @@
 
 #include <imgui/imgui_internal.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -472,6 +474,57 @@ void Performance_window::imgui()
     for (auto* plot : m_generic_plots) {
         plot->imgui();
     }
+
+    thread_pool_imgui();
+#endif
+}
+
+void Performance_window::thread_pool_imgui()
+{
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+    erhe::concurrency::Thread_pool& thread_pool = erhe::concurrency::Thread_pool::get_default();
+    if (!ImGui::TreeNodeEx("Thread pool", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+
+    // Utilization is busy time relative to all workers and one waiting thread
+    const auto  now          = std::chrono::steady_clock::now();
+    const float thread_count = static_cast<float>(thread_pool.size() + 1);
+    const float elapsed_ns   = m_last_task_usage_time.has_value()
+        ? std::chrono::duration<float, std::nano>(now - m_last_task_usage_time.value()).count()
+        : 0.0f;
+    if (!m_pause) {
+        m_last_task_usage_time = now;
+        for (const erhe::concurrency::Task_usage* usage : thread_pool.get_task_usages()) {
+            auto i = std::find_if(
+                m_task_usage_samples.begin(),
+                m_task_usage_samples.end(),
+                [usage](const Task_usage_sample& sample) { return sample.name == usage->name; }
+            );
+            if (i == m_task_usage_samples.end()) {
+                i = m_task_usage_samples.insert(m_task_usage_samples.end(), Task_usage_sample{.name = usage->name});
+            }
+            const std::uint64_t task_count   = usage->task_count  .load(std::memory_order_relaxed);
+            const std::uint64_t busy_time_ns = usage->busy_time_ns.load(std::memory_order_relaxed);
+            i->utilization = (elapsed_ns > 0.0f)
+                ? static_cast<float>(busy_time_ns - i->busy_time_ns) / (elapsed_ns * thread_count)
+                : 0.0f;
+            i->task_count   = task_count;
+            i->busy_time_ns = busy_time_ns;
+        }
+    }
+
+    ImGui::Text("Workers: %d", thread_pool.size());
+    for (const Task_usage_sample& sample : m_task_usage_samples) {
+        ImGui::Text(
+            "%s: %5.1f %%, %llu tasks, %.3f s",
+            sample.name.c_str(),
+            100.0f * sample.utilization,
+            static_cast<unsigned long long>(sample.task_count),
+            static_cast<double>(sample.busy_time_ns) / 1.0e9
+        );
+    }
+    ImGui::TreePop();
 #endif
 }
 
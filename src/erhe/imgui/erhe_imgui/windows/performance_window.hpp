@@ -5,8 +5,10 @@
 #include <imgui/imgui.h>
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace erhe::graphics {
@@ -98,11 +100,24 @@ public:
     void unregister_plot(Plot* plot);
 
 private:
-    Frame_time_plot             m_frame_time_plot;
-    std::vector<Gpu_timer_plot> m_gpu_timer_plots;
-    std::vector<Cpu_timer_plot> m_cpu_timer_plots;
-    std::vector<Plot*>          m_generic_plots;
-    bool                        m_pause{false};
+    void thread_pool_imgui();
+
+    class Task_usage_sample
+    {
+    public:
+        std::string   name;
+        std::uint64_t task_count  {0};
+        std::uint64_t busy_time_ns{0};
+        float         utilization {0.0f};
+    };
+
+    Frame_time_plot                                      m_frame_time_plot;
+    std::vector<Gpu_timer_plot>                          m_gpu_timer_plots;
+    std::vector<Cpu_timer_plot>                          m_cpu_timer_plots;
+    std::vector<Plot*>                                   m_generic_plots;
+    bool                                                 m_pause{false};
+    std::vector<Task_usage_sample>                       m_task_usage_samples;
+    std::optional<std::chrono::steady_clock::time_point> m_last_task_usage_time;
 };
 
 } // namespace editor
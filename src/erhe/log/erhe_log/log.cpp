@@ -3,7 +3,7 @@
 #include "erhe_log/timestamp.hpp"
 #include "erhe_verify/verify.hpp"
 
-#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
@@ -17,6 +17,11 @@
 #   include <unistd.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace erhe::log {
@@ -40,51 +45,302 @@ void console_init()
 #endif
 }
 
-Store_log_sink::Store_log_sink()
+Log_store::Log_store(const Log_ring& ring)
+    : m_ring{ring}
 {
 }
 
-auto Store_log_sink::get_serial() const -> uint64_t
+auto Log_store::get_serial() const -> uint64_t
 {
-    return m_serial;
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return m_index.empty() ? 0 : m_index.back().serial;
 }
 
-auto Store_log_sink::get_log() -> std::deque<Entry>&
+auto Log_store::get_entry(const uint64_t serial, Entry& entry) const -> bool
 {
-    return m_entries;
+    thread_local Log_record record;
+    if (!m_ring.read_history(serial, record)) {
+        return false;
+    }
+    const spdlog::log_clock::duration time_since_epoch = std::chrono::duration_cast<spdlog::log_clock::duration>(
+        std::chrono::nanoseconds{record.time_ns}
+    );
+    entry.serial    = serial;
+    entry.timestamp = erhe::log::timestamp_short(spdlog::log_clock::time_point{time_since_epoch});
+    entry.message   = record.payload;
+    entry.logger    = m_ring.get_logger_info(record.logger_id).name;
+    entry.level     = record.level;
+    return true;
 }
 
-void Store_log_sink::trim(const std::size_t trim_size)
+void Log_store::get_index(std::vector<Log_index_entry>& out) const
 {
-    if (m_entries.size() > trim_size) {
-        const auto trim_count = m_entries.size() - trim_size;
-        m_entries.erase(
-            m_entries.begin(),
-            m_entries.begin() + trim_count
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    out.assign(m_index.begin(), m_index.end());
+}
+
+void Log_store::trim(const std::size_t trim_size)
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_index.size() > trim_size) {
+        const auto trim_count = m_index.size() - trim_size;
+        m_index.erase(
+            m_index.begin(),
+            m_index.begin() + trim_count
         );
-        assert(m_entries.size() == trim_size);
+        assert(m_index.size() == trim_size);
     }
 }
 
-void Store_log_sink::sink_it_(const spdlog::details::log_msg& msg)
+void Log_store::remove_until(const uint64_t serial)
 {
-    ++m_serial;
-    m_entries.push_back(
-        Entry{
-            .serial       = m_serial,
-            .timestamp    = erhe::log::timestamp_short(),
-            .message      = std::string{msg.payload.begin(), msg.payload.end()},
-            .logger       = std::string{msg.logger_name.begin(), msg.logger_name.end()},
-            .repeat_count = 0,
-            .level        = msg.level,
-        }
-    );
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    while (!m_index.empty() && (m_index.front().serial <= serial)) {
+        m_index.pop_front();
+    }
 }
 
-void Store_log_sink::flush_()
+void Log_store::push(const Log_index_entry& entry)
 {
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    // Entries older than one lap of the ring have been overwritten
+    const uint64_t slot_count = m_ring.get_slot_count();
+    while (!m_index.empty() && (m_index.front().serial + slot_count <= entry.serial)) {
+        m_index.pop_front();
+    }
+    m_index.push_back(entry);
 }
 
+namespace {
+
+// Number of 256 byte slots in the log ring
+constexpr std::size_t c_log_ring_slot_count = 16384;
+
+// Drain thread sleeps at most this long when the ring is empty
+constexpr std::chrono::milliseconds c_drain_idle_wait{5};
+
+}
+
+// Owns the log ring and the thread which drains it. Loggers do not format
+// or write anything themselves; each logger has a Ring_log_sink which
+// copies the formatted payload to the ring. The drain thread forwards
+// records to the output sinks (log file, console, debugger) and indexes
+// them into tail and frame stores for the log windows.
+class Log_backend
+{
+public:
+    Log_backend()
+        : m_ring       {c_log_ring_slot_count}
+        , m_tail_store {m_ring}
+        , m_frame_store{m_ring}
+    {
+    }
+
+    ~Log_backend() noexcept
+    {
+        stop();
+    }
+
+    void add_output(const spdlog::sink_ptr& sink)
+    {
+        const std::lock_guard<std::mutex> lock{m_output_mutex};
+        m_outputs.push_back(sink);
+    }
+
+    void start()
+    {
+        if (m_running.load()) {
+            return;
+        }
+        m_stop.store(false);
+        m_running.store(true);
+        m_thread = std::thread{&Log_backend::drain_thread_main, this};
+    }
+
+    void stop()
+    {
+        if (!m_running.load()) {
+            return;
+        }
+        // Records written from now on go directly to outputs. Producers
+        // which saw m_running before it was cleared are still writing to
+        // the ring; the drain thread keeps running until they are done, so
+        // that their records are output and a producer waiting for a free
+        // slot does not wait forever.
+        m_running.store(false, std::memory_order_seq_cst);
+        while (m_ring_writer_count.load(std::memory_order_seq_cst) > 0) {
+            std::this_thread::yield();
+        }
+        {
+            const std::lock_guard<std::mutex> lock{m_mutex};
+            m_stop.store(true);
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        m_drained.notify_all();
+    }
+
+    [[nodiscard]] auto register_logger(const std::string& name, const bool tail) -> uint16_t
+    {
+        return m_ring.register_logger(name, tail);
+    }
+
+    void write(const uint16_t logger_id, const spdlog::details::log_msg& msg)
+    {
+        // Writer count is published before m_running is checked, and stop()
+        // clears m_running before checking writer count; either stop()
+        // waits for this write, or this write sees m_running cleared.
+        m_ring_writer_count.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_running.load(std::memory_order_seq_cst)) {
+            m_ring_writer_count.fetch_sub(1, std::memory_order_release);
+
+            // Before start and after stop, write directly to outputs
+            const std::lock_guard<std::mutex> lock{m_output_mutex};
+            for (const spdlog::sink_ptr& output : m_outputs) {
+                if (output->should_log(msg.level)) {
+                    output->log(msg);
+                }
+            }
+            return;
+        }
+        const int64_t time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+        m_ring.write(
+            logger_id,
+            msg.level,
+            time_ns,
+            static_cast<uint64_t>(msg.thread_id),
+            std::string_view{msg.payload.data(), msg.payload.size()}
+        );
+        m_ring_writer_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Blocks until everything written before the call has reached outputs
+    void flush()
+    {
+        if (!m_running.load() || (std::this_thread::get_id() == m_thread.get_id())) {
+            return;
+        }
+        const uint64_t target_position = m_ring.get_write_position();
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_wake_requested = true;
+        m_wake.notify_one();
+        while (m_running.load() && (m_ring.get_read_position() < target_position)) {
+            m_drained.wait_for(lock, c_drain_idle_wait);
+        }
+    }
+
+    [[nodiscard]] auto get_tail_store () -> Log_store& { return m_tail_store; }
+    [[nodiscard]] auto get_frame_store() -> Log_store& { return m_frame_store; }
+
+private:
+    void drain_thread_main()
+    {
+        Log_record record;
+        for (;;) {
+            const bool stop = m_stop.load();
+            std::size_t record_count = 0;
+            {
+                const std::lock_guard<std::mutex> lock{m_output_mutex};
+                while (m_ring.try_drain(record)) {
+                    output(record);
+                    ++record_count;
+                }
+                if (record_count > 0) {
+                    for (const spdlog::sink_ptr& output : m_outputs) {
+                        output->flush();
+                    }
+                }
+            }
+            if (record_count > 0) {
+                const std::lock_guard<std::mutex> lock{m_mutex};
+                m_drained.notify_all();
+            }
+            if (stop) {
+                return;
+            }
+            if (record_count == 0) {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_wake.wait_for(lock, c_drain_idle_wait, [this]() { return m_stop.load() || m_wake_requested; });
+                m_wake_requested = false;
+            }
+        }
+    }
+
+    void output(const Log_record& record)
+    {
+        const Logger_info& logger_info = m_ring.get_logger_info(record.logger_id);
+        const spdlog::log_clock::duration time_since_epoch = std::chrono::duration_cast<spdlog::log_clock::duration>(
+            std::chrono::nanoseconds{record.time_ns}
+        );
+        spdlog::details::log_msg msg{
+            spdlog::log_clock::time_point{time_since_epoch},
+            spdlog::source_loc{},
+            spdlog::string_view_t{logger_info.name.data(), logger_info.name.size()},
+            record.level,
+            spdlog::string_view_t{record.payload.data(), record.payload.size()}
+        };
+        msg.thread_id = static_cast<std::size_t>(record.thread_id);
+        for (const spdlog::sink_ptr& output : m_outputs) {
+            if (output->should_log(msg.level)) {
+                output->log(msg);
+            }
+        }
+        Log_store& store = logger_info.tail ? m_tail_store : m_frame_store;
+        store.push(Log_index_entry{.serial = record.position, .level = record.level});
+    }
+
+    Log_ring                      m_ring;
+    Log_store                     m_tail_store;
+    Log_store                     m_frame_store;
+
+    std::mutex                    m_output_mutex;
+    std::vector<spdlog::sink_ptr> m_outputs;
+
+    std::mutex                    m_mutex;
+    std::condition_variable       m_wake;
+    std::condition_variable       m_drained;
+    bool                          m_wake_requested   {false};
+    std::atomic<bool>             m_stop             {false};
+    std::atomic<bool>             m_running          {false};
+    std::atomic<uint32_t>         m_ring_writer_count{0};     // producers inside write() while running
+    std::thread                   m_thread;
+};
+
+// Per logger sink which writes records to the log ring without locking.
+// Formatting patterns apply to output sinks, on the drain thread.
+class Ring_log_sink final : public spdlog::sinks::sink
+{
+public:
+    Ring_log_sink(const std::shared_ptr<Log_backend>& backend, const uint16_t logger_id)
+        : m_backend  {backend}
+        , m_logger_id{logger_id}
+    {
+    }
+
+    void log(const spdlog::details::log_msg& msg) override
+    {
+        m_backend->write(m_logger_id, msg);
+    }
+
+    void flush() override
+    {
+        m_backend->flush();
+    }
+
+    void set_pattern(const std::string&) override
+    {
+    }
+
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override
+    {
+    }
+
+private:
+    std::shared_ptr<Log_backend> m_backend;
+    uint16_t                     m_logger_id;
+};
+
 class Log_sinks
 {
 public:
@@ -94,15 +350,19 @@ public:
         return static_instance;
     }
 
-#if defined _WIN32
-    auto get_msvc_sink       () -> spdlog::sinks::msvc_sink_mt& { return *m_sink_msvc.get(); }
-#endif
-    auto get_console_sink    () -> spdlog::sinks::stdout_color_sink_mt& { return *m_sink_console.get(); }
-    auto get_file_sink       () -> spdlog::sinks::basic_file_sink_mt& { return *m_sink_log_file.get(); }
-    auto get_tail_store_sink () -> Store_log_sink& { return *m_tail_store_log.get(); }
-    auto get_frame_store_sink() -> Store_log_sink& { return *m_frame_store_log.get(); }
-    auto get_log_to_console  () const -> bool { return m_log_to_console; }
-    void set_log_to_console  (bool value) { m_log_to_console = value; }
+    auto get_tail_store () -> Log_store& { return m_backend->get_tail_store(); }
+    auto get_frame_store() -> Log_store& { return m_backend->get_frame_store(); }
+    auto get_log_to_console() const -> bool { return m_log_to_console; }
+    void set_log_to_console()
+    {
+        if (m_log_to_console) {
+            return;
+        }
+        m_log_to_console = true;
+        if (m_sink_console) {
+            m_backend->add_output(m_sink_console);
+        }
+    }
 
     auto make_logger(const std::string& name, const bool tail) -> std::shared_ptr<spdlog::logger>
     {
@@ -115,24 +375,17 @@ public:
         ini.get(basename.c_str(), levelname);
         const spdlog::level::level_enum level_parsed = spdlog::level::from_str(levelname);
 
+        const uint16_t logger_id = m_backend->register_logger(name, tail);
         std::shared_ptr<spdlog::logger> logger = std::make_shared<spdlog::logger>(
             name,
-            spdlog::sinks_init_list{
-#if defined _WIN32
-                m_sink_msvc,
-#endif
-                //sink_console,
-                m_sink_log_file,
-                tail ? m_tail_store_log : m_frame_store_log
-            }
+            std::make_shared<Ring_log_sink>(m_backend, logger_id)
         );
-        if (m_log_to_console) {
-            logger->sinks().push_back(m_sink_console);
-        }
         std::shared_ptr<spdlog::logger> logger_copy = logger;
         spdlog::register_logger(logger_copy);
         logger->set_level(level_parsed);
-        logger->flush_on(spdlog::level::trace);
+
+        // Errors wait until drained, so they reach the log file even if the process dies
+        logger->flush_on(spdlog::level::err);
         return logger;
     }
 
@@ -145,44 +398,48 @@ public:
         //   https://learn.microsoft.com/en-us/cpp/windows/latest-supported-vc-redist?view=msvc-170
         // - See also: https://github.com/gabime/spdlog/issues/3145
         m_sink_log_file->set_pattern("[%H:%M:%S %z] [%n] [%L] [%t] %v");
+        m_backend->add_output(m_sink_log_file);
 
 #if defined _WIN32
-        m_sink_msvc = std::make_shared<spdlog::sinks::msvc_sink_mt>();
+        m_backend->add_output(std::make_shared<spdlog::sinks::msvc_sink_mt>());
 #endif
         m_sink_console = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-        m_tail_store_log = std::make_shared<Store_log_sink>();
-        m_frame_store_log = std::make_shared<Store_log_sink>();
+        if (m_log_to_console) {
+            m_backend->add_output(m_sink_console);
+        }
+        m_backend->start();
     }
 
 private:
     Log_sinks()
+        : m_backend{std::make_shared<Log_backend>()}
+    {
+    }
+    ~Log_sinks()
     {
+        // Loggers may outlive this; after stop they write directly to outputs
+        m_backend->stop();
     }
-    ~Log_sinks() {}
 
-#if defined _WIN32
-    std::shared_ptr<spdlog::sinks::msvc_sink_mt>         m_sink_msvc      {};
-#endif
-    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> m_sink_console   {};
-    std::shared_ptr<spdlog::sinks::basic_file_sink_mt>   m_sink_log_file  {};
-    std::shared_ptr<Store_log_sink>                      m_tail_store_log {};
-    std::shared_ptr<Store_log_sink>                      m_frame_store_log{};
-    bool                                                 m_log_to_console {false};
+    std::shared_ptr<Log_backend>                         m_backend       {};
+    std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> m_sink_console  {};
+    std::shared_ptr<spdlog::sinks::basic_file_sink_mt>   m_sink_log_file {};
+    bool                                                 m_log_to_console{false};
 };
 
-auto get_tail_store_log() -> Store_log_sink&
+auto get_tail_store_log() -> Log_store&
 {
-    return Log_sinks::get_instance().get_tail_store_sink();
+    return Log_sinks::get_instance().get_tail_store();
 }
 
-auto get_frame_store_log() -> Store_log_sink&
+auto get_frame_store_log() -> Log_store&
 {
-    return Log_sinks::get_instance().get_frame_store_sink();
+    return Log_sinks::get_instance().get_frame_store();
 }
 
 void log_to_console()
 {
-    Log_sinks::get_instance().set_log_to_console(true);
+    Log_sinks::get_instance().set_log_to_console();
 }
 
 void initialize_log_sinks()
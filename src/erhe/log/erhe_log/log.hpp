@@ -1,12 +1,15 @@
 #pragma once
 
+#include "erhe_log/log_ring.hpp"
+
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
-#include <spdlog/sinks/base_sink.h>
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace erhe::log {
 
@@ -21,36 +24,43 @@ auto make_frame_logger(const std::string& name) -> std::shared_ptr<spdlog::logge
 class Entry
 {
 public:
-    uint64_t                  serial  {0};
-    bool                      selected{false};
+    uint64_t                  serial   {0};
     std::string               timestamp;
     std::string               message;
     std::string               logger;
-    unsigned int              repeat_count{0};
-    spdlog::level::level_enum level       {2/*spdlog::level::level_enum::SPDLOG_LEVEL_INFO*/};
+    spdlog::level::level_enum level    {2/*spdlog::level::level_enum::SPDLOG_LEVEL_INFO*/};
 };
 
-// Sink that keeps log entries in deqeue
-class Store_log_sink final : public spdlog::sinks::base_sink<std::mutex>
+class Log_index_entry
 {
 public:
-    Store_log_sink();
+    uint64_t                  serial{0};
+    spdlog::level::level_enum level {2/*spdlog::level::level_enum::SPDLOG_LEVEL_INFO*/};
+};
 
-    [[nodiscard]] auto get_serial() const -> uint64_t;
-    [[nodiscard]] auto get_log   () -> std::deque<Entry>&;
-    void trim(std::size_t count);
+// Index of log records drained from the log ring. Messages stay in the
+// ring and are decoded only when read; entries disappear once producers
+// have reused their ring slots.
+class Log_store
+{
+public:
+    explicit Log_store(const Log_ring& ring);
 
-protected:
-    void sink_it_(const spdlog::details::log_msg& msg) override;
-    void flush_  ()                                    override;
+    [[nodiscard]] auto get_serial() const -> uint64_t;
+    [[nodiscard]] auto get_entry (uint64_t serial, Entry& entry) const -> bool;
+    void get_index   (std::vector<Log_index_entry>& out) const;
+    void trim        (std::size_t count);
+    void remove_until(uint64_t serial);
+    void push        (const Log_index_entry& entry);
 
 private:
-    uint64_t          m_serial{0};
-    std::deque<Entry> m_entries;
+    const Log_ring&             m_ring;
+    mutable std::mutex          m_mutex;
+    std::deque<Log_index_entry> m_index;
 };
 
-[[nodiscard]] auto get_tail_store_log () -> Store_log_sink&;
-[[nodiscard]] auto get_frame_store_log() -> Store_log_sink&;
+[[nodiscard]] auto get_tail_store_log () -> Log_store&;
+[[nodiscard]] auto get_frame_store_log() -> Log_store&;
 [[nodiscard]] auto get_groupname      (const std::string& s) -> std::string;
 [[nodiscard]] auto get_basename       (const std::string& s) -> std::string;
 [[nodiscard]] auto get_levelname      (spdlog::level::level_enum level) -> std::string;
@@ -0,0 +1,210 @@
+#include "erhe_log/log_ring.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace erhe::log {
+
+Log_ring::Log_ring(const std::size_t slot_count)
+    : m_slot_count{slot_count}
+    , m_mask      {slot_count - 1}
+    , m_slots     {std::make_unique<Slot[]>(slot_count)}
+    , m_loggers   {std::make_unique<Logger_info[]>(c_max_loggers)}
+{
+    ERHE_VERIFY(slot_count >= c_max_slots_per_record);
+    ERHE_VERIFY((slot_count & (slot_count - 1)) == 0);
+    for (std::size_t i = 0; i < slot_count; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Log_ring::~Log_ring() noexcept = default;
+
+auto Log_ring::register_logger(const std::string_view name, const bool tail) -> uint16_t
+{
+    const std::lock_guard<std::mutex> lock{m_logger_mutex};
+    const std::size_t logger_id = m_logger_count.load(std::memory_order_relaxed);
+    ERHE_VERIFY(logger_id < c_max_loggers);
+    m_loggers[logger_id].name = std::string{name};
+    m_loggers[logger_id].tail = tail;
+    m_logger_count.store(logger_id + 1, std::memory_order_release);
+    return static_cast<uint16_t>(logger_id);
+}
+
+auto Log_ring::get_logger_info(const uint16_t logger_id) const -> const Logger_info&
+{
+    ERHE_VERIFY(logger_id < m_logger_count.load(std::memory_order_acquire));
+    return m_loggers[logger_id];
+}
+
+auto Log_ring::get_slot_count() const -> std::size_t
+{
+    return m_slot_count;
+}
+
+auto Log_ring::get_write_position() const -> uint64_t
+{
+    return m_write_position.load(std::memory_order_acquire);
+}
+
+auto Log_ring::get_read_position() const -> uint64_t
+{
+    return m_read_position.load(std::memory_order_acquire);
+}
+
+auto Log_ring::pack_header(const Slot_header& header) -> uint64_t
+{
+    return
+        (static_cast<uint64_t>(header.logger_id   )      ) |
+        (static_cast<uint64_t>(header.payload_size) << 16) |
+        (static_cast<uint64_t>(header.level       ) << 32) |
+        (static_cast<uint64_t>(header.slot_count  ) << 40);
+}
+
+auto Log_ring::unpack_header(const uint64_t header) -> Slot_header
+{
+    return Slot_header{
+        .logger_id    = static_cast<uint16_t>( header        & 0xffffu),
+        .payload_size = static_cast<uint16_t>((header >> 16) & 0xffffu),
+        .level        = static_cast<uint8_t >((header >> 32) & 0xffu),
+        .slot_count   = static_cast<uint8_t >((header >> 40) & 0xffu)
+    };
+}
+
+auto Log_ring::get_slot(const uint64_t position) const -> const Slot&
+{
+    return m_slots[position & m_mask];
+}
+
+auto Log_ring::acquire_slot(const uint64_t position) -> Slot&
+{
+    Slot& slot = m_slots[position & m_mask];
+
+    // Slot becomes free once the previous lap has been drained
+    while (slot.sequence.load(std::memory_order_acquire) != position) {
+        std::this_thread::yield();
+    }
+
+    // History readers must see the slot as being written before any data changes
+    slot.sequence.store(c_slot_writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot;
+}
+
+void Log_ring::write(
+    const uint16_t                  logger_id,
+    const spdlog::level::level_enum level,
+    const int64_t                   time_ns,
+    const uint64_t                  thread_id,
+    const std::string_view          payload
+)
+{
+    const std::size_t payload_size = std::min(payload.size(), c_max_payload_size);
+    const std::size_t slot_count   = std::max(
+        std::size_t{1},
+        (payload_size + c_slot_payload_size - 1) / c_slot_payload_size
+    );
+    const uint64_t first_position = m_write_position.fetch_add(slot_count, std::memory_order_relaxed);
+
+    // Continuation slots are published before the first slot; once the
+    // consumer sees the first slot published, the whole record is.
+    for (std::size_t i = slot_count; i > 0;) {
+        --i;
+        const uint64_t    position     = first_position + i;
+        Slot&             slot         = acquire_slot(position);
+        const std::size_t chunk_offset = i * c_slot_payload_size;
+        const std::size_t chunk_size   = std::min(c_slot_payload_size, payload_size - std::min(payload_size, chunk_offset));
+        for (std::size_t offset = 0, word_index = 0; offset < chunk_size; offset += sizeof(uint64_t), ++word_index) {
+            uint64_t word{0};
+            std::memcpy(&word, payload.data() + chunk_offset + offset, std::min(sizeof(uint64_t), chunk_size - offset));
+            slot.payload[word_index].store(word, std::memory_order_relaxed);
+        }
+        if (i == 0) {
+            slot.time_ns  .store(time_ns,   std::memory_order_relaxed);
+            slot.thread_id.store(thread_id, std::memory_order_relaxed);
+            slot.header   .store(
+                pack_header(
+                    Slot_header{
+                        .logger_id    = logger_id,
+                        .payload_size = static_cast<uint16_t>(payload_size),
+                        .level        = static_cast<uint8_t>(level),
+                        .slot_count   = static_cast<uint8_t>(slot_count)
+                    }
+                ),
+                std::memory_order_relaxed
+            );
+        }
+        slot.sequence.store(position + 1, std::memory_order_release);
+    }
+}
+
+void Log_ring::copy_record(const uint64_t position, Log_record& record) const
+{
+    const Slot&       first        = get_slot(position);
+    const Slot_header header       = unpack_header(first.header.load(std::memory_order_relaxed));
+    const std::size_t slot_count   = std::min(static_cast<std::size_t>(header.slot_count), c_max_slots_per_record);
+    const std::size_t payload_size = std::min(static_cast<std::size_t>(header.payload_size), slot_count * c_slot_payload_size);
+    record.position  = position;
+    record.time_ns   = first.time_ns  .load(std::memory_order_relaxed);
+    record.thread_id = first.thread_id.load(std::memory_order_relaxed);
+    record.logger_id = header.logger_id;
+    record.level     = static_cast<spdlog::level::level_enum>(std::min(header.level, static_cast<uint8_t>(spdlog::level::off)));
+    record.payload.resize(payload_size);
+    for (std::size_t offset = 0; offset < payload_size; offset += sizeof(uint64_t)) {
+        const Slot&       slot       = get_slot(position + offset / c_slot_payload_size);
+        const std::size_t word_index = (offset % c_slot_payload_size) / sizeof(uint64_t);
+        const uint64_t    word       = slot.payload[word_index].load(std::memory_order_relaxed);
+        std::memcpy(record.payload.data() + offset, &word, std::min(sizeof(uint64_t), payload_size - offset));
+    }
+}
+
+auto Log_ring::try_drain(Log_record& record) -> bool
+{
+    const uint64_t position = m_read_position.load(std::memory_order_relaxed);
+    Slot&          first    = m_slots[position & m_mask];
+    if (first.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    copy_record(position, record);
+
+    // Release slots to producers of the next lap
+    const std::size_t slot_count = unpack_header(first.header.load(std::memory_order_relaxed)).slot_count;
+    for (std::size_t i = 0; i < slot_count; ++i) {
+        m_slots[(position + i) & m_mask].sequence.store(position + i + m_slot_count, std::memory_order_release);
+    }
+    m_read_position.store(position + slot_count, std::memory_order_release);
+    return true;
+}
+
+auto Log_ring::read_history(const uint64_t position, Log_record& record) const -> bool
+{
+    const Slot& first = get_slot(position);
+    if (first.sequence.load(std::memory_order_acquire) != position + m_slot_count) {
+        return false;
+    }
+    const std::size_t slot_count = unpack_header(first.header.load(std::memory_order_relaxed)).slot_count;
+    if ((slot_count == 0) || (slot_count > c_max_slots_per_record)) {
+        return false;
+    }
+    for (std::size_t i = 1; i < slot_count; ++i) {
+        if (get_slot(position + i).sequence.load(std::memory_order_acquire) != position + i + m_slot_count) {
+            return false;
+        }
+    }
+
+    copy_record(position, record);
+
+    // Record is valid only if no producer claimed any of its slots while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    for (std::size_t i = 0; i < slot_count; ++i) {
+        if (get_slot(position + i).sequence.load(std::memory_order_relaxed) != position + i + m_slot_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace erhe::log
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <spdlog/common.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace erhe::log {
+
+// Record read from Log_ring
+class Log_record
+{
+public:
+    uint64_t                  position {0}; // Ring position of first slot, used as serial
+    int64_t                   time_ns  {0}; // spdlog::log_clock time since epoch
+    uint64_t                  thread_id{0};
+    uint16_t                  logger_id{0};
+    spdlog::level::level_enum level    {spdlog::level::info};
+    std::string               payload;      // Reused between reads
+};
+
+class Logger_info
+{
+public:
+    std::string name;
+    bool        tail{true};
+};
+
+// Multi-producer, single-consumer ring of fixed size slots for log records.
+//
+// Producers claim consecutive slots with a single fetch_add and publish
+// them through per slot sequence numbers, without locks. Payload which
+// does not fit one slot continues in the following slots. Producers wait
+// only when the ring is full.
+//
+// The consumer drains records in order. Drained slots keep their contents
+// until producers reuse them, so recent history can be read directly from
+// the ring. History reads are validated against slot sequence numbers,
+// seqlock style, and fail once the record has been overwritten. Since a
+// history read can overlap with a producer reusing the slot, slot fields
+// are relaxed atomics; these compile to plain loads and stores.
+class Log_ring
+{
+public:
+    static constexpr std::size_t c_slot_size            = 256;
+    static constexpr std::size_t c_max_slots_per_record = 16;
+    static constexpr std::size_t c_max_loggers          = 1024;
+
+    explicit Log_ring(std::size_t slot_count);
+    ~Log_ring() noexcept;
+
+    Log_ring(const Log_ring&) = delete;
+    auto operator=(const Log_ring&) -> Log_ring& = delete;
+
+    // Logger registry; names are referred to by logger id in records
+    [[nodiscard]] auto register_logger(std::string_view name, bool tail) -> uint16_t;
+    [[nodiscard]] auto get_logger_info(uint16_t logger_id) const -> const Logger_info&;
+
+    // Producer API, can be called from any thread. Payload is truncated
+    // to what fits in c_max_slots_per_record slots.
+    void write(
+        uint16_t                  logger_id,
+        spdlog::level::level_enum level,
+        int64_t                   time_ns,
+        uint64_t                  thread_id,
+        std::string_view          payload
+    );
+
+    // Consumer API, must be called from a single thread at a time.
+    // Returns false if the next record has not been published yet.
+    [[nodiscard]] auto try_drain(Log_record& record) -> bool;
+
+    // Reads an already drained record; can be called from any thread.
+    // Returns false if the record is no longer available.
+    [[nodiscard]] auto read_history(uint64_t position, Log_record& record) const -> bool;
+
+    [[nodiscard]] auto get_slot_count    () const -> std::size_t;
+    [[nodiscard]] auto get_write_position() const -> uint64_t;
+    [[nodiscard]] auto get_read_position () const -> uint64_t;
+
+private:
+    static constexpr std::size_t c_slot_header_size  = 32;
+    static constexpr std::size_t c_slot_payload_size = c_slot_size - c_slot_header_size;
+    static constexpr std::size_t c_slot_payload_word_count = c_slot_payload_size / sizeof(uint64_t);
+    static constexpr std::size_t c_max_payload_size  = c_slot_payload_size * c_max_slots_per_record;
+    static constexpr uint64_t    c_slot_writing      = ~uint64_t{0};
+
+    // Sequence of slot for ring position p is:
+    // - p                  : free, can be claimed by producer of position p
+    // - c_slot_writing     : producer is writing the slot
+    // - p + 1              : published, not yet drained
+    // - p + slot count     : drained, available for history reads
+    //                        (which is also free for the next lap)
+    // Header fields are valid in the first slot of a record only.
+    // Header packs logger id, payload size (whole record), level and slot
+    // count (whole record), see pack_header().
+    class alignas(64) Slot
+    {
+    public:
+        std::atomic<uint64_t>                                         sequence {0};
+        std::atomic<int64_t>                                          time_ns  {0};
+        std::atomic<uint64_t>                                         thread_id{0};
+        std::atomic<uint64_t>                                         header   {0};
+        std::array<std::atomic<uint64_t>, c_slot_payload_word_count> payload  {};
+    };
+    static_assert(sizeof(Slot) == c_slot_size);
+    static_assert(c_slot_payload_size % sizeof(uint64_t) == 0);
+
+    class Slot_header
+    {
+    public:
+        uint16_t logger_id   {0};
+        uint16_t payload_size{0};
+        uint8_t  level       {0};
+        uint8_t  slot_count  {0};
+    };
+    [[nodiscard]] static auto pack_header  (const Slot_header& header) -> uint64_t;
+    [[nodiscard]] static auto unpack_header(uint64_t header) -> Slot_header;
+
+    [[nodiscard]] auto acquire_slot(uint64_t position) -> Slot&;
+    [[nodiscard]] auto get_slot    (uint64_t position) const -> const Slot&;
+    void copy_record(uint64_t position, Log_record& record) const;
+
+    std::size_t                       m_slot_count;
+    uint64_t                          m_mask;
+    std::unique_ptr<Slot[]>           m_slots;
+    alignas(64) std::atomic<uint64_t> m_write_position{0};
+    alignas(64) std::atomic<uint64_t> m_read_position {0};
+
+    std::mutex                        m_logger_mutex;
+    std::unique_ptr<Logger_info[]>    m_loggers;
+    std::atomic<std::size_t>          m_logger_count{0};
+};
+
+} // namespace erhe::log
@@ -70,4 +70,26 @@ auto timestamp_short() -> std::string
     );
 }
 
+auto timestamp_short(const std::chrono::system_clock::time_point time) -> std::string
+{
+    const auto        since_epoch  = time.time_since_epoch();
+    const std::time_t seconds      = static_cast<std::time_t>(std::chrono::duration_cast<std::chrono::seconds>(since_epoch).count());
+    const auto        milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count() % 1000;
+
+    struct tm local_time;
+#if defined (_WIN32) // _MSC_VER
+    localtime_s(&local_time, &seconds);
+#else
+    localtime_r(&seconds, &local_time);
+#endif
+
+    return fmt::format(
+        "{:02}:{:02}:{:02}.{:03d} ",
+        local_time.tm_hour,
+        local_time.tm_min,
+        local_time.tm_sec,
+        milliseconds
+    );
+}
+
 }
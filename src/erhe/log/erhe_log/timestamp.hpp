@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 
 namespace erhe::log
@@ -7,5 +8,6 @@ namespace erhe::log
 
 auto timestamp      () -> std::string;
 auto timestamp_short() -> std::string;
+auto timestamp_short(std::chrono::system_clock::time_point time) -> std::string;
 
 }
@@ -1,47 +1,321 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
-#include <queue>
+#include <mutex>
 #include <vector>
 
 namespace erhe::message_bus {
 
-//// TODO use something like https://github.com/TheWisp/signals instead
+using Receiver_handle = uint64_t;
+
+static constexpr Receiver_handle c_invalid_receiver_handle{0};
+
+// Messages are either sent immediately with send_message(), or queued with
+// queue_message() and delivered in one batch by update().
+//
+// - queue_message() may be called from any thread. Queued messages are
+//   moved to a fixed size lock-free ring (multiple producers, single
+//   consumer), and no memory is allocated. If the ring is full, messages
+//   go to a mutex protected overflow list, so no message is lost; order
+//   is preserved unless the ring overflows.
+// - send_message(), update(), add_receiver() and remove_receiver() must
+//   be called from the thread that owns the bus (typically once per frame
+//   for update()).
+// - Messages queued by receivers during update() are delivered by the
+//   next update().
+// - Receivers may be added and removed during delivery; changes take
+//   effect after the outermost delivery completes.
+// - If a coalesce key function is set, queued messages with the same non
+//   zero key are delivered once per update(). The message is delivered at
+//   the position of the first queued message with that key, with contents
+//   of the most recently queued one; order relative to other messages
+//   follows the first occurrence.
 template <typename Message_type>
 class Message_bus
 {
 public:
-    void add_receiver(std::function<void(Message_type&)> message_receiver)
+    using Receiver          = std::function<void(Message_type&)>;
+    using Coalesce_function = auto (*)(const Message_type&) -> uint64_t;
+
+    static constexpr std::size_t c_default_queue_capacity{1024};
+
+    explicit Message_bus(const std::size_t queue_capacity = c_default_queue_capacity)
     {
-        m_receivers.push_back(message_receiver);
+        std::size_t capacity = 2;
+        while (capacity < queue_capacity) {
+            capacity *= 2;
+        }
+        m_mask  = capacity - 1;
+        m_slots = std::make_unique<Slot[]>(capacity);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_batch.reserve(capacity);
     }
 
-    void send_message(Message_type message)
+    Message_bus           (const Message_bus&) = delete;
+    Message_bus& operator=(const Message_bus&) = delete;
+    Message_bus           (Message_bus&&)      = delete;
+    Message_bus& operator=(Message_bus&&)      = delete;
+
+    auto add_receiver(Receiver message_receiver) -> Receiver_handle
+    {
+        const Receiver_handle handle = ++m_last_receiver_handle;
+        if (m_dispatch_depth > 0) {
+            m_added_receivers.push_back(Receiver_entry{handle, std::move(message_receiver)});
+        } else {
+            m_receivers.push_back(Receiver_entry{handle, std::move(message_receiver)});
+        }
+        return handle;
+    }
+
+    void remove_receiver(const Receiver_handle handle)
     {
-        for (auto iter = m_receivers.begin(); iter != m_receivers.end(); iter++) {
-            (*iter)(message);
+        if (handle == c_invalid_receiver_handle) {
+            return;
+        }
+        for (std::vector<Receiver_entry>* receivers : { &m_receivers, &m_added_receivers }) {
+            for (auto i = receivers->begin(), end = receivers->end(); i != end; ++i) {
+                if (i->handle != handle) {
+                    continue;
+                }
+                if (m_dispatch_depth > 0) {
+                    // Receiver may be executing; erased after delivery
+                    i->handle = c_invalid_receiver_handle;
+                    m_has_removed_receivers = true;
+                } else {
+                    receivers->erase(i);
+                }
+                return;
+            }
         }
     }
 
+    void set_coalesce_function(const Coalesce_function coalesce_function)
+    {
+        m_coalesce_function = coalesce_function;
+    }
+
+    void send_message(Message_type message)
+    {
+        dispatch(message);
+    }
+
     void queue_message(Message_type message)
     {
-        m_messages.push(message);
+        if (try_push(message)) {
+            return;
+        }
+        const std::lock_guard<std::mutex> lock{m_overflow_mutex};
+        m_overflow.push_back(std::move(message));
+        m_overflow_count.store(m_overflow.size(), std::memory_order_release);
     }
 
     void update()
     {
-        while (!m_messages.empty()) {
-            for (auto iter = m_receivers.begin(); iter != m_receivers.end(); iter++) {
-                (*iter)(m_messages.front());
+        // Nested update() from a receiver is ignored; messages are left for the next update()
+        if (m_dispatch_depth > 0) {
+            return;
+        }
+
+        m_batch.clear();
+        Message_type message;
+        while (try_pop(message)) {
+            m_batch.push_back(std::move(message));
+        }
+        if (m_overflow_count.load(std::memory_order_acquire) > 0) {
+            const std::lock_guard<std::mutex> lock{m_overflow_mutex};
+            for (Message_type& overflow_message : m_overflow) {
+                m_batch.push_back(std::move(overflow_message));
             }
-            m_messages.pop();
+            m_overflow.clear();
+            m_overflow_count.store(0, std::memory_order_release);
+        }
+        if (m_batch.empty()) {
+            return;
+        }
+
+        if (m_coalesce_function != nullptr) {
+            coalesce_batch();
+        }
+
+        for (std::size_t i = 0, end = m_batch.size(); i < end; ++i) {
+            dispatch(m_batch[i]);
         }
+
+        // Release message resources now rather than at next update()
+        m_batch.clear();
+    }
+
+    [[nodiscard]] auto get_receiver_count() const -> std::size_t
+    {
+        return m_receivers.size() + m_added_receivers.size();
     }
 
 private:
-    std::vector<std::function<void (Message_type&)>> m_receivers;
-    std::queue<Message_type>                         m_messages;
+    class Slot
+    {
+    public:
+        std::atomic<std::size_t> sequence{0};
+        Message_type             message {};
+    };
+
+    class Receiver_entry
+    {
+    public:
+        Receiver_handle handle{c_invalid_receiver_handle};
+        Receiver        receiver;
+    };
+
+    // Coalesce table entry; entries from earlier batches are recognized by
+    // generation, so the table does not need to be cleared between batches.
+    class Coalesce_entry
+    {
+    public:
+        uint64_t    key        {0};
+        uint64_t    generation {0};
+        std::size_t batch_index{0};
+    };
+
+    // Bounded multi producer queue; each slot sequence tells whether the
+    // slot is free for the producer at that position (sequence == position)
+    // or holds a message for the consumer (sequence == position + 1).
+    auto try_push(Message_type& message) -> bool
+    {
+        std::size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot&               slot       = m_slots[position & m_mask];
+            const std::size_t   sequence   = slot.sequence.load(std::memory_order_acquire);
+            const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.message = std::move(message);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // full
+            } else {
+                position = m_enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Only called from the owning thread
+    auto try_pop(Message_type& out_message) -> bool
+    {
+        Slot&             slot     = m_slots[m_dequeue_position & m_mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeue_position + 1) {
+            return false;
+        }
+        out_message  = std::move(slot.message);
+        slot.message = Message_type{};
+        slot.sequence.store(m_dequeue_position + m_mask + 1, std::memory_order_release);
+        ++m_dequeue_position;
+        return true;
+    }
+
+    // Compacts the batch in place so that only one message per non zero
+    // key remains, at the position of the first message with that key.
+    // Keys are looked up from a reused open addressing table with linear
+    // probing, sized to at most half full.
+    void coalesce_batch()
+    {
+        const std::size_t batch_size = m_batch.size();
+        if (m_coalesce_table.size() < 2 * batch_size) {
+            std::size_t table_size = 16;
+            while (table_size < 2 * batch_size) {
+                table_size *= 2;
+            }
+            m_coalesce_table.assign(table_size, Coalesce_entry{});
+            m_coalesce_generation = 0;
+        }
+        ++m_coalesce_generation;
+
+        const std::size_t table_mask  = m_coalesce_table.size() - 1;
+        std::size_t       write_index = 0;
+        for (std::size_t read_index = 0; read_index < batch_size; ++read_index) {
+            const uint64_t key = m_coalesce_function(m_batch[read_index]);
+            if (key != 0) {
+                uint64_t hash = key * 0x9e3779b97f4a7c15ull;
+                hash ^= (hash >> 32);
+                std::size_t table_index = static_cast<std::size_t>(hash) & table_mask;
+                while (
+                    (m_coalesce_table[table_index].generation == m_coalesce_generation) &&
+                    (m_coalesce_table[table_index].key != key)
+                ) {
+                    table_index = (table_index + 1) & table_mask;
+                }
+                Coalesce_entry& entry = m_coalesce_table[table_index];
+                if (entry.generation == m_coalesce_generation) {
+                    // Later message replaces contents of the first one
+                    m_batch[entry.batch_index] = std::move(m_batch[read_index]);
+                    continue;
+                }
+                entry.key         = key;
+                entry.generation  = m_coalesce_generation;
+                entry.batch_index = write_index;
+            }
+            if (write_index != read_index) {
+                m_batch[write_index] = std::move(m_batch[read_index]);
+            }
+            ++write_index;
+        }
+        m_batch.erase(m_batch.begin() + static_cast<std::ptrdiff_t>(write_index), m_batch.end());
+    }
+
+    void dispatch(Message_type& message)
+    {
+        ++m_dispatch_depth;
+        for (std::size_t i = 0, end = m_receivers.size(); i < end; ++i) {
+            if (m_receivers[i].handle != c_invalid_receiver_handle) {
+                m_receivers[i].receiver(message);
+            }
+        }
+        --m_dispatch_depth;
+        if (m_dispatch_depth == 0) {
+            apply_receiver_changes();
+        }
+    }
+
+    void apply_receiver_changes()
+    {
+        if (m_has_removed_receivers) {
+            for (std::vector<Receiver_entry>* receivers : { &m_receivers, &m_added_receivers }) {
+                std::erase_if(*receivers, [](const Receiver_entry& entry) { return entry.handle == c_invalid_receiver_handle; });
+            }
+            m_has_removed_receivers = false;
+        }
+        for (Receiver_entry& entry : m_added_receivers) {
+            m_receivers.push_back(std::move(entry));
+        }
+        m_added_receivers.clear();
+    }
+
+    // Producer side, any thread
+    std::unique_ptr<Slot[]>                   m_slots;
+    std::size_t                               m_mask{0};
+    alignas(64) std::atomic<std::size_t>      m_enqueue_position{0};
+    std::atomic<std::size_t>                  m_overflow_count  {0};
+    std::mutex                                m_overflow_mutex;
+    std::vector<Message_type>                 m_overflow;
+
+    // Owning thread only
+    alignas(64) std::size_t                   m_dequeue_position{0};
+    std::vector<Receiver_entry>               m_receivers;
+    std::vector<Receiver_entry>               m_added_receivers;
+    Receiver_handle                           m_last_receiver_handle{c_invalid_receiver_handle};
+    int                                       m_dispatch_depth{0};
+    bool                                      m_has_removed_receivers{false};
+    Coalesce_function                         m_coalesce_function{nullptr};
+    std::vector<Message_type>                 m_batch;
+    std::vector<Coalesce_entry>               m_coalesce_table;
+    uint64_t                                  m_coalesce_generation{0};
 };
 
-}
+} // namespace erhe::message_bus
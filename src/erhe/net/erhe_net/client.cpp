@@ -13,7 +13,10 @@ Client::~Client()
 }
 
 Client::Client(Client&& other) noexcept
-    : m_socket{std::move(other.m_socket)}
+    : m_socket       {std::move(other.m_socket)}
+#if defined(ERHE_OS_LINUX)
+    , m_epoll_sockets{std::move(other.m_epoll_sockets)}
+#endif
 {
     log_client->trace("Client move constructor");
 }
@@ -22,12 +25,19 @@ auto Client::operator=(Client&& other) noexcept -> Client&
 {
     log_client->trace("Client move assignment");
     m_socket = std::move(other.m_socket);
+#if defined(ERHE_OS_LINUX)
+    m_epoll_sockets = std::move(other.m_epoll_sockets);
+#endif
     return *this;
 }
 
 auto Client::connect(const char* address, const int port) -> bool
 {
-    return m_socket.connect(address, port);
+    const bool result = m_socket.connect(address, port);
+#if defined(ERHE_OS_LINUX)
+    m_epoll_sockets.forget(m_socket.get_socket());
+#endif
+    return result;
 }
 
 void Client::disconnect()
@@ -41,27 +51,40 @@ auto Client::poll(const int timeout_ms) -> bool
     if (m_socket.get_state() == Socket::State::CLOSED) {
         return true; // NOP
     }
+
+    const SOCKET socket = m_socket.get_socket();
+#if defined(ERHE_OS_LINUX)
+    m_epoll_sockets.begin_update();
+    m_epoll_sockets.update(socket, m_socket.get_poll_flags());
+    m_epoll_sockets.end_update();
+
+    // Call epoll_wait() to find out if there is work to do
+    const int poll_res = m_epoll_sockets.wait(timeout_ms);
+    const Epoll_sockets& ready_sockets = m_epoll_sockets;
+#else
     Select_sockets select_sockets;
 
     m_socket.pre_select(select_sockets);
 
     // Call select() to find out if there is work to do
-    const int select_res = select_sockets.select(timeout_ms);
-    if (select_res == SOCKET_ERROR) {
-        log_client->trace("client select() returned error {}", get_net_last_error_message());
+    const int poll_res = select_sockets.select(timeout_ms);
+    const Select_sockets& ready_sockets = select_sockets;
+#endif
+    if (poll_res == SOCKET_ERROR) {
+        log_client->trace("client poll returned error {}", get_net_last_error_message());
         return false; // TODO
     }
-    if (select_res == 0) {
+    if (poll_res == 0) {
         return true; // NOP
     }
 
     switch (m_socket.get_state()) {
         case Socket::State::CLIENT_CONNECTING: {
-            m_socket.post_select_connect(select_sockets);
+            m_socket.process_connect(ready_sockets.has_write(socket), ready_sockets.has_except(socket));
             break;
         }
         case Socket::State::CONNECTED: {
-            m_socket.post_select_send_recv(select_sockets);
+            m_socket.process_send_recv(ready_sockets.has_read(socket), ready_sockets.has_write(socket));
             break;
         }
         default: {
@@ -72,12 +95,19 @@ auto Client::poll(const int timeout_ms) -> bool
     return true;
 }
 
+auto Client::send(const void* const data, const std::size_t length) -> bool
+{
+    return m_socket.send(data, length);
+}
+
+auto Client::send(const std::span<const uint8_t> message) -> bool
+{
+    return m_socket.send(message);
+}
+
 auto Client::send(const std::string& message) -> bool
 {
-    return m_socket.send(
-        message.data(),
-        static_cast<int>(message.size())
-    );
+    return m_socket.send(message.data(), message.size());
 }
 
 void Client::set_receive_handler(Receive_handler receive_handler)
@@ -90,4 +120,9 @@ auto Client::get_state() -> Socket::State
     return m_socket.get_state();
 }
 
+auto Client::get_send_queue_size() const -> std::size_t
+{
+    return m_socket.get_send_buffer_size();
+}
+
 }
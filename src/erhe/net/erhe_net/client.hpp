@@ -2,6 +2,10 @@
 
 #include "erhe_net/socket.hpp"
 
+#if defined(ERHE_OS_LINUX)
+#   include "erhe_net/epoll_sockets.hpp"
+#endif
+
 namespace erhe::net {
 
 class Client
@@ -16,13 +20,19 @@ public:
 
     auto connect            (const char* address, int port) -> bool;
     void disconnect         ();
+    auto send               (const void* data, std::size_t length) -> bool;
+    auto send               (std::span<const uint8_t> message) -> bool;
     auto send               (const std::string& message) -> bool;
     void set_receive_handler(Receive_handler receive_handler);
     auto poll               (int timeout_ms) -> bool;
     auto get_state          () -> Socket::State;
+    auto get_send_queue_size() const -> std::size_t;
 
 private:
-    Socket m_socket;
+    Socket        m_socket;
+#if defined(ERHE_OS_LINUX)
+    Epoll_sockets m_epoll_sockets;
+#endif
 };
 
 } // namespace erhe::net
@@ -0,0 +1,186 @@
+#include "erhe_net/epoll_sockets.hpp"
+#include "erhe_net/net_log.hpp"
+#include "erhe_net/select_sockets.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <sys/epoll.h>
+
+namespace erhe::net {
+
+namespace {
+
+constexpr int c_max_event_count{64};
+
+[[nodiscard]] auto get_epoll_events(const unsigned int flags) -> uint32_t
+{
+    uint32_t events = 0;
+    if ((flags & Select_sockets::flag_read) != 0) {
+        events |= EPOLLIN;
+    }
+    if ((flags & Select_sockets::flag_write) != 0) {
+        events |= EPOLLOUT;
+    }
+    // EPOLLERR and EPOLLHUP are always reported
+    return events;
+}
+
+[[nodiscard]] auto get_select_flags(const uint32_t events) -> unsigned int
+{
+    unsigned int flags = 0;
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) != 0) {
+        flags |= Select_sockets::flag_read; // recv() detects close
+    }
+    if ((events & EPOLLOUT) != 0) {
+        flags |= Select_sockets::flag_write;
+    }
+    if ((events & EPOLLERR) != 0) {
+        flags |= Select_sockets::flag_except;
+    }
+    return flags;
+}
+
+} // anonymous namespace
+
+Epoll_sockets::Epoll_sockets()
+    : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (m_epoll_fd < 0) {
+        log_net->error("epoll_create1() failed with error {}", get_net_last_error_message());
+    }
+}
+
+Epoll_sockets::~Epoll_sockets()
+{
+    if (m_epoll_fd >= 0) {
+        ::close(m_epoll_fd);
+    }
+}
+
+Epoll_sockets::Epoll_sockets(Epoll_sockets&& other) noexcept
+    : m_epoll_fd     {other.m_epoll_fd}
+    , m_generation   {other.m_generation}
+    , m_registrations{std::move(other.m_registrations)}
+    , m_ready_flags  {std::move(other.m_ready_flags)}
+    , m_ready_sockets{std::move(other.m_ready_sockets)}
+{
+    other.m_epoll_fd = -1;
+}
+
+auto Epoll_sockets::operator=(Epoll_sockets&& other) noexcept -> Epoll_sockets&
+{
+    if (m_epoll_fd >= 0) {
+        ::close(m_epoll_fd);
+    }
+    m_epoll_fd       = other.m_epoll_fd;
+    m_generation     = other.m_generation;
+    m_registrations  = std::move(other.m_registrations);
+    m_ready_flags    = std::move(other.m_ready_flags);
+    m_ready_sockets  = std::move(other.m_ready_sockets);
+    other.m_epoll_fd = -1;
+    return *this;
+}
+
+void Epoll_sockets::begin_update()
+{
+    ++m_generation;
+}
+
+void Epoll_sockets::update(const SOCKET socket, const unsigned int flags)
+{
+    if (!is_socket_good(socket) || (m_epoll_fd < 0)) {
+        return;
+    }
+
+    const auto i = m_registrations.find(socket);
+    if (flags == 0) {
+        if (i != m_registrations.end()) {
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, socket, nullptr);
+            m_registrations.erase(i);
+        }
+        return;
+    }
+
+    if (i != m_registrations.end()) {
+        i->second.generation = m_generation;
+        if (i->second.flags == flags) {
+            return; // Common case, no system call needed
+        }
+    }
+
+    epoll_event event{};
+    event.events  = get_epoll_events(flags);
+    event.data.fd = socket;
+    const int operation = (i != m_registrations.end()) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    const int result    = epoll_ctl(m_epoll_fd, operation, socket, &event);
+    if (result != 0) {
+        log_net->error("epoll_ctl() failed with error {}", get_net_last_error_message());
+        return;
+    }
+    m_registrations[socket] = Registration{
+        .flags      = flags,
+        .generation = m_generation
+    };
+}
+
+void Epoll_sockets::end_update()
+{
+    for (auto i = m_registrations.begin(); i != m_registrations.end();) {
+        if (i->second.generation == m_generation) {
+            ++i;
+            continue;
+        }
+        // Closed sockets have already been removed by the kernel; this is for sockets still open
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, i->first, nullptr);
+        i = m_registrations.erase(i);
+    }
+}
+
+void Epoll_sockets::forget(const SOCKET socket)
+{
+    m_registrations.erase(socket);
+}
+
+auto Epoll_sockets::wait(const int timeout_ms) -> int
+{
+    m_ready_flags.clear();
+    m_ready_sockets.clear();
+    if (m_epoll_fd < 0) {
+        return SOCKET_ERROR;
+    }
+
+    epoll_event events[c_max_event_count];
+    const int event_count = epoll_wait(m_epoll_fd, events, c_max_event_count, timeout_ms);
+    if (event_count < 0) {
+        return (get_net_last_error() == EINTR) ? 0 : SOCKET_ERROR;
+    }
+    // Level triggered; events beyond c_max_event_count are reported by next wait()
+    for (int i = 0; i < event_count; ++i) {
+        const SOCKET socket = events[i].data.fd;
+        m_ready_flags[socket] = get_select_flags(events[i].events);
+        m_ready_sockets.push_back(socket);
+    }
+    return event_count;
+}
+
+auto Epoll_sockets::get_ready_flags(const SOCKET socket) const -> unsigned int
+{
+    const auto i = m_ready_flags.find(socket);
+    return (i != m_ready_flags.end()) ? i->second : 0;
+}
+
+auto Epoll_sockets::has_read(const SOCKET socket) const -> bool
+{
+    return (get_ready_flags(socket) & Select_sockets::flag_read) != 0;
+}
+
+auto Epoll_sockets::has_write(const SOCKET socket) const -> bool
+{
+    return (get_ready_flags(socket) & Select_sockets::flag_write) != 0;
+}
+
+auto Epoll_sockets::has_except(const SOCKET socket) const -> bool
+{
+    return (get_ready_flags(socket) & Select_sockets::flag_except) != 0;
+}
+
+} // namespace erhe::net
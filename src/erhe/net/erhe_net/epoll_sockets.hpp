@@ -0,0 +1,60 @@
+#pragma once
+
+#include "erhe_net/net_os.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::net {
+
+// epoll() based alternative to Select_sockets (Linux only).
+//
+// Sockets stay registered between polls, so poll cost depends on the
+// number of ready sockets instead of the number of watched sockets, and
+// there is no FD_SETSIZE limit. Flags are the Select_sockets::flag_*
+// values, as returned by Socket::get_poll_flags().
+//
+// Usage for each poll: begin_update(), update() for each live socket,
+// end_update(), wait(), then has_read() / has_write() / has_except() or
+// get_ready_sockets(). Socket numbers of closed sockets are reused, so
+// forget() must be called for each newly created socket.
+class Epoll_sockets
+{
+public:
+    Epoll_sockets();
+    ~Epoll_sockets();
+    Epoll_sockets (const Epoll_sockets&) = delete;
+    void operator=(const Epoll_sockets&) = delete;
+    Epoll_sockets (Epoll_sockets&& other) noexcept;
+    auto operator=(Epoll_sockets&& other) noexcept -> Epoll_sockets&;
+
+    void begin_update();
+    void update      (SOCKET socket, unsigned int flags); // flags == 0 removes socket
+    void end_update  (); // Removes sockets which were not updated since begin_update()
+    void forget      (SOCKET socket);
+    auto wait        (int timeout_ms) -> int;
+
+    auto has_read         (SOCKET socket) const -> bool;
+    auto has_write        (SOCKET socket) const -> bool;
+    auto has_except       (SOCKET socket) const -> bool;
+    auto get_ready_sockets() const -> const std::vector<SOCKET>& { return m_ready_sockets; }
+
+private:
+    class Registration
+    {
+    public:
+        unsigned int flags     {0};
+        uint64_t     generation{0};
+    };
+
+    auto get_ready_flags(SOCKET socket) const -> unsigned int;
+
+    int                                        m_epoll_fd  {-1};
+    uint64_t                                   m_generation{0};
+    std::unordered_map<SOCKET, Registration>   m_registrations;
+    std::unordered_map<SOCKET, unsigned int>   m_ready_flags;
+    std::vector<SOCKET>                        m_ready_sockets;
+};
+
+} // namespace erhe::net
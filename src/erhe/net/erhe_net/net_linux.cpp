@@ -1,5 +1,6 @@
 #include "erhe_net/net_os.hpp"
 #include "erhe_net/net_log.hpp"
+#include "erhe_verify/verify.hpp"
 #include <string.h>
 
 #include <fmt/format.h>
@@ -213,7 +214,7 @@ auto set_socket_option(
             if (flags == -1) {
                 return false;
             }
-            flags = (value != 0) ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+            flags = (value != 0) ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
             result = fcntl(socket, F_SETFL, flags);
             break;
         }
@@ -308,4 +309,32 @@ auto get_net_hints(const int flags, const int family, const int socktype, const
     };
 }
 
+auto send_gather(const SOCKET socket, const Send_span* const spans, const std::size_t span_count) -> int64_t
+{
+    ERHE_VERIFY(span_count <= c_max_io_span_count);
+    iovec iov[c_max_io_span_count];
+    for (std::size_t i = 0; i < span_count; ++i) {
+        iov[i].iov_base = const_cast<void*>(spans[i].data);
+        iov[i].iov_len  = spans[i].byte_count;
+    }
+    msghdr message{};
+    message.msg_iov    = iov;
+    message.msg_iovlen = span_count;
+    return static_cast<int64_t>(::sendmsg(socket, &message, MSG_NOSIGNAL));
+}
+
+auto receive_scatter(const SOCKET socket, const Receive_span* const spans, const std::size_t span_count) -> int64_t
+{
+    ERHE_VERIFY(span_count <= c_max_io_span_count);
+    iovec iov[c_max_io_span_count];
+    for (std::size_t i = 0; i < span_count; ++i) {
+        iov[i].iov_base = spans[i].data;
+        iov[i].iov_len  = spans[i].byte_count;
+    }
+    msghdr message{};
+    message.msg_iov    = iov;
+    message.msg_iovlen = span_count;
+    return static_cast<int64_t>(::recvmsg(socket, &message, 0));
+}
+
 }
@@ -33,6 +33,8 @@ static constexpr int    SD_BOTH        = SHUT_RDWR;
 inline auto closesocket(const SOCKET s) -> int { return close(s); }
 #endif
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -65,4 +67,26 @@ auto get_socket_option(SOCKET socket, Socket_option option) -> std::optional<int
 
 auto initialize_net() -> bool;
 
+// Scatter / gather I/O; lets sockets send from and receive into both
+// regions of a wrapped ring buffer (and header + payload) with one call.
+class Send_span
+{
+public:
+    const void* data      {nullptr};
+    std::size_t byte_count{0};
+};
+
+class Receive_span
+{
+public:
+    void*       data      {nullptr};
+    std::size_t byte_count{0};
+};
+
+static constexpr std::size_t c_max_io_span_count{4};
+
+// Returns number of bytes sent / received, or -1 in case of error (see get_net_last_error())
+auto send_gather    (SOCKET socket, const Send_span*    spans, std::size_t span_count) -> int64_t;
+auto receive_scatter(SOCKET socket, const Receive_span* spans, std::size_t span_count) -> int64_t;
+
 } // namespace erhe::net
@@ -1,5 +1,6 @@
 #include "erhe_net/net_os.hpp"
 #include "erhe_net/net_log.hpp"
+#include "erhe_verify/verify.hpp"
 
 #include <fmt/format.h>
 
@@ -286,4 +287,31 @@ auto get_net_hints(const int flags, const int family, const int socktype, const
     };
 }
 
+auto send_gather(const SOCKET socket, const Send_span* const spans, const std::size_t span_count) -> int64_t
+{
+    ERHE_VERIFY(span_count <= c_max_io_span_count);
+    WSABUF buffers[c_max_io_span_count];
+    for (std::size_t i = 0; i < span_count; ++i) {
+        buffers[i].buf = static_cast<CHAR*>(const_cast<void*>(spans[i].data));
+        buffers[i].len = static_cast<ULONG>(spans[i].byte_count);
+    }
+    DWORD     sent_byte_count{0};
+    const int result = WSASend(socket, buffers, static_cast<DWORD>(span_count), &sent_byte_count, 0, nullptr, nullptr);
+    return (result == SOCKET_ERROR) ? -1 : static_cast<int64_t>(sent_byte_count);
+}
+
+auto receive_scatter(const SOCKET socket, const Receive_span* const spans, const std::size_t span_count) -> int64_t
+{
+    ERHE_VERIFY(span_count <= c_max_io_span_count);
+    WSABUF buffers[c_max_io_span_count];
+    for (std::size_t i = 0; i < span_count; ++i) {
+        buffers[i].buf = static_cast<CHAR*>(spans[i].data);
+        buffers[i].len = static_cast<ULONG>(spans[i].byte_count);
+    }
+    DWORD     received_byte_count{0};
+    DWORD     flags{0};
+    const int result = WSARecv(socket, buffers, static_cast<DWORD>(span_count), &received_byte_count, &flags, nullptr, nullptr);
+    return (result == SOCKET_ERROR) ? -1 : static_cast<int64_t>(received_byte_count);
+}
+
 }
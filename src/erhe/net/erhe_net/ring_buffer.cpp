@@ -1,5 +1,6 @@
 #include "erhe_net/ring_buffer.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 
@@ -124,10 +125,31 @@ auto Ring_buffer::begin_produce(
 
 void Ring_buffer::end_produce(const std::size_t write_byte_count)
 {
+    if (write_byte_count == 0) {
+        return; // Empty buffer must not become full
+    }
     m_write_offset = (m_write_offset + write_byte_count) % m_max_size;
     m_full = (m_write_offset == m_read_offset);
 }
 
+auto Ring_buffer::get_produce_spans(
+    std::span<uint8_t>& before_wrap,
+    std::span<uint8_t>& after_wrap
+) -> std::size_t
+{
+    const std::size_t can_write_count = size_available_for_write();
+    if (can_write_count == 0) {
+        before_wrap = {};
+        after_wrap  = {};
+        return 0;
+    }
+    const std::size_t max_count_before_wrap = m_max_size - m_write_offset;
+    const std::size_t count_before_wrap     = (std::min)(can_write_count, max_count_before_wrap);
+    before_wrap = std::span<uint8_t>{&m_buffer[m_write_offset], count_before_wrap};
+    after_wrap  = std::span<uint8_t>{m_buffer.data(), can_write_count - count_before_wrap};
+    return can_write_count;
+}
+
 auto Ring_buffer::write(const uint8_t* src, const std::size_t byte_count) -> std::size_t
 {
     const std::size_t can_write_count = (std::min)(size_available_for_write(), byte_count);
@@ -173,6 +195,24 @@ void Ring_buffer::end_consume(std::size_t byte_count)
     m_full        = false;
 }
 
+auto Ring_buffer::get_consume_spans(
+    std::span<const uint8_t>& before_wrap,
+    std::span<const uint8_t>& after_wrap
+) const -> std::size_t
+{
+    const std::size_t can_read_count = size_available_for_read();
+    if (can_read_count == 0) {
+        before_wrap = {};
+        after_wrap  = {};
+        return 0;
+    }
+    const std::size_t max_count_before_wrap = m_max_size - m_read_offset;
+    const std::size_t count_before_wrap     = (std::min)(can_read_count, max_count_before_wrap);
+    before_wrap = std::span<const uint8_t>{&m_buffer[m_read_offset], count_before_wrap};
+    after_wrap  = std::span<const uint8_t>{m_buffer.data(), can_read_count - count_before_wrap};
+    return can_read_count;
+}
+
 auto Ring_buffer::read(uint8_t* dst, const std::size_t byte_count) -> std::size_t
 {
     const std::size_t can_read_count = std::min(size_available_for_read(), byte_count);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace erhe::net {
@@ -30,6 +31,12 @@ public:
     ) -> uint8_t*;
     void end_produce             (std::size_t byte_count);
 
+    // For scatter recv - writable region, split at wrap; returns total byte count
+    auto get_produce_spans       (
+        std::span<uint8_t>& before_wrap,
+        std::span<uint8_t>& after_wrap
+    ) -> std::size_t;
+
     auto write                   (const uint8_t* src, std::size_t byte_count) -> std::size_t;
 
     // For send
@@ -39,6 +46,12 @@ public:
     ) -> const uint8_t*;
     void end_consume             (std::size_t byte_count);
 
+    // For gather send - readable region, split at wrap; returns total byte count
+    auto get_consume_spans       (
+        std::span<const uint8_t>& before_wrap,
+        std::span<const uint8_t>& after_wrap
+    ) const -> std::size_t;
+
     auto read                    (uint8_t* dst, std::size_t byte_count) -> std::size_t;
     auto peek                    (uint8_t* dst, std::size_t byte_count) -> std::size_t;
 
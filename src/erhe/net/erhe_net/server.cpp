@@ -19,6 +19,10 @@ Server::Server(Server&& other) noexcept
     : m_listen_socket  {std::move(other.m_listen_socket)}
     , m_receive_handler{std::move(other.m_receive_handler)}
     , m_clients        {std::move(other.m_clients)}
+#if defined(ERHE_OS_LINUX)
+    , m_epoll_sockets  {std::move(other.m_epoll_sockets)}
+    , m_client_indices {std::move(other.m_client_indices)}
+#endif
 {
     log_server->trace("Server move constructor");
 }
@@ -29,14 +33,95 @@ auto Server::operator=(Server&& other) noexcept -> Server&
     m_listen_socket   = std::move(other.m_listen_socket);
     m_receive_handler = std::move(other.m_receive_handler);
     m_clients         = std::move(other.m_clients);
+#if defined(ERHE_OS_LINUX)
+    m_epoll_sockets   = std::move(other.m_epoll_sockets);
+    m_client_indices  = std::move(other.m_client_indices);
+#endif
     return *this;
 }
 
 auto Server::listen(const char* address, const int port) -> bool
 {
-    return m_listen_socket.bind(address, port);
+    const bool result = m_listen_socket.bind(address, port);
+#if defined(ERHE_OS_LINUX)
+    m_epoll_sockets.forget(m_listen_socket.get_socket());
+#endif
+    return result;
+}
+
+#if defined(ERHE_OS_LINUX)
+void Server::update_client_indices()
+{
+    m_client_indices.clear();
+    for (std::size_t i = 0, end = m_clients.size(); i < end; ++i) {
+        m_client_indices[m_clients[i].get_socket()] = i;
+    }
 }
 
+auto Server::poll(const int timeout_ms) -> bool
+{
+    if (m_listen_socket.get_state() == Socket::State::CLOSED) {
+        return true; // NOP
+    }
+
+    // Update interest; epoll_ctl() is only called when socket flags change
+    m_epoll_sockets.begin_update();
+    m_epoll_sockets.update(m_listen_socket.get_socket(), m_listen_socket.get_poll_flags());
+    for (const auto& client : m_clients) {
+        m_epoll_sockets.update(client.get_socket(), client.get_poll_flags());
+    }
+    m_epoll_sockets.end_update();
+
+    // Call epoll_wait() to find out if there is work to do
+    const int wait_res = m_epoll_sockets.wait(timeout_ms);
+    if (wait_res == SOCKET_ERROR) {
+        log_net->trace("server epoll_wait() returned error {}", get_net_last_error_message());
+        return false; // TODO
+    }
+
+    // Perform send and receive for ready client sockets only
+    for (const SOCKET socket : m_epoll_sockets.get_ready_sockets()) {
+        const auto i = m_client_indices.find(socket);
+        if (i == m_client_indices.end()) {
+            continue;
+        }
+        m_clients[i->second].process_send_recv(
+            m_epoll_sockets.has_read (socket),
+            m_epoll_sockets.has_write(socket)
+        );
+    }
+
+    // Remove closed sockets
+    const std::size_t old_client_count = m_clients.size();
+    m_clients.erase(
+        std::remove_if(
+            m_clients.begin(),
+            m_clients.end(),
+            [](Socket& client) {
+                return client.get_state() == Socket::State::CLOSED;
+            }
+        ),
+        m_clients.end()
+    );
+    bool clients_changed = m_clients.size() != old_client_count;
+
+    // Check for new clients
+    const SOCKET listen_socket = m_listen_socket.get_socket();
+    auto new_socket = m_listen_socket.process_listen(m_epoll_sockets.has_read(listen_socket));
+    if (new_socket.has_value()) {
+        log_net->info("new client is connecting to server");
+        new_socket.value().set_receive_handler(m_receive_handler);
+        m_epoll_sockets.forget(new_socket.value().get_socket());
+        m_clients.push_back(std::move(new_socket.value()));
+        clients_changed = true;
+    }
+
+    if (clients_changed) {
+        update_client_indices();
+    }
+    return true;
+}
+#else
 auto Server::poll(const int timeout_ms) -> bool
 {
     if (m_listen_socket.get_state() == Socket::State::CLOSED) {
@@ -85,18 +170,32 @@ auto Server::poll(const int timeout_ms) -> bool
 
     return true;
 }
+#endif
 
-auto Server::broadcast(const std::string& message) -> bool
+auto Server::broadcast(const void* const data, const std::size_t length) -> bool
 {
     std::size_t error_count = 0;
     for (auto& client : m_clients) {
-        if (!client.send(message.data(), static_cast<int>(message.length()))) {
+        if (client.get_state() != Socket::State::CONNECTED) {
+            continue;
+        }
+        if (!client.send(data, length)) {
             ++error_count;
         }
     }
     return error_count == 0;
 }
 
+auto Server::broadcast(const std::span<const uint8_t> message) -> bool
+{
+    return broadcast(message.data(), message.size());
+}
+
+auto Server::broadcast(const std::string& message) -> bool
+{
+    return broadcast(message.data(), message.size());
+}
+
 void Server::set_receive_handler(Receive_handler receive_handler)
 {
     m_receive_handler = receive_handler;
@@ -106,6 +205,9 @@ void Server::disconnect()
 {
     m_listen_socket.close();
     m_clients.clear();
+#if defined(ERHE_OS_LINUX)
+    m_client_indices.clear();
+#endif
 }
 
 auto Server::get_state() const -> Socket::State
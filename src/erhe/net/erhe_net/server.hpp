@@ -2,6 +2,12 @@
 
 #include "erhe_net/socket.hpp"
 
+#if defined(ERHE_OS_LINUX)
+#   include "erhe_net/epoll_sockets.hpp"
+
+#   include <unordered_map>
+#endif
+
 namespace erhe::net
 {
 
@@ -15,6 +21,8 @@ public:
     Server(Server&& other) noexcept;
     auto operator=(Server&& other) noexcept -> Server&;
 
+    auto broadcast          (const void* data, std::size_t length) -> bool;
+    auto broadcast          (std::span<const uint8_t> message) -> bool;
     auto broadcast          (const std::string& message) -> bool;
     void set_receive_handler(Receive_handler receive_handler);
     void disconnect         ();
@@ -24,9 +32,15 @@ public:
     auto get_client_count   () const -> std::size_t;
 
 private:
-    Socket              m_listen_socket;
-    Receive_handler     m_receive_handler;
-    std::vector<Socket> m_clients;
+    Socket                             m_listen_socket;
+    Receive_handler                    m_receive_handler;
+    std::vector<Socket>                m_clients;
+#if defined(ERHE_OS_LINUX)
+    void update_client_indices();
+
+    Epoll_sockets                      m_epoll_sockets;
+    std::unordered_map<SOCKET, size_t> m_client_indices;
+#endif
 };
 
 }
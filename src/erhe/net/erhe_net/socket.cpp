@@ -83,6 +83,7 @@ Socket::Socket(Socket&& other) noexcept
     , m_send_buffer    {std::move(other.m_send_buffer)}
     , m_receive_buffer {std::move(other.m_receive_buffer)}
     , m_receive_handler{std::move(other.m_receive_handler)}
+    , m_wrapped_packet {std::move(other.m_wrapped_packet)}
 {
     log_socket->trace("Socket move constructor");
     other.m_socket    = INVALID_SOCKET;
@@ -101,6 +102,7 @@ auto Socket::operator=(Socket&& other) noexcept -> Socket&
     m_send_buffer     = std::move(other.m_send_buffer);
     m_receive_buffer  = std::move(other.m_receive_buffer);
     m_receive_handler = std::move(other.m_receive_handler);
+    m_wrapped_packet  = std::move(other.m_wrapped_packet);
     other.m_socket    = INVALID_SOCKET;
     other.m_state     = State::CLOSED;
     other.m_addr_info = nullptr;
@@ -237,88 +239,122 @@ auto Socket::bind(const char* const address, const int port) -> bool
 }
 
 // Attempts to send some or all of the data queued in send buffer.
+// Both regions of a wrapped send buffer are sent with a single gather send.
 // Returns true if no error, returns false in case of error.
 auto Socket::send_pending() -> bool
 {
     ERHE_VERIFY(m_state == State::CONNECTED);
     ERHE_VERIFY(m_send_buffer);
 
-    // Loop (at most) twice, for the case where the ring buffer
-    // wraps around, in which case two send() calls are needed.
-    for (;;) {
-        if (m_send_buffer->empty()) {
-            return true;
-        }
+    std::span<const uint8_t> before_wrap;
+    std::span<const uint8_t> after_wrap;
+    const std::size_t queued_byte_count = m_send_buffer->get_consume_spans(before_wrap, after_wrap);
+    if (queued_byte_count == 0) {
+        return true;
+    }
 
-        std::size_t          can_send_byte_count_before_wrap{0};
-        std::size_t          can_send_byte_count_after_wrap {0};
-        const uint8_t* const read_pointer    = m_send_buffer->begin_consume(can_send_byte_count_before_wrap, can_send_byte_count_after_wrap);
-        const int            send_result     = ::send(m_socket, reinterpret_cast<const char*>(read_pointer), static_cast<int>(can_send_byte_count_before_wrap), 0);
-        const int            sent_byte_count = (std::max)(0, send_result);
-        if (can_send_byte_count_after_wrap > 0) {
-            log_socket->info("send() before wrap {} bytes, after wrap {} bytes", can_send_byte_count_before_wrap, can_send_byte_count_after_wrap);
+    const Send_span spans[2]{
+        { before_wrap.data(), before_wrap.size() },
+        { after_wrap .data(), after_wrap .size() }
+    };
+    const int64_t send_result = send_gather(m_socket, spans, after_wrap.empty() ? 1 : 2);
+    if (send_result < 0) {
+        const int error_code = get_net_last_error();
+        if (is_error_fatal(error_code)) {
+            log_socket->error(
+                "send({} bytes) failed with error {}",
+                queued_byte_count,
+                get_net_error_message(error_code)
+            );
+            close();
+            return false;
         }
+        return true;
+    }
+    m_send_buffer->end_consume(static_cast<std::size_t>(send_result));
+    return true;
+}
+
+// Sends a packet. Returns true if there was no error, false if there was an error.
+//
+// When nothing is queued, header and payload are sent directly from the
+// caller memory with a gather send, and only a partially sent remainder
+// is copied to the send buffer.
+auto Socket::send(const void* const data, const std::size_t length) -> bool
+{
+    ERHE_VERIFY(m_state == State::CONNECTED);
+    ERHE_VERIFY(m_send_buffer);
+
+    const std::size_t packet_byte_count = sizeof(Packet_header) + length;
+    if (packet_byte_count > m_send_buffer->max_size()) {
+        log_socket->warn("message ({} bytes) does not fit to send queue ({} bytes)", length, m_send_buffer->max_size());
+        return false;
+    }
+
+    const Packet_header header{static_cast<uint32_t>(length)};
+    std::size_t         sent_byte_count{0};
+    if (m_send_buffer->empty()) {
+        const Send_span spans[2]{
+            { &header, sizeof(Packet_header) },
+            { data,    length                }
+        };
+        const int64_t send_result = send_gather(m_socket, spans, (length > 0) ? 2 : 1);
         if (send_result < 0) {
-            m_send_buffer->end_consume(0);
             const int error_code = get_net_last_error();
-            if (is_error_fatal(error_code))
-            {
+            if (is_error_fatal(error_code)) {
                 log_socket->error(
                     "send({} bytes) failed with error {}",
-                    can_send_byte_count_before_wrap,
+                    packet_byte_count,
                     get_net_error_message(error_code)
                 );
                 close();
                 return false;
             }
+        } else {
+            sent_byte_count = static_cast<std::size_t>(send_result);
+        }
+        if (sent_byte_count == packet_byte_count) {
             return true;
         }
-        m_send_buffer->end_consume(sent_byte_count);
-        if (
-            (sent_byte_count < can_send_byte_count_before_wrap) ||
-            (can_send_byte_count_after_wrap == 0)
-        ) {
-            break;
+    } else {
+        // Check if new message fits to send buffer
+        if (m_send_buffer->size_available_for_write() < packet_byte_count) {
+            // Does not fit? Try to flush queued data
+            const auto send_pending_result = send_pending();
+            if (!send_pending_result) {
+                return false;
+            }
+            // Check again how much fits
+            const std::size_t can_write_count = m_send_buffer->size_available_for_write();
+            if (can_write_count < packet_byte_count) {
+                log_socket->warn("message ({} bytes) does not fit to send queue ({} bytes free)", length, can_write_count);
+                return false;
+            }
         }
     }
-    return true;
-}
-
-// Sends a packet. Returns true if there was no error, false if there was an error.
-auto Socket::send(const char* const data, const int length) -> bool
-{
-    ERHE_VERIFY(m_state == State::CONNECTED);
 
-    // Check if new message fits to send buffer
-    std::size_t can_write_count = m_send_buffer->size_available_for_write();
-    if (can_write_count < sizeof(Packet_header) + length) {
-        // Does not fit? Try to flush queued data
-        const auto send_pending_result = send_pending();
-        if (!send_pending_result) {
-            return false;
-        }
-        // Check again how much fits
-        can_write_count = m_send_buffer->size_available_for_write();
-        if (can_write_count < sizeof(Packet_header) + length) {
-            m_send_buffer->end_produce(0);
-            log_socket->warn("message ({} bytes) does not fit to send queue ({} bytes free)", length, can_write_count);
-            return false;
-        }
+    // Queue the part of the packet that was not sent
+    if (sent_byte_count < sizeof(Packet_header)) {
+        const std::size_t header_byte_count_left = sizeof(Packet_header) - sent_byte_count;
+        const auto header_byte_write_count = m_send_buffer->write(reinterpret_cast<const uint8_t*>(&header) + sent_byte_count, header_byte_count_left);
+        ERHE_VERIFY(header_byte_write_count == header_byte_count_left);
+        sent_byte_count = 0;
+    } else {
+        sent_byte_count -= sizeof(Packet_header);
     }
-
-    // Write header to send buffer
-    const Packet_header header{static_cast<uint32_t>(length)};
-    const auto header_byte_write_count = m_send_buffer->write(reinterpret_cast<const uint8_t*>(&header), sizeof(Packet_header));
-    ERHE_VERIFY(header_byte_write_count == sizeof(Packet_header));
-
-    // Write payload to send buffer
-    const auto payload_byte_write_count = m_send_buffer->write(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(length));
-    ERHE_VERIFY(payload_byte_write_count == length);
+    const std::size_t payload_byte_count_left  = length - sent_byte_count;
+    const auto        payload_byte_write_count = m_send_buffer->write(static_cast<const uint8_t*>(data) + sent_byte_count, payload_byte_count_left);
+    ERHE_VERIFY(payload_byte_write_count == payload_byte_count_left);
 
     // Try to send some or all of the queued send buffer
     return send_pending();
 }
 
+auto Socket::send(const std::span<const uint8_t> message) -> bool
+{
+    return send(message.data(), message.size());
+}
+
 auto Socket::receive_packet_length() -> uint32_t
 {
     ERHE_VERIFY(m_state == State::CONNECTED);
@@ -335,7 +371,54 @@ auto Socket::receive_packet_length() -> uint32_t
     return header.length;
 }
 
-// returns false in case of error, true if ok
+// Passes fully received packets to receive handler. Packets are passed
+// in place from the receive buffer, except when the receive buffer wraps
+// within a packet; such packets are gathered to m_wrapped_packet.
+void Socket::dispatch_packets()
+{
+    for (;;) {
+        if (!m_receive_buffer) {
+            return; // receive handler closed the socket
+        }
+        if (m_receive_buffer->size_available_for_read() < sizeof(Packet_header)) {
+            return; // Header not received
+        }
+        // Empty packets are passed to receive handler with zero length
+        const uint32_t next_packet_length = receive_packet_length();
+        std::span<const uint8_t> before_wrap;
+        std::span<const uint8_t> after_wrap;
+        const std::size_t readable_byte_count = m_receive_buffer->get_consume_spans(before_wrap, after_wrap);
+        if (readable_byte_count < sizeof(Packet_header) + next_packet_length) {
+            return; // Packet not fully received
+        }
+
+        log_socket->trace("received message, length = {} bytes", next_packet_length);
+
+        const bool     wrapped = before_wrap.size() < sizeof(Packet_header) + next_packet_length;
+        const uint8_t* payload = before_wrap.data() + header_byte_count;
+        if (wrapped) {
+            log_socket->trace("message ring buffer wrap - gathering packet");
+            m_receive_buffer->discard(sizeof(Packet_header));
+            m_wrapped_packet.resize(next_packet_length);
+            const std::size_t peek_byte_count = m_receive_buffer->peek(m_wrapped_packet.data(), next_packet_length);
+            ERHE_VERIFY(peek_byte_count == next_packet_length);
+            payload = m_wrapped_packet.data();
+        }
+
+        if (m_receive_handler) {
+            m_receive_handler(payload, next_packet_length);
+        } else {
+            log_socket->warn("no receive handler set, message discarded");
+        }
+        if (!m_receive_buffer) {
+            return;
+        }
+        m_receive_buffer->discard(wrapped ? next_packet_length : header_byte_count + next_packet_length);
+    }
+}
+
+// Receives with a single scatter recv into both regions of a wrapped
+// receive buffer. Returns false in case of error, true if ok
 auto Socket::recv() -> bool
 {
     ERHE_VERIFY(m_state == State::CONNECTED);
@@ -348,13 +431,15 @@ auto Socket::recv() -> bool
         }
 
         // See how much space we have in the receive buffer
-        std::size_t    can_receive_byte_count_before_wrap{0};
-        std::size_t    can_receive_byte_count_after_wrap {0};
-        uint8_t* const write_pointer       = m_receive_buffer->begin_produce(can_receive_byte_count_before_wrap, can_receive_byte_count_after_wrap);
-        const int      recv_result         = ::recv(m_socket, reinterpret_cast<char*>(write_pointer), static_cast<int>(can_receive_byte_count_before_wrap), 0);
-        const int      received_byte_count = (std::max)(0, recv_result);
+        std::span<uint8_t> before_wrap;
+        std::span<uint8_t> after_wrap;
+        const std::size_t can_receive_byte_count = m_receive_buffer->get_produce_spans(before_wrap, after_wrap);
+        const Receive_span spans[2]{
+            { before_wrap.data(), before_wrap.size() },
+            { after_wrap .data(), after_wrap .size() }
+        };
+        const int64_t recv_result = receive_scatter(m_socket, spans, after_wrap.empty() ? 1 : 2);
         if (recv_result < 0) {
-            m_receive_buffer->end_produce(0);
             const int error_code = get_net_last_error();
             if (is_error_fatal(error_code)) {
                 log_socket->error("recv() failed with error {}", get_net_error_message(error_code));
@@ -363,99 +448,81 @@ auto Socket::recv() -> bool
             }
             return true; // non-fatal error
         }
-        m_receive_buffer->end_produce(received_byte_count);
         if (recv_result == 0) {
             log_socket->info("connection close detected");
             close();
             return true;
         }
+        const std::size_t received_byte_count = static_cast<std::size_t>(recv_result);
+        m_receive_buffer->end_produce(received_byte_count);
 
         // Process received packets
-        for (;;) {
-            const uint32_t next_packet_length = receive_packet_length();
-            if (next_packet_length == 0) {
-                break; // Header not received
-            }
-            std::size_t    readable_byte_count_before_wrap{0};
-            std::size_t    readable_byte_count_after_wrap {0};
-            const uint8_t* read_pointer = m_receive_buffer->begin_consume(readable_byte_count_before_wrap, readable_byte_count_after_wrap);
-            std::size_t    readable_byte_count_total = readable_byte_count_before_wrap + readable_byte_count_after_wrap;
-            if (readable_byte_count_total < sizeof(Packet_header) + next_packet_length) {
-                m_receive_buffer->end_consume(0); // Packet not fully received
-                break;
-            }
-
-            log_socket->trace("received message, length = {} bytes", next_packet_length);
-
-            // Ring buffer would wrap? Rotate so that it won't
-            if (readable_byte_count_before_wrap < sizeof(Packet_header) + next_packet_length) {
-                log_socket->trace("message ring buffer wrap - rotating ring buffer");
-                m_receive_buffer->end_consume(0);
-                m_receive_buffer->rotate();
-                readable_byte_count_before_wrap = 0;
-                readable_byte_count_after_wrap  = 0;
-                read_pointer = m_receive_buffer->begin_consume(readable_byte_count_before_wrap, readable_byte_count_after_wrap);
-            }
-            ERHE_VERIFY(readable_byte_count_before_wrap >= sizeof(Packet_header) + next_packet_length);
-            if (m_receive_handler) {
-                log_socket->info("calling receive handler");
-                m_receive_handler(read_pointer + header_byte_count, next_packet_length);
-            } else {
-                log_socket->warn("no receive handler set, message discarded");
-            }
-            m_receive_buffer->end_consume(header_byte_count + next_packet_length);
+        dispatch_packets();
+        if (m_state != State::CONNECTED) {
+            return true;
         }
 
-        if (
-            (received_byte_count < can_receive_byte_count_before_wrap) ||
-            (can_receive_byte_count_after_wrap == 0)
-        ) {
+        if (received_byte_count < can_receive_byte_count) {
             break;
         }
     }
     return true;
 }
 
-void Socket::pre_select(Select_sockets& select_sockets)
+auto Socket::get_poll_flags() const -> unsigned int
 {
     switch (m_state) {
         case State::CLOSED: {
-            return;
+            return 0;
         }
 
         case State::CLIENT_CONNECTING: {
-            select_sockets.set_write (m_socket);
-            select_sockets.set_except(m_socket); // For connect errors
-            return;
+            return Select_sockets::flag_write | Select_sockets::flag_except; // except for connect errors
         }
 
         case State::SERVER_LISTENING: {
-            select_sockets.set_read(m_socket);
-            return;
+            return Select_sockets::flag_read;
         }
 
         default: {
-            // Check socket writability
-            if (has_pending_writes()) {
-                select_sockets.set_write(m_socket);
-            }
-
-            // Check socket readability
-            select_sockets.set_read(m_socket);
+            // Check socket writability only when there is something to send
+            return has_pending_writes()
+                ? (Select_sockets::flag_read | Select_sockets::flag_write)
+                : Select_sockets::flag_read;
         }
     }
 }
 
+void Socket::pre_select(Select_sockets& select_sockets)
+{
+    const unsigned int flags = get_poll_flags();
+    if ((flags & Select_sockets::flag_read) != 0) {
+        select_sockets.set_read(m_socket);
+    }
+    if ((flags & Select_sockets::flag_write) != 0) {
+        select_sockets.set_write(m_socket);
+    }
+    if ((flags & Select_sockets::flag_except) != 0) {
+        select_sockets.set_except(m_socket);
+    }
+}
+
 // returns false in case of error, true if ok
 auto Socket::post_select_send_recv(Select_sockets& select_sockets) -> bool
 {
-    if (select_sockets.has_write(m_socket)) {
+    return process_send_recv(select_sockets.has_read(m_socket), select_sockets.has_write(m_socket));
+}
+
+// returns false in case of error, true if ok
+auto Socket::process_send_recv(const bool readable, const bool writable) -> bool
+{
+    if (writable) {
         const bool send_ok = send_pending();
         if (!send_ok) {
             return false;
         }
     }
-    if (select_sockets.has_read(m_socket)) {
+    if (readable) {
         const bool recv_ok = recv();
         if (!recv_ok) {
             return false;
@@ -478,6 +545,8 @@ void Socket::on_state_changed(const State old_state, const State new_state)
 {
     log_socket->info("Socket state changed {} -> {}", c_str(old_state), c_str(new_state));
     if (new_state == State::CONNECTED) {
+        // Packets are sent with single gather send, so Nagle would only add latency
+        set_socket_option(m_socket, Socket_option::NoDelay, 1);
         m_send_buffer    = std::make_unique<Ring_buffer>(4 * 1024 * 1024);
         m_receive_buffer = std::make_unique<Ring_buffer>(4 * 1024 * 1024);
     }
@@ -513,7 +582,13 @@ auto Socket::connect() -> bool
 // returns false in case of error, true if ok
 auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
 {
-    if (select_sockets.has_except(m_socket)) {
+    return process_connect(select_sockets.has_write(m_socket), select_sockets.has_except(m_socket));
+}
+
+// returns false in case of error, true if ok
+auto Socket::process_connect(const bool writable, const bool except) -> bool
+{
+    if (except) {
         // connection attempt failed. retry
         connect();
 
@@ -529,8 +604,7 @@ auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
         return false;
     }
 
-    const bool is_writable = select_sockets.has_write(m_socket);
-    if (is_writable) {
+    if (writable) {
         // man connect:
         // > After select(2) indicates writability, use getsockopt(2) to read the SO_ERROR option at
         // > level SOL_SOCKET to determine whether connect() completed successfully (SO_ERROR is zero)
@@ -562,8 +636,13 @@ auto Socket::post_select_connect(Select_sockets& select_sockets) -> bool
 
 auto Socket::post_select_listen(Select_sockets& select_sockets) -> std::optional<Socket>
 {
-    if (select_sockets.has_read(m_socket)) {
-        log_socket->info("Server post_select_listen() has readable socket");
+    return process_listen(select_sockets.has_read(m_socket));
+}
+
+auto Socket::process_listen(const bool readable) -> std::optional<Socket>
+{
+    if (readable) {
+        log_socket->info("Server process_listen() has readable socket");
 
         sockaddr_in  address{};
         socklen_t    len        = sizeof(address);
@@ -578,6 +657,7 @@ auto Socket::post_select_listen(Select_sockets& select_sockets) -> std::optional
             // TODO check if already added
             // TODO set buffer sizes
             log_socket->info("Server accept(): new connection");
+            set_socket_option(accept_res, Socket_option::NonBlocking, 1);
             return Socket{accept_res, address};
         }
     }
@@ -6,6 +6,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -39,18 +40,27 @@ public:
     auto get_sockaddr_in     () const -> const sockaddr_in&    { return m_address_in; }
     auto get_address_string  () const -> const std::string&    { return m_address; }
     auto get_send_buffer_size() const -> size_t                { return m_send_buffer ? m_send_buffer->size() : 0; }
-    auto send                (const char* data, int length) -> bool;
+    auto send                (const void* data, std::size_t length) -> bool;
+    auto send                (std::span<const uint8_t> message) -> bool;
     auto send_pending        () -> bool;
     auto recv                () -> bool;
     auto get_receive_buffer  () -> Ring_buffer* { return m_receive_buffer.get(); }
     void close               ();
-    auto has_pending_writes  () -> bool         { return m_send_buffer ? !m_send_buffer->empty() : false; }
+    auto has_pending_writes  () const -> bool   { return m_send_buffer ? !m_send_buffer->empty() : false; }
+
+    // Select_sockets::flag_read / flag_write / flag_except wanted in current state
+    auto get_poll_flags       () const -> unsigned int;
 
     void pre_select           (Select_sockets& select_sockets);
     auto post_select_send_recv(Select_sockets& select_sockets) -> bool;
     auto post_select_connect  (Select_sockets& select_sockets) -> bool;
     auto post_select_listen   (Select_sockets& select_sockets) -> std::optional<Socket>;
 
+    // Poller independent versions of post_select_*()
+    auto process_send_recv    (bool readable, bool writable) -> bool;
+    auto process_connect      (bool writable, bool except) -> bool;
+    auto process_listen       (bool readable) -> std::optional<Socket>;
+
     auto connect(const char* address, int port) -> bool; // for client
     auto bind   (const char* address, int port) -> bool; // for server
 
@@ -59,6 +69,7 @@ private:
     void set_state            (State state);
     void on_state_changed     (State old_state, State new_state);
     auto receive_packet_length() -> uint32_t;
+    void dispatch_packets     ();
 
     SOCKET                       m_socket    {INVALID_SOCKET};
     sockaddr_in                  m_address_in{};
@@ -68,6 +79,7 @@ private:
     std::unique_ptr<Ring_buffer> m_send_buffer;
     std::unique_ptr<Ring_buffer> m_receive_buffer;
     Receive_handler              m_receive_handler;
+    std::vector<uint8_t>         m_wrapped_packet; // for packets split by receive buffer wrap
 };
 
 [[nodiscard]] auto c_str(const Socket::State state) -> const char*;
@@ -3,8 +3,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -15,6 +19,35 @@ class IDebug_draw;
 class IRigid_body;
 class IRigid_body_create_info;
 
+// Layer mask bits for scene queries
+class Query_layer
+{
+public:
+    static constexpr uint32_t none          = 0u;
+    static constexpr uint32_t non_moving    = (1u << 0); // Static bodies
+    static constexpr uint32_t moving        = (1u << 1); // Kinematic and dynamic bodies
+    static constexpr uint32_t non_colliding = (1u << 2); // Bodies with collisions disabled
+    static constexpr uint32_t colliding     = non_moving | moving;
+    static constexpr uint32_t all           = non_moving | moving | non_colliding;
+};
+
+class Query_ray
+{
+public:
+    glm::vec3 origin      {0.0f, 0.0f, 0.0f};
+    glm::vec3 direction   {0.0f, 0.0f, -1.0f}; // Does not need to be normalized
+    float     max_distance{std::numeric_limits<float>::max()};
+};
+
+class Query_hit
+{
+public:
+    IRigid_body* rigid_body{nullptr};
+    glm::vec3    position  {0.0f, 0.0f, 0.0f}; // World space contact point
+    glm::vec3    normal    {0.0f, 0.0f, 0.0f}; // World space surface normal, pointing away from the hit body
+    float        distance  {0.0f};             // Distance along the ray or sweep
+};
+
 class IWorld
 {
 public:
@@ -43,6 +76,9 @@ public:
     virtual void update_fixed_step      (double dt)                                      = 0;
     virtual void add_rigid_body         (IRigid_body* rigid_body)                        = 0;
     virtual void remove_rigid_body      (IRigid_body* rigid_body)                        = 0;
+    virtual void add_rigid_bodies       (std::span<IRigid_body* const> rigid_bodies)     = 0;
+    virtual void remove_rigid_bodies    (std::span<IRigid_body* const> rigid_bodies)     = 0;
+    virtual void optimize_broad_phase   ()                                               = 0;
     virtual void add_constraint         (IConstraint* constraint)                        = 0;
     virtual void remove_constraint      (IConstraint* constraint)                        = 0;
     virtual void set_gravity            (const glm::vec3& gravity)                       = 0;
@@ -52,6 +88,52 @@ public:
     virtual void set_on_body_activated  (std::function<void(IRigid_body*)> callback)     = 0;
     virtual void set_on_body_deactivated(std::function<void(IRigid_body*)> callback)     = 0;
     virtual void for_each_active_body   (std::function<void(IRigid_body*)> callback)     = 0;
+
+    // Scene queries. These use the broad phase of the simulation, and must
+    // not be called while the world is being stepped. Bodies are considered
+    // only if their layer is included in layer_mask (see Query_layer).
+    [[nodiscard]] virtual auto ray_cast(
+        const Query_ray& ray,
+        uint32_t         layer_mask = Query_layer::all
+    ) const -> std::optional<Query_hit> = 0;
+
+    // Casts each ray in rays, storing closest hit to matching element of
+    // hits. Large batches are distributed to the default thread pool.
+    virtual void ray_cast_n(
+        std::span<const Query_ray>          rays,
+        std::span<std::optional<Query_hit>> hits,
+        uint32_t                            layer_mask = Query_layer::all
+    ) const = 0;
+
+    // Sweeps shape from ray origin along ray direction, returns first hit
+    [[nodiscard]] virtual auto sphere_cast(
+        const Query_ray& ray,
+        float            radius,
+        uint32_t         layer_mask = Query_layer::all
+    ) const -> std::optional<Query_hit> = 0;
+
+    [[nodiscard]] virtual auto box_cast(
+        const Query_ray& ray,
+        const glm::vec3& half_extents,
+        const glm::quat& orientation,
+        uint32_t         layer_mask = Query_layer::all
+    ) const -> std::optional<Query_hit> = 0;
+
+    // Appends each body intersecting the shape to out, once
+    virtual void overlap_sphere(
+        const glm::vec3&           center,
+        float                      radius,
+        std::vector<IRigid_body*>& out,
+        uint32_t                   layer_mask = Query_layer::all
+    ) const = 0;
+
+    virtual void overlap_box(
+        const glm::vec3&           center,
+        const glm::vec3&           half_extents,
+        const glm::quat&           orientation,
+        std::vector<IRigid_body*>& out,
+        uint32_t                   layer_mask = Query_layer::all
+    ) const = 0;
 };
 
 } // namespace erhe::physics
@@ -0,0 +1,82 @@
+#include "erhe_physics/jolt/jolt_job_system.hpp"
+#include "erhe_physics/physics_log.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace erhe::physics {
+
+Jolt_job_system::Jolt_job_system(
+    erhe::concurrency::Thread_pool& thread_pool,
+    const unsigned int              max_jobs,
+    const unsigned int              max_barriers
+)
+    : JPH::JobSystemWithBarrier{max_barriers}
+    , m_thread_pool            {thread_pool}
+    , m_queue                  {thread_pool, "physics", erhe::concurrency::Priority::HIGH}
+{
+    m_jobs.Init(max_jobs, max_jobs);
+}
+
+Jolt_job_system::~Jolt_job_system() noexcept
+{
+    m_queue.wait();
+}
+
+auto Jolt_job_system::GetMaxConcurrency() const -> int
+{
+    // Thread waiting for a barrier also executes jobs
+    return m_thread_pool.size() + 1;
+}
+
+auto Jolt_job_system::CreateJob(
+    const char*        inName,
+    JPH::ColorArg      inColor,
+    const JobFunction& inJobFunction,
+    const JPH::uint32  inNumDependencies
+) -> JobHandle
+{
+    JPH::uint32 index = JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex;
+    for (;;) {
+        index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        if (index != JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex) {
+            break;
+        }
+        log_physics->warn("Jolt job system: no free jobs, waiting");
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+    }
+    Job* job = &m_jobs.Get(index);
+
+    // Handle keeps a reference; queued job may complete immediately
+    JobHandle handle{job};
+    if (inNumDependencies == 0) {
+        QueueJob(job);
+    }
+    return handle;
+}
+
+void Jolt_job_system::QueueJob(Job* inJob)
+{
+    // Reference is released by the task after the job has been executed
+    inJob->AddRef();
+    m_queue.enqueue(
+        [inJob]() {
+            inJob->Execute();
+            inJob->Release();
+        }
+    );
+}
+
+void Jolt_job_system::QueueJobs(Job** inJobs, const JPH::uint inNumJobs)
+{
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+        QueueJob(inJobs[i]);
+    }
+}
+
+void Jolt_job_system::FreeJob(Job* inJob)
+{
+    m_jobs.DestructObject(inJob);
+}
+
+} // namespace erhe::physics
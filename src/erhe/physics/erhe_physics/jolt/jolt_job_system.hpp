@@ -0,0 +1,45 @@
+#pragma once
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+namespace erhe::physics {
+
+// Runs Jolt jobs as tasks of an erhe::concurrency::Thread_pool, so that
+// physics shares worker threads with other subsystems instead of owning a
+// JobSystemThreadPool. Barriers are provided by JobSystemWithBarrier; the
+// thread waiting on a barrier also executes jobs of that barrier.
+class Jolt_job_system : public JPH::JobSystemWithBarrier
+{
+public:
+    Jolt_job_system(
+        erhe::concurrency::Thread_pool& thread_pool,
+        unsigned int                    max_jobs,
+        unsigned int                    max_barriers
+    );
+    ~Jolt_job_system() noexcept override;
+
+    // Implements JPH::JobSystem
+    auto GetMaxConcurrency() const -> int override;
+    auto CreateJob(
+        const char*        inName,
+        JPH::ColorArg      inColor,
+        const JobFunction& inJobFunction,
+        JPH::uint32        inNumDependencies = 0
+    ) -> JobHandle override;
+
+protected:
+    void QueueJob (Job* inJob)                        override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob  (Job* inJob)                        override;
+
+private:
+    erhe::concurrency::Thread_pool&     m_thread_pool;
+    JPH::FixedSizeFreeList<Job>         m_jobs;
+    erhe::concurrency::Concurrent_queue m_queue; // Destroyed first; waits for queued jobs
+};
+
+} // namespace erhe::physics
@@ -1,16 +1,29 @@
 #include "erhe_physics/jolt/jolt_world.hpp"
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_configuration/configuration.hpp"
 #include "erhe_log/log_glm.hpp"
 #include "erhe_physics/jolt/jolt_constraint.hpp"
 #include "erhe_physics/jolt/jolt_rigid_body.hpp"
 #include "erhe_physics/jolt/glm_conversions.hpp"
 #include "erhe_physics/idebug_draw.hpp"
 #include "erhe_physics/physics_log.hpp"
+#include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Physics/Body/Body.h>
-
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+
+#include <algorithm>
 #include <cstdarg>
 
 namespace erhe::physics {
@@ -128,6 +141,63 @@ auto Jolt_collision_filter::ShouldCollide(JPH::ObjectLayer inLayer1, JPH::Object
     }
 }
 
+// Query_layer bits are indexed by object layer. Broad phase layers map 1:1
+// to object layers, so the same mask is used for both filters.
+static_assert(Query_layer::non_moving    == (1u << Layers::NON_MOVING));
+static_assert(Query_layer::moving        == (1u << Layers::MOVING));
+static_assert(Query_layer::non_colliding == (1u << Layers::NON_COLLIDING));
+
+namespace {
+
+class Query_broad_phase_layer_filter final : public JPH::BroadPhaseLayerFilter
+{
+public:
+    explicit Query_broad_phase_layer_filter(const uint32_t layer_mask)
+        : m_layer_mask{layer_mask}
+    {
+    }
+
+    auto ShouldCollide(const JPH::BroadPhaseLayer inLayer) const -> bool override
+    {
+        return (m_layer_mask & (1u << inLayer.GetValue())) != 0;
+    }
+
+private:
+    uint32_t m_layer_mask;
+};
+
+class Query_object_layer_filter final : public JPH::ObjectLayerFilter
+{
+public:
+    explicit Query_object_layer_filter(const uint32_t layer_mask)
+        : m_layer_mask{layer_mask}
+    {
+    }
+
+    auto ShouldCollide(const JPH::ObjectLayer inLayer) const -> bool override
+    {
+        return (m_layer_mask & (1u << inLayer)) != 0;
+    }
+
+private:
+    uint32_t m_layer_mask;
+};
+
+// Jolt rays and sweeps are given as a displacement vector, which must stay finite
+constexpr float c_max_query_distance = 1.0e6f;
+
+[[nodiscard]] auto get_query_displacement(const Query_ray& ray) -> std::optional<glm::vec3>
+{
+    const float direction_length = glm::length(ray.direction);
+    const float distance         = std::min(ray.max_distance, c_max_query_distance);
+    if ((direction_length <= 0.0f) || !(distance > 0.0f)) {
+        return {};
+    }
+    return ray.direction * (distance / direction_length);
+}
+
+}
+
 IWorld::~IWorld() noexcept
 {
 }
@@ -166,14 +236,34 @@ Jolt_world::Initialize_first::Initialize_first()
     ////register_empty_shape();
 }
 
+namespace {
+
+[[nodiscard]] auto get_temp_allocator_byte_count() -> std::size_t
+{
+    int temp_allocator_mb{10};
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "physics");
+    ini.get("temp_allocator_mb", temp_allocator_mb);
+    return static_cast<std::size_t>(std::max(temp_allocator_mb, 1)) * 1024 * 1024;
+}
+
+[[nodiscard]] auto get_max_body_count() -> unsigned int
+{
+    int max_bodies{1024 * 128};
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "physics");
+    ini.get("max_bodies", max_bodies);
+    return static_cast<unsigned int>(std::max(max_bodies, 1024));
+}
+
+}
+
 Jolt_world::Jolt_world()
-    : m_temp_allocator{10 * 1024 * 1024}
-    , m_job_system    {JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, 10}
+    : m_temp_allocator{get_temp_allocator_byte_count()}
+    , m_job_system    {erhe::concurrency::Thread_pool::get_default(), JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers}
 {
     //m_debug_renderer              = std::make_unique<Jolt_debug_renderer             >();
     m_broad_phase_layer_interface = std::make_unique<Broad_phase_layer_interface_impl>();
     m_physics_system.Init(
-        cMaxBodies,
+        get_max_body_count(),
         cNumBodyMutexes,
         cMaxBodyPairs,
         cMaxContactConstraints,
@@ -191,6 +281,13 @@ Jolt_world::~Jolt_world() noexcept = default;
 void Jolt_world::update_fixed_step(const double dt)
 {
     log_physics_frame->trace("update_fixed_step()");
+
+    // Bodies added one at a time (for example while loading a scene) leave
+    // an unbalanced broad phase tree
+    if (m_bodies_added_since_optimize >= c_optimize_broad_phase_body_count) {
+        optimize_broad_phase();
+    }
+
     // If you take larger steps than 1 / 60th of a second you need to do
     // multiple collision steps in order to keep the simulation stable.
     // Do 1 collision step per 1 / 60th of a second (round up).
@@ -232,9 +329,8 @@ auto Jolt_world::describe() const -> std::vector<std::string>
     return out;
 }
 
-void Jolt_world::add_rigid_body(IRigid_body* rigid_body)
+auto Jolt_world::get_addable_body_id(IRigid_body* rigid_body) -> JPH::BodyID
 {
-    auto& body_interface  = m_physics_system.GetBodyInterface();
     auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
 
     ERHE_VERIFY(jolt_rigid_body != nullptr);
@@ -242,60 +338,124 @@ void Jolt_world::add_rigid_body(IRigid_body* rigid_body)
     auto* jolt_body = jolt_rigid_body->get_jolt_body();
     ERHE_VERIFY(jolt_body != nullptr);
     if (jolt_body == &JPH::Body::sFixedToWorld) {
-        return;
+        return JPH::BodyID{};
+    }
+    if (jolt_body->IsInBroadPhase()) {
+        log_physics->error("rigid body {} already in world", rigid_body->get_debug_label());
+        return JPH::BodyID{};
     }
+    return jolt_body->GetID();
+}
 
+auto Jolt_world::get_removable_body_id(IRigid_body* rigid_body) -> JPH::BodyID
+{
+    auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
 
-#ifndef NDEBUG
-    const auto i = std::find(m_rigid_bodies.begin(), m_rigid_bodies.end(), jolt_rigid_body);
-    if (i != m_rigid_bodies.end()) {
-        log_physics->error("rigid body {} already in world", rigid_body->get_debug_label());
-    } else
-#endif
-    {
-        body_interface.AddBody(
-            jolt_body->GetID(),
-            JPH::EActivation::DontActivate
-        );
-        m_rigid_bodies.push_back(jolt_rigid_body);
+    ERHE_VERIFY(jolt_rigid_body != nullptr);
+
+    auto* jolt_body = jolt_rigid_body->get_jolt_body();
+    ERHE_VERIFY(jolt_body != nullptr);
+    if (jolt_body == &JPH::Body::sFixedToWorld) {
+        return JPH::BodyID{};
+    }
+    if (!jolt_body->IsInBroadPhase()) {
+        log_physics->error("rigid body {} not in world", rigid_body->get_debug_label());
+        return JPH::BodyID{};
+    }
+    return jolt_body->GetID();
+}
+
+void Jolt_world::add_rigid_body(IRigid_body* rigid_body)
+{
+    const JPH::BodyID body_id = get_addable_body_id(rigid_body);
+    if (body_id.IsInvalid()) {
+        return;
     }
 
+    m_physics_system.GetBodyInterface().AddBody(body_id, JPH::EActivation::DontActivate);
+    ++m_bodies_added_since_optimize;
+
     log_physics->trace(
         "added rigid body {} id = {} (total {})",
         rigid_body->get_debug_label(),
-        jolt_body->GetID().GetIndex(),
+        body_id.GetIndex(),
         m_physics_system.GetNumBodies()
     );
 }
 
 void Jolt_world::remove_rigid_body(IRigid_body* rigid_body)
 {
-    auto& body_interface  = m_physics_system.GetBodyInterface();
-    auto* jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(rigid_body);
+    const JPH::BodyID body_id = get_removable_body_id(rigid_body);
+    if (body_id.IsInvalid()) {
+        return;
+    }
 
-    ERHE_VERIFY(jolt_rigid_body != nullptr);
+    log_physics->trace("remove rigid body {} id = {}", rigid_body->get_debug_label(), body_id.GetIndex());
 
-    auto* jolt_body = jolt_rigid_body->get_jolt_body();
-    ERHE_VERIFY(jolt_body != nullptr);
-    if (jolt_body == &JPH::Body::sFixedToWorld) {
+    m_physics_system.GetBodyInterface().RemoveBody(body_id);
+}
+
+// Bodies are inserted into the broad phase as one prebuilt subtree per
+// layer, instead of one tree insertion per body. Each body may appear in
+// the span only once.
+void Jolt_world::add_rigid_bodies(std::span<IRigid_body* const> rigid_bodies)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    m_batch_body_ids.clear();
+    m_batch_body_ids.reserve(rigid_bodies.size());
+    for (IRigid_body* rigid_body : rigid_bodies) {
+        const JPH::BodyID body_id = get_addable_body_id(rigid_body);
+        if (!body_id.IsInvalid()) {
+            m_batch_body_ids.push_back(body_id);
+        }
+    }
+    if (m_batch_body_ids.empty()) {
         return;
     }
 
-    log_physics->trace("remove rigid body {} id = {}", rigid_body->get_debug_label(), jolt_body->GetID().GetIndex());
+    auto&     body_interface = m_physics_system.GetBodyInterface();
+    const int body_count     = static_cast<int>(m_batch_body_ids.size());
+    const JPH::BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(m_batch_body_ids.data(), body_count);
+    body_interface.AddBodiesFinalize(m_batch_body_ids.data(), body_count, add_state, JPH::EActivation::DontActivate);
 
-    const auto i = std::remove(
-        m_rigid_bodies.begin(),
-        m_rigid_bodies.end(),
-        jolt_rigid_body
-    );
-    if (i == m_rigid_bodies.end()) {
-        log_physics->error("rigid body {} not in world", rigid_body->get_debug_label());
-    } else {
-        body_interface.RemoveBody(jolt_body->GetID());
-        m_rigid_bodies.erase(i, m_rigid_bodies.end());
+    log_physics->trace("added {} rigid bodies (total {})", body_count, m_physics_system.GetNumBodies());
+
+    m_bodies_added_since_optimize += m_batch_body_ids.size();
+    if (m_bodies_added_since_optimize >= c_optimize_broad_phase_body_count) {
+        optimize_broad_phase();
     }
 }
 
+void Jolt_world::remove_rigid_bodies(std::span<IRigid_body* const> rigid_bodies)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    m_batch_body_ids.clear();
+    m_batch_body_ids.reserve(rigid_bodies.size());
+    for (IRigid_body* rigid_body : rigid_bodies) {
+        const JPH::BodyID body_id = get_removable_body_id(rigid_body);
+        if (!body_id.IsInvalid()) {
+            m_batch_body_ids.push_back(body_id);
+        }
+    }
+    if (m_batch_body_ids.empty()) {
+        return;
+    }
+
+    m_physics_system.GetBodyInterface().RemoveBodies(m_batch_body_ids.data(), static_cast<int>(m_batch_body_ids.size()));
+
+    log_physics->trace("removed {} rigid bodies (total {})", m_batch_body_ids.size(), m_physics_system.GetNumBodies());
+}
+
+void Jolt_world::optimize_broad_phase()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    m_physics_system.OptimizeBroadPhase();
+    m_bodies_added_since_optimize = 0;
+}
+
 void Jolt_world::add_constraint(IConstraint* constraint)
 {
     log_physics->trace("add constraint");
@@ -394,6 +554,241 @@ void Jolt_world::for_each_active_body(std::function<void(IRigid_body*)> callback
     }
 }
 
+auto Jolt_world::get_query_rigid_body(const JPH::BodyID body_id) const -> IRigid_body*
+{
+    const JPH::uint64 user_data = m_physics_system.GetBodyInterface().GetUserData(body_id);
+    return reinterpret_cast<Jolt_rigid_body*>(user_data);
+}
+
+auto Jolt_world::ray_cast(const Query_ray& ray, const uint32_t layer_mask) const -> std::optional<Query_hit>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::optional<glm::vec3> displacement = get_query_displacement(ray);
+    if (!displacement.has_value()) {
+        return {};
+    }
+
+    const JPH::RRayCast                  jolt_ray{to_jolt(ray.origin), to_jolt(displacement.value())};
+    const Query_broad_phase_layer_filter broad_phase_layer_filter{layer_mask};
+    const Query_object_layer_filter      object_layer_filter{layer_mask};
+    JPH::RayCastResult                   result;
+    const bool hit = m_physics_system.GetNarrowPhaseQuery().CastRay(jolt_ray, result, broad_phase_layer_filter, object_layer_filter);
+    if (!hit) {
+        return {};
+    }
+
+    const JPH::BodyLockRead lock{m_physics_system.GetBodyLockInterface(), result.mBodyID};
+    if (!lock.Succeeded()) {
+        return {};
+    }
+    const JPH::Body& body            = lock.GetBody();
+    const JPH::RVec3 position        = jolt_ray.GetPointOnRay(result.mFraction);
+    auto*            jolt_rigid_body = reinterpret_cast<Jolt_rigid_body*>(body.GetUserData());
+    if (jolt_rigid_body == nullptr) {
+        return {};
+    }
+
+    Query_hit query_hit;
+    query_hit.rigid_body = jolt_rigid_body;
+    query_hit.position   = from_jolt(position);
+    query_hit.normal     = from_jolt(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, position));
+    query_hit.distance   = result.mFraction * glm::length(displacement.value());
+    return query_hit;
+}
+
+// Narrow phase queries only read the body manager, so rays can be cast
+// concurrently. Each ray writes only its own element of hits.
+void Jolt_world::ray_cast_n(
+    std::span<const Query_ray>          rays,
+    std::span<std::optional<Query_hit>> hits,
+    const uint32_t                      layer_mask
+) const
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(hits.size() >= rays.size());
+
+    const std::size_t               ray_count   = rays.size();
+    erhe::concurrency::Thread_pool& thread_pool = erhe::concurrency::Thread_pool::get_default();
+    if ((ray_count < c_parallel_ray_cast_count) || (thread_pool.size() == 0)) {
+        for (std::size_t i = 0; i < ray_count; ++i) {
+            hits[i] = ray_cast(rays[i], layer_mask);
+        }
+        return;
+    }
+
+    erhe::concurrency::Concurrent_queue queue{thread_pool, "physics query"};
+    queue.enqueue_range(
+        0, ray_count, c_parallel_ray_cast_count / 4,
+        [this, rays, hits, layer_mask](const std::size_t first, const std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                hits[i] = ray_cast(rays[i], layer_mask);
+            }
+        }
+    );
+    queue.wait();
+}
+
+auto Jolt_world::shape_cast(
+    const JPH::Shape& shape,
+    const glm::quat&  orientation,
+    const Query_ray&  ray,
+    const uint32_t    layer_mask
+) const -> std::optional<Query_hit>
+{
+    const std::optional<glm::vec3> displacement = get_query_displacement(ray);
+    if (!displacement.has_value()) {
+        return {};
+    }
+
+    const JPH::RShapeCast shape_cast = JPH::RShapeCast::sFromWorldTransform(
+        &shape,
+        JPH::Vec3::sReplicate(1.0f),
+        JPH::RMat44::sRotationTranslation(to_jolt(orientation), to_jolt(ray.origin)),
+        to_jolt(displacement.value())
+    );
+
+    // Deepest point is needed for a meaningful normal when the shape
+    // already overlaps a body at the start of the sweep
+    JPH::ShapeCastSettings settings;
+    settings.mReturnDeepestPoint = true;
+
+    const Query_broad_phase_layer_filter                       broad_phase_layer_filter{layer_mask};
+    const Query_object_layer_filter                            object_layer_filter{layer_mask};
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+    m_physics_system.GetNarrowPhaseQuery().CastShape(
+        shape_cast, settings, JPH::RVec3::sZero(), collector, broad_phase_layer_filter, object_layer_filter
+    );
+    if (!collector.HadHit()) {
+        return {};
+    }
+
+    const JPH::ShapeCastResult& result     = collector.mHit;
+    IRigid_body*                rigid_body = get_query_rigid_body(result.mBodyID2);
+    if (rigid_body == nullptr) {
+        return {};
+    }
+
+    // Penetration axis points from the cast shape into the hit body
+    const glm::vec3 penetration_axis = from_jolt(result.mPenetrationAxis);
+    const float     axis_length      = glm::length(penetration_axis);
+
+    Query_hit query_hit;
+    query_hit.rigid_body = rigid_body;
+    query_hit.position   = from_jolt(result.mContactPointOn2);
+    query_hit.normal     = (axis_length > 0.0f)
+        ? -penetration_axis / axis_length
+        : -glm::normalize(displacement.value());
+    query_hit.distance   = result.mFraction * glm::length(displacement.value());
+    return query_hit;
+}
+
+void Jolt_world::collide_shape(
+    const JPH::Shape&          shape,
+    const glm::vec3&           center,
+    const glm::quat&           orientation,
+    std::vector<IRigid_body*>& out,
+    const uint32_t             layer_mask
+) const
+{
+    const Query_broad_phase_layer_filter                      broad_phase_layer_filter{layer_mask};
+    const Query_object_layer_filter                           object_layer_filter{layer_mask};
+    const JPH::CollideShapeSettings                           settings;
+    JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+    m_physics_system.GetNarrowPhaseQuery().CollideShape(
+        &shape,
+        JPH::Vec3::sReplicate(1.0f),
+        JPH::RMat44::sRotationTranslation(to_jolt(orientation), to_jolt(center)),
+        settings,
+        JPH::RVec3::sZero(),
+        collector,
+        broad_phase_layer_filter,
+        object_layer_filter
+    );
+
+    // Collector reports each contacting sub shape pair; report each body once
+    std::vector<JPH::BodyID> body_ids;
+    body_ids.reserve(collector.mHits.size());
+    for (const JPH::CollideShapeResult& hit : collector.mHits) {
+        body_ids.push_back(hit.mBodyID2);
+    }
+    std::sort(body_ids.begin(), body_ids.end());
+    body_ids.erase(std::unique(body_ids.begin(), body_ids.end()), body_ids.end());
+    for (const JPH::BodyID body_id : body_ids) {
+        IRigid_body* rigid_body = get_query_rigid_body(body_id);
+        if (rigid_body != nullptr) {
+            out.push_back(rigid_body);
+        }
+    }
+}
+
+auto Jolt_world::sphere_cast(const Query_ray& ray, const float radius, const uint32_t layer_mask) const -> std::optional<Query_hit>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!(radius > 0.0f)) {
+        return {};
+    }
+    JPH::SphereShape sphere{radius};
+    sphere.SetEmbedded();
+    return shape_cast(sphere, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}, ray, layer_mask);
+}
+
+auto Jolt_world::box_cast(
+    const Query_ray& ray,
+    const glm::vec3& half_extents,
+    const glm::quat& orientation,
+    const uint32_t   layer_mask
+) const -> std::optional<Query_hit>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const float min_half_extent = std::min(std::min(half_extents.x, half_extents.y), half_extents.z);
+    if (!(min_half_extent > 0.0f)) {
+        return {};
+    }
+    JPH::BoxShape box{to_jolt(half_extents), std::min(JPH::cDefaultConvexRadius, min_half_extent)};
+    box.SetEmbedded();
+    return shape_cast(box, orientation, ray, layer_mask);
+}
+
+void Jolt_world::overlap_sphere(
+    const glm::vec3&           center,
+    const float                radius,
+    std::vector<IRigid_body*>& out,
+    const uint32_t             layer_mask
+) const
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!(radius > 0.0f)) {
+        return;
+    }
+    JPH::SphereShape sphere{radius};
+    sphere.SetEmbedded();
+    collide_shape(sphere, center, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}, out, layer_mask);
+}
+
+void Jolt_world::overlap_box(
+    const glm::vec3&           center,
+    const glm::vec3&           half_extents,
+    const glm::quat&           orientation,
+    std::vector<IRigid_body*>& out,
+    const uint32_t             layer_mask
+) const
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const float min_half_extent = std::min(std::min(half_extents.x, half_extents.y), half_extents.z);
+    if (!(min_half_extent > 0.0f)) {
+        return;
+    }
+    JPH::BoxShape box{to_jolt(half_extents), std::min(JPH::cDefaultConvexRadius, min_half_extent)};
+    box.SetEmbedded();
+    collide_shape(box, center, orientation, out, layer_mask);
+}
+
 void Jolt_world::OnBodyActivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData)
 {
     if (!m_on_body_activated_callback) {
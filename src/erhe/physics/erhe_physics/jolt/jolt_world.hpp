@@ -1,16 +1,18 @@
 #pragma once
 
 #include "erhe_physics/iworld.hpp"
+#include "erhe_physics/jolt/jolt_job_system.hpp"
 
 #include <Jolt/Jolt.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace erhe::physics {
@@ -77,6 +79,9 @@ public:
     void set_gravity         (const glm::vec3& gravity)           override;
     void add_rigid_body      (IRigid_body* rigid_body)            override;
     void remove_rigid_body   (IRigid_body* rigid_body)            override;
+    void add_rigid_bodies    (std::span<IRigid_body* const> rigid_bodies) override;
+    void remove_rigid_bodies (std::span<IRigid_body* const> rigid_bodies) override;
+    void optimize_broad_phase()                                   override;
     void add_constraint      (IConstraint* constraint)            override;
     void remove_constraint   (IConstraint* constraint)            override;
     void set_debug_drawer    (IDebug_draw* debug_draw)            override;
@@ -87,6 +92,13 @@ public:
     void set_on_body_deactivated(std::function<void(IRigid_body*)> callback) override;
     void for_each_active_body   (std::function<void(IRigid_body*)> callback) override;
 
+    auto ray_cast      (const Query_ray& ray, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    void ray_cast_n    (std::span<const Query_ray> rays, std::span<std::optional<Query_hit>> hits, uint32_t layer_mask) const override;
+    auto sphere_cast   (const Query_ray& ray, float radius, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    auto box_cast      (const Query_ray& ray, const glm::vec3& half_extents, const glm::quat& orientation, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    void overlap_sphere(const glm::vec3& center, float radius, std::vector<IRigid_body*>& out, uint32_t layer_mask) const override;
+    void overlap_box   (const glm::vec3& center, const glm::vec3& half_extents, const glm::quat& orientation, std::vector<IRigid_body*>& out, uint32_t layer_mask) const override;
+
     // Implements BodyActivationListener
     void OnBodyActivated  (const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
     void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData) override;
@@ -112,16 +124,40 @@ private:
     };
     Initialize_first m_initialize_first;
 
-    static constexpr unsigned int cMaxBodies             = 1024 * 32;
     static constexpr unsigned int cNumBodyMutexes        = 0;
     static constexpr unsigned int cMaxBodyPairs          = 1024 * 8;
     static constexpr unsigned int cMaxContactConstraints = 1024;
 
+    // Broad phase is optimized when at least this many bodies have been
+    // added since the previous optimization; immediately for batches,
+    // otherwise before the next simulation step.
+    static constexpr std::size_t  c_optimize_broad_phase_body_count = 256;
+
+    // Batched ray casts are split into tasks when there are at least this many rays
+    static constexpr std::size_t  c_parallel_ray_cast_count = 256;
+
+    [[nodiscard]] auto get_addable_body_id  (IRigid_body* rigid_body) -> JPH::BodyID;
+    [[nodiscard]] auto get_removable_body_id(IRigid_body* rigid_body) -> JPH::BodyID;
+    [[nodiscard]] auto get_query_rigid_body (JPH::BodyID body_id) const -> IRigid_body*;
+    [[nodiscard]] auto shape_cast(
+        const JPH::Shape& shape,
+        const glm::quat&  orientation,
+        const Query_ray&  ray,
+        uint32_t          layer_mask
+    ) const -> std::optional<Query_hit>;
+    void collide_shape(
+        const JPH::Shape&          shape,
+        const glm::vec3&           center,
+        const glm::quat&           orientation,
+        std::vector<IRigid_body*>& out,
+        uint32_t                   layer_mask
+    ) const;
+
     glm::vec3                                      m_gravity        {0.0f};
     const Jolt_collision_filter                    m_collision_filter;
 
     JPH::TempAllocatorImpl                         m_temp_allocator;
-    JPH::JobSystemThreadPool                       m_job_system;
+    Jolt_job_system                                m_job_system;
     std::unique_ptr<JPH::BroadPhaseLayerInterface> m_broad_phase_layer_interface;
     JPH::PhysicsSystem                             m_physics_system;
     //std::unique_ptr<Jolt_debug_renderer>           m_debug_renderer;
@@ -129,7 +165,8 @@ private:
     std::function<void(Jolt_rigid_body*)>          m_on_body_activated_callback;
     std::function<void(Jolt_rigid_body*)>          m_on_body_deactivated_callback;
 
-    std::vector<Jolt_rigid_body*>                  m_rigid_bodies;
+    std::size_t                                    m_bodies_added_since_optimize{0};
+    std::vector<JPH::BodyID>                       m_batch_body_ids;
     std::vector<Jolt_constraint*>                  m_constraints;
 
     std::vector<std::shared_ptr<ICollision_shape>> m_collision_shapes;
@@ -55,6 +55,22 @@ void Null_world::remove_rigid_body(IRigid_body* rigid_body)
     );
 }
 
+void Null_world::add_rigid_bodies(std::span<IRigid_body* const> rigid_bodies)
+{
+    m_rigid_bodies.insert(m_rigid_bodies.end(), rigid_bodies.begin(), rigid_bodies.end());
+}
+
+void Null_world::remove_rigid_bodies(std::span<IRigid_body* const> rigid_bodies)
+{
+    for (IRigid_body* rigid_body : rigid_bodies) {
+        remove_rigid_body(rigid_body);
+    }
+}
+
+void Null_world::optimize_broad_phase()
+{
+}
+
 void Null_world::add_constraint(IConstraint* constraint)
 {
     m_constraints.push_back(constraint);
@@ -95,5 +111,77 @@ void Null_world::sanity_check()
 {
 }
 
+// Null_world bodies have no shapes in any broad phase; queries never hit
+
+auto Null_world::ray_cast(const Query_ray& ray, const uint32_t layer_mask) const -> std::optional<Query_hit>
+{
+    static_cast<void>(ray);
+    static_cast<void>(layer_mask);
+    return {};
+}
+
+void Null_world::ray_cast_n(
+    std::span<const Query_ray>          rays,
+    std::span<std::optional<Query_hit>> hits,
+    const uint32_t                      layer_mask
+) const
+{
+    static_cast<void>(layer_mask);
+    ERHE_VERIFY(hits.size() >= rays.size());
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        hits[i].reset();
+    }
+}
+
+auto Null_world::sphere_cast(const Query_ray& ray, const float radius, const uint32_t layer_mask) const -> std::optional<Query_hit>
+{
+    static_cast<void>(ray);
+    static_cast<void>(radius);
+    static_cast<void>(layer_mask);
+    return {};
+}
+
+auto Null_world::box_cast(
+    const Query_ray& ray,
+    const glm::vec3& half_extents,
+    const glm::quat& orientation,
+    const uint32_t   layer_mask
+) const -> std::optional<Query_hit>
+{
+    static_cast<void>(ray);
+    static_cast<void>(half_extents);
+    static_cast<void>(orientation);
+    static_cast<void>(layer_mask);
+    return {};
+}
+
+void Null_world::overlap_sphere(
+    const glm::vec3&           center,
+    const float                radius,
+    std::vector<IRigid_body*>& out,
+    const uint32_t             layer_mask
+) const
+{
+    static_cast<void>(center);
+    static_cast<void>(radius);
+    static_cast<void>(out);
+    static_cast<void>(layer_mask);
+}
+
+void Null_world::overlap_box(
+    const glm::vec3&           center,
+    const glm::vec3&           half_extents,
+    const glm::quat&           orientation,
+    std::vector<IRigid_body*>& out,
+    const uint32_t             layer_mask
+) const
+{
+    static_cast<void>(center);
+    static_cast<void>(half_extents);
+    static_cast<void>(orientation);
+    static_cast<void>(out);
+    static_cast<void>(layer_mask);
+}
+
 
 } // namespace erhe::physics
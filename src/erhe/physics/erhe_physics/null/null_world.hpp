@@ -22,12 +22,22 @@ public:
     auto get_gravity      () const -> glm::vec3      override;
     void add_rigid_body   (IRigid_body* rigid_body)  override;
     void remove_rigid_body(IRigid_body* rigid_body)  override;
+    void add_rigid_bodies    (std::span<IRigid_body* const> rigid_bodies) override;
+    void remove_rigid_bodies (std::span<IRigid_body* const> rigid_bodies) override;
+    void optimize_broad_phase()                                           override;
     void add_constraint   (IConstraint* constraint)  override;
     void remove_constraint(IConstraint* constraint)  override;
     void set_debug_drawer (IDebug_draw* debug_draw)  override;
     void debug_draw       ()                         override;
     void sanity_check     ()                         override;
 
+    auto ray_cast      (const Query_ray& ray, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    void ray_cast_n    (std::span<const Query_ray> rays, std::span<std::optional<Query_hit>> hits, uint32_t layer_mask) const override;
+    auto sphere_cast   (const Query_ray& ray, float radius, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    auto box_cast      (const Query_ray& ray, const glm::vec3& half_extents, const glm::quat& orientation, uint32_t layer_mask) const -> std::optional<Query_hit> override;
+    void overlap_sphere(const glm::vec3& center, float radius, std::vector<IRigid_body*>& out, uint32_t layer_mask) const override;
+    void overlap_box   (const glm::vec3& center, const glm::vec3& half_extents, const glm::quat& orientation, std::vector<IRigid_body*>& out, uint32_t layer_mask) const override;
+
 private:
     glm::vec3                 m_gravity        {0.0f};
 
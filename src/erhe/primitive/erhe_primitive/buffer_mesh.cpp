@@ -5,13 +5,13 @@ namespace erhe::primitive {
 
 auto Buffer_mesh::base_vertex() const -> uint32_t
 {
-    return static_cast<uint32_t>(vertex_buffer_range.byte_offset / vertex_buffer_range.element_size);
+    return static_cast<uint32_t>(vertex_buffer_range.get_byte_offset() / vertex_buffer_range.element_size);
 }
 
 // Value that should be added in index range first index
 auto Buffer_mesh::base_index() const -> uint32_t
 {
-    return static_cast<uint32_t>(index_buffer_range.byte_offset / index_buffer_range.element_size);
+    return static_cast<uint32_t>(index_buffer_range.get_byte_offset() / index_buffer_range.element_size);
 }
 
 auto Buffer_mesh::index_range(const Primitive_mode primitive_mode) const -> Index_range
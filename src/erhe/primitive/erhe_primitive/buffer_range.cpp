@@ -1 +1,11 @@
 #include "erhe_primitive/buffer_range.hpp"
+#include "erhe_graphics/buffer.hpp"
+
+namespace erhe::primitive {
+
+auto Buffer_range::get_byte_offset() const -> std::size_t
+{
+    return allocation ? allocation->get_byte_offset() : byte_offset;
+}
+
+} // namespace erhe::primitive
@@ -1,17 +1,28 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+
+namespace erhe::graphics {
+    class Buffer_allocation;
+}
 
 namespace erhe::primitive {
 
 class Buffer_range
 {
 public:
-    [[nodiscard]] auto get_byte_size() const -> std::size_t { return count * element_size; }
+    [[nodiscard]] auto get_byte_size  () const -> std::size_t { return count * element_size; }
+
+    // Current byte offset; follows allocation if buffer has been compacted
+    [[nodiscard]] auto get_byte_offset() const -> std::size_t;
 
     std::size_t count       {0};
     std::size_t element_size{0};
-    std::size_t byte_offset {0};
+    std::size_t byte_offset {0}; // initial byte offset
+
+    // Set when range is allocated from a GPU buffer; keeps range allocated
+    std::shared_ptr<erhe::graphics::Buffer_allocation> allocation;
 };
 
 } // namespace erhe::primitive
@@ -3,6 +3,9 @@
 #include "erhe_graphics/buffer.hpp"
 #include "erhe_graphics/buffer_transfer_queue.hpp"
 #include "erhe_raytrace/ibuffer.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <cstring>
 
 namespace erhe::primitive {
 
@@ -10,6 +13,18 @@ Buffer_sink::~Buffer_sink() noexcept
 {
 }
 
+auto Buffer_sink::get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    static_cast<void>(range);
+    return {};
+}
+
+auto Buffer_sink::get_index_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    static_cast<void>(range);
+    return {};
+}
+
 Gl_buffer_sink::Gl_buffer_sink(
     erhe::graphics::Buffer_transfer_queue& buffer_transfer_queue,
     erhe::graphics::Buffer&                vertex_buffer,
@@ -23,29 +38,53 @@ Gl_buffer_sink::Gl_buffer_sink(
 
 auto Gl_buffer_sink::allocate_vertex_buffer(const std::size_t vertex_count, const std::size_t vertex_element_size) -> Buffer_range
 {
-    const auto byte_offset = m_vertex_buffer.allocate_bytes(
+    auto allocation = std::make_shared<erhe::graphics::Buffer_allocation>(
+        m_vertex_buffer,
         vertex_count * vertex_element_size,
         vertex_element_size
     );
+    ERHE_VERIFY(allocation->is_valid());
 
     return Buffer_range{
         .count        = vertex_count,
         .element_size = vertex_element_size,
-        .byte_offset  = byte_offset
+        .byte_offset  = allocation->get_byte_offset(),
+        .allocation   = allocation
     };
 }
 
 auto Gl_buffer_sink::allocate_index_buffer(const std::size_t index_count, const std::size_t index_element_size) -> Buffer_range
 {
-    const auto index_byte_offset = m_index_buffer.allocate_bytes(index_count * index_element_size);
+    auto allocation = std::make_shared<erhe::graphics::Buffer_allocation>(
+        m_index_buffer,
+        index_count * index_element_size
+    );
+    ERHE_VERIFY(allocation->is_valid());
 
     return Buffer_range{
         .count        = index_count,
         .element_size = index_element_size,
-        .byte_offset  = index_byte_offset
+        .byte_offset  = allocation->get_byte_offset(),
+        .allocation   = allocation
     };
 }
 
+auto Gl_buffer_sink::get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    if (range.allocation) {
+        return m_buffer_transfer_queue.reserve(m_vertex_buffer, *range.allocation.get(), range.get_byte_size());
+    }
+    return m_buffer_transfer_queue.reserve(m_vertex_buffer, range.byte_offset, range.get_byte_size());
+}
+
+auto Gl_buffer_sink::get_index_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    if (range.allocation) {
+        return m_buffer_transfer_queue.reserve(m_index_buffer, *range.allocation.get(), range.get_byte_size());
+    }
+    return m_buffer_transfer_queue.reserve(m_index_buffer, range.byte_offset, range.get_byte_size());
+}
+
 void Gl_buffer_sink::enqueue_index_data(std::size_t offset, std::vector<uint8_t>&& data) const
 {
     m_buffer_transfer_queue.enqueue(
@@ -66,20 +105,36 @@ void Gl_buffer_sink::enqueue_vertex_data(std::size_t offset, std::vector<uint8_t
 
 void Gl_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 {
-    m_buffer_transfer_queue.enqueue(
-        m_vertex_buffer,
-        writer.start_offset(),
-        std::move(writer.vertex_data)
-    );
+    if (writer.vertex_data_reserved) {
+        m_buffer_transfer_queue.commit(writer.vertex_data_span);
+        return;
+    }
+    if (writer.vertex_data.empty()) {
+        return; // Empty range, nothing was reserved
+    }
+    const Buffer_range& range = writer.get_buffer_range();
+    if (range.allocation) {
+        m_buffer_transfer_queue.enqueue(m_vertex_buffer, *range.allocation.get(), std::move(writer.vertex_data));
+        return;
+    }
+    m_buffer_transfer_queue.enqueue(m_vertex_buffer, range.byte_offset, std::move(writer.vertex_data));
 }
 
 void Gl_buffer_sink::buffer_ready(Index_buffer_writer& writer) const
 {
-    m_buffer_transfer_queue.enqueue(
-        m_index_buffer,
-        writer.start_offset(),
-        std::move(writer.index_data)
-    );
+    if (writer.index_data_reserved) {
+        m_buffer_transfer_queue.commit(writer.index_data_span);
+        return;
+    }
+    if (writer.index_data.empty()) {
+        return; // Empty range, nothing was reserved
+    }
+    const Buffer_range& range = writer.get_buffer_range();
+    if (range.allocation) {
+        m_buffer_transfer_queue.enqueue(m_index_buffer, *range.allocation.get(), std::move(writer.index_data));
+        return;
+    }
+    m_buffer_transfer_queue.enqueue(m_index_buffer, range.byte_offset, std::move(writer.index_data));
 }
 
 Raytrace_buffer_sink::Raytrace_buffer_sink(
@@ -120,6 +175,27 @@ auto Raytrace_buffer_sink::allocate_index_buffer(
     };
 }
 
+namespace {
+
+auto get_range_span(erhe::raytrace::IBuffer& buffer, const Buffer_range& range) -> std::span<std::uint8_t>
+{
+    const std::span<std::byte> buffer_span = buffer.span();
+    const std::span<std::byte> range_span  = buffer_span.subspan(range.byte_offset, range.count * range.element_size);
+    return std::span<std::uint8_t>{reinterpret_cast<std::uint8_t*>(range_span.data()), range_span.size()};
+}
+
+}
+
+auto Raytrace_buffer_sink::get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    return get_range_span(m_vertex_buffer, range);
+}
+
+auto Raytrace_buffer_sink::get_index_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>
+{
+    return get_range_span(m_index_buffer, range);
+}
+
 void Raytrace_buffer_sink::enqueue_index_data(std::size_t offset, std::vector<uint8_t>&& data) const
 {
     auto buffer_span = m_index_buffer.span();
@@ -136,6 +212,9 @@ void Raytrace_buffer_sink::enqueue_vertex_data(std::size_t offset, std::vector<u
 
 void Raytrace_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 {
+    if (writer.vertex_data.empty()) {
+        return; // written directly to buffer
+    }
     auto        buffer_span = m_vertex_buffer.span();
     const auto& data        = writer.vertex_data;
     auto        offset_span = buffer_span.subspan(writer.start_offset(), data.size());
@@ -144,6 +223,9 @@ void Raytrace_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 
 void Raytrace_buffer_sink::buffer_ready(Index_buffer_writer& writer) const
 {
+    if (writer.index_data.empty()) {
+        return; // written directly to buffer
+    }
     auto        buffer_span = m_index_buffer.span();
     const auto& data        = writer.index_data;
     auto        offset_span = buffer_span.subspan(writer.start_offset(), data.size());
@@ -2,8 +2,9 @@
 
 #include "erhe_primitive/buffer_range.hpp"
 
-#include <vector>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 namespace erhe::graphics {
     class Buffer;
@@ -28,6 +29,13 @@ public:
     [[nodiscard]] virtual auto allocate_vertex_buffer(std::size_t vertex_count, std::size_t vertex_element_size) -> Buffer_range = 0;
     [[nodiscard]] virtual auto allocate_index_buffer(std::size_t index_count, std::size_t index_element_size) -> Buffer_range = 0;
 
+    // Returns memory where the data for an allocated range can be written
+    // directly, or an empty span if the sink only accepts the data through
+    // buffer_ready(). When a span is returned, writers skip their staging
+    // vector and buffer_ready() has nothing to copy.
+    [[nodiscard]] virtual auto get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t>;
+    [[nodiscard]] virtual auto get_index_data_span (const Buffer_range& range) const -> std::span<std::uint8_t>;
+
     virtual void enqueue_index_data (std::size_t offset, std::vector<uint8_t>&& data) const = 0;
     virtual void enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const = 0;
     virtual void buffer_ready       (Vertex_buffer_writer& writer) const = 0;
@@ -46,6 +54,9 @@ public:
     [[nodiscard]] auto allocate_vertex_buffer(std::size_t vertex_count, std::size_t vertex_element_size) -> Buffer_range override;
     [[nodiscard]] auto allocate_index_buffer(std::size_t index_count, std::size_t index_element_size) -> Buffer_range override;
 
+    [[nodiscard]] auto get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t> override;
+    [[nodiscard]] auto get_index_data_span (const Buffer_range& range) const -> std::span<std::uint8_t> override;
+
     void enqueue_index_data (std::size_t offset, std::vector<uint8_t>&& data) const override;
     void enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const override;
     void buffer_ready       (Vertex_buffer_writer& writer) const                    override;
@@ -65,6 +76,9 @@ public:
     auto allocate_vertex_buffer(std::size_t vertex_count, std::size_t vertex_element_size) -> Buffer_range override;
     auto allocate_index_buffer(std::size_t index_count, std::size_t index_element_size) -> Buffer_range override;
 
+    [[nodiscard]] auto get_vertex_data_span(const Buffer_range& range) const -> std::span<std::uint8_t> override;
+    [[nodiscard]] auto get_index_data_span (const Buffer_range& range) const -> std::span<std::uint8_t> override;
+
     void enqueue_index_data (std::size_t offset, std::vector<uint8_t>&& data) const override;
     void enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const override;
     void buffer_ready       (Vertex_buffer_writer& writer) const                    override;
@@ -8,6 +8,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/packing.hpp>
 
+#include <algorithm>
 #include <span>
 
 namespace erhe::primitive {
@@ -265,8 +266,15 @@ Vertex_buffer_writer::Vertex_buffer_writer(Build_context& build_context, Buffer_
 {
     ERHE_VERIFY(build_context.root.buffer_mesh != nullptr);
     const auto& vertex_buffer_range = build_context.root.buffer_mesh->vertex_buffer_range;
-    vertex_data.resize(vertex_buffer_range.count * vertex_buffer_range.element_size);
-    vertex_data_span = vertex_data;
+    vertex_data_span     = buffer_sink.get_vertex_data_span(vertex_buffer_range);
+    vertex_data_reserved = !vertex_data_span.empty();
+    if (!vertex_data_reserved) {
+        vertex_data.resize(vertex_buffer_range.count * vertex_buffer_range.element_size);
+        vertex_data_span = vertex_data;
+    } else {
+        // Attributes not in the format are not written; keep them zero like vertex_data
+        std::fill(vertex_data_span.begin(), vertex_data_span.end(), std::uint8_t{0});
+    }
 }
 
 Vertex_buffer_writer::~Vertex_buffer_writer() noexcept
@@ -276,7 +284,12 @@ Vertex_buffer_writer::~Vertex_buffer_writer() noexcept
 
 auto Vertex_buffer_writer::start_offset() -> std::size_t
 {
-    return build_context.root.buffer_mesh->vertex_buffer_range.byte_offset;
+    return build_context.root.buffer_mesh->vertex_buffer_range.get_byte_offset();
+}
+
+auto Vertex_buffer_writer::get_buffer_range() const -> const Buffer_range&
+{
+    return build_context.root.buffer_mesh->vertex_buffer_range;
 }
 
 Index_buffer_writer::Index_buffer_writer(Build_context& build_context, Buffer_sink& buffer_sink)
@@ -289,8 +302,12 @@ Index_buffer_writer::Index_buffer_writer(Build_context& build_context, Buffer_si
     const auto& buffer_mesh        = *build_context.root.buffer_mesh;
     const auto& index_buffer_range = buffer_mesh.index_buffer_range;
     const auto& mesh_info          = build_context.root.mesh_info;
-    index_data.resize(index_buffer_range.count * index_type_size);
-    index_data_span = index_data;
+    index_data_span     = buffer_sink.get_index_data_span(index_buffer_range);
+    index_data_reserved = !index_data_span.empty();
+    if (!index_data_reserved) {
+        index_data.resize(index_buffer_range.count * index_type_size);
+        index_data_span = index_data;
+    }
 
     const auto& primitive_types = build_context.root.build_info.primitive_types;
 
@@ -327,58 +344,93 @@ Index_buffer_writer::~Index_buffer_writer() noexcept
 
 auto Index_buffer_writer::start_offset() -> std::size_t
 {
-    return build_context.root.buffer_mesh->index_buffer_range.byte_offset;
+    return build_context.root.buffer_mesh->index_buffer_range.get_byte_offset();
+}
+
+auto Index_buffer_writer::get_buffer_range() const -> const Buffer_range&
+{
+    return build_context.root.buffer_mesh->index_buffer_range;
 }
 
 void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::vec2 value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::vec3 value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::vec4 value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const uint32_t value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::uvec2 value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::uvec4 value)
+{
+    write(vertex_write_offset, attribute, value);
+}
+
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec2 value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
 }
 
-void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::vec3 value)
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec3 value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
 }
 
-void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::vec4 value)
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec4 value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
 }
 
-void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const uint32_t value)
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const uint32_t value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
 }
 
-void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::uvec2 value)
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::uvec2 value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
 }
 
-void Vertex_buffer_writer::write(const Vertex_attribute_info& attribute, const glm::uvec4 value)
+void Vertex_buffer_writer::write(const std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::uvec4 value)
 {
     write_low(
-        vertex_data_span.subspan(vertex_write_offset + attribute.offset, attribute.size),
+        vertex_data_span.subspan(vertex_offset + attribute.offset, attribute.size),
         attribute.data_type,
         value
     );
@@ -413,6 +465,19 @@ void Index_buffer_writer::write_edge(const uint32_t v0, const uint32_t v1)
     edge_line_indices_written += 2;
 }
 
+void Index_buffer_writer::write_corner(const std::size_t corner_point_position, const uint32_t v0)
+{
+    write_low(corner_point_index_data_span.subspan(corner_point_position * index_type_size, index_type_size), index_type, v0);
+}
+
+void Index_buffer_writer::write_triangle(const std::size_t triangle_position, const uint32_t v0, const uint32_t v1, const uint32_t v2)
+{
+    const std::size_t first = 3 * triangle_position;
+    write_low(triangle_fill_index_data_span.subspan((first + 0) * index_type_size, index_type_size), index_type, v0);
+    write_low(triangle_fill_index_data_span.subspan((first + 1) * index_type_size, index_type_size), index_type, v1);
+    write_low(triangle_fill_index_data_span.subspan((first + 2) * index_type_size, index_type_size), index_type, v2);
+}
+
 void Index_buffer_writer::write_centroid(const uint32_t v0)
 {
     //log_primitive_builder.trace("centroid {}\n", v0);
@@ -22,7 +22,12 @@ class Buffer_mesh;
 
 /// Writes vertex attribute values to byte buffer/memory.
 ///
-/// Vertex_buffer_writer is target API agnostic.
+/// Vertex_buffer_writer is target API agnostic. If the buffer sink provides
+/// a span for direct writes, values are written there, otherwise to
+/// vertex_data which is handed to the sink in the destructor.
+///
+/// Writes with explicit vertex_offset do not use vertex_write_offset and
+/// can be made concurrently for distinct vertices.
 class Vertex_buffer_writer
 {
 public:
@@ -35,21 +40,31 @@ public:
     void write(const Vertex_attribute_info& attribute, const uint32_t value);
     void write(const Vertex_attribute_info& attribute, const glm::uvec2 value);
     void write(const Vertex_attribute_info& attribute, const glm::uvec4 value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec2 value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec3 value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::vec4 value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const uint32_t value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::uvec2 value);
+    void write(std::size_t vertex_offset, const Vertex_attribute_info& attribute, const glm::uvec4 value);
     void move (const std::size_t relative_offset);
 
     [[nodiscard]] auto start_offset() -> std::size_t;
+    [[nodiscard]] auto get_buffer_range() const -> const Buffer_range&;
 
     Build_context&            build_context;
     Buffer_sink&              buffer_sink;
     Buffer_range              buffer_range;
     std::vector<std::uint8_t> vertex_data;
     std::span<std::uint8_t>   vertex_data_span;
-    std::size_t               vertex_write_offset{0};
+    bool                      vertex_data_reserved{false}; // vertex_data_span is from Buffer_sink, not vertex_data
+    std::size_t               vertex_write_offset {0};
 };
 
 /// Writes 8/16/32 -bit indices to byte buffer/memory
 ///
-/// Index_buffer_writer is target API agnostic.
+/// Index_buffer_writer is target API agnostic. Writes with explicit
+/// position (index of the corner point / triangle) do not update the
+/// written counters and can be made concurrently for distinct positions.
 class Index_buffer_writer
 {
 public:
@@ -61,8 +76,11 @@ public:
     void write_quad    (const uint32_t v0, const uint32_t v1, const uint32_t v2, const uint32_t v3);
     void write_edge    (const uint32_t v0, const uint32_t v1);
     void write_centroid(const uint32_t v0);
+    void write_corner  (std::size_t corner_point_position, const uint32_t v0);
+    void write_triangle(std::size_t triangle_position, const uint32_t v0, const uint32_t v1, const uint32_t v2);
 
     [[nodiscard]] auto start_offset() -> std::size_t;
+    [[nodiscard]] auto get_buffer_range() const -> const Buffer_range&;
 
     Build_context&                 build_context;
     Buffer_sink&                   buffer_sink;
@@ -71,6 +89,7 @@ public:
     const std::size_t              index_type_size{0};
     std::vector<std::uint8_t>      index_data;
     std::span<std::uint8_t>        index_data_span;
+    bool                           index_data_reserved{false}; // index_data_span is from Buffer_sink, not index_data
     std::span<std::uint8_t>        corner_point_index_data_span;
     std::span<std::uint8_t>        triangle_fill_index_data_span;
     std::span<std::uint8_t>        edge_line_index_data_span;
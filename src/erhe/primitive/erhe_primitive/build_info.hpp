@@ -7,6 +7,9 @@
 #include <cstdint>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::graphics {
     class Vertex_attribute_mappings;
 }
@@ -32,6 +35,7 @@ public:
     Normal_style                               normal_style             {Normal_style::corner_normals};
     erhe::graphics::Vertex_attribute_mappings* vertex_attribute_mappings{nullptr};
     bool                                       autocolor                {false};
+    erhe::concurrency::Thread_pool*            thread_pool              {nullptr}; // optional, used to build polygon fill in parallel
 };
 
 class Element_mappings
@@ -0,0 +1,295 @@
+#include "erhe_primitive/morph_targets.hpp"
+#include "erhe_primitive/triangle_soup.hpp"
+#include "erhe_dataformat/dataformat.hpp"
+#include "erhe_graphics/vertex_attribute.hpp"
+#include "erhe_graphics/vertex_format.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace erhe::primitive {
+
+namespace {
+
+constexpr float c_quantize_max = static_cast<float>(std::numeric_limits<int16_t>::max());
+
+// Returns dequantization scale; out_values is left empty if all deltas are zero
+auto quantize(const std::span<const glm::vec3> deltas, std::vector<int16_t>& out_values) -> float
+{
+    out_values.clear();
+    float max_abs = 0.0f;
+    for (const glm::vec3& delta : deltas) {
+        max_abs = std::max(max_abs, std::max(std::abs(delta.x), std::max(std::abs(delta.y), std::abs(delta.z))));
+    }
+    if (max_abs == 0.0f) {
+        return 0.0f;
+    }
+    const float scale     = max_abs / c_quantize_max;
+    const float inv_scale = 1.0f / scale;
+    out_values.resize(deltas.size() * 3);
+    for (std::size_t i = 0, end = deltas.size(); i < end; ++i) {
+        out_values[3 * i + 0] = static_cast<int16_t>(std::lround(deltas[i].x * inv_scale));
+        out_values[3 * i + 1] = static_cast<int16_t>(std::lround(deltas[i].y * inv_scale));
+        out_values[3 * i + 2] = static_cast<int16_t>(std::lround(deltas[i].z * inv_scale));
+    }
+    return scale;
+}
+
+[[nodiscard]] auto is_non_zero(const std::vector<int16_t>& values, const std::size_t vertex_index) -> bool
+{
+    if (values.empty()) {
+        return false;
+    }
+    const int16_t* value = &values[3 * vertex_index];
+    return (value[0] != 0) || (value[1] != 0) || (value[2] != 0);
+}
+
+void compact(std::vector<int16_t>& values, const std::vector<uint32_t>& vertex_indices)
+{
+    if (values.empty()) {
+        return;
+    }
+    for (std::size_t i = 0, end = vertex_indices.size(); i < end; ++i) {
+        const std::size_t src = 3 * static_cast<std::size_t>(vertex_indices[i]);
+        values[3 * i + 0] = values[src + 0];
+        values[3 * i + 1] = values[src + 1];
+        values[3 * i + 2] = values[src + 2];
+    }
+    values.resize(3 * vertex_indices.size());
+    values.shrink_to_fit();
+}
+
+void accumulate_attribute(
+    const Morph_target&         target,
+    const std::vector<int16_t>& values,
+    const float                 scale,
+    const std::span<glm::vec3>  out_deltas
+)
+{
+    if (values.empty() || out_deltas.empty()) {
+        return;
+    }
+    const std::size_t count = target.get_stored_vertex_count();
+    const int16_t*    value = values.data();
+    if (target.is_sparse()) {
+        const uint32_t* vertex_indices = target.vertex_indices.data();
+        for (std::size_t i = 0; i < count; ++i, value += 3) {
+            out_deltas[vertex_indices[i]] += scale * glm::vec3{value[0], value[1], value[2]};
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i, value += 3) {
+            out_deltas[i] += scale * glm::vec3{value[0], value[1], value[2]};
+        }
+    }
+}
+
+void apply_deltas(
+    Triangle_soup&                                     out,
+    const erhe::graphics::Vertex_attribute::Usage_type usage_type,
+    const std::span<const glm::vec3>                   deltas,
+    const bool                                         normalize
+)
+{
+    if (deltas.empty()) {
+        return;
+    }
+    const erhe::graphics::Vertex_attribute* attribute = out.vertex_format.find_attribute_maybe(usage_type);
+    if (attribute == nullptr) {
+        return;
+    }
+    const std::size_t stride = out.vertex_format.stride();
+    uint8_t*          base   = out.vertex_data.data() + attribute->offset;
+    for (std::size_t i = 0, end = deltas.size(); i < end; ++i) {
+        uint8_t* data = base + i * stride;
+        float value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        erhe::dataformat::convert(data, attribute->data_type, &value[0], erhe::dataformat::Format::format_32_vec4_float, 1.0f);
+        glm::vec3 xyz = glm::vec3{value[0], value[1], value[2]} + deltas[i];
+        if (normalize) {
+            const float length = glm::length(xyz);
+            if (length > 0.0f) {
+                xyz /= length;
+            }
+        }
+        value[0] = xyz.x;
+        value[1] = xyz.y;
+        value[2] = xyz.z;
+        erhe::dataformat::convert(&value[0], erhe::dataformat::Format::format_32_vec4_float, data, attribute->data_type, 1.0f);
+    }
+}
+
+}
+
+auto has_active_morph_weights(const std::span<const float> weights) -> bool
+{
+    return std::any_of(weights.begin(), weights.end(), [](const float weight) { return std::abs(weight) > c_morph_weight_epsilon; });
+}
+
+auto Morph_target::is_sparse() const -> bool
+{
+    return !vertex_indices.empty();
+}
+
+auto Morph_target::get_stored_vertex_count() const -> std::size_t
+{
+    if (is_sparse()) {
+        return vertex_indices.size();
+    }
+    const std::size_t value_count = std::max(position_deltas.size(), std::max(normal_deltas.size(), tangent_deltas.size()));
+    return value_count / 3;
+}
+
+auto Morph_target::get_vertex_index(const std::size_t stored_index) const -> uint32_t
+{
+    return is_sparse() ? vertex_indices[stored_index] : static_cast<uint32_t>(stored_index);
+}
+
+Morph_targets::Morph_targets(const std::size_t vertex_count)
+    : m_vertex_count{vertex_count}
+{
+}
+
+void Morph_targets::add_target(
+    const std::string_view           name,
+    const std::span<const glm::vec3> position_deltas,
+    const std::span<const glm::vec3> normal_deltas,
+    const std::span<const glm::vec3> tangent_deltas
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(position_deltas.empty() || (position_deltas.size() == m_vertex_count));
+    ERHE_VERIFY(normal_deltas  .empty() || (normal_deltas  .size() == m_vertex_count));
+    ERHE_VERIFY(tangent_deltas .empty() || (tangent_deltas .size() == m_vertex_count));
+
+    Morph_target& target = m_targets.emplace_back();
+    target.name           = std::string{name};
+    target.position_scale = quantize(position_deltas, target.position_deltas);
+    target.normal_scale   = quantize(normal_deltas,   target.normal_deltas);
+    target.tangent_scale  = quantize(tangent_deltas,  target.tangent_deltas);
+
+    const std::size_t attribute_count =
+        (target.position_deltas.empty() ? 0 : 1) +
+        (target.normal_deltas  .empty() ? 0 : 1) +
+        (target.tangent_deltas .empty() ? 0 : 1);
+    if (attribute_count == 0) {
+        return;
+    }
+
+    std::vector<uint32_t> vertex_indices;
+    for (std::size_t i = 0; i < m_vertex_count; ++i) {
+        if (
+            is_non_zero(target.position_deltas, i) ||
+            is_non_zero(target.normal_deltas,   i) ||
+            is_non_zero(target.tangent_deltas,  i)
+        ) {
+            vertex_indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Use sparse storage only when it is smaller than dense storage
+    const std::size_t vertex_byte_count = attribute_count * 3 * sizeof(int16_t);
+    const std::size_t dense_byte_count  = m_vertex_count * vertex_byte_count;
+    const std::size_t sparse_byte_count = vertex_indices.size() * (vertex_byte_count + sizeof(uint32_t));
+    if (vertex_indices.empty() || (sparse_byte_count >= dense_byte_count)) {
+        return;
+    }
+    compact(target.position_deltas, vertex_indices);
+    compact(target.normal_deltas,   vertex_indices);
+    compact(target.tangent_deltas,  vertex_indices);
+    target.vertex_indices = std::move(vertex_indices);
+}
+
+auto Morph_targets::get_vertex_count() const -> std::size_t
+{
+    return m_vertex_count;
+}
+
+auto Morph_targets::get_target_count() const -> std::size_t
+{
+    return m_targets.size();
+}
+
+auto Morph_targets::get_targets() const -> const std::vector<Morph_target>&
+{
+    return m_targets;
+}
+
+auto Morph_targets::get_byte_count() const -> std::size_t
+{
+    std::size_t byte_count = 0;
+    for (const Morph_target& target : m_targets) {
+        byte_count +=
+            target.vertex_indices .size() * sizeof(uint32_t) +
+            target.position_deltas.size() * sizeof(int16_t) +
+            target.normal_deltas  .size() * sizeof(int16_t) +
+            target.tangent_deltas .size() * sizeof(int16_t);
+    }
+    return byte_count;
+}
+
+auto Morph_targets::has_normal_deltas() const -> bool
+{
+    return std::any_of(m_targets.begin(), m_targets.end(), [](const Morph_target& target) { return !target.normal_deltas.empty(); });
+}
+
+auto Morph_targets::has_tangent_deltas() const -> bool
+{
+    return std::any_of(m_targets.begin(), m_targets.end(), [](const Morph_target& target) { return !target.tangent_deltas.empty(); });
+}
+
+auto Morph_targets::accumulate(
+    const std::span<const float> weights,
+    const std::span<glm::vec3>   out_position_deltas,
+    const std::span<glm::vec3>   out_normal_deltas,
+    const std::span<glm::vec3>   out_tangent_deltas
+) const -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(out_position_deltas.empty() || (out_position_deltas.size() >= m_vertex_count));
+    ERHE_VERIFY(out_normal_deltas  .empty() || (out_normal_deltas  .size() >= m_vertex_count));
+    ERHE_VERIFY(out_tangent_deltas .empty() || (out_tangent_deltas .size() >= m_vertex_count));
+
+    bool any_active = false;
+    for (std::size_t i = 0, end = std::min(weights.size(), m_targets.size()); i < end; ++i) {
+        const float weight = weights[i];
+        if (std::abs(weight) <= c_morph_weight_epsilon) {
+            continue;
+        }
+        const Morph_target& target = m_targets[i];
+        accumulate_attribute(target, target.position_deltas, weight * target.position_scale, out_position_deltas);
+        accumulate_attribute(target, target.normal_deltas,   weight * target.normal_scale,   out_normal_deltas);
+        accumulate_attribute(target, target.tangent_deltas,  weight * target.tangent_scale,  out_tangent_deltas);
+        any_active = true;
+    }
+    return any_active;
+}
+
+void Morph_targets::apply(const std::span<const float> weights, const Triangle_soup& base, Triangle_soup& out) const
+{
+    ERHE_PROFILE_FUNCTION();
+
+    out.vertex_format = base.vertex_format;
+    out.type          = base.type;
+    out.vertex_data   = base.vertex_data;
+    out.index_data    = base.index_data;
+
+    if ((base.get_vertex_count() != m_vertex_count) || !has_active_morph_weights(weights)) {
+        return;
+    }
+
+    std::vector<glm::vec3> position_deltas(m_vertex_count, glm::vec3{0.0f});
+    std::vector<glm::vec3> normal_deltas  (has_normal_deltas () ? m_vertex_count : 0, glm::vec3{0.0f});
+    std::vector<glm::vec3> tangent_deltas (has_tangent_deltas() ? m_vertex_count : 0, glm::vec3{0.0f});
+    accumulate(weights, position_deltas, normal_deltas, tangent_deltas);
+
+    using Usage_type = erhe::graphics::Vertex_attribute::Usage_type;
+    apply_deltas(out, Usage_type::position, position_deltas, false);
+    apply_deltas(out, Usage_type::normal,   normal_deltas,   true);
+    apply_deltas(out, Usage_type::tangent,  tangent_deltas,  true);
+}
+
+} // namespace erhe::primitive
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace erhe::primitive {
+
+class Triangle_soup;
+
+// Weights with smaller magnitude are treated as zero, and their targets are
+// not processed.
+static constexpr float c_morph_weight_epsilon{1.0e-5f};
+
+[[nodiscard]] auto has_active_morph_weights(std::span<const float> weights) -> bool;
+
+// Position, normal and tangent deltas of one morph target. Deltas are
+// quantized to 16-bit signed integers with one scale per attribute. Only
+// vertices with a non-zero delta are stored when that is smaller than
+// storing all vertices; vertex_indices is empty for dense targets.
+class Morph_target
+{
+public:
+    [[nodiscard]] auto is_sparse               () const -> bool;
+    [[nodiscard]] auto get_stored_vertex_count () const -> std::size_t;
+    [[nodiscard]] auto get_vertex_index        (std::size_t stored_index) const -> uint32_t;
+
+    std::string           name;
+    std::vector<uint32_t> vertex_indices;  // sparse targets only
+    std::vector<int16_t>  position_deltas; // 3 per stored vertex, empty if target has no position deltas
+    std::vector<int16_t>  normal_deltas;   // 3 per stored vertex, empty if target has no normal deltas
+    std::vector<int16_t>  tangent_deltas;  // 3 per stored vertex, empty if target has no tangent deltas
+    float                 position_scale{0.0f};
+    float                 normal_scale  {0.0f};
+    float                 tangent_scale {0.0f};
+};
+
+class Morph_targets
+{
+public:
+    explicit Morph_targets(std::size_t vertex_count);
+
+    // Any of the delta spans may be empty; non-empty spans must have
+    // vertex_count entries.
+    void add_target(
+        std::string_view           name,
+        std::span<const glm::vec3> position_deltas,
+        std::span<const glm::vec3> normal_deltas,
+        std::span<const glm::vec3> tangent_deltas
+    );
+
+    [[nodiscard]] auto get_vertex_count  () const -> std::size_t;
+    [[nodiscard]] auto get_target_count  () const -> std::size_t;
+    [[nodiscard]] auto get_targets       () const -> const std::vector<Morph_target>&;
+    [[nodiscard]] auto get_byte_count    () const -> std::size_t;
+    [[nodiscard]] auto has_normal_deltas () const -> bool;
+    [[nodiscard]] auto has_tangent_deltas() const -> bool;
+
+    // Adds weighted deltas of targets with non-zero weight to outputs.
+    // Outputs are indexed by vertex; output spans may be empty to skip an
+    // attribute. Returns false if no target has non-zero weight, in which
+    // case outputs are not modified.
+    auto accumulate(
+        std::span<const float> weights,
+        std::span<glm::vec3>   out_position_deltas,
+        std::span<glm::vec3>   out_normal_deltas,
+        std::span<glm::vec3>   out_tangent_deltas
+    ) const -> bool;
+
+    // CPU morph path, for consumers such as raytrace and physics which
+    // build from triangle soups. Writes base vertex data with morph
+    // applied to position, normal and tangent attributes to out. Index
+    // data and vertex format are copied from base.
+    void apply(std::span<const float> weights, const Triangle_soup& base, Triangle_soup& out) const;
+
+private:
+    std::size_t               m_vertex_count{0};
+    std::vector<Morph_target> m_targets;
+};
+
+} // namespace erhe::primitive
@@ -379,6 +379,7 @@ auto Primitive_render_shape::make_buffer_mesh(const Build_info& build_info, Norm
         ERHE_VERIFY(m_element_mappings.primitive_id_to_polygon_id.empty());
         ERHE_VERIFY(m_element_mappings.corner_to_vertex_id.empty());
         m_renderable_mesh = erhe::primitive::make_buffer_mesh(*m_geometry.get(), build_info, m_element_mappings, normal_style);
+        m_buffer_mesh_from_triangle_soup = false;
         return true;
     } else {
         return make_buffer_mesh(build_info.buffer_info);
@@ -391,6 +392,7 @@ auto Primitive_render_shape::make_buffer_mesh(const Buffer_info& buffer_info) ->
         return false;
     }
     m_renderable_mesh = build_buffer_mesh_from_triangle_soup(*m_triangle_soup.get(), buffer_info);
+    m_buffer_mesh_from_triangle_soup = true;
     return true;
 }
 #pragma endregion Primitive_render_shape
@@ -417,7 +419,7 @@ Buffer_mesh build_buffer_mesh_from_triangle_soup(const Triangle_soup& triangle_s
     // Copy indices to buffer
     std::vector<uint8_t> sink_index_data(index_count * index_range.element_size);
     memcpy(sink_index_data.data(), triangle_soup.index_data.data(), index_count * index_range.element_size);
-    buffer_info.buffer_sink.enqueue_index_data(index_range.byte_offset, std::move(sink_index_data));
+    buffer_info.buffer_sink.enqueue_index_data(index_range.get_byte_offset(), std::move(sink_index_data));
 
     // Copy and convert vertices to buffer
     std::vector<uint8_t> sink_vertex_data(vertex_count * vertex_range.element_size);
@@ -447,7 +449,7 @@ Buffer_mesh build_buffer_mesh_from_triangle_soup(const Triangle_soup& triangle_s
         }
     }
 
-    buffer_info.buffer_sink.enqueue_vertex_data(vertex_range.byte_offset, std::move(sink_vertex_data));
+    buffer_info.buffer_sink.enqueue_vertex_data(vertex_range.get_byte_offset(), std::move(sink_vertex_data));
 
     const erhe::graphics::Vertex_attribute* position_attribute = buffer_info.vertex_format.find_attribute_maybe(erhe::graphics::Vertex_attribute::Usage_type::position);
     erhe::math::Point_vector_bounding_volume_source positions{vertex_count};
@@ -650,4 +652,15 @@ auto Primitive::get_shape_for_raytrace() const -> std::shared_ptr<Primitive_shap
     // }
 }
 
+auto Primitive::get_morph_targets() const -> const Morph_targets*
+{
+    // Morph target deltas are indexed by triangle soup vertex, which
+    // matches renderable mesh vertices only when it was built from the soup
+    if (!render_shape || !render_shape->is_buffer_mesh_from_triangle_soup()) {
+        return nullptr;
+    }
+    const std::shared_ptr<Triangle_soup>& triangle_soup = render_shape->get_triangle_soup();
+    return triangle_soup ? triangle_soup->morph_targets.get() : nullptr;
+}
+
 } // namespace erhe::primitive
@@ -21,6 +21,7 @@ namespace erhe::primitive {
 class Build_info;
 class Buffer_info;
 class Material;
+class Morph_targets;
 class Triangle_soup;
 
 class Primitive_raytrace
@@ -97,10 +98,12 @@ public:
     [[nodiscard]] auto get_mutable_renderable_mesh() -> Buffer_mesh& { return m_renderable_mesh; }
     [[nodiscard]] auto get_renderable_mesh        () const -> const Buffer_mesh& { return m_renderable_mesh; }
     [[nodiscard]] auto get_normal_style           () const -> Normal_style { return m_normal_style; }
+    [[nodiscard]] auto is_buffer_mesh_from_triangle_soup() const -> bool { return m_buffer_mesh_from_triangle_soup; }
 
 private:
     Normal_style m_normal_style   {Normal_style::none};
     Buffer_mesh  m_renderable_mesh{};
+    bool         m_buffer_mesh_from_triangle_soup{false};
 };
 
 /////////////////////////
@@ -140,6 +143,7 @@ public:
     [[nodiscard]] auto get_bounding_box        () const -> erhe::math::Bounding_box;
     [[nodiscard]] auto get_shape_for_raytrace  () const -> std::shared_ptr<Primitive_shape>;
     [[nodiscard]] auto separate_collision_data () const -> bool;
+    [[nodiscard]] auto get_morph_targets       () const -> const Morph_targets*;
     
     std::shared_ptr<Primitive_render_shape> render_shape;
     std::shared_ptr<Primitive_shape>        collision_shape;
@@ -7,6 +7,7 @@
 #include "erhe_primitive/index_range.hpp"
 #include "erhe_primitive/primitive_log.hpp"
 #include "erhe_primitive/buffer_mesh.hpp"
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/property_map.hpp"
 #include "erhe_gl/enum_string_functions.hpp"
@@ -18,6 +19,8 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+
 namespace erhe::primitive {
 
 using Corner_id         = erhe::geometry::Corner_id;
@@ -295,7 +298,7 @@ Build_context::~Build_context() noexcept
     ERHE_VERIFY(vertex_index == root.total_vertex_count);
 }
 
-void Build_context::build_polygon_id()
+void Build_context::build_polygon_id(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -308,22 +311,22 @@ void Build_context::build_polygon_id()
     //// }
 
     if (root.attributes.id_vec3.is_valid()) {
-        const vec3 v = erhe::math::vec3_from_uint(polygon_index);
-        vertex_writer.write(root.attributes.id_vec3, v);
+        const vec3 v = erhe::math::vec3_from_uint(cursor.polygon_index);
+        vertex_writer.write(cursor.vertex_offset, root.attributes.id_vec3, v);
     }
 }
 
-auto Build_context::get_polygon_normal() -> vec3
+auto Build_context::get_polygon_normal(const Build_cursor& cursor) -> vec3
 {
     vec3 polygon_normal{0.0f, 1.0f, 0.0f};
     if (property_maps.polygon_normals != nullptr) {
-        property_maps.polygon_normals->maybe_get(polygon_id, polygon_normal);
+        property_maps.polygon_normals->maybe_get(cursor.polygon_id, polygon_normal);
     }
 
     return polygon_normal;
 }
 
-void Build_context::build_vertex_position()
+void Build_context::build_vertex_position(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -332,17 +335,17 @@ void Build_context::build_vertex_position()
     }
 
     ERHE_VERIFY(property_maps.point_locations != nullptr);
-    const vec3 position = property_maps.point_locations->get(point_id);
-    vertex_writer.write(root.attributes.position, position);
+    const vec3 position = property_maps.point_locations->get(cursor.point_id);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.position, position);
 
     SPDLOG_LOGGER_TRACE(
         log_primitive_builder,
         "polygon {} corner {} point {} vertex {} location {}",
-        polygon_index, corner_id, point_id, vertex_index, position
+        cursor.polygon_index, cursor.corner_id, cursor.point_id, cursor.vertex_index, position
     );
 }
 
-void Build_context::build_vertex_normal()
+void Build_context::build_vertex_normal(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -350,21 +353,21 @@ void Build_context::build_vertex_normal()
         return;
     }
 
-    const vec3 polygon_normal = get_polygon_normal();
+    const vec3 polygon_normal = get_polygon_normal(cursor);
     vec3 normal{0.0f, 1.0f, 0.0f};
 
     vec3 point_normal{0.0f, 1.0f, 0.0f};
     bool found_point_normal{false};
     if (property_maps.point_normals != nullptr) {
-        found_point_normal = property_maps.point_normals->maybe_get(point_id, point_normal) && (glm::length(point_normal) > 0.9f);
+        found_point_normal = property_maps.point_normals->maybe_get(cursor.point_id, point_normal) && (glm::length(point_normal) > 0.9f);
     }
     if (!found_point_normal && (property_maps.point_normals_smooth != nullptr)) {
-        found_point_normal = property_maps.point_normals_smooth->maybe_get(point_id, point_normal) && (glm::length(point_normal) > 0.9f);
+        found_point_normal = property_maps.point_normals_smooth->maybe_get(cursor.point_id, point_normal) && (glm::length(point_normal) > 0.9f);
     }
 
     bool found_normal{false};
     if (property_maps.corner_normals != nullptr) {
-        found_normal = property_maps.corner_normals->maybe_get(corner_id, normal) && (glm::length(normal) > 0.9f);
+        found_normal = property_maps.corner_normals->maybe_get(cursor.corner_id, normal) && (glm::length(normal) > 0.9f);
     }
     if (!found_normal) {
         normal = point_normal;
@@ -380,22 +383,22 @@ void Build_context::build_vertex_normal()
 
             case Normal_style::corner_normals: {
                 ERHE_VERIFY(glm::length(normal) > 0.9f);
-                vertex_writer.write(root.attributes.normal, normal);
-                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} normal {}", point_id, corner_id, normal);
+                vertex_writer.write(cursor.vertex_offset, root.attributes.normal, normal);
+                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} normal {}", cursor.point_id, cursor.corner_id, normal);
                 break;
             }
 
             case Normal_style::point_normals: {
                 ERHE_VERIFY(glm::length(point_normal) > 0.9f);
-                vertex_writer.write(root.attributes.normal, point_normal);
-                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point normal {}", point_id, corner_id, point_normal);
+                vertex_writer.write(cursor.vertex_offset, root.attributes.normal, point_normal);
+                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point normal {}", cursor.point_id, cursor.corner_id, point_normal);
                 break;
             }
 
             case Normal_style::polygon_normals: {
                 ERHE_VERIFY(glm::length(polygon_normal) > 0.9f);
-                vertex_writer.write(root.attributes.normal, polygon_normal);
-                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon normal {}", point_id, corner_id, polygon_normal);
+                vertex_writer.write(cursor.vertex_offset, root.attributes.normal, polygon_normal);
+                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon normal {}", cursor.point_id, cursor.corner_id, polygon_normal);
                 break;
             }
 
@@ -413,23 +416,23 @@ void Build_context::build_vertex_normal()
     if (root.attributes.normal_smooth.is_valid()) {
         vec3 smooth_point_normal{0.0f, 1.0f, 0.0f};
     
-        if ((property_maps.point_normals_smooth != nullptr) && property_maps.point_normals_smooth->has(point_id)) {
-            smooth_point_normal = property_maps.point_normals_smooth->get(point_id);
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} smooth point normal {}", point_id, corner_id, smooth_point_normal);
+        if ((property_maps.point_normals_smooth != nullptr) && property_maps.point_normals_smooth->has(cursor.point_id)) {
+            smooth_point_normal = property_maps.point_normals_smooth->get(cursor.point_id);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} smooth point normal {}", cursor.point_id, cursor.corner_id, smooth_point_normal);
         } else {
             // Smooth normals are currently used only for wide line depth bias.
             // If edge lines are not used, do not generate warning about missing smooth normals.
             if (root.build_info.primitive_types.edge_lines) {
-                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} smooth unit y normal", point_id, corner_id);
-                used_fallback_smooth_normal = true;
+                SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} smooth unit y normal", cursor.point_id, cursor.corner_id);
+                cursor.used_fallback_smooth_normal = true;
             }
         }
     
-        vertex_writer.write(root.attributes.normal_smooth, smooth_point_normal);
+        vertex_writer.write(cursor.vertex_offset, root.attributes.normal_smooth, smooth_point_normal);
     }
 }
 
-void Build_context::build_vertex_tangent()
+void Build_context::build_vertex_tangent(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -440,31 +443,31 @@ void Build_context::build_vertex_tangent()
     vec4 tangent{1.0f, 0.0f, 0.0, 1.0f};
     bool found{false};
     if (property_maps.corner_tangents != nullptr) {
-        found = property_maps.corner_tangents->maybe_get(corner_id, tangent) && (glm::length(tangent) > 0.9f);
+        found = property_maps.corner_tangents->maybe_get(cursor.corner_id, tangent) && (glm::length(tangent) > 0.9f);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found)
         {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} tangent {}", point_id, corner_id, tangent);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} tangent {}", cursor.point_id, cursor.corner_id, tangent);
         }
 #endif
     }
     if (!found && (property_maps.point_tangents != nullptr)) {
-        found = property_maps.point_tangents->maybe_get(point_id, tangent) && (glm::length(tangent) > 0.9f);
+        found = property_maps.point_tangents->maybe_get(cursor.point_id, tangent) && (glm::length(tangent) > 0.9f);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point tangent {}", point_id, corner_id, tangent);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point tangent {}", cursor.point_id, cursor.corner_id, tangent);
         }
 #endif
     }
     if (!found) {
-        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point_id {} corner {} unit x tangent", point_id, corner_id);
-        used_fallback_tangent = true;
+        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point_id {} corner {} unit x tangent", cursor.point_id, cursor.corner_id);
+        cursor.used_fallback_tangent = true;
     }
 
-    vertex_writer.write(root.attributes.tangent, tangent);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.tangent, tangent);
 }
 
-void Build_context::build_vertex_bitangent()
+void Build_context::build_vertex_bitangent(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -475,30 +478,30 @@ void Build_context::build_vertex_bitangent()
     vec4 bitangent{0.0f, 0.0f, 1.0, 1.0f};
     bool found{false};
     if (property_maps.corner_bitangents != nullptr) {
-        found = property_maps.corner_bitangents->maybe_get(corner_id, bitangent) && (glm::length(bitangent) > 0.9f);
+        found = property_maps.corner_bitangents->maybe_get(cursor.corner_id, bitangent) && (glm::length(bitangent) > 0.9f);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} bitangent {}", point_id, corner_id, bitangent);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} bitangent {}", cursor.point_id, cursor.corner_id, bitangent);
         }
 #endif
     }
     if (!found && (property_maps.point_bitangents != nullptr)) {
-        found = property_maps.point_bitangents->maybe_get(point_id, bitangent) && (glm::length(bitangent) > 0.9f);
+        found = property_maps.point_bitangents->maybe_get(cursor.point_id, bitangent) && (glm::length(bitangent) > 0.9f);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point bitangent {}", point_id, corner_id, bitangent);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point bitangent {}", cursor.point_id, cursor.corner_id, bitangent);
         }
 #endif
     }
     if (!found) {
-        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} unit z bitangent", point_id, corner_id);
-        used_fallback_bitangent = true;
+        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} unit z bitangent", cursor.point_id, cursor.corner_id);
+        cursor.used_fallback_bitangent = true;
     }
 
-    vertex_writer.write(root.attributes.bitangent, bitangent);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.bitangent, bitangent);
 }
 
-void Build_context::build_vertex_texcoord()
+void Build_context::build_vertex_texcoord(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -509,30 +512,30 @@ void Build_context::build_vertex_texcoord()
     vec2 texcoord{0.0f, 0.0f};
     bool found{false};
     if (property_maps.corner_texcoords != nullptr) {
-        found = property_maps.corner_texcoords->maybe_get(corner_id, texcoord);
+        found = property_maps.corner_texcoords->maybe_get(cursor.corner_id, texcoord);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} texcoord {}", point_id, corner_id, texcoord);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} texcoord {}", cursor.point_id, cursor.corner_id, texcoord);
         }
 #endif
     }
     if (!found && (property_maps.point_texcoords != nullptr)) {
-        found = property_maps.point_texcoords->maybe_get(point_id, texcoord);
+        found = property_maps.point_texcoords->maybe_get(cursor.point_id, texcoord);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point texcoord {}", point_id, corner_id, texcoord);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point texcoord {}", cursor.point_id, cursor.corner_id, texcoord);
         }
 #endif
     }
     if (!found) {
-        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} default texcoord", point_id, corner_id);
-        used_fallback_texcoord = true;
+        SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} default texcoord", cursor.point_id, cursor.corner_id);
+        cursor.used_fallback_texcoord = true;
     }
 
-    vertex_writer.write(root.attributes.texcoord, texcoord);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.texcoord, texcoord);
 }
 
-void Build_context::build_vertex_joint_indices()
+void Build_context::build_vertex_joint_indices(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -541,18 +544,18 @@ void Build_context::build_vertex_joint_indices()
     }
 
     const uvec4 joint_indices = (property_maps.point_joint_indices != nullptr)
-        ? property_maps.point_joint_indices->get(point_id)
+        ? property_maps.point_joint_indices->get(cursor.point_id)
         : uvec4{0u, 0u, 0u, 0u};
-    vertex_writer.write(root.attributes.joint_indices, joint_indices);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.joint_indices, joint_indices);
 
     SPDLOG_LOGGER_TRACE(
         log_primitive_builder,
         "polygon {} corner {} point {} vertex {} joint_indices {}",
-        polygon_index, corner_id, point_id, vertex_index, joint_indices
+        cursor.polygon_index, cursor.corner_id, cursor.point_id, cursor.vertex_index, joint_indices
     );
 }
 
-void Build_context::build_vertex_joint_weights()
+void Build_context::build_vertex_joint_weights(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -561,14 +564,14 @@ void Build_context::build_vertex_joint_weights()
     }
 
     const vec4 joint_weights = (property_maps.point_joint_weights != nullptr)
-        ? property_maps.point_joint_weights->get(point_id)
+        ? property_maps.point_joint_weights->get(cursor.point_id)
         : vec4{1.0f, 0.0f, 0.0f, 0.0f};
-    vertex_writer.write(root.attributes.joint_weights, joint_weights);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.joint_weights, joint_weights);
 
     SPDLOG_LOGGER_TRACE(
         log_primitive_builder,
         "polygon {} corner {} point {} vertex {} joint_weights {}",
-        polygon_index, corner_id, point_id, vertex_index, joint_weights
+        cursor.polygon_index, cursor.corner_id, cursor.point_id, cursor.vertex_index, joint_weights
     );
 }
 
@@ -592,7 +595,7 @@ void Build_context::build_vertex_joint_weights()
 //
 // }
 
-void Build_context::build_vertex_color(const uint32_t /*polygon_corner_count*/)
+void Build_context::build_vertex_color(Build_cursor& cursor, const uint32_t /*polygon_corner_count*/)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -603,26 +606,26 @@ void Build_context::build_vertex_color(const uint32_t /*polygon_corner_count*/)
     vec4 color{root.build_info.constant_color};
     bool found{false};
     if (property_maps.corner_colors != nullptr) {
-        found = property_maps.corner_colors->maybe_get(corner_id, color);
+        found = property_maps.corner_colors->maybe_get(cursor.corner_id, color);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} corner color {}", point_id, corner_id, color);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} corner color {}", cursor.point_id, cursor.corner_id, color);
         }
 #endif
     }
     if (!found && (property_maps.point_colors != nullptr)) {
-        found = property_maps.point_colors->maybe_get(point_id, color);
+        found = property_maps.point_colors->maybe_get(cursor.point_id, color);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point color {}", point_id, corner_id, color);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point color {}", cursor.point_id, cursor.corner_id, color);
         }
 #endif
     }
     if (!found && (property_maps.polygon_colors != nullptr)) {
-        found = property_maps.polygon_colors->maybe_get(polygon_id, color);
+        found = property_maps.polygon_colors->maybe_get(cursor.polygon_id, color);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon {} polygon color {}", point_id, corner_id, polygon_id, color);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon {} polygon color {}", cursor.point_id, cursor.corner_id, cursor.polygon_id, color);
         }
 #else
         static_cast<void>(found);
@@ -637,10 +640,10 @@ void Build_context::build_vertex_color(const uint32_t /*polygon_corner_count*/)
     //    //}
     //}
 
-    vertex_writer.write(root.attributes.color, color);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.color, color);
 }
 
-void Build_context::build_vertex_aniso_control()
+void Build_context::build_vertex_aniso_control(Build_cursor& cursor)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -657,50 +660,50 @@ void Build_context::build_vertex_aniso_control()
     vec2 value{1.0f, 1.0f};
     bool found{false};
     if (property_maps.corner_aniso_control != nullptr) {
-        found = property_maps.corner_aniso_control->maybe_get(corner_id, value);
+        found = property_maps.corner_aniso_control->maybe_get(cursor.corner_id, value);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} corner aniso control {}", point_id, corner_id, value);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} corner aniso control {}", cursor.point_id, cursor.corner_id, value);
         }
 #endif
     }
     if (!found && (property_maps.point_aniso_control != nullptr)) {
-        found = property_maps.point_aniso_control->maybe_get(point_id, value);
+        found = property_maps.point_aniso_control->maybe_get(cursor.point_id, value);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point aniso control {}", point_id, corner_id, value);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} point aniso control {}", cursor.point_id, cursor.corner_id, value);
         }
 #endif
     }
     if (!found && (property_maps.polygon_aniso_control != nullptr)) {
-        found = property_maps.polygon_aniso_control->maybe_get(polygon_id, value);
+        found = property_maps.polygon_aniso_control->maybe_get(cursor.polygon_id, value);
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
         if (found) {
-            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon {} polygon aniso control {}", point_id, corner_id, polygon_id, value);
+            SPDLOG_LOGGER_TRACE(log_primitive_builder, "point {} corner {} polygon {} polygon aniso control {}", cursor.point_id, cursor.corner_id, cursor.polygon_id, value);
         }
 #else
         static_cast<void>(found);
 #endif
     }
 
-    vertex_writer.write(root.attributes.aniso_control, value);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.aniso_control, value);
 }
 
-void Build_context::build_centroid_position()
+void Build_context::build_centroid_position(Build_cursor& cursor)
 {
     if (!root.build_info.primitive_types.centroid_points || !root.attributes.position.is_valid()) {
         return;
     }
 
     vec3 position{0.0f, 0.0f, 0.0f};
-    if ((property_maps.polygon_centroids != nullptr) && property_maps.polygon_centroids->has(polygon_id)) {
-        position = property_maps.polygon_centroids->get(polygon_id);
+    if ((property_maps.polygon_centroids != nullptr) && property_maps.polygon_centroids->has(cursor.polygon_id)) {
+        position = property_maps.polygon_centroids->get(cursor.polygon_id);
     }
 
-    vertex_writer.write(root.attributes.position, position);
+    vertex_writer.write(cursor.vertex_offset, root.attributes.position, position);
 }
 
-void Build_context::build_centroid_normal()
+void Build_context::build_centroid_normal(Build_cursor& cursor)
 {
     //const auto& features = root.build_info.format.features;
 
@@ -710,11 +713,11 @@ void Build_context::build_centroid_normal()
 
     vec3 normal{0.0f, 1.0f, 0.0f};
     if (property_maps.polygon_normals != nullptr) {
-        property_maps.polygon_normals->maybe_get(polygon_id, normal);
+        property_maps.polygon_normals->maybe_get(cursor.polygon_id, normal);
     }
 
     if (root.attributes.normal.is_valid()) {
-        vertex_writer.write(root.attributes.normal, normal);
+        vertex_writer.write(cursor.vertex_offset, root.attributes.normal, normal);
     }
 
     // if (root.attributes.normal_flat.is_valid()) {
@@ -722,34 +725,86 @@ void Build_context::build_centroid_normal()
     // }
 }
 
-void Build_context::build_valency_edge_count()
+void Build_context::build_valency_edge_count(Build_cursor& cursor)
 {
     if (root.attributes.normal.is_valid()) {
-        const unsigned int vertex_valency      = static_cast<unsigned int>(root.geometry.points.at(point_id).corner_count);
-        const unsigned int polygone_edge_count = static_cast<unsigned int>(root.geometry.polygons.at(polygon_id).corner_count);
+        const unsigned int vertex_valency      = static_cast<unsigned int>(root.geometry.points.at(cursor.point_id).corner_count);
+        const unsigned int polygone_edge_count = static_cast<unsigned int>(root.geometry.polygons.at(cursor.polygon_id).corner_count);
         const glm::uvec2 valency_edge_count{vertex_valency, polygone_edge_count};
-        vertex_writer.write(root.attributes.valency_edge_count, valency_edge_count);
+        vertex_writer.write(cursor.vertex_offset, root.attributes.valency_edge_count, valency_edge_count);
     }
 }
 
-void Build_context::build_corner_point_index()
+void Build_context::build_corner_point_index(Build_cursor& cursor)
 {
     if (root.build_info.primitive_types.corner_points) {
-        index_writer.write_corner(vertex_index);
+        index_writer.write_corner(cursor.vertex_index, cursor.vertex_index);
     }
 }
 
-void Build_context::build_triangle_fill_index()
+void Build_context::build_triangle_fill_index(Build_cursor& cursor)
 {
     if (root.build_info.primitive_types.fill_triangles) {
-        if (previous_index != first_index) {
-            index_writer.write_triangle(first_index, previous_index, vertex_index);
-            root.element_mappings.primitive_id_to_polygon_id[primitive_index] = polygon_id;
-            ++primitive_index;
+        if (cursor.previous_index != cursor.first_index) {
+            index_writer.write_triangle(cursor.primitive_index, cursor.first_index, cursor.previous_index, cursor.vertex_index);
+            root.element_mappings.primitive_id_to_polygon_id[cursor.primitive_index] = cursor.polygon_id;
+            ++cursor.primitive_index;
         }
     }
 
-    previous_index = vertex_index;
+    cursor.previous_index = cursor.vertex_index;
+}
+
+void Build_context::build_polygon_fill_range(
+    const Polygon_id polygon_id_begin,
+    const Polygon_id polygon_id_end,
+    Build_cursor&    cursor
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    for (cursor.polygon_id = polygon_id_begin; cursor.polygon_id < polygon_id_end; ++cursor.polygon_id) {
+        const Polygon& polygon = root.geometry.polygons[cursor.polygon_id];
+        cursor.polygon_index   = cursor.polygon_id;
+        cursor.first_index     = cursor.vertex_index;
+        cursor.previous_index  = cursor.first_index;
+
+        if (property_maps.polygon_ids_uint32 != nullptr) {
+            property_maps.polygon_ids_uint32->put(cursor.polygon_id, cursor.polygon_index);
+        }
+
+        if (property_maps.polygon_ids_vector3 != nullptr) {
+            property_maps.polygon_ids_vector3->put(cursor.polygon_id, erhe::math::vec3_from_uint(cursor.polygon_index));
+        }
+
+        const Polygon_corner_id polyon_corner_id_end = polygon.first_polygon_corner_id + polygon.corner_count;
+        for (Polygon_corner_id polygon_corner_id = polygon.first_polygon_corner_id; polygon_corner_id < polyon_corner_id_end; ++polygon_corner_id) {
+            cursor.corner_id     = root.geometry.polygon_corners[polygon_corner_id];
+            const Corner& corner = root.geometry.corners[cursor.corner_id];
+            cursor.point_id      = corner.point_id;
+
+            root.element_mappings.corner_to_vertex_id[cursor.corner_id] = cursor.vertex_index;
+
+            build_polygon_id          (cursor);
+            build_vertex_position     (cursor);
+            build_vertex_normal       (cursor);
+            build_vertex_tangent      (cursor);
+            build_vertex_bitangent    (cursor);
+            build_vertex_texcoord     (cursor);
+            build_vertex_color        (cursor, polygon.corner_count);
+            build_vertex_aniso_control(cursor);
+            build_vertex_joint_indices(cursor);
+            build_vertex_joint_weights(cursor);
+            build_valency_edge_count  (cursor);
+
+            // Indices
+            build_corner_point_index (cursor);
+            build_triangle_fill_index(cursor);
+
+            cursor.vertex_offset += root.vertex_stride;
+            ++cursor.vertex_index;
+        }
+    }
 }
 
 void Build_context::build_polygon_fill()
@@ -761,9 +816,6 @@ void Build_context::build_polygon_fill()
 
     property_maps.corner_indices->clear();
 
-    vertex_index  = 0;
-    polygon_index = 0;
-
     //const bool any_normal_feature = root.build_info.format.features.normal =
     //    root.build_info.format.features.normal      ||
     //    root.build_info.format.features.normal_flat ||
@@ -771,52 +823,87 @@ void Build_context::build_polygon_fill()
 
     const Polygon_id polygon_id_end = root.geometry.get_polygon_count();
     root.element_mappings.corner_to_vertex_id.resize(root.geometry.get_corner_count());
-    for (polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
-        const Polygon& polygon = root.geometry.polygons[polygon_id];
-        first_index    = vertex_index;
-        previous_index = first_index;
 
-        if (property_maps.polygon_ids_uint32 != nullptr) {
-            property_maps.polygon_ids_uint32->put(polygon_id, polygon_index);
+    // Prefix sums over polygon corner counts give first vertex and first
+    // triangle for each polygon, so that polygons can be built in any order.
+    std::vector<uint32_t> polygon_first_vertex  (static_cast<std::size_t>(polygon_id_end) + 1);
+    std::vector<uint32_t> polygon_first_triangle(static_cast<std::size_t>(polygon_id_end) + 1);
+    {
+        ERHE_PROFILE_SCOPE("prefix sum");
+
+        uint32_t vertex_count   = 0;
+        uint32_t triangle_count = 0;
+        for (Polygon_id polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
+            const uint32_t corner_count = root.geometry.polygons[polygon_id].corner_count;
+            polygon_first_vertex  [polygon_id] = vertex_count;
+            polygon_first_triangle[polygon_id] = triangle_count;
+            vertex_count   += corner_count;
+            triangle_count += (corner_count >= 3) ? (corner_count - 2) : 0;
         }
-
-        if (property_maps.polygon_ids_vector3 != nullptr) {
-            property_maps.polygon_ids_vector3->put(polygon_id, erhe::math::vec3_from_uint(polygon_index));
+        polygon_first_vertex  [polygon_id_end] = vertex_count;
+        polygon_first_triangle[polygon_id_end] = triangle_count;
+    }
+
+    // Size polygon id maps up front; chunks start at multiples of 64
+    // polygons, so they never share presence bitset words.
+    if (property_maps.polygon_ids_uint32 != nullptr) {
+        property_maps.polygon_ids_uint32->trim(polygon_id_end);
+    }
+    if (property_maps.polygon_ids_vector3 != nullptr) {
+        property_maps.polygon_ids_vector3->trim(polygon_id_end);
+    }
+
+    const std::size_t chunk_count = (static_cast<std::size_t>(polygon_id_end) + s_polygon_fill_grain - 1) / s_polygon_fill_grain;
+    std::vector<Build_cursor> chunk_cursors(chunk_count);
+    const auto build_chunks = [&](const std::size_t first_chunk, const std::size_t last_chunk) {
+        for (std::size_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+            const Polygon_id polygon_id_begin = static_cast<Polygon_id>(chunk * s_polygon_fill_grain);
+            const Polygon_id chunk_end        = std::min(static_cast<Polygon_id>(polygon_id_begin + s_polygon_fill_grain), polygon_id_end);
+            Build_cursor& cursor   = chunk_cursors[chunk];
+            cursor.vertex_index    = polygon_first_vertex  [polygon_id_begin];
+            cursor.primitive_index = polygon_first_triangle[polygon_id_begin];
+            cursor.vertex_offset   = static_cast<std::size_t>(cursor.vertex_index) * root.vertex_stride;
+            build_polygon_fill_range(polygon_id_begin, chunk_end, cursor);
         }
+    };
 
-        const Polygon_corner_id polyon_corner_id_end = polygon.first_polygon_corner_id + polygon.corner_count;
-        for (polygon_corner_id = polygon.first_polygon_corner_id; polygon_corner_id < polyon_corner_id_end; ++polygon_corner_id) {
-            corner_id            = root.geometry.polygon_corners[polygon_corner_id];
-            const Corner& corner = root.geometry.corners[corner_id];
-            point_id             = corner.point_id;
-
-            root.element_mappings.corner_to_vertex_id[corner_id] = vertex_index;
-
-            build_polygon_id          ();
-            build_vertex_position     ();
-            build_vertex_normal       ();
-            build_vertex_tangent      ();
-            build_vertex_bitangent    ();
-            build_vertex_texcoord     ();
-            build_vertex_color        (polygon.corner_count);
-            build_vertex_aniso_control();
-            build_vertex_joint_indices();
-            build_vertex_joint_weights();
-            build_valency_edge_count  ();
-
-            // Indices
-            property_maps.corner_indices->put(corner_id, vertex_index);
+    erhe::concurrency::Thread_pool* thread_pool = root.build_info.thread_pool;
+    if ((thread_pool == nullptr) || (chunk_count <= 1)) {
+        build_chunks(0, chunk_count);
+    } else {
+        erhe::concurrency::Concurrent_queue queue{*thread_pool, "primitive_builder"};
+        queue.enqueue_range(0, chunk_count, 1, build_chunks);
+        queue.wait();
+    }
 
-            build_corner_point_index();
-            build_triangle_fill_index();
+    vertex_index = polygon_first_vertex[polygon_id_end];
 
-            vertex_writer.move(root.vertex_stride);
-            ++vertex_index;
+    // corner_indices is keyed by corner id, which chunks do not partition
+    {
+        ERHE_PROFILE_SCOPE("corner indices");
+
+        property_maps.corner_indices->trim(root.geometry.get_corner_count());
+        for (Polygon_id polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
+            const Polygon&          polygon                 = root.geometry.polygons[polygon_id];
+            const Polygon_corner_id polygon_corner_id_begin = polygon.first_polygon_corner_id;
+            const Polygon_corner_id polygon_corner_id_end   = polygon_corner_id_begin + polygon.corner_count;
+            for (Polygon_corner_id polygon_corner_id = polygon_corner_id_begin; polygon_corner_id < polygon_corner_id_end; ++polygon_corner_id) {
+                const Corner_id corner_id = root.geometry.polygon_corners[polygon_corner_id];
+                property_maps.corner_indices->put(corner_id, root.element_mappings.corner_to_vertex_id[corner_id]);
+            }
         }
-
-        ++polygon_index;
     }
 
+    bool used_fallback_smooth_normal{false};
+    bool used_fallback_tangent      {false};
+    bool used_fallback_bitangent    {false};
+    bool used_fallback_texcoord     {false};
+    for (const Build_cursor& cursor : chunk_cursors) {
+        used_fallback_smooth_normal = used_fallback_smooth_normal || cursor.used_fallback_smooth_normal;
+        used_fallback_tangent       = used_fallback_tangent       || cursor.used_fallback_tangent;
+        used_fallback_bitangent     = used_fallback_bitangent     || cursor.used_fallback_bitangent;
+        used_fallback_texcoord      = used_fallback_texcoord      || cursor.used_fallback_texcoord;
+    }
     if (used_fallback_smooth_normal) {
         log_primitive_builder->warn("Warning: Used fallback smooth normal");
     }
@@ -873,15 +960,19 @@ void Build_context::build_centroid_points()
         return;
     }
 
+    Build_cursor cursor;
+    cursor.vertex_index  = vertex_index;
+    cursor.vertex_offset = static_cast<std::size_t>(vertex_index) * root.vertex_stride;
     const Polygon_id polygon_id_end = root.geometry.get_polygon_count();
-    for (polygon_id = 0; polygon_id < polygon_id_end; ++polygon_id) {
-        build_centroid_position();
-        build_centroid_normal();
+    for (cursor.polygon_id = 0; cursor.polygon_id < polygon_id_end; ++cursor.polygon_id) {
+        build_centroid_position(cursor);
+        build_centroid_normal(cursor);
 
-        index_writer.write_centroid(vertex_index);
-        vertex_writer.move(root.vertex_stride);
-        ++vertex_index;
+        index_writer.write_centroid(cursor.vertex_index);
+        cursor.vertex_offset += root.vertex_stride;
+        ++cursor.vertex_index;
     }
+    vertex_index = cursor.vertex_index;
 }
 
 void Build_context_root::allocate_index_range(const gl::Primitive_type primitive_type, const std::size_t index_count, Index_range& out_range)
@@ -76,6 +76,27 @@ public:
     std::size_t                          total_index_count {0};
 };
 
+// Position of the vertex being built. build_polygon_fill() uses one cursor
+// per chunk of polygons, so chunks can be built concurrently.
+class Build_cursor
+{
+public:
+    erhe::geometry::Polygon_id polygon_id     {0};
+    erhe::geometry::Point_id   point_id       {0};
+    erhe::geometry::Corner_id  corner_id      {0};
+    uint32_t                   vertex_index   {0}; // primitive vertex index    .
+    uint32_t                   first_index    {0}; // primitive first index      . These make triangle primitive
+    uint32_t                   previous_index {0}; // primitive previous index  .
+    uint32_t                   polygon_index  {0};
+    uint32_t                   primitive_index{0}; // triangle (TODO quad) index
+    std::size_t                vertex_offset  {0}; // byte offset of vertex in vertex buffer range
+
+    bool used_fallback_smooth_normal{false};
+    bool used_fallback_tangent      {false};
+    bool used_fallback_bitangent    {false};
+    bool used_fallback_texcoord     {false};
+};
+
 class Build_context
 {
 public:
@@ -95,45 +116,36 @@ public:
     Build_context_root root;
 
 private:
-    void build_polygon_id        ();
-
-    [[nodiscard]] auto get_polygon_normal() -> glm::vec3;
-
-    void build_vertex_position     ();
-    void build_vertex_normal       ();
-    void build_vertex_tangent      ();
-    void build_vertex_bitangent    ();
-    void build_vertex_texcoord     ();
-    void build_vertex_color        (const uint32_t polygon_corner_count);
-    void build_vertex_aniso_control();
-    void build_vertex_joint_indices();
-    void build_vertex_joint_weights();
-
-    void build_centroid_position   ();
-    void build_centroid_normal     ();
-    void build_valency_edge_count  ();
-
-    void build_corner_point_index  ();
-    void build_triangle_fill_index ();
-
-    erhe::geometry::Polygon_id        polygon_id       {0};
-    erhe::geometry::Polygon_corner_id polygon_corner_id{0};
-    erhe::geometry::Point_id          point_id         {0};
-    erhe::geometry::Corner_id         corner_id        {0};
-    uint32_t                          vertex_index     {0}; // primitive vertex index    .
-    uint32_t                          first_index      {0}; // primitive first index      . These make triangle primitive
-    uint32_t                          previous_index   {0}; // primitive previous index  .
-    uint32_t                          polygon_index    {0};
-    uint32_t                          primitive_index  {0}; // triangle (TODO quad) index
-    Normal_style                      normal_style     {Normal_style::none};
-    Vertex_buffer_writer              vertex_writer;
-    Index_buffer_writer               index_writer;
-    Property_maps                     property_maps;
+    static constexpr std::size_t s_polygon_fill_grain = 1024; // must be multiple of 64
 
-    bool used_fallback_smooth_normal{false};
-    bool used_fallback_tangent      {false};
-    bool used_fallback_bitangent    {false};
-    bool used_fallback_texcoord     {false};
+    void build_polygon_fill_range(erhe::geometry::Polygon_id polygon_id_begin, erhe::geometry::Polygon_id polygon_id_end, Build_cursor& cursor);
+
+    void build_polygon_id          (Build_cursor& cursor);
+
+    [[nodiscard]] auto get_polygon_normal(const Build_cursor& cursor) -> glm::vec3;
+
+    void build_vertex_position     (Build_cursor& cursor);
+    void build_vertex_normal       (Build_cursor& cursor);
+    void build_vertex_tangent      (Build_cursor& cursor);
+    void build_vertex_bitangent    (Build_cursor& cursor);
+    void build_vertex_texcoord     (Build_cursor& cursor);
+    void build_vertex_color        (Build_cursor& cursor, const uint32_t polygon_corner_count);
+    void build_vertex_aniso_control(Build_cursor& cursor);
+    void build_vertex_joint_indices(Build_cursor& cursor);
+    void build_vertex_joint_weights(Build_cursor& cursor);
+
+    void build_centroid_position   (Build_cursor& cursor);
+    void build_centroid_normal     (Build_cursor& cursor);
+    void build_valency_edge_count  (Build_cursor& cursor);
+
+    void build_corner_point_index  (Build_cursor& cursor);
+    void build_triangle_fill_index (Build_cursor& cursor);
+
+    uint32_t             vertex_index{0}; // next vertex after build_polygon_fill() / build_centroid_points()
+    Normal_style         normal_style{Normal_style::none};
+    Vertex_buffer_writer vertex_writer;
+    Index_buffer_writer  index_writer;
+    Property_maps        property_maps;
 };
 
 class Primitive_builder final
@@ -5,10 +5,12 @@
 #include "erhe_gl/wrapper_enums.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace erhe::primitive {
     class Element_mappings;
+    class Morph_targets;
 }
 namespace erhe::primitive {
 
@@ -18,10 +20,11 @@ public:
     [[nodiscard]] auto get_vertex_count() const -> std::size_t;
     [[nodiscard]] auto get_index_count() const -> std::size_t;
 
-    erhe::graphics::Vertex_format vertex_format;
-    gl::Primitive_type            type;
-    std::vector<uint8_t>          vertex_data;
-    std::vector<uint32_t>         index_data;
+    erhe::graphics::Vertex_format  vertex_format;
+    gl::Primitive_type             type;
+    std::vector<uint8_t>           vertex_data;
+    std::vector<uint32_t>          index_data;
+    std::shared_ptr<Morph_targets> morph_targets; // deltas indexed like vertex_data, optional
 };
 
 [[nodiscard]] auto geometry_from_triangle_soup(const Triangle_soup& triangle_soup, erhe::primitive::Element_mappings& element_mappings) -> erhe::geometry::Geometry;
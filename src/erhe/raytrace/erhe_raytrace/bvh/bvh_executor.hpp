@@ -0,0 +1,99 @@
+#pragma once
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+
+#include <bvh/v2/executor.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace erhe::raytrace {
+
+// bvh::v2 executor which runs loops as tasks of an erhe::concurrency::Thread_pool,
+// replacing bvh::v2::ParallelExecutor and its private bvh::v2::ThreadPool. If no
+// pool is given, Thread_pool::get_default() is used at the time of each call.
+// Ranges smaller than parallel_threshold are processed on the calling thread.
+class Bvh_executor : public bvh::v2::Executor<Bvh_executor>
+{
+public:
+    explicit Bvh_executor(
+        erhe::concurrency::Thread_pool* thread_pool        = nullptr,
+        const std::size_t               parallel_threshold = 1024
+    )
+        : m_thread_pool       {thread_pool}
+        , m_parallel_threshold{parallel_threshold}
+    {
+    }
+
+    template <typename Loop>
+    void for_each(const std::size_t begin, const std::size_t end, const Loop& loop)
+    {
+        if (begin >= end) {
+            return;
+        }
+        erhe::concurrency::Thread_pool& thread_pool = get_thread_pool();
+        if ((end - begin < m_parallel_threshold) || (thread_pool.size() == 0)) {
+            loop(begin, end);
+            return;
+        }
+        erhe::concurrency::Concurrent_queue queue{thread_pool, "bvh"};
+        queue.enqueue_range(
+            begin, end, get_chunk_size(thread_pool, end - begin),
+            [&loop](const std::size_t first, const std::size_t last) {
+                loop(first, last);
+            }
+        );
+        queue.wait();
+    }
+
+    // Each chunk is reduced into its own result, and results are joined in
+    // chunk order, so the result does not depend on scheduling.
+    template <typename T, typename Reduce, typename Join>
+    auto reduce(const std::size_t begin, const std::size_t end, const T& init, const Reduce& reduce, const Join& join) -> T
+    {
+        T result(init);
+        if (begin >= end) {
+            return result;
+        }
+        erhe::concurrency::Thread_pool& thread_pool = get_thread_pool();
+        if ((end - begin < m_parallel_threshold) || (thread_pool.size() == 0)) {
+            reduce(result, begin, end);
+            return result;
+        }
+        const std::size_t chunk_size  = get_chunk_size(thread_pool, end - begin);
+        const std::size_t chunk_count = (end - begin + chunk_size - 1) / chunk_size;
+        std::vector<T> chunk_results(chunk_count, init);
+        erhe::concurrency::Concurrent_queue queue{thread_pool, "bvh"};
+        queue.enqueue_range(
+            0, chunk_count, 1,
+            [&](const std::size_t chunk) {
+                const std::size_t first = begin + chunk * chunk_size;
+                reduce(chunk_results[chunk], first, std::min(end, first + chunk_size));
+            }
+        );
+        queue.wait();
+        for (T& chunk_result : chunk_results) {
+            join(result, std::move(chunk_result));
+        }
+        return result;
+    }
+
+private:
+    [[nodiscard]] auto get_thread_pool() const -> erhe::concurrency::Thread_pool&
+    {
+        return (m_thread_pool != nullptr) ? *m_thread_pool : erhe::concurrency::Thread_pool::get_default();
+    }
+
+    // A few chunks per thread, including the waiting thread, to balance load
+    [[nodiscard]] auto get_chunk_size(erhe::concurrency::Thread_pool& thread_pool, const std::size_t count) const -> std::size_t
+    {
+        const std::size_t thread_count = static_cast<std::size_t>(thread_pool.size()) + 1;
+        return std::max(count / (thread_count * 4), std::max(m_parallel_threshold / 4, std::size_t{1}));
+    }
+
+    erhe::concurrency::Thread_pool* m_thread_pool       {nullptr};
+    std::size_t                     m_parallel_threshold{1024};
+};
+
+} // namespace erhe::raytrace
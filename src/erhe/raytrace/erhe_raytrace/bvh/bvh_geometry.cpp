@@ -8,6 +8,8 @@
 
 #include "erhe_raytrace/bvh/bvh_geometry.hpp"
 #include "erhe_raytrace/bvh/bvh_instance.hpp"
+#include "erhe_raytrace/bvh/bvh_packet.hpp"
+#include "erhe_raytrace/bvh/executor_resources.hpp"
 #include "erhe_raytrace/bvh/glm_conversions.hpp"
 #include "erhe_raytrace/ibuffer.hpp"
 #include "erhe_raytrace/raytrace_log.hpp"
@@ -16,15 +18,17 @@
 #include "erhe_hash/hash.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_time/timer.hpp"
+#include "erhe_verify/verify.hpp"
 
 #include <bvh/v2/bvh.h>
-#include <bvh/v2/default_builder.h>
-#include <bvh/v2/executor.h>
 #include <bvh/v2/node.h>
 #include <bvh/v2/ray.h>
+#include <bvh/v2/reinsertion_optimizer.h>
 #include <bvh/v2/stack.h>
-#include <bvh/v2/thread_pool.h>
+#include <bvh/v2/sweep_sah_builder.h>
 
+#include <array>
+#include <bit>
 #include <fstream>
 
 namespace erhe::raytrace {
@@ -99,25 +103,6 @@ using PrecomputedTri = bvh::v2::PrecomputedTri<Scalar>;
 
 static constexpr bool should_permute = true; // TODO
 
-class Executor_resources
-{
-public:
-    static Executor_resources& get_instance() {
-        static Executor_resources static_instance;
-        return static_instance;
-    }
-
-    auto get_thread_pool() -> bvh::v2::ThreadPool&       { return m_thread_pool; }
-    auto get_executor   () -> bvh::v2::ParallelExecutor& { return m_executor; }
-
-private:
-    Executor_resources() : m_thread_pool{}, m_executor{m_thread_pool} {}
-    ~Executor_resources(){};
-
-    bvh::v2::ThreadPool       m_thread_pool;
-    bvh::v2::ParallelExecutor m_executor;
-};
-
 void Bvh_geometry::commit()
 {
     ERHE_PROFILE_FUNCTION();
@@ -209,20 +194,17 @@ void Bvh_geometry::commit()
         const bool load_ok = load_bvh(m_bvh, hash_code);
         if (!load_ok)
         {
-            typename bvh::v2::DefaultBuilder<Node>::Config config;
-            config.quality = bvh::v2::DefaultBuilder<Node>::Quality::High; // TODO Low
+            typename bvh::v2::SweepSahBuilder<Node>::Config config;
 
             {
                 ERHE_PROFILE_SCOPE("bvh build");
                 erhe::time::Timer timer{m_debug_label.c_str()};
 
                 timer.begin();
-                m_bvh = bvh::v2::DefaultBuilder<Node>::build(
-                    executor_resources.get_thread_pool(),
-                    bboxes,
-                    centers,
-                    config
-                );
+                // Same as DefaultBuilder::build() with quality High, but the
+                // reinsertion optimization runs on the shared thread pool
+                m_bvh = bvh::v2::SweepSahBuilder<Node>::build(bboxes, centers, config);
+                bvh::v2::ReinsertionOptimizer<Node>::optimize(executor_resources.get_executor(), m_bvh);
                 timer.end();
 
                 const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(timer.duration().value()).count();
@@ -361,6 +343,95 @@ auto Bvh_geometry::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance
     return false;
 }
 
+auto Bvh_geometry::intersect_packet(
+    const std::span<Ray>     rays,
+    const std::span<Hit>     hits,
+    uint32_t                 active_mask,
+    Bvh_instance* const      instance
+) -> uint32_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!m_enabled || m_bvh.nodes.empty()) {
+        return 0;
+    }
+    for (std::size_t i = 0, end = rays.size(); i < end; ++i) {
+        if ((rays[i].mask & m_mask) == 0) {
+            active_mask &= ~(uint32_t{1} << i);
+        }
+    }
+    if (active_mask == 0) {
+        return 0;
+    }
+
+    static constexpr std::size_t invalid_id = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t stack_size = 64;
+
+    Bvh_packet packet{rays, active_mask};
+    std::array<std::size_t, Bvh_packet::max_size> prim_ids;
+    std::array<float,       Bvh_packet::max_size> u;
+    std::array<float,       Bvh_packet::max_size> v;
+    prim_ids.fill(invalid_id);
+
+    std::array<std::size_t, stack_size> stack;
+    std::size_t stack_top = 0;
+    stack[stack_top++] = 0; // root
+    while (stack_top > 0) {
+        const Node&    node      = m_bvh.nodes[stack[--stack_top]];
+        const uint32_t node_mask = packet.intersect(node.get_bbox(), active_mask);
+        if (node_mask == 0) {
+            continue;
+        }
+        const std::size_t first_id = static_cast<std::size_t>(node.index.first_id());
+        if (!node.index.is_leaf()) {
+            ERHE_VERIFY(stack_top + 2 <= stack_size);
+            stack[stack_top++] = first_id + 1;
+            stack[stack_top++] = first_id;
+            continue;
+        }
+        for (std::size_t j = first_id, end = first_id + node.index.prim_count(); j < end; ++j) {
+            PrecomputedTri& triangle = m_precomputed_triangles[should_permute ? j : m_bvh.prim_ids[j]];
+            for (uint32_t lanes = node_mask; lanes != 0; lanes &= lanes - 1) {
+                const std::size_t i = static_cast<std::size_t>(std::countr_zero(lanes));
+                bvh::v2::Ray<Scalar, 3> bvh_ray = packet.get_ray(i);
+                if (auto hit = triangle.intersect(bvh_ray)) {
+                    packet.t_far[i] = bvh_ray.tmax;
+                    prim_ids[i]     = j;
+                    std::tie(u[i], v[i]) = *hit;
+                }
+            }
+        }
+    }
+
+    uint32_t hit_mask = 0;
+    const auto transform = (instance != nullptr) ? instance->get_transform() : glm::mat4{1.0};
+    for (std::size_t i = 0, end = rays.size(); i < end; ++i) {
+        const std::size_t prim_id = prim_ids[i];
+        if (prim_id == invalid_id) {
+            continue;
+        }
+        const auto  triangle_index = should_permute ? prim_id : m_bvh.prim_ids[prim_id];
+        const auto& triangle       = m_precomputed_triangles[triangle_index];
+        Hit& hit = hits[i];
+        rays[i].t_far   = packet.t_far[i];
+        hit.triangle_id = static_cast<unsigned int>(m_bvh.prim_ids[prim_id]);
+        hit.uv          = glm::vec2{u[i], v[i]};
+        hit.normal      = glm::vec3{transform * glm::vec4{from_bvh(triangle.n), 0.0f}};
+        hit.instance    = instance;
+        hit.geometry    = this;
+        hit_mask |= (uint32_t{1} << i);
+    }
+    return hit_mask;
+}
+
+auto Bvh_geometry::get_bbox() const -> BBox
+{
+    if (m_bvh.nodes.empty()) {
+        return BBox::make_empty();
+    }
+    return m_bvh.get_root().get_bbox();
+}
+
 /// auto Bvh_geometry::get_sphere() const -> const erhe::math::Bounding_sphere&
 /// {
 ///     return m_bounding_sphere;
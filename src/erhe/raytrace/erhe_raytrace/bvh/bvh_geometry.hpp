@@ -13,6 +13,7 @@
 #include <bvh/v2/bvh.h>
 #include <bvh/v2/tri.h>
 
+#include <span>
 #include <string>
 #include <vector>
 
@@ -52,6 +53,12 @@ public:
 
     // Bvh_geometry public API
     auto intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance) -> bool;
+    auto get_bbox          () const -> bvh::v2::BBox<float, 3>; // empty if not committed
+
+    // Intersects rays (at most Bvh_packet::max_size) in geometry space with
+    // a single traversal. Only rays with bit set in active_mask are tested.
+    // Returns mask of rays that hit; t_far and hit are updated for those.
+    auto intersect_packet(std::span<Ray> rays, std::span<Hit> hits, uint32_t active_mask, Bvh_instance* instance) -> uint32_t;
 
 private:
     class Buffer_info
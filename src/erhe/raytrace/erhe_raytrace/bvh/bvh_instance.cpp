@@ -1,5 +1,6 @@
  #include "erhe_raytrace/bvh/bvh_instance.hpp"
 #include "erhe_log/log_glm.hpp"
+#include "erhe_raytrace/bvh/bvh_packet.hpp"
 #include "erhe_raytrace/bvh/bvh_scene.hpp"
 #include "erhe_raytrace/iscene.hpp"
 #include "erhe_raytrace/ray.hpp"
@@ -7,6 +8,8 @@
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
+#include <array>
+
 namespace erhe::raytrace
 {
 
@@ -61,11 +64,30 @@ void Bvh_instance::set_transform(const glm::mat4 transform)
 {
     //log_frame->trace("Bvh_instance::set_transform {}", m_debug_label);
     m_transform = transform;
+    mark_dirty();
 }
 
 void Bvh_instance::set_scene(IScene* scene)
 {
     m_scene = scene;
+    mark_dirty();
+}
+
+void Bvh_instance::set_parent_scene(Bvh_scene* scene)
+{
+    m_parent = scene;
+}
+
+auto Bvh_instance::get_parent_scene() const -> Bvh_scene*
+{
+    return m_parent;
+}
+
+void Bvh_instance::mark_dirty()
+{
+    if (m_parent != nullptr) {
+        m_parent->mark_instance_dirty();
+    }
 }
 
 void Bvh_instance::set_mask(const uint32_t mask)
@@ -103,6 +125,44 @@ auto Bvh_instance::intersect(Ray& ray, Hit& hit) -> bool
     return is_hit;
 }
 
+auto Bvh_instance::intersect_packet(
+    const std::span<Ray> rays,
+    const std::span<Hit> hits,
+    uint32_t             active_mask
+) -> uint32_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!m_enabled) {
+        return 0;
+    }
+    for (std::size_t i = 0, end = rays.size(); i < end; ++i) {
+        if ((rays[i].mask & m_mask) == 0) {
+            active_mask &= ~(uint32_t{1} << i);
+        }
+    }
+    if (active_mask == 0) {
+        return 0;
+    }
+
+    const auto inverse_transform = glm::inverse(get_transform());
+    std::array<Ray, Bvh_packet::max_size> local_rays;
+    for (std::size_t i = 0, end = rays.size(); i < end; ++i) {
+        local_rays[i] = rays[i].transform(inverse_transform);
+    }
+    auto* bvh_scene = reinterpret_cast<Bvh_scene*>(get_scene());
+    const uint32_t hit_mask = bvh_scene->intersect_instance_packet(
+        std::span<Ray>{local_rays.data(), rays.size()},
+        hits,
+        active_mask,
+        this
+    );
+    for (std::size_t i = 0, end = rays.size(); i < end; ++i) {
+        rays[i].t_far = local_rays[i].t_far;
+    }
+    return hit_mask;
+}
+
 #if 0
 void Bvh_instance::collect_spheres(
     std::vector<bvh::Sphere<float>>& spheres,
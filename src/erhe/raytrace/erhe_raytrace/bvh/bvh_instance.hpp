@@ -4,6 +4,7 @@
 
 #include <glm/glm.hpp>
 
+#include <span>
 #include <string>
 
 namespace erhe::raytrace {
@@ -32,12 +33,18 @@ public:
     auto debug_label  () const -> std::string_view override;
 
     // Bvh_instance public API
-    auto intersect(Ray& ray, Hit& hit) -> bool;
+    auto intersect        (Ray& ray, Hit& hit) -> bool;
+    auto intersect_packet (std::span<Ray> rays, std::span<Hit> hits, uint32_t active_mask) -> uint32_t;
+    void set_parent_scene (Bvh_scene* scene); // scene this instance is attached to
+    auto get_parent_scene () const -> Bvh_scene*;
 
 private:
+    void mark_dirty();
+
     glm::mat4   m_transform{1.0f};
     bool        m_enabled  {true};
     IScene*     m_scene    {nullptr};
+    Bvh_scene*  m_parent   {nullptr};
     uint32_t    m_mask     {0xffffffffu};
     void*       m_user_data{nullptr};
     std::string m_debug_label;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "erhe_raytrace/ray.hpp"
+
+#include <bvh/v2/bbox.h>
+#include <bvh/v2/ray.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+namespace erhe::raytrace {
+
+// Structure of arrays for up to max_size coherent rays which traverse a
+// BVH together. Node bounds are tested for all lanes in one loop, which
+// the compiler can vectorize; the result is a mask of lanes that hit.
+class Bvh_packet
+{
+public:
+    static constexpr std::size_t max_size = 8;
+
+    static constexpr auto lane_mask(const std::size_t count) -> uint32_t
+    {
+        return (count >= 32) ? ~uint32_t{0} : ((uint32_t{1} << count) - 1u);
+    }
+
+    Bvh_packet(const std::span<const Ray> rays, const uint32_t active_mask)
+    {
+        for (std::size_t i = 0, end = std::min(rays.size(), max_size); i < end; ++i) {
+            if ((active_mask & (uint32_t{1} << i)) == 0) {
+                continue;
+            }
+            const Ray& ray = rays[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                const float d = ray.direction[axis];
+                origin       [axis][i] = ray.origin[axis];
+                direction    [axis][i] = d;
+                inv_direction[axis][i] = 1.0f / ((std::abs(d) > min_direction) ? d : std::copysign(min_direction, d));
+            }
+            t_near[i] = ray.t_near;
+            t_far [i] = ray.t_far;
+        }
+    }
+
+    [[nodiscard]] auto intersect(const bvh::v2::BBox<float, 3>& bbox, const uint32_t mask) const -> uint32_t
+    {
+        uint32_t result = 0;
+        for (std::size_t i = 0; i < max_size; ++i) {
+            float t_min = t_near[i];
+            float t_max = t_far[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                const float t0 = (bbox.min[axis] - origin[axis][i]) * inv_direction[axis][i];
+                const float t1 = (bbox.max[axis] - origin[axis][i]) * inv_direction[axis][i];
+                t_min = std::max(t_min, std::min(t0, t1));
+                t_max = std::min(t_max, std::max(t0, t1));
+            }
+            result |= static_cast<uint32_t>(t_min <= t_max) << i;
+        }
+        return result & mask;
+    }
+
+    [[nodiscard]] auto get_ray(const std::size_t i) const -> bvh::v2::Ray<float, 3>
+    {
+        return bvh::v2::Ray<float, 3>{
+            bvh::v2::Vec<float, 3>{origin   [0][i], origin   [1][i], origin   [2][i]},
+            bvh::v2::Vec<float, 3>{direction[0][i], direction[1][i], direction[2][i]},
+            t_near[i],
+            t_far [i]
+        };
+    }
+
+    static constexpr float min_direction = 1.0e-20f;
+
+    std::array<std::array<float, max_size>, 3> origin       {};
+    std::array<std::array<float, max_size>, 3> direction    {};
+    std::array<std::array<float, max_size>, 3> inv_direction{};
+    std::array<float, max_size>                 t_near      {};
+    std::array<float, max_size>                 t_far       {}; // lanes with t_far < t_near never hit
+};
+
+} // namespace erhe::raytrace
@@ -8,14 +8,66 @@
 #include "erhe_log/log_glm.hpp"
 #include "erhe_raytrace/bvh/bvh_geometry.hpp"
 #include "erhe_raytrace/bvh/bvh_instance.hpp"
+#include "erhe_raytrace/bvh/bvh_packet.hpp"
+#include "erhe_raytrace/bvh/executor_resources.hpp"
+#include "erhe_raytrace/bvh/glm_conversions.hpp"
 #include "erhe_raytrace/iinstance.hpp"
 #include "erhe_raytrace/raytrace_log.hpp"
 #include "erhe_raytrace/ray.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
+#include <bvh/v2/default_builder.h>
+#include <bvh/v2/ray.h>
+#include <bvh/v2/stack.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
 namespace erhe::raytrace {
 
+namespace {
+
+[[nodiscard]] auto is_empty(const bvh::v2::BBox<float, 3>& bbox) -> bool
+{
+    return bbox.min[0] > bbox.max[0];
+}
+
+[[nodiscard]] auto transform_bbox(const bvh::v2::BBox<float, 3>& bbox, const glm::mat4& transform) -> bvh::v2::BBox<float, 3>
+{
+    if (is_empty(bbox)) {
+        return bbox;
+    }
+    auto result = bvh::v2::BBox<float, 3>::make_empty();
+    for (unsigned int i = 0; i < 8; ++i) {
+        const glm::vec3 corner{
+            ((i & 1u) != 0) ? bbox.max[0] : bbox.min[0],
+            ((i & 2u) != 0) ? bbox.max[1] : bbox.min[1],
+            ((i & 4u) != 0) ? bbox.max[2] : bbox.min[2]
+        };
+        result.extend(to_bvh(glm::vec3{transform * glm::vec4{corner, 1.0f}}));
+    }
+    return result;
+}
+
+[[nodiscard]] auto get_instance_bbox(const Bvh_instance* instance) -> bvh::v2::BBox<float, 3>
+{
+    const auto* instance_scene = reinterpret_cast<const Bvh_scene*>(instance->get_scene());
+    if (instance_scene == nullptr) {
+        return bvh::v2::BBox<float, 3>::make_empty();
+    }
+    return transform_bbox(instance_scene->get_bbox(), instance->get_transform());
+}
+
+// Rebuild when refitting has made tree this much worse than when built
+static constexpr float tlas_rebuild_cost_ratio = 2.0f;
+
+// intersect_n() uses multiple threads for at least this many rays
+static constexpr std::size_t parallel_ray_count = 1024;
+
+} // anonymous namespace
+
 auto IScene::create(const std::string_view debug_label) -> IScene*
 {
     return new Bvh_scene(debug_label);
@@ -39,6 +91,11 @@ Bvh_scene::Bvh_scene(const std::string_view debug_label)
 
 Bvh_scene::~Bvh_scene() noexcept
 {
+    for (Bvh_instance* instance : m_instances) {
+        if (instance->get_parent_scene() == this) {
+            instance->set_parent_scene(nullptr);
+        }
+    }
     log_scene->trace("Destroyed Bvh_scene '{}'", m_debug_label);
 }
 
@@ -77,6 +134,9 @@ void Bvh_scene::attach(IInstance* instance)
 #endif
     {
         m_instances.push_back(bvh_instance);
+        bvh_instance->set_parent_scene(this);
+        m_tlas_rebuild = true;
+        m_tlas_dirty.store(true);
     }
 }
 
@@ -109,12 +169,284 @@ void Bvh_scene::detach(IInstance* instance)
         log_scene->error("raytrace instance not in scene");
     } else {
         m_instances.erase(i, m_instances.end());
+        if (bvh_instance->get_parent_scene() == this) {
+            bvh_instance->set_parent_scene(nullptr);
+        }
+        m_tlas_rebuild = true;
+        m_tlas_dirty.store(true);
     }
 }
 
 void Bvh_scene::commit()
 {
-    // TODO
+    ERHE_PROFILE_FUNCTION();
+
+    // Always update, geometry bounds in instanced scenes may have changed
+    const std::lock_guard<std::mutex> lock{m_tlas_mutex};
+    update_tlas();
+}
+
+void Bvh_scene::mark_instance_dirty()
+{
+    m_tlas_dirty.store(true);
+}
+
+auto Bvh_scene::get_bbox() const -> bvh::v2::BBox<float, 3>
+{
+    return m_bbox;
+}
+
+void Bvh_scene::update_tlas()
+{
+    if (!m_tlas_rebuild) {
+        m_tlas_rebuild = !refit_tlas();
+    }
+    if (m_tlas_rebuild) {
+        build_tlas();
+    }
+    update_bbox();
+    m_tlas_dirty.store(false);
+}
+
+void Bvh_scene::build_tlas()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    m_tlas_instances.clear();
+    m_tlas_bboxes.clear();
+    m_unbounded_instances.clear();
+    std::vector<bvh::v2::Vec<float, 3>> centers;
+    for (Bvh_instance* instance : m_instances) {
+        const Tlas_bbox bbox = get_instance_bbox(instance);
+        if (is_empty(bbox)) {
+            m_unbounded_instances.push_back(instance);
+            continue;
+        }
+        m_tlas_instances.push_back(instance);
+        m_tlas_bboxes.push_back(bbox);
+        centers.push_back(bbox.get_center());
+    }
+
+    m_tlas = Tlas{};
+    if (!m_tlas_instances.empty()) {
+        typename bvh::v2::DefaultBuilder<Tlas_node>::Config config;
+        config.quality = bvh::v2::DefaultBuilder<Tlas_node>::Quality::High;
+        m_tlas = bvh::v2::DefaultBuilder<Tlas_node>::build(m_tlas_bboxes, centers, config);
+    }
+    m_tlas_build_cost = get_tlas_cost();
+    m_tlas_rebuild    = false;
+
+    log_scene->trace(
+        "Bvh_scene {} TLAS built, instances = {}, unbounded instances = {}, nodes = {}",
+        m_debug_label, m_tlas_instances.size(), m_unbounded_instances.size(), m_tlas.nodes.size()
+    );
+}
+
+// Returns false if TLAS needs to be rebuilt instead
+auto Bvh_scene::refit_tlas() -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    for (const Bvh_instance* instance : m_unbounded_instances) {
+        if (!is_empty(get_instance_bbox(instance))) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0, end = m_tlas_instances.size(); i < end; ++i) {
+        m_tlas_bboxes[i] = get_instance_bbox(m_tlas_instances[i]);
+        if (is_empty(m_tlas_bboxes[i])) {
+            return false;
+        }
+    }
+    if (m_tlas.nodes.empty()) {
+        return true;
+    }
+    static_cast<void>(refit_tlas_node(0));
+    return get_tlas_cost() <= tlas_rebuild_cost_ratio * m_tlas_build_cost;
+}
+
+// Children are refitted before parents; node order after build
+// optimization is not guaranteed to be topological.
+auto Bvh_scene::refit_tlas_node(const std::size_t node_index) -> Tlas_bbox
+{
+    Tlas_node& node = m_tlas.nodes[node_index];
+    Tlas_bbox bbox = Tlas_bbox::make_empty();
+    const std::size_t first_id = static_cast<std::size_t>(node.index.first_id());
+    if (node.index.is_leaf()) {
+        for (std::size_t i = first_id, end = first_id + node.index.prim_count(); i < end; ++i) {
+            bbox.extend(m_tlas_bboxes[m_tlas.prim_ids[i]]);
+        }
+    } else {
+        bbox.extend(refit_tlas_node(first_id));
+        bbox.extend(refit_tlas_node(first_id + 1));
+    }
+    node.set_bbox(bbox);
+    return bbox;
+}
+
+// Surface area heuristic cost estimate, relative to root
+auto Bvh_scene::get_tlas_cost() const -> float
+{
+    if (m_tlas.nodes.empty()) {
+        return 0.0f;
+    }
+    float cost = 0.0f;
+    for (const Tlas_node& node : m_tlas.nodes) {
+        const float area = node.get_bbox().get_half_area();
+        cost += node.index.is_leaf() ? area * static_cast<float>(node.index.prim_count()) : area;
+    }
+    const float root_area = m_tlas.get_root().get_bbox().get_half_area();
+    return (root_area > 0.0f) ? cost / root_area : cost;
+}
+
+void Bvh_scene::update_bbox()
+{
+    m_bbox = Tlas_bbox::make_empty();
+    if (!m_tlas.nodes.empty()) {
+        m_bbox.extend(m_tlas.get_root().get_bbox());
+    }
+    for (const Bvh_geometry* geometry : m_geometries) {
+        const Tlas_bbox bbox = geometry->get_bbox();
+        if (!is_empty(bbox)) {
+            m_bbox.extend(bbox);
+        }
+    }
+}
+
+void Bvh_scene::update_if_dirty()
+{
+    if (m_tlas_dirty.load()) {
+        const std::lock_guard<std::mutex> lock{m_tlas_mutex};
+        if (m_tlas_dirty.load()) {
+            update_tlas();
+        }
+    }
+}
+
+auto Bvh_scene::intersect_tlas(Ray& ray, Hit& hit) -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    update_if_dirty();
+    if (m_tlas.nodes.empty()) {
+        return false;
+    }
+
+    bvh::v2::Ray<float, 3> bvh_ray{
+        to_bvh(ray.origin),
+        to_bvh(ray.direction),
+        ray.t_near,
+        ray.t_far
+    };
+
+    static constexpr std::size_t stack_size           = 64;
+    static constexpr bool        use_robust_traversal = false;
+
+    bool is_hit = false;
+    bvh::v2::SmallStack<Tlas::Index, stack_size> stack;
+    m_tlas.intersect<false, use_robust_traversal>(
+        bvh_ray,
+        m_tlas.get_root().index,
+        stack,
+        [&] (const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                Bvh_instance* instance = m_tlas_instances[m_tlas.prim_ids[i]];
+                if (instance->intersect(ray, hit)) {
+                    is_hit = true;
+                    bvh_ray.tmax = ray.t_far;
+                }
+            }
+            return false;
+        }
+    );
+    return is_hit;
+}
+
+auto Bvh_scene::intersect_tlas_packet(
+    const std::span<Ray> rays,
+    const std::span<Hit> hits,
+    const uint32_t       active_mask
+) -> uint32_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    update_if_dirty();
+    if (m_tlas.nodes.empty()) {
+        return 0;
+    }
+
+    static constexpr std::size_t stack_size = 64;
+
+    Bvh_packet packet{rays, active_mask};
+    uint32_t   hit_mask = 0;
+
+    std::array<std::size_t, stack_size> stack;
+    std::size_t stack_top = 0;
+    stack[stack_top++] = 0; // root
+    while (stack_top > 0) {
+        const Tlas_node& node      = m_tlas.nodes[stack[--stack_top]];
+        const uint32_t   node_mask = packet.intersect(node.get_bbox(), active_mask);
+        if (node_mask == 0) {
+            continue;
+        }
+        const std::size_t first_id = static_cast<std::size_t>(node.index.first_id());
+        if (!node.index.is_leaf()) {
+            ERHE_VERIFY(stack_top + 2 <= stack_size);
+            stack[stack_top++] = first_id + 1;
+            stack[stack_top++] = first_id;
+            continue;
+        }
+        for (std::size_t j = first_id, end = first_id + node.index.prim_count(); j < end; ++j) {
+            Bvh_instance* instance = m_tlas_instances[m_tlas.prim_ids[j]];
+            const uint32_t instance_hit_mask = instance->intersect_packet(rays, hits, node_mask);
+            for (uint32_t lanes = instance_hit_mask; lanes != 0; lanes &= lanes - 1) {
+                const std::size_t i = static_cast<std::size_t>(std::countr_zero(lanes));
+                packet.t_far[i] = rays[i].t_far;
+            }
+            hit_mask |= instance_hit_mask;
+        }
+    }
+    return hit_mask;
+}
+
+auto Bvh_scene::intersect_packet(const std::span<Ray> rays, const std::span<Hit> hits) -> uint32_t
+{
+    const uint32_t active_mask = Bvh_packet::lane_mask(rays.size());
+    uint32_t hit_mask = intersect_tlas_packet(rays, hits, active_mask);
+    for (const auto& geometry : m_geometries) {
+        hit_mask |= geometry->intersect_packet(rays, hits, active_mask, nullptr);
+    }
+    return hit_mask;
+}
+
+auto Bvh_scene::intersect_n(const std::span<Ray> rays, const std::span<Hit> hits) -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(hits.size() >= rays.size());
+
+    // Update before tracing from multiple threads
+    update_if_dirty();
+
+    const std::size_t packet_count = (rays.size() + Bvh_packet::max_size - 1) / Bvh_packet::max_size;
+    std::atomic<std::size_t> hit_count{0};
+    const auto trace_packets = [&](const std::size_t begin, const std::size_t end) {
+        std::size_t local_hit_count = 0;
+        for (std::size_t packet = begin; packet < end; ++packet) {
+            const std::size_t first = packet * Bvh_packet::max_size;
+            const std::size_t count = std::min(Bvh_packet::max_size, rays.size() - first);
+            const uint32_t hit_mask = intersect_packet(rays.subspan(first, count), hits.subspan(first, count));
+            local_hit_count += static_cast<std::size_t>(std::popcount(hit_mask));
+        }
+        hit_count.fetch_add(local_hit_count);
+    };
+
+    if (rays.size() >= parallel_ray_count) {
+        Executor_resources::get_instance().get_executor().for_each(0, packet_count, trace_packets);
+    } else {
+        trace_packets(0, packet_count);
+    }
+    return hit_count.load();
 }
 
 auto Bvh_scene::intersect(Ray& ray, Hit& hit) -> bool
@@ -126,13 +458,7 @@ auto Bvh_scene::intersect(Ray& ray, Hit& hit) -> bool
 
     ERHE_PROFILE_FUNCTION();
 
-    bool is_hit = false;
-    for (const auto& instance : m_instances) {
-        const bool instance_is_hit = instance->intersect(ray, hit);
-        if (instance_is_hit) {
-            is_hit = true;
-        }
-    }
+    bool is_hit = intersect_tlas(ray, hit);
     for (const auto& geometry : m_geometries) {
         const bool geometry_is_hit = geometry->intersect_instance(ray, hit, nullptr);
         if (geometry_is_hit) {
@@ -146,12 +472,7 @@ auto Bvh_scene::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* in_instance
 {
     bool is_hit = false;
     if (in_instance == nullptr) {
-        for (const auto& instance : m_instances) {
-            const bool instance_is_hit = instance->intersect(ray, hit);
-            if (instance_is_hit) {
-                is_hit = true;
-            }
-        }
+        is_hit = intersect_tlas(ray, hit);
     } else {
         for (const auto& geometry : m_geometries) {
             const bool geometry_is_hit = geometry->intersect_instance(ray, hit, in_instance);
@@ -163,6 +484,23 @@ auto Bvh_scene::intersect_instance(Ray& ray, Hit& hit, Bvh_instance* in_instance
     return is_hit;
 }
 
+auto Bvh_scene::intersect_instance_packet(
+    const std::span<Ray> rays,
+    const std::span<Hit> hits,
+    const uint32_t       active_mask,
+    Bvh_instance* const  in_instance
+) -> uint32_t
+{
+    if (in_instance == nullptr) {
+        return intersect_tlas_packet(rays, hits, active_mask);
+    }
+    uint32_t hit_mask = 0;
+    for (const auto& geometry : m_geometries) {
+        hit_mask |= geometry->intersect_packet(rays, hits, active_mask, in_instance);
+    }
+    return hit_mask;
+}
+
 auto Bvh_scene::debug_label() const -> std::string_view
 {
     return m_debug_label;
@@ -8,8 +8,13 @@
 
 #include "erhe_raytrace/iscene.hpp"
 
+#include <bvh/v2/bbox.h>
 #include <bvh/v2/bvh.h>
+#include <bvh/v2/node.h>
 
+#include <atomic>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -32,15 +37,53 @@ public:
     void detach     (IInstance* geometry)        override;
     void commit     ()                           override;
     auto intersect  (Ray& ray, Hit& hit) -> bool override;
+    auto intersect_n(std::span<Ray> rays, std::span<Hit> hits) -> std::size_t override;
     auto debug_label() const -> std::string_view override;
 
     // Bvh_scene public API
-    auto intersect_instance(Ray& ray, Hit& hit, Bvh_instance* instance) -> bool;
+    auto intersect_instance       (Ray& ray, Hit& hit, Bvh_instance* instance) -> bool;
+    auto intersect_instance_packet(std::span<Ray> rays, std::span<Hit> hits, uint32_t active_mask, Bvh_instance* instance) -> uint32_t;
+
+    // Bounds of geometries and instances in scene space, as of last commit()
+    [[nodiscard]] auto get_bbox() const -> bvh::v2::BBox<float, 3>;
+
+    // Called by attached instances when their world bounds change. The
+    // top level BVH is then refitted by commit(), or by the next intersect().
+    void mark_instance_dirty();
 
 private:
+    using Tlas_bbox = bvh::v2::BBox<float, 3>;
+    using Tlas_node = bvh::v2::Node<float, 3>;
+    using Tlas      = bvh::v2::Bvh<Tlas_node>;
+
+    // Top level BVH over world space bounds of instances. Instances are
+    // leaves; each instance traverses the BVHs of the geometries in its
+    // own scene. Refitted when instances move, rebuilt when instances
+    // are attached or detached, or when refitting has degraded the tree.
+    void update_if_dirty      ();
+    void update_tlas          ();
+    void build_tlas           ();
+    auto refit_tlas           () -> bool;
+    auto refit_tlas_node      (std::size_t node_index) -> Tlas_bbox;
+    auto get_tlas_cost        () const -> float;
+    auto intersect_tlas       (Ray& ray, Hit& hit) -> bool;
+    auto intersect_tlas_packet(std::span<Ray> rays, std::span<Hit> hits, uint32_t active_mask) -> uint32_t;
+    auto intersect_packet     (std::span<Ray> rays, std::span<Hit> hits) -> uint32_t;
+    void update_bbox          ();
+
     std::vector<Bvh_geometry*> m_geometries;
     std::vector<Bvh_instance*> m_instances;
     std::string                m_debug_label;
+
+    std::mutex                 m_tlas_mutex;
+    std::atomic<bool>          m_tlas_dirty  {true};
+    bool                       m_tlas_rebuild{true};
+    Tlas                       m_tlas;
+    std::vector<Bvh_instance*> m_tlas_instances;      // TLAS primitives, bounded instances
+    std::vector<Tlas_bbox>     m_tlas_bboxes;         // world bounds of m_tlas_instances
+    std::vector<Bvh_instance*> m_unbounded_instances; // instances without geometry, not in TLAS
+    float                      m_tlas_build_cost{0.0f};
+    Tlas_bbox                  m_bbox{Tlas_bbox::make_empty()};
 };
 
 } // namespace erhe::raytrace
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "erhe_raytrace/bvh/bvh_executor.hpp"
+
+namespace erhe::raytrace {
+
+class Executor_resources
+{
+public:
+    static Executor_resources& get_instance() {
+        static Executor_resources static_instance;
+        return static_instance;
+    }
+
+    // Runs on erhe::concurrency::Thread_pool::get_default()
+    auto get_executor() -> Bvh_executor& { return m_executor; }
+
+private:
+    Executor_resources() : m_executor{} {}
+    ~Executor_resources(){};
+
+    Bvh_executor m_executor;
+};
+
+} // namespace erhe::raytrace
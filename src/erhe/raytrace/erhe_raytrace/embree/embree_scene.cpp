@@ -6,6 +6,8 @@
 #include "erhe_raytrace/ray.hpp"
 #include "erhe_profile/profile.hpp"
 
+#include <algorithm>
+
 namespace erhe::raytrace
 {
 
@@ -220,12 +222,17 @@ void Embree_scene::intersect(Ray& ray, Hit& hit)
     hit.normal       = glm::vec3{ray_hit.hit.Ng_x, ray_hit.hit.Ng_y, ray_hit.hit.Ng_z};
     hit.uv           = glm::vec2{ray_hit.hit.u, ray_hit.hit.v};
     hit.primitive_id = ray_hit.hit.primID;
-    hit.geometry     = nullptr;
-    hit.instance     = nullptr;
+    set_hit_geometry(hit, ray_hit.hit.instID[0], ray_hit.hit.geomID);
+}
+
+void Embree_scene::set_hit_geometry(Hit& hit, const unsigned int inst_id, const unsigned int geom_id)
+{
+    hit.geometry = nullptr;
+    hit.instance = nullptr;
 
-    if (ray_hit.hit.instID[0] != RTC_INVALID_GEOMETRY_ID)
+    if (inst_id != RTC_INVALID_GEOMETRY_ID)
     {
-        const auto instance_geometry = rtcGetGeometry(m_scene, ray_hit.hit.instID[0]);
+        const auto instance_geometry = rtcGetGeometry(m_scene, inst_id);
         if (instance_geometry != nullptr)
         {
             void* user_data       = rtcGetGeometryUserData(instance_geometry);
@@ -236,19 +243,78 @@ void Embree_scene::intersect(Ray& ray, Hit& hit)
                 auto* embree_instance_scene = embree_instance->get_embree_scene();
                 if (embree_instance_scene != nullptr)
                 {
-                    hit.geometry = embree_instance_scene->get_geometry_from_id(ray_hit.hit.geomID);
+                    hit.geometry = embree_instance_scene->get_geometry_from_id(geom_id);
                 }
             }
         }
     }
     else
     {
-        hit.geometry = (ray_hit.hit.geomID != RTC_INVALID_GEOMETRY_ID)
-            ? get_geometry_from_id(ray_hit.hit.geomID)
+        hit.geometry = (geom_id != RTC_INVALID_GEOMETRY_ID)
+            ? get_geometry_from_id(geom_id)
             : nullptr;
     }
 }
 
+auto Embree_scene::intersect_n(std::span<Ray> rays, std::span<Hit> hits) -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION
+
+    static constexpr std::size_t packet_size = 8;
+
+    std::size_t hit_count = 0;
+    RTCIntersectContext context;
+    rtcInitIntersectContext(&context);
+    context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    for (std::size_t first = 0; first < rays.size(); first += packet_size)
+    {
+        const std::size_t count = std::min(packet_size, rays.size() - first);
+
+        alignas(32) int valid[packet_size];
+        alignas(32) RTCRayHit8 ray_hit;
+        for (std::size_t i = 0; i < packet_size; ++i)
+        {
+            const Ray& ray = rays[first + std::min(i, count - 1)];
+            valid[i]                = (i < count) ? -1 : 0;
+            ray_hit.ray.org_x[i]    = ray.origin.x;
+            ray_hit.ray.org_y[i]    = ray.origin.y;
+            ray_hit.ray.org_z[i]    = ray.origin.z;
+            ray_hit.ray.tnear[i]    = ray.t_near;
+            ray_hit.ray.dir_x[i]    = ray.direction.x;
+            ray_hit.ray.dir_y[i]    = ray.direction.y;
+            ray_hit.ray.dir_z[i]    = ray.direction.z;
+            ray_hit.ray.time[i]     = ray.time;
+            ray_hit.ray.tfar[i]     = ray.t_far;
+            ray_hit.ray.mask[i]     = ray.mask;
+            ray_hit.ray.id[i]       = ray.id;
+            ray_hit.ray.flags[i]    = 0;
+            ray_hit.hit.geomID[i]   = RTC_INVALID_GEOMETRY_ID;
+            ray_hit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+        }
+
+        SPDLOG_LOGGER_TRACE(log_embree, "rtcIntersect8({})", m_debug_label);
+        rtcIntersect8(valid, m_scene, &context, &ray_hit);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (ray_hit.hit.geomID[i] == RTC_INVALID_GEOMETRY_ID)
+            {
+                continue;
+            }
+            Ray& ray = rays[first + i];
+            Hit& hit = hits[first + i];
+            ray.t_far        = ray_hit.ray.tfar[i];
+            hit.normal       = glm::vec3{ray_hit.hit.Ng_x[i], ray_hit.hit.Ng_y[i], ray_hit.hit.Ng_z[i]};
+            hit.uv           = glm::vec2{ray_hit.hit.u[i], ray_hit.hit.v[i]};
+            hit.primitive_id = ray_hit.hit.primID[i];
+            set_hit_geometry(hit, ray_hit.hit.instID[0][i], ray_hit.hit.geomID[i]);
+            ++hit_count;
+        }
+    }
+    return hit_count;
+}
+
 //void Embree_scene::set_dirty()
 //{
 //    m_dirty = true;
@@ -48,11 +48,16 @@ public:
 
     void intersect(Ray& ray, Hit& out_hit) override;
 
+    // rtcIntersect8()
+    auto intersect_n(std::span<Ray> rays, std::span<Hit> hits) -> std::size_t override;
+
     //void set_dirty();
     auto get_rtc_scene() -> RTCScene;
     auto get_geometry_from_id(const unsigned int id) -> Embree_geometry*;
 
 private:
+    void set_hit_geometry(Hit& hit, unsigned int inst_id, unsigned int geom_id);
+
     RTCScene    m_scene{nullptr};
     std::string m_debug_label;
     //bool        m_dirty{true};
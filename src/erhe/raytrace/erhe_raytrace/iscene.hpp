@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <string_view>
 
 namespace erhe::raytrace {
@@ -21,6 +23,12 @@ public:
     virtual void detach   (IInstance* instance) = 0;
     virtual void commit   () = 0;
     virtual auto intersect(Ray& ray, Hit& hit) -> bool = 0;
+
+    // Intersects rays[i] and updates hits[i] for each ray, like intersect().
+    // Neighbouring rays should be coherent, as implementations may trace
+    // them together as packets, and large batches may be traced using
+    // multiple threads. Returns number of rays that hit.
+    virtual auto intersect_n(std::span<Ray> rays, std::span<Hit> hits) -> std::size_t = 0;
     [[nodiscard]] virtual auto debug_label() const -> std::string_view = 0;
 
     [[nodiscard]] static auto create       (const std::string_view debug_label) -> IScene*;
@@ -92,8 +92,14 @@ void Null_scene::commit()
 {
 }
 
-void Null_scene::intersect(Ray&, Hit&)
+auto Null_scene::intersect(Ray&, Hit&) -> bool
 {
+    return false;
+}
+
+auto Null_scene::intersect_n(std::span<Ray>, std::span<Hit>) -> std::size_t
+{
+    return 0;
 }
 
 auto Null_scene::debug_label() const -> std::string_view
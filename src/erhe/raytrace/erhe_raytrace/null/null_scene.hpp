@@ -18,12 +18,13 @@ public:
     ~Null_scene() noexcept override;
 
     // Implements IScene
-    void attach   (IGeometry* geometry) override;
-    void attach   (IInstance* instance) override;
-    void detach   (IGeometry* geometry) override;
-    void detach   (IInstance* geometry) override;
-    void commit   ()           override;
-    void intersect(Ray&, Hit&) override;
+    void attach     (IGeometry* geometry) override;
+    void attach     (IInstance* instance) override;
+    void detach     (IGeometry* geometry) override;
+    void detach     (IInstance* geometry) override;
+    void commit     ()           override;
+    auto intersect  (Ray&, Hit&) -> bool override;
+    auto intersect_n(std::span<Ray>, std::span<Hit>) -> std::size_t override;
     [[nodiscard]] auto debug_label() const -> std::string_view override;
 
 private:
@@ -24,6 +24,60 @@ Draw_indirect_buffer::Draw_indirect_buffer(erhe::graphics::Instance& graphics_in
     );
 }
 
+void Draw_indirect_buffer::write_mesh_draw_commands(
+    const erhe::scene::Mesh&              mesh,
+    const erhe::primitive::Primitive_mode primitive_mode,
+    const std::span<std::byte>            gpu_data,
+    std::size_t&                          draw_indirect_count
+)
+{
+    auto&             buffer        = current_buffer();
+    const std::size_t entry_size    = sizeof(gl::Draw_elements_indirect_command);
+    const uint32_t    instance_count{1};
+    const uint32_t    base_instance {0};
+
+    for (auto& primitive : mesh.get_primitives()) {
+        const erhe::primitive::Buffer_mesh& buffer_mesh = primitive.render_shape->get_renderable_mesh();
+        const erhe::primitive::Index_range  index_range = buffer_mesh.index_range(primitive_mode);
+        if (index_range.index_count == 0) {
+            continue;
+        }
+
+        if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
+            log_render->critical("draw indirect buffer capacity {} exceeded", buffer.capacity_byte_count());
+            ERHE_FATAL("draw indirect buffer capacity exceeded");
+            break;
+        }
+
+        uint32_t index_count = static_cast<uint32_t>(index_range.index_count);
+        if (m_max_index_count_enable) {
+            index_count = std::min(index_count, static_cast<uint32_t>(m_max_index_count));
+        }
+
+        const uint32_t base_index  = buffer_mesh.base_index();
+        const uint32_t first_index = static_cast<uint32_t>(index_range.first_index + base_index);
+        const uint32_t base_vertex = buffer_mesh.base_vertex();
+
+        const gl::Draw_elements_indirect_command draw_command{
+            index_count,
+            instance_count,
+            first_index,
+            base_vertex,
+            base_instance
+        };
+
+        erhe::graphics::write(
+            gpu_data,
+            m_writer.write_offset,
+            erhe::graphics::as_span(draw_command)
+        );
+
+        m_writer.write_offset += entry_size;
+        ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
+        ++draw_indirect_count;
+    }
+}
+
 auto Draw_indirect_buffer::update(
     const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
     erhe::primitive::Primitive_mode                            primitive_mode,
@@ -52,10 +106,8 @@ auto Draw_indirect_buffer::update(
     const std::size_t entry_size     = sizeof(gl::Draw_elements_indirect_command);
     const std::size_t max_byte_count = primitive_count * entry_size;
     const auto        gpu_data       = m_writer.begin(&buffer, max_byte_count);
-    uint32_t          instance_count     {1};
-    uint32_t          base_instance      {0};
     std::size_t       draw_indirect_count{0};
-    
+
     for (const auto& mesh : meshes) {
         const auto* node = mesh->get_node();
 
@@ -67,57 +119,45 @@ auto Draw_indirect_buffer::update(
             continue;
         }
 
-        if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-            log_render->critical("draw indirect buffer capacity {} exceeded", buffer.capacity_byte_count());
-            ERHE_FATAL("draw indirect buffer capacity exceeded");
-            break;
-        }
+        write_mesh_draw_commands(*mesh.get(), primitive_mode, gpu_data, draw_indirect_count);
+    }
+
+    m_writer.end();
+
+    SPDLOG_LOGGER_TRACE(log_draw, "wrote {} entries to draw indirect buffer", draw_indirect_count);
+    return { m_writer.range, draw_indirect_count };
+}
+
+auto Draw_indirect_buffer::update(
+    const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    const std::span<const uint32_t>                            mesh_indices,
+    const erhe::primitive::Primitive_mode                      primitive_mode
+) -> Draw_indirect_buffer_range
+{
+    ERHE_PROFILE_FUNCTION();
 
-        for (auto& primitive : mesh->get_primitives()) {
-            const erhe::primitive::Buffer_mesh& buffer_mesh = primitive.render_shape->get_renderable_mesh();
-            const erhe::primitive::Index_range  index_range = buffer_mesh.index_range(primitive_mode);
-            if (index_range.index_count == 0) {
-                continue;
-            }
-
-            if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-                log_render->critical("draw indirect buffer capacity {} exceeded", buffer.capacity_byte_count());
-                ERHE_FATAL("draw indirect buffer capacity exceeded");
-                break;
-            }
-
-            uint32_t index_count = static_cast<uint32_t>(index_range.index_count);
-            if (m_max_index_count_enable) {
-                index_count = std::min(index_count, static_cast<uint32_t>(m_max_index_count));
-            }
-
-            const uint32_t base_index  = buffer_mesh.base_index();
-            const uint32_t first_index = static_cast<uint32_t>(index_range.first_index + base_index);
-            const uint32_t base_vertex = buffer_mesh.base_vertex();
-
-            const gl::Draw_elements_indirect_command draw_command{
-                index_count,
-                instance_count,
-                first_index,
-                base_vertex,
-                base_instance
-            };
-
-            erhe::graphics::write(
-                gpu_data,
-                m_writer.write_offset,
-                erhe::graphics::as_span(draw_command)
-            );
-
-            m_writer.write_offset += entry_size;
-            ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
-            ++draw_indirect_count;
+    // Conservative upper limit
+    std::size_t primitive_count = 0;
+    for (const uint32_t i : mesh_indices) {
+        primitive_count += meshes[i]->get_primitives().size();
+    }
+
+    auto&             buffer         = current_buffer();
+    const std::size_t entry_size     = sizeof(gl::Draw_elements_indirect_command);
+    const std::size_t max_byte_count = primitive_count * entry_size;
+    const auto        gpu_data       = m_writer.begin(&buffer, max_byte_count);
+    std::size_t       draw_indirect_count{0};
+
+    for (const uint32_t i : mesh_indices) {
+        const erhe::scene::Mesh& mesh = *meshes[i].get();
+        if (mesh.get_node() == nullptr) {
+            continue;
         }
+        write_mesh_draw_commands(mesh, primitive_mode, gpu_data, draw_indirect_count);
     }
 
     m_writer.end();
 
-    SPDLOG_LOGGER_TRACE(log_draw, "wrote {} entries to draw indirect buffer", draw_indirect_count);
     return { m_writer.range, draw_indirect_count };
 }
 
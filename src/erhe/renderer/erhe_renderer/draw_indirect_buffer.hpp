@@ -3,6 +3,7 @@
 #include "erhe_renderer/multi_buffer.hpp"
 #include "erhe_primitive/enums.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <span>
 
@@ -34,9 +35,24 @@ public:
         const erhe::Item_filter&                                   filter
     ) -> Draw_indirect_buffer_range;
 
+    // Writes draw commands for meshes selected by mesh_indices. Filtering is
+    // done by the caller.
+    auto update(
+        const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+        std::span<const uint32_t>                                  mesh_indices,
+        erhe::primitive::Primitive_mode                            primitive_mode
+    ) -> Draw_indirect_buffer_range;
+
     //// void debug_properties_window();
 
 private:
+    void write_mesh_draw_commands(
+        const erhe::scene::Mesh&        mesh,
+        erhe::primitive::Primitive_mode primitive_mode,
+        std::span<std::byte>            gpu_data,
+        std::size_t&                    draw_indirect_count
+    );
+
     bool m_max_index_count_enable{false};
     int  m_max_index_count       {256};
     int  m_max_draw_count        {8000};
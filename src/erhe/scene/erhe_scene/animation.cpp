@@ -4,6 +4,8 @@
 #include "erhe_bit/bit_helpers.hpp"
 #include "erhe_verify/verify.hpp"
 
+#include <algorithm>
+
 namespace erhe::scene {
 
 auto get_component_count(const Animation_path path) -> std::size_t
@@ -16,7 +18,7 @@ auto get_component_count(const Animation_path path) -> std::size_t
     }
 }
 
-[[nodiscard]] auto get_key_value_count(const Animation_interpolation_mode interpolation_mode) -> std::size_t
+auto get_key_value_count(const Animation_interpolation_mode interpolation_mode) -> std::size_t
 {
     switch (interpolation_mode) {
         case Animation_interpolation_mode::STEP:        return 1; // value
@@ -120,40 +122,31 @@ public:
     float s3; // coefficient for end tangent
 };
 
-void Animation_sampler::seek(Animation_channel& channel, const float time) const
+auto Animation_sampler::find_keyframe(const std::size_t hint, const float time) const -> std::size_t
 {
-    if (timestamps.empty()) {
-        return;
-    }
-
-    if (timestamps[channel.start_position] == time) {
-        return;
+    const std::size_t count = timestamps.size();
+    if ((count == 0) || (time <= timestamps[0])) {
+        return 0;
     }
 
-    while (time < timestamps[channel.start_position]) {
-        if (channel.start_position > 0) {
-            --channel.start_position;
-            continue;
+    // Playback usually stays on the same keyframe or advances to the next one
+    if (hint < count && (timestamps[hint] <= time)) {
+        if ((hint + 1 == count) || (time < timestamps[hint + 1])) {
+            return hint;
+        }
+        if ((hint + 2 == count) || (time < timestamps[hint + 2])) {
+            return hint + 1;
         }
-        return;
     }
 
-    if (timestamps[channel.start_position] == time) {
-        return;
-    }
+    // Last keyframe with timestamp <= time
+    const auto i = std::upper_bound(timestamps.begin(), timestamps.end(), time);
+    return static_cast<std::size_t>(std::distance(timestamps.begin(), i)) - 1;
+}
 
-    std::size_t end = timestamps.size();
-    for (;;) {
-        std::size_t next = channel.start_position + 1;
-        if (next == end) {
-            return;
-        }
-        if (time >= timestamps[next]) {
-            channel.start_position = next;
-            continue;
-        }
-        break;
-    }
+void Animation_sampler::seek(Animation_channel& channel, const float time) const
+{
+    channel.start_position = find_keyframe(channel.start_position, time);
 }
 
 auto Animation_sampler::evaluate(Animation_channel& channel, float time_current) const -> glm::vec4
@@ -249,33 +242,62 @@ auto Animation_sampler::evaluate(Animation_channel& channel, float time_current)
     return vec4{0.0f, 0.0f, 0.0f, 0.0f};
 }
 
-void Animation_sampler::apply(Animation_channel& channel, const float time_current) const
+auto Animation_sampler::get_weight_count() const -> std::size_t
 {
-    seek(channel, time_current);
+    const std::size_t key_value_count = get_key_value_count(interpolation_mode);
+    if (timestamps.empty() || (key_value_count == 0)) {
+        return 0;
+    }
+    return data.size() / (timestamps.size() * key_value_count);
+}
 
-    Trs_transform& target = channel.target->node_data.transforms.parent_from_node;
+void Animation_sampler::evaluate_weights(Animation_channel& channel, const float time_current, const std::span<float> out_weights) const
+{
+    const std::size_t weight_count    = out_weights.size();
+    const std::size_t key_value_count = get_key_value_count(interpolation_mode);
+    const std::size_t stride          = weight_count * key_value_count;
+    if ((weight_count == 0) || timestamps.empty() || (data.size() < timestamps.size() * stride)) {
+        return;
+    }
 
-    const glm::vec4 value = evaluate(channel, time_current);
+    seek(channel, time_current);
 
-    switch (channel.path) {
-        case Animation_path::TRANSLATION: {
-            target.set_translation(glm::vec3{value});
-            break;
-        }
-        case Animation_path::ROTATION: {
-            target.set_rotation(glm::quat{value.w, value.x, value.y, value.z});
-            break;
+    const std::size_t key    = channel.start_position;
+    const std::size_t offset = key * stride + channel.value_offset;
+    if (
+        (interpolation_mode == Animation_interpolation_mode::STEP) ||
+        (key + 1 >= timestamps.size()) ||
+        (time_current <= timestamps[key])
+    ) {
+        for (std::size_t i = 0; i < weight_count; ++i) {
+            out_weights[i] = data[offset + i];
         }
+        return;
+    }
 
-        case Animation_path::SCALE: {
-            target.set_scale(glm::vec3{value});
-            break;
+    const std::size_t next_offset = offset + stride;
+    const float       t_d         = timestamps[key + 1] - timestamps[key];
+    const float       t           = (time_current - timestamps[key]) / t_d;
+    if (interpolation_mode != Animation_interpolation_mode::CUBICSPLINE) {
+        for (std::size_t i = 0; i < weight_count; ++i) {
+            out_weights[i] = glm::mix(data[offset + i], data[next_offset + i], t);
         }
+        return;
+    }
 
-        default: {
-            // TODO
-            break;
-        }
+    // Keyframe layout is in-tangents, values, out-tangents; value_offset
+    // is weight_count. Tangents are scaled by keyframe duration.
+    const Cubic_constants cubic{t};
+    for (std::size_t i = 0; i < weight_count; ++i) {
+        const float start_value       = data[offset + i];
+        const float start_out_tangent = data[offset + weight_count + i] * t_d;
+        const float next_in_tangent   = data[next_offset - weight_count + i] * t_d;
+        const float next_value        = data[next_offset + i];
+        out_weights[i] =
+            cubic.s0 * start_value       +
+            cubic.s1 * start_out_tangent +
+            cubic.s2 * next_value        +
+            cubic.s3 * next_in_tangent;
     }
 }
 
@@ -310,16 +332,13 @@ auto Animation::evaluate(const float time_current, const std::size_t channel_ind
 {
     auto& channel = channels.at(channel_index);
     auto& sampler = samplers.at(channel.sampler_index);
+    if (channel.path == Animation_path::WEIGHTS) {
+        std::vector<float> weights(sampler.get_weight_count(), 0.0f);
+        sampler.evaluate_weights(channel, time_current, weights);
+        return (component < weights.size()) ? weights[component] : 0.0f;
+    }
     const glm::vec4 value = sampler.evaluate(channel, time_current);
     return value[static_cast<glm::vec4::length_type>(component)];
 }
 
-void Animation::apply(float time_current)
-{
-    for (auto& channel : channels) {
-        auto& sampler = samplers.at(channel.sampler_index);
-        sampler.apply(channel, time_current);
-    }
-}
-
 } // namespace erhe::scene
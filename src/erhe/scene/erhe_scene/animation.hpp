@@ -4,6 +4,7 @@
 
 #include <glm/glm.hpp>
 
+#include <span>
 #include <string>
 
 namespace erhe::scene {
@@ -30,6 +31,7 @@ enum class Animation_interpolation_mode : int {
 [[nodiscard]] auto c_str(Animation_interpolation_mode interpolation_mode) -> const char*;
 
 [[nodiscard]] auto get_component_count(const Animation_path path) -> std::size_t;
+[[nodiscard]] auto get_key_value_count(const Animation_interpolation_mode interpolation_mode) -> std::size_t;
 
 class Animation_channel;
 
@@ -44,8 +46,16 @@ public:
 
     [[nodiscard]] auto evaluate(Animation_channel& channel, float time_current) const -> glm::vec4;
 
-    void apply(Animation_channel& channel, float time_current) const;
-    void seek (Animation_channel& channel, float time_current) const;
+    // Morph target weights (Animation_path::WEIGHTS) have one component per
+    // morph target, so they are evaluated to a span instead of a vec4.
+    [[nodiscard]] auto get_weight_count() const -> std::size_t;
+    void evaluate_weights(Animation_channel& channel, float time_current, std::span<float> out_weights) const;
+
+    void seek(Animation_channel& channel, float time_current) const;
+
+    // Returns index of last keyframe with timestamp <= time, or 0 if time is
+    // before first keyframe. hint is checked first, then binary search is used.
+    [[nodiscard]] auto find_keyframe(std::size_t hint, float time) const -> std::size_t;
 
     Animation_interpolation_mode interpolation_mode{Animation_interpolation_mode::LINEAR};
     std::vector<float>           timestamps;
@@ -78,8 +88,8 @@ public:
     auto get_type_name() const -> std::string_view override;
 
     // Public API
+    // Animations are applied to nodes with Animation_batch
     [[nodiscard]] auto evaluate(float time_current, std::size_t channel_index, std::size_t component) -> float;
-    void apply(float time_current);
 
     std::vector<Animation_sampler> samplers;
     std::vector<Animation_channel> channels;
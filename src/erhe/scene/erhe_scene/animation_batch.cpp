@@ -0,0 +1,430 @@
+#include "erhe_scene/animation_batch.hpp"
+
+#include "erhe_scene/mesh.hpp"
+#include "erhe_scene/node.hpp"
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace erhe::scene {
+
+namespace {
+
+// Minimum number of tracks or poses per task when evaluating in parallel
+constexpr std::size_t s_track_grain = 256;
+
+template <typename F>
+void for_each_range(erhe::concurrency::Thread_pool* const thread_pool, const std::size_t count, const char* name, F&& f)
+{
+    if (count == 0) {
+        return;
+    }
+    if ((thread_pool == nullptr) || (count < 2 * s_track_grain)) {
+        f(std::size_t{0}, count);
+        return;
+    }
+    erhe::concurrency::Concurrent_queue queue{*thread_pool, name};
+    queue.enqueue_range(0, count, s_track_grain, std::forward<F>(f));
+    queue.wait();
+}
+
+// Selects keyframes for time and returns offset of start value in sampler
+// data. out_next_offset is set to offset of end value, and out_t to
+// interpolation parameter (0 when there is no end keyframe).
+[[nodiscard]] auto find_keyframes(
+    const Animation_sampler& sampler,
+    std::size_t&             cursor,
+    const std::size_t        stride,
+    const std::size_t        value_offset,
+    const bool               step,
+    const float              time,
+    std::size_t&             out_next_offset,
+    float&                   out_t
+) -> std::size_t
+{
+    const std::vector<float>& timestamps = sampler.timestamps;
+    const std::size_t         key        = sampler.find_keyframe(cursor, time);
+    const std::size_t         offset     = key * stride + value_offset;
+    cursor          = key;
+    out_next_offset = offset;
+    out_t           = 0.0f;
+    if (!step && (key + 1 < timestamps.size()) && (time > timestamps[key])) {
+        out_next_offset = offset + stride;
+        out_t           = (time - timestamps[key]) / (timestamps[key + 1] - timestamps[key]);
+    }
+    return offset;
+}
+
+}
+
+void Animation_batch::Vec3_lanes::resize(const std::size_t count)
+{
+    for (std::vector<float>* lane : {&x0, &y0, &z0, &x1, &y1, &z1, &t}) {
+        lane->resize(count);
+    }
+}
+
+void Animation_batch::Quat_lanes::resize(const std::size_t count)
+{
+    for (std::vector<float>* lane : {&x0, &y0, &z0, &w0, &x1, &y1, &z1, &w1, &t}) {
+        lane->resize(count);
+    }
+}
+
+void Animation_batch::set_thread_pool(erhe::concurrency::Thread_pool* const thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+void Animation_batch::clear()
+{
+    m_animations   .clear();
+    m_times        .clear();
+    m_vec3_tracks  .clear();
+    m_quat_tracks  .clear();
+    m_cubic_tracks .clear();
+    m_cubic_values .clear();
+    m_weight_tracks.clear();
+    m_weight_values.clear();
+    m_poses        .clear();
+    m_pose_indices .clear();
+}
+
+auto Animation_batch::get_pose_index(const std::shared_ptr<Node>& node) -> uint32_t
+{
+    const auto i = m_pose_indices.find(node.get());
+    if (i != m_pose_indices.end()) {
+        return i->second;
+    }
+    const uint32_t pose_index = static_cast<uint32_t>(m_poses.size());
+    const Trs_transform& trs = node->node_data.transforms.parent_from_node;
+    m_poses.push_back(
+        Pose{
+            .node        = node,
+            .translation = trs.get_translation(),
+            .rotation    = trs.get_rotation(),
+            .scale       = trs.get_scale()
+        }
+    );
+    m_pose_indices.emplace(node.get(), pose_index);
+    return pose_index;
+}
+
+auto Animation_batch::add(const std::shared_ptr<Animation>& animation) -> std::size_t
+{
+    ERHE_VERIFY(animation);
+
+    const std::size_t animation_index = m_animations.size();
+    m_animations.push_back(animation);
+    m_times     .push_back(0.0f);
+
+    for (const Animation_channel& channel : animation->channels) {
+        if (!channel.target || (channel.sampler_index >= animation->samplers.size())) {
+            continue;
+        }
+        const Animation_sampler& sampler = animation->samplers[channel.sampler_index];
+        if (channel.path == Animation_path::WEIGHTS) {
+            std::shared_ptr<Mesh> mesh         = get_mesh(channel.target.get());
+            const std::size_t     weight_count = sampler.get_weight_count();
+            if (!mesh || (weight_count == 0)) {
+                continue;
+            }
+            m_weight_tracks.push_back(
+                Weight_track{
+                    .sampler         = &sampler,
+                    .channel         = channel,
+                    .mesh            = std::move(mesh),
+                    .first_value     = m_weight_values.size(),
+                    .weight_count    = weight_count,
+                    .animation_index = static_cast<uint32_t>(animation_index)
+                }
+            );
+            m_weight_values.resize(m_weight_values.size() + weight_count, 0.0f);
+            continue;
+        }
+
+        const std::size_t component_count = get_component_count(channel.path);
+        const std::size_t stride          = component_count * get_key_value_count(sampler.interpolation_mode);
+        if (
+            (component_count == 0) ||
+            (stride == 0) ||
+            sampler.timestamps.empty() ||
+            (sampler.data.size() < sampler.timestamps.size() * stride) ||
+            (channel.value_offset + component_count > stride)
+        ) {
+            continue;
+        }
+
+        const uint32_t pose_index = get_pose_index(channel.target);
+        if (sampler.interpolation_mode == Animation_interpolation_mode::CUBICSPLINE) {
+            m_cubic_tracks.push_back(
+                Cubic_track{
+                    .sampler         = &sampler,
+                    .channel         = channel,
+                    .animation_index = static_cast<uint32_t>(animation_index),
+                    .pose_index      = pose_index
+                }
+            );
+            continue;
+        }
+
+        const Track track{
+            .sampler         = &sampler,
+            .value_offset    = channel.value_offset,
+            .stride          = stride,
+            .cursor          = 0,
+            .animation_index = static_cast<uint32_t>(animation_index),
+            .pose_index      = pose_index,
+            .pose_bit        =
+                (channel.path == Animation_path::TRANSLATION) ? c_translation_bit :
+                (channel.path == Animation_path::ROTATION   ) ? c_rotation_bit    : c_scale_bit,
+            .step            = (sampler.interpolation_mode == Animation_interpolation_mode::STEP)
+        };
+        if (channel.path == Animation_path::ROTATION) {
+            m_quat_tracks.push_back(track);
+        } else {
+            m_vec3_tracks.push_back(track);
+        }
+    }
+
+    m_vec3_lanes  .resize(m_vec3_tracks.size());
+    m_quat_lanes  .resize(m_quat_tracks.size());
+    m_cubic_values.resize(m_cubic_tracks.size());
+    return animation_index;
+}
+
+void Animation_batch::set_time(const std::size_t animation_index, const float time)
+{
+    m_times.at(animation_index) = time;
+}
+
+auto Animation_batch::get_animation_count() const -> std::size_t
+{
+    return m_animations.size();
+}
+
+auto Animation_batch::get_track_count() const -> std::size_t
+{
+    return m_vec3_tracks.size() + m_quat_tracks.size() + m_cubic_tracks.size() + m_weight_tracks.size();
+}
+
+auto Animation_batch::get_pose_count() const -> std::size_t
+{
+    return m_poses.size();
+}
+
+void Animation_batch::evaluate_vec3_tracks(const std::size_t first, const std::size_t last)
+{
+    Vec3_lanes& lanes = m_vec3_lanes;
+    for (std::size_t i = first; i < last; ++i) {
+        Track&       track = m_vec3_tracks[i];
+        const float* data  = track.sampler->data.data();
+        std::size_t  next_offset{0};
+        float        t{0.0f};
+        const std::size_t offset = find_keyframes(
+            *track.sampler, track.cursor, track.stride, track.value_offset, track.step,
+            m_times[track.animation_index], next_offset, t
+        );
+        lanes.x0[i] = data[offset         ];
+        lanes.y0[i] = data[offset      + 1];
+        lanes.z0[i] = data[offset      + 2];
+        lanes.x1[i] = data[next_offset    ];
+        lanes.y1[i] = data[next_offset + 1];
+        lanes.z1[i] = data[next_offset + 2];
+        lanes.t [i] = t;
+    }
+
+    // Lerp, result is written to x0, y0, z0
+    float* const       x0 = lanes.x0.data();
+    float* const       y0 = lanes.y0.data();
+    float* const       z0 = lanes.z0.data();
+    const float* const x1 = lanes.x1.data();
+    const float* const y1 = lanes.y1.data();
+    const float* const z1 = lanes.z1.data();
+    const float* const t  = lanes.t .data();
+    for (std::size_t i = first; i < last; ++i) {
+        x0[i] += t[i] * (x1[i] - x0[i]);
+        y0[i] += t[i] * (y1[i] - y0[i]);
+        z0[i] += t[i] * (z1[i] - z0[i]);
+    }
+}
+
+void Animation_batch::evaluate_quat_tracks(const std::size_t first, const std::size_t last)
+{
+    Quat_lanes& lanes = m_quat_lanes;
+    for (std::size_t i = first; i < last; ++i) {
+        Track&       track = m_quat_tracks[i];
+        const float* data  = track.sampler->data.data();
+        std::size_t  next_offset{0};
+        float        t{0.0f};
+        const std::size_t offset = find_keyframes(
+            *track.sampler, track.cursor, track.stride, track.value_offset, track.step,
+            m_times[track.animation_index], next_offset, t
+        );
+        lanes.x0[i] = data[offset         ];
+        lanes.y0[i] = data[offset      + 1];
+        lanes.z0[i] = data[offset      + 2];
+        lanes.w0[i] = data[offset      + 3];
+        lanes.x1[i] = data[next_offset    ];
+        lanes.y1[i] = data[next_offset + 1];
+        lanes.z1[i] = data[next_offset + 2];
+        lanes.w1[i] = data[next_offset + 3];
+        lanes.t [i] = t;
+    }
+
+    // Shortest path slerp, matching glm::slerp(); result is written to x0, y0, z0, w0
+    constexpr float    one_minus_epsilon = 1.0f - std::numeric_limits<float>::epsilon();
+    float* const       x0 = lanes.x0.data();
+    float* const       y0 = lanes.y0.data();
+    float* const       z0 = lanes.z0.data();
+    float* const       w0 = lanes.w0.data();
+    const float* const x1 = lanes.x1.data();
+    const float* const y1 = lanes.y1.data();
+    const float* const z1 = lanes.z1.data();
+    const float* const w1 = lanes.w1.data();
+    const float* const t  = lanes.t .data();
+    for (std::size_t i = first; i < last; ++i) {
+        const float d         = x0[i] * x1[i] + y0[i] * y1[i] + z0[i] * z1[i] + w0[i] * w1[i];
+        const float sign      = (d < 0.0f) ? -1.0f : 1.0f;
+        const float cos_theta = sign * d;
+        const float theta     = std::acos(std::min(cos_theta, one_minus_epsilon));
+        const float sin_theta = std::sin(theta);
+        const bool  use_lerp  = cos_theta > one_minus_epsilon;
+        const float s0        = use_lerp ? 1.0f - t[i] : std::sin((1.0f - t[i]) * theta) / sin_theta;
+        const float s1        = sign * (use_lerp ? t[i] : std::sin(t[i] * theta) / sin_theta);
+        x0[i] = s0 * x0[i] + s1 * x1[i];
+        y0[i] = s0 * y0[i] + s1 * y1[i];
+        z0[i] = s0 * z0[i] + s1 * z1[i];
+        w0[i] = s0 * w0[i] + s1 * w1[i];
+    }
+}
+
+void Animation_batch::evaluate_cubic_tracks(const std::size_t first, const std::size_t last)
+{
+    for (std::size_t i = first; i < last; ++i) {
+        Cubic_track& track = m_cubic_tracks[i];
+        m_cubic_values[i] = track.sampler->evaluate(track.channel, m_times[track.animation_index]);
+    }
+}
+
+void Animation_batch::evaluate_weight_tracks(const std::size_t first, const std::size_t last)
+{
+    for (std::size_t i = first; i < last; ++i) {
+        Weight_track&          track = m_weight_tracks[i];
+        const std::span<float> weights{m_weight_values.data() + track.first_value, track.weight_count};
+        track.sampler->evaluate_weights(track.channel, m_times[track.animation_index], weights);
+    }
+}
+
+void Animation_batch::evaluate()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    {
+        ERHE_PROFILE_SCOPE("tracks");
+
+        for_each_range(m_thread_pool, m_vec3_tracks.size(), "animation_vec3", [this](const std::size_t first, const std::size_t last) {
+            evaluate_vec3_tracks(first, last);
+        });
+        for_each_range(m_thread_pool, m_quat_tracks.size(), "animation_quat", [this](const std::size_t first, const std::size_t last) {
+            evaluate_quat_tracks(first, last);
+        });
+        for_each_range(m_thread_pool, m_cubic_tracks.size(), "animation_cubic", [this](const std::size_t first, const std::size_t last) {
+            evaluate_cubic_tracks(first, last);
+        });
+        for_each_range(m_thread_pool, m_weight_tracks.size(), "animation_weights", [this](const std::size_t first, const std::size_t last) {
+            evaluate_weight_tracks(first, last);
+        });
+    }
+
+    // Scatter to pose buffer serially, so that if several channels target
+    // same node and path, the result does not depend on scheduling.
+    ERHE_PROFILE_SCOPE("scatter");
+    for (std::size_t i = 0, end = m_vec3_tracks.size(); i < end; ++i) {
+        const Track& track = m_vec3_tracks[i];
+        Pose&        pose  = m_poses[track.pose_index];
+        const glm::vec3 value{m_vec3_lanes.x0[i], m_vec3_lanes.y0[i], m_vec3_lanes.z0[i]};
+        if (track.pose_bit == c_translation_bit) {
+            pose.translation = value;
+        } else {
+            pose.scale = value;
+        }
+        pose.written |= track.pose_bit;
+    }
+    for (std::size_t i = 0, end = m_quat_tracks.size(); i < end; ++i) {
+        Pose& pose = m_poses[m_quat_tracks[i].pose_index];
+        pose.rotation = glm::quat{m_quat_lanes.w0[i], m_quat_lanes.x0[i], m_quat_lanes.y0[i], m_quat_lanes.z0[i]};
+        pose.written |= c_rotation_bit;
+    }
+    for (std::size_t i = 0, end = m_cubic_tracks.size(); i < end; ++i) {
+        const Cubic_track& track = m_cubic_tracks[i];
+        const glm::vec4&   value = m_cubic_values[i];
+        Pose&              pose  = m_poses[track.pose_index];
+        switch (track.channel.path) {
+            case Animation_path::TRANSLATION: {
+                pose.translation = glm::vec3{value};
+                pose.written |= c_translation_bit;
+                break;
+            }
+            case Animation_path::ROTATION: {
+                pose.rotation = glm::quat{value.w, value.x, value.y, value.z};
+                pose.written |= c_rotation_bit;
+                break;
+            }
+            case Animation_path::SCALE: {
+                pose.scale = glm::vec3{value};
+                pose.written |= c_scale_bit;
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+void Animation_batch::compose_poses(const std::size_t first, const std::size_t last)
+{
+    for (std::size_t i = first; i < last; ++i) {
+        const Pose& pose = m_poses[i];
+        if (pose.written == 0) {
+            continue;
+        }
+        Trs_transform& trs = pose.node->node_data.transforms.parent_from_node;
+        trs.set_trs(
+            ((pose.written & c_translation_bit) != 0) ? pose.translation : trs.get_translation(),
+            ((pose.written & c_rotation_bit   ) != 0) ? pose.rotation    : trs.get_rotation(),
+            ((pose.written & c_scale_bit      ) != 0) ? pose.scale       : trs.get_scale()
+        );
+    }
+}
+
+void Animation_batch::commit()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Nodes are distinct, so transforms can be composed in parallel.
+    // Marking nodes dirty updates scene state and is done serially.
+    for_each_range(m_thread_pool, m_poses.size(), "animation_commit", [this](const std::size_t first, const std::size_t last) {
+        compose_poses(first, last);
+    });
+    for (Pose& pose : m_poses) {
+        if (pose.written == 0) {
+            continue;
+        }
+        if (!pose.node->mark_transform_dirty()) {
+            pose.node->handle_transform_update(Node_transforms::get_next_serial());
+        }
+        pose.written = 0;
+    }
+    for (const Weight_track& track : m_weight_tracks) {
+        const float* const weights = m_weight_values.data() + track.first_value;
+        track.mesh->morph_weights.assign(weights, weights + track.weight_count);
+    }
+}
+
+} // namespace erhe::scene
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "erhe_scene/animation.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::concurrency {
+    class Thread_pool;
+}
+
+namespace erhe::scene {
+
+class Mesh;
+class Node;
+
+// Evaluates channels of many animations together. Channels are flattened
+// into tracks when animations are added. evaluate() finds keyframes (cached
+// cursor, then binary search) and interpolates linear and step tracks over
+// structure of arrays lane data, writing results into a pose buffer with
+// one entry per target node. commit() writes each pose entry to its node
+// once, so node transform matrices are composed once per node instead of
+// once per channel. Morph target weight tracks are written to the mesh
+// attached to the target node.
+//
+// Tracks reference animation samplers; if animations are modified after
+// add(), call clear() and add() them again.
+class Animation_batch
+{
+public:
+    void set_thread_pool(erhe::concurrency::Thread_pool* thread_pool);
+
+    void clear();
+
+    // Returns animation index, for set_time()
+    auto add     (const std::shared_ptr<Animation>& animation) -> std::size_t;
+    void set_time(std::size_t animation_index, float time);
+
+    void evaluate();
+    void commit  ();
+
+    [[nodiscard]] auto get_animation_count() const -> std::size_t;
+    [[nodiscard]] auto get_track_count    () const -> std::size_t;
+    [[nodiscard]] auto get_pose_count     () const -> std::size_t;
+
+private:
+    static constexpr uint8_t c_translation_bit{1u << 0u};
+    static constexpr uint8_t c_rotation_bit   {1u << 1u};
+    static constexpr uint8_t c_scale_bit      {1u << 2u};
+
+    class Track
+    {
+    public:
+        const Animation_sampler* sampler        {nullptr};
+        std::size_t              value_offset   {0};
+        std::size_t              stride         {0}; // floats per keyframe
+        std::size_t              cursor         {0}; // keyframe from previous evaluate()
+        uint32_t                 animation_index{0};
+        uint32_t                 pose_index     {0};
+        uint8_t                  pose_bit       {0};
+        bool                     step           {false};
+    };
+
+    class Cubic_track
+    {
+    public:
+        const Animation_sampler* sampler        {nullptr};
+        Animation_channel        channel;
+        uint32_t                 animation_index{0};
+        uint32_t                 pose_index     {0};
+    };
+
+    class Weight_track
+    {
+    public:
+        const Animation_sampler* sampler        {nullptr};
+        Animation_channel        channel;
+        std::shared_ptr<Mesh>    mesh;
+        std::size_t              first_value    {0}; // in m_weight_values
+        std::size_t              weight_count   {0};
+        uint32_t                 animation_index{0};
+    };
+
+    class Pose
+    {
+    public:
+        std::shared_ptr<Node> node;
+        glm::vec3             translation{0.0f};
+        glm::quat             rotation   {1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3             scale      {1.0f};
+        uint8_t               written    {0}; // c_translation_bit | c_rotation_bit | c_scale_bit
+    };
+
+    // Lane data for linear and step tracks; start and end values and
+    // interpolation parameter are gathered, then interpolated in place.
+    class Vec3_lanes
+    {
+    public:
+        void resize(std::size_t count);
+
+        std::vector<float> x0, y0, z0;
+        std::vector<float> x1, y1, z1;
+        std::vector<float> t;
+    };
+
+    class Quat_lanes
+    {
+    public:
+        void resize(std::size_t count);
+
+        std::vector<float> x0, y0, z0, w0;
+        std::vector<float> x1, y1, z1, w1;
+        std::vector<float> t;
+    };
+
+    [[nodiscard]] auto get_pose_index(const std::shared_ptr<Node>& node) -> uint32_t;
+
+    void evaluate_vec3_tracks  (std::size_t first, std::size_t last);
+    void evaluate_quat_tracks  (std::size_t first, std::size_t last);
+    void evaluate_cubic_tracks (std::size_t first, std::size_t last);
+    void evaluate_weight_tracks(std::size_t first, std::size_t last);
+    void compose_poses         (std::size_t first, std::size_t last);
+
+    erhe::concurrency::Thread_pool*           m_thread_pool{nullptr};
+    std::vector<std::shared_ptr<Animation>>   m_animations;
+    std::vector<float>                        m_times;
+    std::vector<Track>                        m_vec3_tracks;  // translation and scale
+    std::vector<Track>                        m_quat_tracks;  // rotation
+    std::vector<Cubic_track>                  m_cubic_tracks;
+    std::vector<glm::vec4>                    m_cubic_values;
+    std::vector<Weight_track>                 m_weight_tracks;
+    std::vector<float>                        m_weight_values;
+    Vec3_lanes                                m_vec3_lanes;
+    Quat_lanes                                m_quat_lanes;
+    std::vector<Pose>                         m_poses;
+    std::unordered_map<const Node*, uint32_t> m_pose_indices;
+};
+
+} // namespace erhe::scene
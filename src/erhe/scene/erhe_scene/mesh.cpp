@@ -83,11 +83,12 @@ Mesh::Mesh(const std::string_view name, const erhe::primitive::Primitive& primit
 }
 
 Mesh::Mesh(const Mesh& src, erhe::for_clone)
-    : Item      {src}
-    , layer_id  {src.layer_id}
-    , skin      {src.skin}
-    , point_size{src.point_size}
-    , line_width{src.line_width}
+    : Item         {src}
+    , layer_id     {src.layer_id}
+    , skin         {src.skin}
+    , point_size   {src.point_size}
+    , line_width   {src.line_width}
+    , morph_weights{src.morph_weights}
 {
     set_primitives(src.get_primitives());
 }
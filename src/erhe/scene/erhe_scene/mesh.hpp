@@ -66,6 +66,7 @@ public:
     std::shared_ptr<Skin> skin; // TODO Make this a separate node attachment
     float                 point_size{3.0f};
     float                 line_width{1.0f};
+    std::vector<float>    morph_weights; // shared by all primitives with morph targets
 
 private:
 
@@ -259,6 +259,12 @@ void Node::handle_parent_update(erhe::Hierarchy* const old_parent_item, erhe::Hi
     erhe::Item_host* const new_item_host = (new_parent != nullptr) ? new_parent->get_item_host() : nullptr;
     if (old_item_host != new_item_host) {
         handle_item_host_update(old_item_host, new_item_host);
+    } else {
+        // Depth and parent have changed within the same scene
+        Scene* const scene = get_scene();
+        if (scene != nullptr) {
+            scene->mark_nodes_unsorted();
+        }
     }
 
     hierarchy_sanity_check();
@@ -360,6 +366,20 @@ void Node::update_transform(uint64_t serial)
     }
 }
 
+auto Node::mark_transform_dirty() -> bool
+{
+    Scene* const scene = get_scene();
+    return (scene != nullptr) && scene->mark_transform_dirty(*this);
+}
+
+void Node::update_world_from_node(const Node& parent)
+{
+    node_data.transforms.world_from_node.set(
+        parent.world_from_node() * parent_from_node(),
+        node_from_parent() * parent.node_from_world()
+    );
+}
+
 void Node::update_world_from_node()
 {
     const auto& current_parent = get_parent_node();
@@ -521,7 +541,9 @@ void Node::set_parent_from_node(const glm::mat4 parent_from_node)
 {
     node_data.transforms.parent_from_node.set(parent_from_node);
     update_world_from_node();
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 void Node::set_parent_from_node(const Transform& parent_from_node)
@@ -533,7 +555,9 @@ void Node::set_parent_from_node(const Transform& parent_from_node)
         parent_from_node.get_inverse_matrix()
     );
     update_world_from_node();
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 void Node::set_node_from_parent(const glm::mat4 node_from_parent)
@@ -543,7 +567,9 @@ void Node::set_node_from_parent(const glm::mat4 node_from_parent)
         node_from_parent
     );
     update_world_from_node();
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 void Node::set_node_from_parent(const Transform& node_from_parent)
@@ -553,7 +579,9 @@ void Node::set_node_from_parent(const Transform& node_from_parent)
         node_from_parent.get_matrix()
     );
     update_world_from_node();
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 void Node::set_world_from_node(const glm::mat4 world_from_node)
@@ -591,7 +619,9 @@ void Node::set_node_from_world(const glm::mat4 node_from_world)
     } else {
         node_data.transforms.parent_from_node = node_data.transforms.world_from_node;
     }
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 void Node::set_node_from_world(const Transform& node_from_world)
@@ -609,7 +639,9 @@ void Node::set_node_from_world(const Transform& node_from_world)
     } else {
         node_data.transforms.parent_from_node = node_data.transforms.world_from_node;
     }
-    handle_transform_update(Node_transforms::get_next_serial());
+    if (!mark_transform_dirty()) {
+        handle_transform_update(Node_transforms::get_next_serial());
+    }
 }
 
 auto Node_data::diff_mask(const Node_data& lhs, const Node_data& rhs)-> unsigned int
@@ -4,6 +4,7 @@
 #include "erhe_scene/trs_transform.hpp"
 
 #include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
 #include <type_traits>
@@ -44,8 +45,9 @@ public:
     Node_data(const Node_data& src, for_clone);
 
     Node_transforms                               transforms;
-    Scene_host*                                   host     {nullptr};
+    Scene_host*                                   host       {nullptr};
     std::vector<std::shared_ptr<Node_attachment>> attachments;
+    std::size_t                                   flat_index {std::numeric_limits<std::size_t>::max()}; // in Scene flat nodes, set by Scene::sort_transform_nodes()
 
     static constexpr unsigned int bit_transform  {1u << 0};
     static constexpr unsigned int bit_attachments{1u << 1};
@@ -119,7 +121,13 @@ public:
     [[nodiscard]] auto get_scene                              () const -> Scene*;
 
     void node_sanity_check     () const;
+
+    // Returns false if node is not in a scene, in which case attachments
+    // must be notified by the caller; otherwise the scene notifies them in
+    // Scene::update_node_transforms().
+    auto mark_transform_dirty  () -> bool;
     void update_world_from_node();
+    void update_world_from_node(const Node& parent);
     void update_transform      (uint64_t serial);
     void set_parent_from_node  (const glm::mat4 parent_from_node);
     void set_parent_from_node  (const Transform& parent_from_node);
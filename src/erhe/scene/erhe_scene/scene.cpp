@@ -8,13 +8,22 @@
 #include "erhe_scene/scene_message_bus.hpp"
 #include "erhe_scene/skin.hpp"
 #include "erhe_bit/bit_helpers.hpp"
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
 #include <algorithm>
+#include <optional>
 
 namespace erhe::scene {
 
+namespace {
+
+// Minimum number of nodes per task when updating transforms in parallel
+constexpr std::size_t s_parallel_grain = 256;
+
+}
+
 auto Scene::get_static_type()       -> uint64_t         { return erhe::Item_type::scene; }
 auto Scene::get_type       () const -> uint64_t         { return get_static_type(); }
 auto Scene::get_type_name  () const -> std::string_view { return static_type_name; }
@@ -242,31 +251,148 @@ void Scene::sanity_check() const
 
 void Scene::sort_transform_nodes()
 {
+    ERHE_PROFILE_FUNCTION();
+
     log->trace("sorting {} nodes", m_flat_node_vector.size());
 
-    std::sort(
+    std::stable_sort(
         m_flat_node_vector.begin(),
         m_flat_node_vector.end(),
         [](const auto& lhs, const auto& rhs) {
             return lhs->get_depth() < rhs->get_depth();
         }
     );
+
+    const std::size_t node_count = m_flat_node_vector.size();
+    ERHE_VERIFY(node_count < no_flat_parent);
+    m_flat_parent_index.resize(node_count);
+    m_flat_transform_dirty.assign(node_count, 0);
+    m_flat_depth_offsets.clear();
+    m_first_dirty_transform = 0;
+    m_dirty_transform_count = 0;
+
+    for (std::size_t i = 0; i < node_count; ++i) {
+        Node* const node = m_flat_node_vector[i].get();
+        node->node_data.flat_index = i;
+        const std::size_t depth = node->get_depth();
+        while (m_flat_depth_offsets.size() <= depth) {
+            m_flat_depth_offsets.push_back(i);
+        }
+        // Parents have smaller depth, so their flat index is already set.
+        // Nodes directly under the implicit root node have no flat parent.
+        const std::shared_ptr<Node> parent       = node->get_parent_node();
+        const std::size_t           parent_index = parent ? parent->node_data.flat_index : no_flat_parent;
+        const bool                  in_scene     =
+            (parent_index < i) &&
+            (m_flat_node_vector[parent_index] == parent);
+        m_flat_parent_index[i] = in_scene ? static_cast<uint32_t>(parent_index) : no_flat_parent;
+    }
+    m_flat_depth_offsets.push_back(node_count);
     m_nodes_sorted = true;
 }
 
-void Scene::update_node_transforms()
+void Scene::mark_nodes_unsorted()
+{
+    m_nodes_sorted = false;
+}
+
+auto Scene::mark_transform_dirty(const Node& node) -> bool
+{
+    // Unsorted nodes are all updated by the next update_node_transforms()
+    if (!m_nodes_sorted) {
+        return true;
+    }
+    const std::size_t i = node.node_data.flat_index;
+    if ((i >= m_flat_node_vector.size()) || (m_flat_node_vector[i].get() != &node)) {
+        return false;
+    }
+    if (m_flat_transform_dirty[i] != 0) {
+        return true;
+    }
+    m_flat_transform_dirty[i] = 1;
+    m_first_dirty_transform = (m_dirty_transform_count == 0) ? i : std::min(m_first_dirty_transform, i);
+    ++m_dirty_transform_count;
+    return true;
+}
+
+void Scene::update_node_transforms(erhe::concurrency::Thread_pool* const thread_pool)
 {
     ERHE_PROFILE_FUNCTION();
 
     if (!m_nodes_sorted) {
         sort_transform_nodes();
+        std::fill(m_flat_transform_dirty.begin(), m_flat_transform_dirty.end(), uint8_t{1});
+        m_first_dirty_transform = 0;
+        m_dirty_transform_count = m_flat_node_vector.size();
+    }
+    if (m_dirty_transform_count == 0) {
+        return;
+    }
+
+    // Nodes are sorted by depth, so parents are always processed before
+    // their children; dirty flags propagate down in a single pass. Nodes of
+    // the same depth do not depend on each other.
+    const Node* const root_node = m_root_node.get();
+    const auto update_range = [this, root_node](const std::size_t first, const std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            const uint32_t parent_index = m_flat_parent_index[i];
+            const bool     parent_dirty = (parent_index != no_flat_parent) && (m_flat_transform_dirty[parent_index] != 0);
+            if (!parent_dirty && (m_flat_transform_dirty[i] == 0)) {
+                continue;
+            }
+            Node* const node = m_flat_node_vector[i].get();
+            if (node->is_no_transform_update()) {
+                continue;
+            }
+            const Node& parent = (parent_index != no_flat_parent) ? *m_flat_node_vector[parent_index].get() : *root_node;
+            node->update_world_from_node(parent);
+            m_flat_transform_dirty[i] = 1;
+        }
+    };
+
+    const std::size_t first_dirty = m_first_dirty_transform;
+    const std::size_t node_count  = m_flat_node_vector.size();
+    {
+        ERHE_PROFILE_SCOPE("world from node");
+
+        std::optional<erhe::concurrency::Concurrent_queue> queue;
+        for (std::size_t depth = 0, end = m_flat_depth_offsets.size(); depth + 1 < end; ++depth) {
+            const std::size_t first = std::max(m_flat_depth_offsets[depth], first_dirty);
+            const std::size_t last  = m_flat_depth_offsets[depth + 1];
+            if (first >= last) {
+                continue;
+            }
+            if ((thread_pool == nullptr) || (last - first < 2 * s_parallel_grain)) {
+                update_range(first, last);
+                continue;
+            }
+            if (!queue.has_value()) {
+                queue.emplace(*thread_pool, "update_node_transforms");
+            }
+            queue->enqueue_range(first, last, s_parallel_grain, update_range);
+            queue->wait();
+        }
     }
 
-    for (auto& node : m_flat_node_vector) {
-        if (node->is_no_transform_update()) {
-            continue;
+    // Flags are cleared before attachments are notified, so that transform
+    // changes made by attachments are picked up by the next update.
+    m_notify_transform_indices.clear();
+    for (std::size_t i = first_dirty; i < node_count; ++i) {
+        if (m_flat_transform_dirty[i] != 0) {
+            m_flat_transform_dirty[i] = 0;
+            m_notify_transform_indices.push_back(i);
+        }
+    }
+    m_first_dirty_transform = 0;
+    m_dirty_transform_count = 0;
+
+    {
+        ERHE_PROFILE_SCOPE("notify");
+
+        const uint64_t serial = Node_transforms::get_next_serial();
+        for (const std::size_t i : m_notify_transform_indices) {
+            m_flat_node_vector[i]->handle_transform_update(serial);
         }
-        node->update_transform(0);
     }
 }
 
@@ -366,8 +492,10 @@ void Scene::unregister_node(const std::shared_ptr<erhe::scene::Node>& node)
     if (i == m_flat_node_vector.end()) {
         log->error("Node {} not in scene nodes", node->get_name());
     } else {
-        node->node_data.host = nullptr;
+        node->node_data.host       = nullptr;
+        node->node_data.flat_index = std::numeric_limits<std::size_t>::max();
         m_flat_node_vector.erase(i, m_flat_node_vector.end());
+        m_nodes_sorted = false;
     }
 
 #if !defined(NDEBUG)
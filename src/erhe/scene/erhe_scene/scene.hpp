@@ -6,11 +6,17 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
+
 namespace erhe::scene {
 
 class Camera;
@@ -78,7 +84,16 @@ public:
     // Public API
     void sanity_check          () const;
     void sort_transform_nodes  ();
-    void update_node_transforms();
+    void mark_nodes_unsorted   ();
+    // Returns false if node is not tracked by this scene
+    auto mark_transform_dirty  (const Node& node) -> bool;
+
+    // Updates world transforms of nodes which have been marked dirty, and
+    // their descendants. Nodes of each depth are updated in parallel when
+    // thread pool is given. This is the only place where attachments of
+    // nodes in the scene are notified of transform changes; they are
+    // notified once per update from the calling thread.
+    void update_node_transforms(erhe::concurrency::Thread_pool* thread_pool = nullptr);
 
     [[nodiscard]] auto get_mesh_by_id       (erhe::Unique_id<Node>::id_type id) const -> std::shared_ptr<Mesh>;
     [[nodiscard]] auto get_light_by_id      (erhe::Unique_id<Node>::id_type id) const -> std::shared_ptr<Light>;
@@ -115,12 +130,20 @@ private:
     Scene_message_bus&                        m_message_bus;
     Scene_host*                               m_host       {nullptr};
     std::shared_ptr<erhe::scene::Node>        m_root_node;
-    std::vector<std::shared_ptr<Node>>        m_flat_node_vector;
+    std::vector<std::shared_ptr<Node>>        m_flat_node_vector;       // sorted by depth when m_nodes_sorted
+    std::vector<uint32_t>                     m_flat_parent_index;      // index to m_flat_node_vector, or no_flat_parent
+    std::vector<uint8_t>                      m_flat_transform_dirty;
+    std::vector<std::size_t>                  m_flat_depth_offsets;     // first index for each depth, and end
+    std::size_t                               m_first_dirty_transform{0};
+    std::size_t                               m_dirty_transform_count{0};
+    std::vector<std::size_t>                  m_notify_transform_indices;
     std::vector<std::shared_ptr<Mesh_layer>>  m_mesh_layers;
     std::vector<std::shared_ptr<Skin>>        m_skins;
     std::vector<std::shared_ptr<Light_layer>> m_light_layers;
     std::vector<std::shared_ptr<Camera>>      m_cameras;
     bool                                      m_nodes_sorted{false};
+
+    static constexpr uint32_t no_flat_parent = std::numeric_limits<uint32_t>::max();
 };
 
 } // namespace erhe::scene
@@ -35,6 +35,7 @@ Forward_renderer::Forward_renderer(erhe::graphics::Instance& graphics_instance,
     , m_joint_buffers        {graphics_instance, program_interface.joint_interface}
     , m_light_buffers        {graphics_instance, program_interface.light_interface}
     , m_material_buffers     {graphics_instance, program_interface.material_interface}
+    , m_morph_buffers        {graphics_instance, program_interface.morph_interface}
     , m_primitive_buffers    {graphics_instance, program_interface.primitive_interface}
     , m_nearest_sampler{
         erhe::graphics::Sampler_create_info{
@@ -50,6 +51,7 @@ Forward_renderer::Forward_renderer(erhe::graphics::Instance& graphics_instance,
     erhe::graphics::Scoped_debug_group forward_renderer_initialization{c_forward_renderer_initialize_component};
 
     m_dummy_texture = graphics_instance.create_dummy_texture();
+    m_primitive_buffers.set_morph_buffer(&m_morph_buffers);
 }
 
 static constexpr std::string_view c_forward_renderer_render{"Forward_renderer::render()"};
@@ -61,7 +63,25 @@ void Forward_renderer::next_frame()
     m_joint_buffers        .next_frame();
     m_light_buffers        .next_frame();
     m_material_buffers     .next_frame();
+    m_morph_buffers        .next_frame();
     m_primitive_buffers    .next_frame();
+    m_frustum_culler       .next_frame();
+    m_render_list          .next_frame();
+}
+
+auto Forward_renderer::get_culling_statistics() const -> const Culling_statistics&
+{
+    return m_culling_statistics;
+}
+
+auto Forward_renderer::get_render_list() -> Render_list&
+{
+    return m_render_list;
+}
+
+auto Forward_renderer::get_joint_buffer() -> Joint_buffer&
+{
+    return m_joint_buffers;
 }
 
 namespace {
@@ -110,9 +130,52 @@ void Forward_renderer::render(const Render_parameters& parameters)
     );
 
     gl::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
+    std::vector<Frustum> frustums;
     if (camera != nullptr) {
         const auto range = m_camera_buffers.update(*camera->projection(), *camera->get_node(), viewport, camera->get_exposure());
         m_camera_buffers.bind(range);
+        if (parameters.frustum_culling) {
+            frustums.emplace_back(camera->projection_transforms(viewport).clip_from_world.get_matrix());
+        }
+    }
+
+    // Morph vertex indices are used by primitive buffer updates
+    const auto morph_range = m_morph_buffers.update(mesh_spans);
+    m_morph_buffers.bind(morph_range);
+
+    // Primitive and draw indirect data is written once and shared by all passes
+    m_culling_statistics = Culling_statistics{};
+    m_mesh_span_draws.clear();
+    {
+        ERHE_PROFILE_SCOPE("primitives");
+
+        for (const auto& meshes : mesh_spans) {
+            if (meshes.empty()) {
+                continue;
+            }
+            m_visible_mesh_indices.clear();
+            m_frustum_culler.cull(meshes, frustums, filter, m_visible_mesh_indices, m_culling_statistics);
+            if (m_visible_mesh_indices.empty()) {
+                continue;
+            }
+
+            const auto  mesh_records = m_render_list.get_mesh_records(meshes);
+            std::size_t primitive_count{0};
+            const auto  primitive_range            = m_primitive_buffers.update(meshes, mesh_records, m_visible_mesh_indices, primitive_mode, parameters.primitive_settings, primitive_count);
+            const auto  draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, m_visible_mesh_indices, primitive_mode);
+            if (draw_indirect_buffer_range.draw_indirect_count == 0) {
+                continue;
+            }
+            if (primitive_count != draw_indirect_buffer_range.draw_indirect_count) {
+                log_render->warn("primitive_count != draw_indirect_buffer_range.draw_indirect_count");
+            }
+            m_mesh_span_draws.push_back(
+                Mesh_span_draw{
+                    .primitive_range            = primitive_range,
+                    .draw_indirect_buffer_range = draw_indirect_buffer_range
+                }
+            );
+        }
     }
 
     if (!m_graphics_instance.info.use_bindless_texture) {
@@ -177,23 +240,11 @@ void Forward_renderer::render(const Render_parameters& parameters)
         }
         m_graphics_instance.opengl_state_tracker.execute(pipeline, use_override_shader_stages);
 
-        for (const auto& meshes : mesh_spans) {
+        for (const Mesh_span_draw& mesh_span_draw : m_mesh_span_draws) {
             ERHE_PROFILE_SCOPE("mesh span");
             //ERHE_PROFILE_GPU_SCOPE(c_forward_renderer_render);
-            if (meshes.empty()) {
-                continue;
-            }
-
-            std::size_t primitive_count{0};
-            const auto primitive_range            = m_primitive_buffers.update(meshes, primitive_mode, filter, parameters.primitive_settings, primitive_count);
-            const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, primitive_mode, filter);
-            if (draw_indirect_buffer_range.draw_indirect_count == 0) {
-                continue;
-            }
-            if (primitive_count != draw_indirect_buffer_range.draw_indirect_count) {
-                log_render->warn("primitive_count != draw_indirect_buffer_range.draw_indirect_count");
-            }
-            m_primitive_buffers.bind(primitive_range);
+            const auto& draw_indirect_buffer_range = mesh_span_draw.draw_indirect_buffer_range;
+            m_primitive_buffers.bind(mesh_span_draw.primitive_range);
             m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
 
             {
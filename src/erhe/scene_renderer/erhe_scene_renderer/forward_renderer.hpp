@@ -6,10 +6,13 @@
 #include "erhe_renderer/draw_indirect_buffer.hpp"
 #include "erhe_renderer/pipeline_renderpass.hpp"
 #include "erhe_scene_renderer/camera_buffer.hpp"
+#include "erhe_scene_renderer/frustum_culler.hpp"
 #include "erhe_scene_renderer/joint_buffer.hpp"
 #include "erhe_scene_renderer/light_buffer.hpp"
 #include "erhe_scene_renderer/material_buffer.hpp"
+#include "erhe_scene_renderer/morph_buffer.hpp"
 #include "erhe_scene_renderer/primitive_buffer.hpp"
+#include "erhe_scene_renderer/render_list.hpp"
 
 #include <glm/glm.hpp>
 
@@ -67,13 +70,26 @@ public:
         const glm::uvec4&                                                  debug_joint_indices{0, 0, 0, 0};
         const std::span<glm::vec4>&                                        debug_joint_colors{};
         const std::string_view                                             debug_label;
+        const bool                                                         frustum_culling{true}; // cull meshes against camera frustum
     };
 
     void render(const Render_parameters& parameters);
     void render_fullscreen(const Render_parameters& parameters, const erhe::scene::Light* light);
     void next_frame();
 
+    // Statistics from the most recent render() call, for all passes
+    [[nodiscard]] auto get_culling_statistics() const -> const Culling_statistics&;
+    [[nodiscard]] auto get_render_list       () -> Render_list&;
+    [[nodiscard]] auto get_joint_buffer      () -> Joint_buffer&;
+
 private:
+    class Mesh_span_draw
+    {
+    public:
+        erhe::renderer::Buffer_range               primitive_range;
+        erhe::renderer::Draw_indirect_buffer_range draw_indirect_buffer_range;
+    };
+
     erhe::graphics::Instance&                m_graphics_instance;
     Program_interface&                       m_program_interface;
     int                                      m_base_texture_unit{0};
@@ -82,9 +98,15 @@ private:
     Joint_buffer                             m_joint_buffers;
     Light_buffer                             m_light_buffers;
     Material_buffer                          m_material_buffers;
+    Morph_buffer                             m_morph_buffers;
     Primitive_buffer                         m_primitive_buffers;
     erhe::graphics::Sampler                  m_nearest_sampler;
     std::shared_ptr<erhe::graphics::Texture> m_dummy_texture;
+    Frustum_culler                           m_frustum_culler;
+    Culling_statistics                       m_culling_statistics;
+    Render_list                              m_render_list;
+    std::vector<uint32_t>                    m_visible_mesh_indices;
+    std::vector<Mesh_span_draw>              m_mesh_span_draws;
 };
 
 } // namespace erhe::scene_renderer
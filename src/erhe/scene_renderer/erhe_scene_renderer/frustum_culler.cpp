@@ -0,0 +1,356 @@
+#include "erhe_scene_renderer/frustum_culler.hpp"
+
+#include "erhe_item/item.hpp"
+#include "erhe_scene/mesh.hpp"
+#include "erhe_scene/node.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::scene_renderer {
+
+namespace {
+
+[[nodiscard]] auto surface_area(const erhe::math::Bounding_box& box) -> float
+{
+    if (!box.is_valid()) {
+        return 0.0f;
+    }
+    const glm::vec3 d = box.diagonal();
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+[[nodiscard]] auto is_same_box(const erhe::math::Bounding_box& lhs, const erhe::math::Bounding_box& rhs) -> bool
+{
+    return (lhs.min == rhs.min) && (lhs.max == rhs.max);
+}
+
+}
+
+Frustum::Frustum(const glm::mat4& clip_from_world)
+{
+    const glm::vec4 row_x{clip_from_world[0][0], clip_from_world[1][0], clip_from_world[2][0], clip_from_world[3][0]};
+    const glm::vec4 row_y{clip_from_world[0][1], clip_from_world[1][1], clip_from_world[2][1], clip_from_world[3][1]};
+    const glm::vec4 row_z{clip_from_world[0][2], clip_from_world[1][2], clip_from_world[2][2], clip_from_world[3][2]};
+    const glm::vec4 row_w{clip_from_world[0][3], clip_from_world[1][3], clip_from_world[2][3], clip_from_world[3][3]};
+    planes = {
+        row_w + row_x,
+        row_w - row_x,
+        row_w + row_y,
+        row_w - row_y,
+        row_w + row_z,
+        row_w - row_z
+    };
+    for (glm::vec4& plane : planes) {
+        const float length = glm::length(glm::vec3{plane});
+        plane = (length > 1.0e-6f)
+            ? plane / length
+            : glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+    }
+}
+
+auto Frustum::test(const erhe::math::Bounding_box& box) const -> Result
+{
+    const glm::vec3 center = box.center();
+    const glm::vec3 extent = box.diagonal() * 0.5f;
+    Result result = Result::inside;
+    for (const glm::vec4& plane : planes) {
+        const glm::vec3 normal   = glm::vec3{plane};
+        const float     distance = glm::dot(normal, center) + plane.w;
+        const float     radius   = glm::dot(glm::abs(normal), extent);
+        if (distance + radius < 0.0f) {
+            return Result::outside;
+        }
+        if (distance - radius < 0.0f) {
+            result = Result::intersect;
+        }
+    }
+    return result;
+}
+
+void Culling_statistics::add(const Culling_statistics& other)
+{
+    mesh_count              += other.mesh_count;
+    tested_bounds_count     += other.tested_bounds_count;
+    visible_mesh_count      += other.visible_mesh_count;
+    visible_primitive_count += other.visible_primitive_count;
+}
+
+void Frustum_culler::next_frame()
+{
+    // Drop hierarchies for spans which were not rendered during this or the previous frame
+    const uint64_t frame = m_frame;
+    m_span_bvhs.erase(
+        std::remove_if(
+            m_span_bvhs.begin(),
+            m_span_bvhs.end(),
+            [frame](const std::unique_ptr<Span_bvh>& bvh) {
+                return bvh->used_frame + 1 < frame;
+            }
+        ),
+        m_span_bvhs.end()
+    );
+    ++m_frame;
+}
+
+auto Frustum_culler::get_span_bvh(const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes) -> Span_bvh&
+{
+    for (const auto& bvh : m_span_bvhs) {
+        if ((bvh->data == meshes.data()) && (bvh->size == meshes.size())) {
+            bvh->used_frame = m_frame;
+            return *bvh.get();
+        }
+    }
+    auto& bvh = m_span_bvhs.emplace_back(std::make_unique<Span_bvh>());
+    bvh->data       = meshes.data();
+    bvh->size       = meshes.size();
+    bvh->used_frame = m_frame;
+    return *bvh.get();
+}
+
+void Frustum_culler::validate(Span_bvh& bvh, const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t mesh_count = meshes.size();
+    bool rebuild = (bvh.meshes.size() != mesh_count);
+    bool moved   = false;
+    if (rebuild) {
+        bvh.meshes      .assign(mesh_count, nullptr);
+        bvh.node_serials.assign(mesh_count, 0);
+        bvh.local_boxes .assign(mesh_count, erhe::math::Bounding_box{});
+        bvh.world_boxes .assign(mesh_count, erhe::math::Bounding_box{});
+    }
+
+    for (std::size_t i = 0; i < mesh_count; ++i) {
+        const erhe::scene::Mesh* const mesh = meshes[i].get();
+        ERHE_VERIFY(mesh != nullptr);
+        const erhe::scene::Node* const node = mesh->get_node();
+
+        // Skinned meshes are not bounded by their bind pose bounding box
+        erhe::math::Bounding_box local_box{};
+        if ((node != nullptr) && !mesh->skin) {
+            for (const auto& primitive : mesh->get_primitives()) {
+                local_box.include(primitive.get_bounding_box());
+            }
+        }
+        const uint64_t serial = (node != nullptr) ? node->node_data.transforms.world_from_node_serial : 0;
+        if ((bvh.meshes[i] != mesh) || (local_box.is_valid() != bvh.local_boxes[i].is_valid())) {
+            rebuild = true;
+        }
+        if (
+            rebuild ||
+            (bvh.node_serials[i] != serial) ||
+            !is_same_box(bvh.local_boxes[i], local_box)
+        ) {
+            bvh.meshes      [i] = mesh;
+            bvh.node_serials[i] = serial;
+            bvh.local_boxes [i] = local_box;
+            bvh.world_boxes [i] = local_box.is_valid()
+                ? local_box.transformed_by(node->world_from_node())
+                : erhe::math::Bounding_box{};
+            moved = true;
+        }
+    }
+
+    if (rebuild) {
+        build(bvh);
+        return;
+    }
+    if (moved) {
+        refit(bvh);
+    }
+}
+
+void Frustum_culler::build(Span_bvh& bvh)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    bvh.indices       .clear();
+    bvh.always_visible.clear();
+    bvh.nodes         .clear();
+    for (uint32_t i = 0, end = static_cast<uint32_t>(bvh.meshes.size()); i < end; ++i) {
+        if (bvh.local_boxes[i].is_valid()) {
+            bvh.indices.push_back(i);
+        } else {
+            bvh.always_visible.push_back(i);
+        }
+    }
+
+    bvh.build_cost = 0.0f;
+    if (bvh.indices.empty()) {
+        return;
+    }
+
+    // Binary tree with at least one mesh per leaf; reserving prevents
+    // reallocation while build_node() holds references.
+    bvh.nodes.reserve(2 * bvh.indices.size());
+    bvh.nodes.emplace_back();
+    build_node(bvh, 0, 0, static_cast<uint32_t>(bvh.indices.size()));
+    for (const Bvh_node& node : bvh.nodes) {
+        bvh.build_cost += surface_area(node.box);
+    }
+}
+
+void Frustum_culler::build_node(Span_bvh& bvh, const uint32_t node_index, const uint32_t first, const uint32_t count)
+{
+    erhe::math::Bounding_box box{};
+    erhe::math::Bounding_box centroid_box{};
+    for (uint32_t k = first; k < first + count; ++k) {
+        const erhe::math::Bounding_box& mesh_box = bvh.world_boxes[bvh.indices[k]];
+        box.include(mesh_box);
+        centroid_box.include(mesh_box.center());
+    }
+
+    Bvh_node& node = bvh.nodes[node_index];
+    node.box   = box;
+    node.first = first;
+    node.count = count;
+    node.left  = 0;
+    if (count <= max_leaf_size) {
+        return;
+    }
+
+    // Median split along the largest extent of mesh centers
+    const glm::vec3 extent = centroid_box.diagonal();
+    const int axis = (extent.x >= extent.y) && (extent.x >= extent.z)
+        ? 0
+        : (extent.y >= extent.z) ? 1 : 2;
+    const uint32_t middle = first + count / 2;
+    std::nth_element(
+        bvh.indices.begin() + first,
+        bvh.indices.begin() + middle,
+        bvh.indices.begin() + first + count,
+        [&bvh, axis](const uint32_t lhs, const uint32_t rhs) {
+            return bvh.world_boxes[lhs].center()[axis] < bvh.world_boxes[rhs].center()[axis];
+        }
+    );
+
+    const uint32_t left = static_cast<uint32_t>(bvh.nodes.size());
+    bvh.nodes.emplace_back();
+    bvh.nodes.emplace_back();
+    node.left = left;
+    build_node(bvh, left,     first,  middle - first);
+    build_node(bvh, left + 1, middle, first + count - middle);
+}
+
+void Frustum_culler::refit(Span_bvh& bvh)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Children are always stored after their parent
+    float cost = 0.0f;
+    for (std::size_t k = bvh.nodes.size(); k > 0; --k) {
+        Bvh_node& node = bvh.nodes[k - 1];
+        erhe::math::Bounding_box box{};
+        if (node.left == 0) {
+            for (uint32_t j = node.first; j < node.first + node.count; ++j) {
+                box.include(bvh.world_boxes[bvh.indices[j]]);
+            }
+        } else {
+            box.include(bvh.nodes[node.left    ].box);
+            box.include(bvh.nodes[node.left + 1].box);
+        }
+        node.box = box;
+        cost += surface_area(box);
+    }
+
+    // Refitting keeps the topology; rebuild once nodes overlap too much
+    if (cost > 2.0f * bvh.build_cost) {
+        build(bvh);
+    }
+}
+
+void Frustum_culler::traverse(const Span_bvh& bvh, const Frustum& frustum, Culling_statistics& statistics)
+{
+    if (bvh.nodes.empty()) {
+        return;
+    }
+
+    m_stack.clear();
+    m_stack.push_back(0);
+    while (!m_stack.empty()) {
+        const Bvh_node& node = bvh.nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        ++statistics.tested_bounds_count;
+        const Frustum::Result result = frustum.test(node.box);
+        if (result == Frustum::Result::outside) {
+            continue;
+        }
+        if (result == Frustum::Result::inside) {
+            m_visible_indices.insert(
+                m_visible_indices.end(),
+                bvh.indices.begin() + node.first,
+                bvh.indices.begin() + node.first + node.count
+            );
+            continue;
+        }
+        if (node.left != 0) {
+            m_stack.push_back(node.left);
+            m_stack.push_back(node.left + 1);
+            continue;
+        }
+        for (uint32_t k = node.first; k < node.first + node.count; ++k) {
+            const uint32_t i = bvh.indices[k];
+            ++statistics.tested_bounds_count;
+            if (frustum.test(bvh.world_boxes[i]) != Frustum::Result::outside) {
+                m_visible_indices.push_back(i);
+            }
+        }
+    }
+}
+
+void Frustum_culler::cull(
+    const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    const std::span<const Frustum>                             frustums,
+    const erhe::Item_filter&                                   filter,
+    std::vector<uint32_t>&                                     out_visible_mesh_indices,
+    Culling_statistics&                                        statistics
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    statistics.mesh_count += meshes.size();
+
+    const auto emit = [&](const uint32_t i) {
+        const erhe::scene::Mesh* const mesh = meshes[i].get();
+        if (!filter(mesh->get_flag_bits())) {
+            return;
+        }
+        out_visible_mesh_indices.push_back(i);
+        ++statistics.visible_mesh_count;
+        statistics.visible_primitive_count += mesh->get_primitives().size();
+    };
+
+    if (frustums.empty()) {
+        for (uint32_t i = 0, end = static_cast<uint32_t>(meshes.size()); i < end; ++i) {
+            emit(i);
+        }
+        return;
+    }
+
+    Span_bvh& bvh = get_span_bvh(meshes);
+    if (bvh.validated_frame != m_frame) {
+        validate(bvh, meshes);
+        bvh.validated_frame = m_frame;
+    }
+
+    m_visible_indices.assign(bvh.always_visible.begin(), bvh.always_visible.end());
+    for (const Frustum& frustum : frustums) {
+        traverse(bvh, frustum, statistics);
+    }
+
+    // Restore span order; with multiple frustums a mesh can be visited more than once
+    std::sort(m_visible_indices.begin(), m_visible_indices.end());
+    m_visible_indices.erase(
+        std::unique(m_visible_indices.begin(), m_visible_indices.end()),
+        m_visible_indices.end()
+    );
+    for (const uint32_t i : m_visible_indices) {
+        emit(i);
+    }
+}
+
+} // namespace erhe::scene_renderer
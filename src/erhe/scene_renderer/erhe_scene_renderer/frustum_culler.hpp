@@ -0,0 +1,117 @@
+#pragma once
+
+#include "erhe_math/math_util.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace erhe {
+    class Item_filter;
+}
+namespace erhe::scene {
+    class Mesh;
+}
+
+namespace erhe::scene_renderer {
+
+// Planes are extracted from clip_from_world using only -w <= x, y, z <= w,
+// which is conservative for all depth range conventions (including reverse
+// depth). Degenerate planes, such as far plane of infinite projection, are
+// ignored.
+class Frustum
+{
+public:
+    enum class Result : unsigned int {
+        outside = 0,
+        intersect,
+        inside
+    };
+
+    explicit Frustum(const glm::mat4& clip_from_world);
+
+    [[nodiscard]] auto test(const erhe::math::Bounding_box& box) const -> Result;
+
+    std::array<glm::vec4, 6> planes;
+};
+
+class Culling_statistics
+{
+public:
+    std::size_t mesh_count             {0}; // candidate meshes
+    std::size_t tested_bounds_count    {0}; // BVH node and mesh bounding box tests
+    std::size_t visible_mesh_count     {0};
+    std::size_t visible_primitive_count{0};
+
+    void add(const Culling_statistics& other);
+};
+
+// Culls meshes against one or more frustums using world space bounding boxes
+// of Buffer_mesh bounds transformed by world_from_node. A bounding volume
+// hierarchy is kept for each mesh span; it is validated once per frame,
+// refitted when nodes have moved and rebuilt when the span contents change
+// or the refitted hierarchy has degraded too much. Meshes with skin or
+// without bounds are never culled.
+class Frustum_culler
+{
+public:
+    void next_frame();
+
+    // Appends indices of visible meshes which pass filter to
+    // out_visible_mesh_indices, in increasing order. A mesh is visible if it
+    // intersects any of the frustums. If frustums is empty, no culling is done.
+    void cull(
+        const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+        const std::span<const Frustum>                             frustums,
+        const erhe::Item_filter&                                   filter,
+        std::vector<uint32_t>&                                     out_visible_mesh_indices,
+        Culling_statistics&                                        statistics
+    );
+
+private:
+    static constexpr uint32_t max_leaf_size{4};
+
+    class Bvh_node
+    {
+    public:
+        erhe::math::Bounding_box box;
+        uint32_t                 first{0}; // in Span_bvh::indices
+        uint32_t                 count{0};
+        uint32_t                 left {0}; // right child is left + 1; 0 for leaf nodes
+    };
+
+    class Span_bvh
+    {
+    public:
+        const std::shared_ptr<erhe::scene::Mesh>* data           {nullptr};
+        std::size_t                               size           {0};
+        uint64_t                                  validated_frame{0};
+        uint64_t                                  used_frame     {0};
+        float                                     build_cost     {0.0f};
+        std::vector<const erhe::scene::Mesh*>     meshes;
+        std::vector<uint64_t>                     node_serials;
+        std::vector<erhe::math::Bounding_box>     local_boxes;
+        std::vector<erhe::math::Bounding_box>     world_boxes;
+        std::vector<uint32_t>                     indices;        // bounded meshes, in leaf order
+        std::vector<uint32_t>                     always_visible; // skinned or unbounded meshes
+        std::vector<Bvh_node>                     nodes;
+    };
+
+    [[nodiscard]] auto get_span_bvh(const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes) -> Span_bvh&;
+    void validate (Span_bvh& bvh, const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes);
+    void build    (Span_bvh& bvh);
+    void build_node(Span_bvh& bvh, uint32_t node_index, uint32_t first, uint32_t count);
+    void refit    (Span_bvh& bvh);
+    void traverse (const Span_bvh& bvh, const Frustum& frustum, Culling_statistics& statistics);
+
+    uint64_t                               m_frame{1};
+    std::vector<std::unique_ptr<Span_bvh>> m_span_bvhs;
+    std::vector<uint32_t>                  m_visible_indices;
+    std::vector<uint32_t>                  m_stack;
+};
+
+} // namespace erhe::scene_renderer
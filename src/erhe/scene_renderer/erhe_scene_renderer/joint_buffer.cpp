@@ -2,6 +2,7 @@
 
 #include "erhe_scene_renderer/joint_buffer.hpp"
 
+#include "erhe_concurrency/concurrent_queue.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_scene/node.hpp"
 #include "erhe_scene/skin.hpp"
@@ -10,8 +11,18 @@
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace erhe::scene_renderer {
 
+namespace {
+
+// Minimum number of skins per task when updating palettes in parallel
+constexpr std::size_t s_skin_palette_grain = 8;
+
+}
+
 Joint_interface::Joint_interface(erhe::graphics::Instance& graphics_instance)
     : joint_block{
         graphics_instance,
@@ -22,7 +33,8 @@ Joint_interface::Joint_interface(erhe::graphics::Instance& graphics_instance)
     , joint_struct{graphics_instance, "Joint"}
 {
     const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "renderer");
-    ini.get("max_joint_count", max_joint_count);
+    ini.get("max_joint_count",       max_joint_count);
+    ini.get("compact_joint_palette", compact_joint_palette);
 
     offsets.debug_joint_indices     = joint_block.add_uvec4("debug_joint_indices")->offset_in_parent();
     offsets.debug_joint_color_count = joint_block.add_uint ("debug_joint_color_count")->offset_in_parent(),
@@ -30,10 +42,17 @@ Joint_interface::Joint_interface(erhe::graphics::Instance& graphics_instance)
     offsets.extra2                  = joint_block.add_uint ("extra2")->offset_in_parent(),
     offsets.extra3                  = joint_block.add_uint ("extra3")->offset_in_parent(),
     offsets.debug_joint_colors      = joint_block.add_vec4 ("debug_joint_colors", 32)->offset_in_parent();
-    offsets.joint = {
-        .world_from_bind          = joint_struct.add_mat4("world_from_bind"         )->offset_in_parent(),
-        .world_from_bind_cofactor = joint_struct.add_mat4("world_from_bind_cofactor")->offset_in_parent()
-    };
+    if (compact_joint_palette) {
+        offsets.joint = {
+            .world_from_bind          = joint_struct.add_mat3x4("world_from_bind")->offset_in_parent(),
+            .world_from_bind_cofactor = 0
+        };
+    } else {
+        offsets.joint = {
+            .world_from_bind          = joint_struct.add_mat4("world_from_bind"         )->offset_in_parent(),
+            .world_from_bind_cofactor = joint_struct.add_mat4("world_from_bind_cofactor")->offset_in_parent()
+        };
+    }
 
     offsets.joint_struct = joint_block.add_struct("joints", &joint_struct, erhe::graphics::Shader_resource::unsized_array)->offset_in_parent();
 }
@@ -51,6 +70,100 @@ Joint_buffer::Joint_buffer(erhe::graphics::Instance& graphics_instance, Joint_in
     );
 }
 
+void Joint_buffer::set_thread_pool(erhe::concurrency::Thread_pool* const thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+void Joint_buffer::update_skin_palette(Skin_palette& skin_palette, const erhe::scene::Skin& skin)
+{
+    const erhe::scene::Skin_data& skin_data = skin.skin_data;
+
+    uint64_t serial = 0;
+    for (const std::shared_ptr<erhe::scene::Node>& joint : skin_data.joints) {
+        const uint64_t joint_serial = joint->node_data.transforms.world_from_node_serial;
+        if (joint_serial == 0) {
+            serial = 0; // transform update pending, always recompute
+            break;
+        }
+        serial = std::max(serial, joint_serial);
+    }
+    if ((serial != 0) && (skin_palette.serial == serial)) {
+        return;
+    }
+    skin_palette.serial = serial;
+
+    using erhe::graphics::as_span;
+    using erhe::graphics::write;
+
+    const std::span<std::byte> palette    {m_palette};
+    const auto                 entry_size = m_joint_interface.joint_struct.size_bytes();
+    const auto&                offsets    = m_joint_interface.offsets.joint;
+    const bool                 compact    = m_joint_interface.compact_joint_palette;
+    std::size_t                offset     = skin_palette.first_joint * entry_size;
+    for (std::size_t i = 0, end_i = skin_data.joints.size(); i < end_i; ++i, offset += entry_size) {
+        const glm::mat4 world_from_joint = skin_data.joints[i]->world_from_node();
+        const glm::mat4 world_from_bind  = world_from_joint * skin_data.inverse_bind_matrices[i];
+        if (compact) {
+            // Columns of transpose are rows of world_from_bind; bottom row is always 0, 0, 0, 1
+            const glm::mat4 world_from_bind_transpose = glm::transpose(world_from_bind);
+            write(palette, offset + offsets.world_from_bind + 0 * 4 * sizeof(float), as_span(world_from_bind_transpose[0]));
+            write(palette, offset + offsets.world_from_bind + 1 * 4 * sizeof(float), as_span(world_from_bind_transpose[1]));
+            write(palette, offset + offsets.world_from_bind + 2 * 4 * sizeof(float), as_span(world_from_bind_transpose[2]));
+        } else {
+            const glm::mat4 world_from_bind_cofactor = erhe::math::compute_cofactor(world_from_bind);
+            write(palette, offset + offsets.world_from_bind,          as_span(world_from_bind         ));
+            write(palette, offset + offsets.world_from_bind_cofactor, as_span(world_from_bind_cofactor));
+        }
+    }
+}
+
+void Joint_buffer::update_palette(const std::span<const std::shared_ptr<erhe::scene::Skin>>& skins)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t skin_count = skins.size();
+    m_skin_palettes.resize(skin_count);
+
+    std::size_t joint_count = 0;
+    for (std::size_t i = 0; i < skin_count; ++i) {
+        const std::shared_ptr<erhe::scene::Skin>& skin = skins[i];
+        ERHE_VERIFY(skin);
+        const std::size_t skin_joint_count = skin->skin_data.joints.size();
+        Skin_palette&     skin_palette     = m_skin_palettes[i];
+        if (
+            (skin_palette.skin        != skin.get())  ||
+            (skin_palette.first_joint != joint_count) ||
+            (skin_palette.joint_count != skin_joint_count)
+        ) {
+            skin_palette = Skin_palette{
+                .skin        = skin.get(),
+                .first_joint = joint_count,
+                .joint_count = skin_joint_count,
+                .serial      = 0
+            };
+        }
+        joint_count += skin_joint_count;
+    }
+
+    m_palette.resize(joint_count * m_joint_interface.joint_struct.size_bytes());
+
+    const auto update_range = [this](const std::size_t first, const std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            Skin_palette& skin_palette = m_skin_palettes[i];
+            update_skin_palette(skin_palette, *skin_palette.skin);
+        }
+    };
+
+    if ((m_thread_pool == nullptr) || (skin_count < 2 * s_skin_palette_grain)) {
+        update_range(0, skin_count);
+    } else {
+        erhe::concurrency::Concurrent_queue queue{*m_thread_pool, "joint_palette"};
+        queue.enqueue_range(0, skin_count, s_skin_palette_grain, update_range);
+        queue.wait();
+    }
+}
+
 auto Joint_buffer::update(
     const glm::uvec4&                                          debug_joint_indices,
     const std::span<glm::vec4>&                                debug_joint_colors,
@@ -66,20 +179,11 @@ auto Joint_buffer::update(
         m_writer.write_offset
     );
 
-    std::size_t joint_count = 0;
-    std::size_t skin_index = 0;
-    for (const std::shared_ptr<erhe::scene::Skin>& skin : skins) {
-        ERHE_VERIFY(skin);
-        ++skin_index;
-
-        const auto& skin_data = skin->skin_data;
-        joint_count += skin_data.joints.size();
-    }
+    update_palette(skins);
 
     auto&             buffer             = current_buffer();
-    const auto        entry_size         = m_joint_interface.joint_struct.size_bytes();
     const auto&       offsets            = m_joint_interface.offsets;
-    const std::size_t max_byte_count     = offsets.joint_struct + joint_count * entry_size;
+    const std::size_t max_byte_count     = offsets.joint_struct + m_palette.size();
     const auto        primitive_gpu_data = m_writer.begin(&buffer, max_byte_count);
 
     using erhe::graphics::as_span;
@@ -115,44 +219,21 @@ auto Joint_buffer::update(
 
     m_writer.write_offset += offsets.joint_struct;
 
-    uint32_t joint_index = 0;
-    for (auto& skin : skins) {
-        ERHE_VERIFY(skin);
-
-        if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-            log_render->critical("joint buffer capacity {} exceeded", buffer.capacity_byte_count());
-            ERHE_FATAL("joint buffer capacity exceeded");
-            break;
-        }
-
-        erhe::scene::Skin_data& skin_data = skin->skin_data;
-        skin_data.joint_buffer_index = joint_index;
-        for (std::size_t i = 0, end_i = skin->skin_data.joints.size(); i < end_i; ++i) {
-            const std::shared_ptr<erhe::scene::Node>& joint = skin->skin_data.joints[i];
-            const glm::mat4 joint_from_bind = skin->skin_data.inverse_bind_matrices[i];
-            if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-                log_render->critical("joint buffer capacity {} exceeded", buffer.capacity_byte_count());
-                ERHE_FATAL("joint buffer capacity exceeded");
-                break;
-            }
-
-            const glm::mat4 world_from_joint = joint->world_from_node();
-            const glm::mat4 world_from_bind  = world_from_joint * joint_from_bind;
-
-            // TODO Use compute shader
-            const glm::mat4 world_from_bind_cofactor = erhe::math::compute_cofactor(world_from_bind);
-
-            write(primitive_gpu_data, m_writer.write_offset + offsets.joint.world_from_bind,          as_span(world_from_bind         ));
-            write(primitive_gpu_data, m_writer.write_offset + offsets.joint.world_from_bind_cofactor, as_span(world_from_bind_cofactor));
-            m_writer.write_offset += entry_size;
-            ++joint_index;
-            ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
+    if ((m_writer.write_offset + m_palette.size()) > m_writer.write_end) {
+        log_render->critical("joint buffer capacity {} exceeded", buffer.capacity_byte_count());
+        ERHE_FATAL("joint buffer capacity exceeded");
+    } else {
+        for (const Skin_palette& skin_palette : m_skin_palettes) {
+            skin_palette.skin->skin_data.joint_buffer_index = static_cast<uint32_t>(skin_palette.first_joint);
         }
+        memcpy(primitive_gpu_data.data() + m_writer.write_offset, m_palette.data(), m_palette.size());
+        m_writer.write_offset += m_palette.size();
+        ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
     }
 
     m_writer.end();
 
-    SPDLOG_LOGGER_TRACE(log_draw, "wrote {} entries to joint buffer", joint_index);
+    SPDLOG_LOGGER_TRACE(log_draw, "wrote {} skins to joint buffer", m_skin_palettes.size());
 
     return m_writer.range;
 }
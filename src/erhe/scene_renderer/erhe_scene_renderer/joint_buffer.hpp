@@ -3,6 +3,12 @@
 #include "erhe_graphics/shader_resource.hpp"
 #include "erhe_renderer/multi_buffer.hpp"
 
+#include <cstdint>
+#include <vector>
+
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::scene {
     class Skin;
 }
@@ -12,8 +18,8 @@ namespace erhe::scene_renderer {
 class Joint_struct
 {
 public:
-    std::size_t world_from_bind;            // mat4 16 * 4 bytes
-    std::size_t world_from_bind_cofactor;   // mat4 16 * 4 bytes
+    std::size_t world_from_bind;            // mat4 16 * 4 bytes, or mat3x4 12 * 4 bytes (rows) with compact palette
+    std::size_t world_from_bind_cofactor;   // mat4 16 * 4 bytes, not used with compact palette
 };
 
 class Joint_block
@@ -38,6 +44,11 @@ public:
     erhe::graphics::Shader_resource joint_struct;
     Joint_block                     offsets;
     std::size_t                     max_joint_count{1000};
+
+    // When set, joints are stored as 3x4 affine matrices (transposed, one
+    // row per column), and shaders derive the cofactor matrix. Shaders see
+    // ERHE_COMPACT_JOINT_PALETTE defined.
+    bool                            compact_joint_palette{true};
 };
 
 class Joint_buffer : public erhe::renderer::Multi_buffer
@@ -45,6 +56,8 @@ class Joint_buffer : public erhe::renderer::Multi_buffer
 public:
     Joint_buffer(erhe::graphics::Instance& graphics_instance, Joint_interface& joint_interface);
 
+    void set_thread_pool(erhe::concurrency::Thread_pool* thread_pool);
+
     auto update(
         const glm::uvec4&                                          debug_joint_indices,
         const std::span<glm::vec4>&                                debug_joint_colors,
@@ -52,8 +65,27 @@ public:
     ) -> erhe::renderer::Buffer_range;
 
 private:
-    erhe::graphics::Instance& m_graphics_instance;
-    Joint_interface&          m_joint_interface;
+    // Joints of each skin are stored contiguously in m_palette, in GPU
+    // layout. Palette of a skin is recomputed only when the skin, its
+    // location in the palette, or world transform of any of its joints
+    // has changed.
+    class Skin_palette
+    {
+    public:
+        erhe::scene::Skin*       skin       {nullptr};
+        std::size_t              first_joint{0};
+        std::size_t              joint_count{0};
+        uint64_t                 serial     {0}; // max world_from_node_serial of joints, 0 if not computed
+    };
+
+    void update_palette     (const std::span<const std::shared_ptr<erhe::scene::Skin>>& skins);
+    void update_skin_palette(Skin_palette& skin_palette, const erhe::scene::Skin& skin);
+
+    erhe::graphics::Instance&       m_graphics_instance;
+    Joint_interface&                m_joint_interface;
+    erhe::concurrency::Thread_pool* m_thread_pool{nullptr};
+    std::vector<Skin_palette>       m_skin_palettes;
+    std::vector<std::byte>          m_palette;
 };
 
 } // namespace erhe::scene_renderer
@@ -0,0 +1,227 @@
+// #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "erhe_scene_renderer/morph_buffer.hpp"
+
+#include "erhe_configuration/configuration.hpp"
+#include "erhe_primitive/morph_targets.hpp"
+#include "erhe_primitive/primitive.hpp"
+#include "erhe_scene/mesh.hpp"
+#include "erhe_scene_renderer/scene_renderer_log.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+
+namespace erhe::scene_renderer {
+
+Morph_interface::Morph_interface(erhe::graphics::Instance& graphics_instance)
+    : morph_block{
+        graphics_instance,
+        "morph",
+        5,
+        erhe::graphics::Shader_resource::Type::shader_storage_block
+    }
+    , morph_vertex_struct{graphics_instance, "Morph_vertex"}
+    , offsets{
+        .position = morph_vertex_struct.add_vec4("position")->offset_in_parent(),
+        .normal   = morph_vertex_struct.add_vec4("normal"  )->offset_in_parent(),
+        .tangent  = morph_vertex_struct.add_vec4("tangent" )->offset_in_parent()
+    }
+{
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "renderer");
+    ini.get("max_morph_vertex_count", max_morph_vertex_count);
+
+    morph_block.add_struct("vertices", &morph_vertex_struct, erhe::graphics::Shader_resource::unsized_array);
+    morph_block.set_readonly(true);
+}
+
+Morph_buffer::Morph_buffer(erhe::graphics::Instance& graphics_instance, Morph_interface& morph_interface)
+    : Multi_buffer     {graphics_instance, "morph"}
+    , m_morph_interface{morph_interface}
+{
+    Multi_buffer::allocate(
+        gl::Buffer_target::shader_storage_buffer,
+        m_morph_interface.morph_block.binding_point(),
+        m_morph_interface.morph_vertex_struct.size_bytes() * m_morph_interface.max_morph_vertex_count
+    );
+}
+
+void Morph_buffer::next_frame()
+{
+    Multi_buffer::next_frame();
+
+    // Drop entries for meshes which were not rendered during this or the previous frame
+    const uint64_t frame = m_frame;
+    std::erase_if(
+        m_mesh_entries,
+        [frame](const auto& key_value) {
+            return key_value.second.used_frame + 1 < frame;
+        }
+    );
+    ++m_frame;
+    m_frame_range = erhe::renderer::Buffer_range{};
+}
+
+void Morph_buffer::blend(Mesh_entry& entry, const erhe::scene::Mesh& mesh)
+{
+    const std::vector<erhe::primitive::Primitive>& primitives = mesh.get_primitives();
+    const std::size_t primitive_count = primitives.size();
+
+    bool up_to_date = (entry.weights == mesh.morph_weights) && (entry.morph_targets.size() == primitive_count);
+    for (std::size_t i = 0; up_to_date && (i < primitive_count); ++i) {
+        up_to_date = (entry.morph_targets[i] == primitives[i].get_morph_targets());
+    }
+    if (up_to_date) {
+        return;
+    }
+
+    ERHE_PROFILE_FUNCTION();
+
+    entry.weights = mesh.morph_weights;
+    entry.morph_targets        .resize(primitive_count);
+    entry.primitive_first_delta.assign(primitive_count, 0);
+    entry.morph_vertex_indices .assign(primitive_count, c_no_morph_vertex_index);
+    std::size_t delta_count = 0;
+    for (std::size_t i = 0; i < primitive_count; ++i) {
+        const erhe::primitive::Morph_targets* morph_targets = primitives[i].get_morph_targets();
+        entry.morph_targets[i]         = morph_targets;
+        entry.primitive_first_delta[i] = delta_count;
+        if (morph_targets != nullptr) {
+            delta_count += morph_targets->get_vertex_count();
+        }
+    }
+    entry.position_deltas.assign(delta_count, glm::vec3{0.0f});
+    entry.normal_deltas  .assign(delta_count, glm::vec3{0.0f});
+    entry.tangent_deltas .assign(delta_count, glm::vec3{0.0f});
+    for (std::size_t i = 0; i < primitive_count; ++i) {
+        const erhe::primitive::Morph_targets* morph_targets = entry.morph_targets[i];
+        if (morph_targets == nullptr) {
+            continue;
+        }
+        const std::size_t first = entry.primitive_first_delta[i];
+        const std::size_t count = morph_targets->get_vertex_count();
+        morph_targets->accumulate(
+            entry.weights,
+            std::span<glm::vec3>{entry.position_deltas}.subspan(first, count),
+            std::span<glm::vec3>{entry.normal_deltas  }.subspan(first, count),
+            std::span<glm::vec3>{entry.tangent_deltas }.subspan(first, count)
+        );
+    }
+}
+
+auto Morph_buffer::update(
+    const std::span<const std::span<const std::shared_ptr<erhe::scene::Mesh>>>& mesh_spans
+) -> erhe::renderer::Buffer_range
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Find meshes with active morph targets which have not been written
+    // during this frame, and blend their deltas if weights have changed
+    m_pending_entries.clear();
+    std::size_t vertex_count = 0;
+    for (const auto& meshes : mesh_spans) {
+        for (const std::shared_ptr<erhe::scene::Mesh>& mesh : meshes) {
+            ERHE_VERIFY(mesh);
+            if (!erhe::primitive::has_active_morph_weights(mesh->morph_weights)) {
+                continue;
+            }
+            Mesh_entry& entry = m_mesh_entries[mesh.get()];
+            if (entry.mesh.expired()) {
+                // New mesh, or a new mesh at the address of a destroyed one
+                entry = Mesh_entry{};
+                entry.mesh = mesh;
+            }
+            entry.used_frame = m_frame;
+            if (entry.written_frame == m_frame) {
+                continue;
+            }
+            blend(entry, *mesh.get());
+            entry.written_frame = m_frame;
+            m_pending_entries.push_back(&entry);
+            vertex_count += entry.position_deltas.size();
+        }
+    }
+
+    // At least one entry is always written so that the buffer range can be bound
+    const bool first_write = (m_frame_range.byte_count == 0);
+    if ((vertex_count == 0) && !first_write) {
+        return m_frame_range;
+    }
+
+    auto&             buffer         = current_buffer();
+    const auto        entry_size     = m_morph_interface.morph_vertex_struct.size_bytes();
+    const auto&       offsets        = m_morph_interface.offsets;
+    // One extra entry leaves room for padding to entry boundary after alignment
+    const std::size_t max_byte_count = (std::max(vertex_count, std::size_t{1}) + 1) * entry_size;
+    const auto        morph_gpu_data = m_writer.begin(&buffer, max_byte_count);
+    if (first_write) {
+        m_frame_range.first_byte_offset = m_writer.range.first_byte_offset;
+    }
+    const std::size_t misalignment = (m_writer.range.first_byte_offset - m_frame_range.first_byte_offset) % entry_size;
+    if (misalignment != 0) {
+        m_writer.write_offset += entry_size - misalignment;
+    }
+    if ((m_writer.write_offset + std::max(vertex_count, std::size_t{1}) * entry_size) > m_writer.write_end) {
+        log_render->critical("morph buffer capacity {} exceeded", buffer.capacity_byte_count());
+        ERHE_FATAL("morph buffer capacity exceeded");
+    }
+
+    using erhe::graphics::as_span;
+    using erhe::graphics::write;
+
+    const glm::vec4 zero{0.0f};
+    if (vertex_count == 0) {
+        write(morph_gpu_data, m_writer.write_offset + offsets.position, as_span(zero));
+        write(morph_gpu_data, m_writer.write_offset + offsets.normal,   as_span(zero));
+        write(morph_gpu_data, m_writer.write_offset + offsets.tangent,  as_span(zero));
+        m_writer.write_offset += entry_size;
+    }
+
+    for (Mesh_entry* entry : m_pending_entries) {
+        for (std::size_t primitive_index = 0, end = entry->morph_targets.size(); primitive_index < end; ++primitive_index) {
+            const erhe::primitive::Morph_targets* morph_targets = entry->morph_targets[primitive_index];
+            if (morph_targets == nullptr) {
+                entry->morph_vertex_indices[primitive_index] = c_no_morph_vertex_index;
+                continue;
+            }
+
+            // Indices are relative to the start of the frame range
+            const std::size_t byte_offset = m_writer.range.first_byte_offset + m_writer.write_offset - m_frame_range.first_byte_offset;
+            entry->morph_vertex_indices[primitive_index] = static_cast<uint32_t>(byte_offset / entry_size);
+
+            const std::size_t first = entry->primitive_first_delta[primitive_index];
+            for (std::size_t i = first, last = first + morph_targets->get_vertex_count(); i < last; ++i) {
+                const glm::vec4 position_delta{entry->position_deltas[i], 0.0f};
+                const glm::vec4 normal_delta  {entry->normal_deltas  [i], 0.0f};
+                const glm::vec4 tangent_delta {entry->tangent_deltas [i], 0.0f};
+                write(morph_gpu_data, m_writer.write_offset + offsets.position, as_span(position_delta));
+                write(morph_gpu_data, m_writer.write_offset + offsets.normal,   as_span(normal_delta  ));
+                write(morph_gpu_data, m_writer.write_offset + offsets.tangent,  as_span(tangent_delta ));
+                m_writer.write_offset += entry_size;
+            }
+            ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
+        }
+    }
+
+    m_writer.end();
+    m_frame_range.byte_count = m_writer.write_offset - m_frame_range.first_byte_offset;
+
+    SPDLOG_LOGGER_TRACE(log_draw, "wrote {} entries to morph buffer", vertex_count);
+
+    return m_frame_range;
+}
+
+auto Morph_buffer::get_morph_vertex_index(const erhe::scene::Mesh& mesh, const std::size_t primitive_index) const -> uint32_t
+{
+    const auto i = m_mesh_entries.find(&mesh);
+    if (i == m_mesh_entries.end()) {
+        return c_no_morph_vertex_index;
+    }
+    const Mesh_entry& entry = i->second;
+    if ((entry.written_frame != m_frame) || (primitive_index >= entry.morph_vertex_indices.size())) {
+        return c_no_morph_vertex_index;
+    }
+    return entry.morph_vertex_indices[primitive_index];
+}
+
+} //namespace erhe::scene_renderer
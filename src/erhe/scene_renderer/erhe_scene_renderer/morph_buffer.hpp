@@ -0,0 +1,95 @@
+#pragma once
+
+#include "erhe_graphics/shader_resource.hpp"
+#include "erhe_renderer/multi_buffer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace erhe::primitive {
+    class Morph_targets;
+}
+namespace erhe::scene {
+    class Mesh;
+}
+
+namespace erhe::scene_renderer {
+
+class Morph_vertex_struct
+{
+public:
+    std::size_t position; // vec4 4 * 4 bytes, xyz = position delta
+    std::size_t normal;   // vec4 4 * 4 bytes, xyz = normal delta
+    std::size_t tangent;  // vec4 4 * 4 bytes, xyz = tangent delta (w of tangent attribute is not morphed)
+};
+
+class Morph_interface
+{
+public:
+    explicit Morph_interface(erhe::graphics::Instance& graphics_instance);
+
+    erhe::graphics::Shader_resource morph_block;
+    erhe::graphics::Shader_resource morph_vertex_struct;
+    Morph_vertex_struct             offsets;
+    std::size_t                     max_morph_vertex_count{65536};
+};
+
+// Vertex shader morph path. For each primitive with morph targets and any
+// non-zero weight, weighted deltas of active targets are blended on CPU
+// and written as one delta per vertex. Vertex shaders add the delta at
+// gl_VertexID + Primitive::morph_vertex_offset when morph_factor is set.
+//
+// Deltas of a mesh are blended again only when its weights change, and
+// written at most once per frame; render calls during the frame share
+// them. Primitive_buffer reads morph vertex indices from this buffer.
+class Morph_buffer : public erhe::renderer::Multi_buffer
+{
+public:
+    static constexpr uint32_t c_no_morph_vertex_index = 0xffffffffu;
+
+    Morph_buffer(erhe::graphics::Instance& graphics_instance, Morph_interface& morph_interface);
+
+    void next_frame();
+
+    // Writes deltas of meshes which have not yet been written during this
+    // frame. Returned range covers all deltas written during this frame.
+    auto update(
+        const std::span<const std::span<const std::shared_ptr<erhe::scene::Mesh>>>& mesh_spans
+    ) -> erhe::renderer::Buffer_range;
+
+    // Returns index of first delta of primitive within the range returned by
+    // update(), or c_no_morph_vertex_index if no deltas were written for it
+    // during this frame.
+    [[nodiscard]] auto get_morph_vertex_index(const erhe::scene::Mesh& mesh, std::size_t primitive_index) const -> uint32_t;
+
+private:
+    class Mesh_entry
+    {
+    public:
+        std::weak_ptr<erhe::scene::Mesh>                   mesh;
+        uint64_t                                           used_frame   {0};
+        uint64_t                                           written_frame{0};
+        std::vector<float>                                 weights;               // weights of blended deltas
+        std::vector<const erhe::primitive::Morph_targets*> morph_targets;         // per primitive, of blended deltas
+        std::vector<std::size_t>                           primitive_first_delta; // per primitive
+        std::vector<uint32_t>                              morph_vertex_indices;  // per primitive, valid when written_frame is current
+        std::vector<glm::vec3>                             position_deltas;       // primitives with morph targets, in order
+        std::vector<glm::vec3>                             normal_deltas;
+        std::vector<glm::vec3>                             tangent_deltas;
+    };
+
+    void blend(Mesh_entry& entry, const erhe::scene::Mesh& mesh);
+
+    Morph_interface&                                         m_morph_interface;
+    uint64_t                                                 m_frame{1};
+    erhe::renderer::Buffer_range                             m_frame_range;
+    std::unordered_map<const erhe::scene::Mesh*, Mesh_entry> m_mesh_entries;
+    std::vector<Mesh_entry*>                                 m_pending_entries;
+};
+
+} // namespace erhe::scene_renderer
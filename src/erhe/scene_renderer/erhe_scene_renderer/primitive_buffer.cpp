@@ -8,6 +8,7 @@
 #include "erhe_scene/mesh.hpp"
 #include "erhe_scene/node.hpp"
 #include "erhe_scene/skin.hpp"
+#include "erhe_scene_renderer/morph_buffer.hpp"
 #include "erhe_scene_renderer/scene_renderer_log.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
@@ -24,7 +25,9 @@ Primitive_interface::Primitive_interface(erhe::graphics::Instance& graphics_inst
         .material_index           = primitive_struct.add_uint ("material_index"          )->offset_in_parent(),
         .size                     = primitive_struct.add_float("size"                    )->offset_in_parent(),
         .skinning_factor          = primitive_struct.add_float("skinning_factor"         )->offset_in_parent(),
-        .base_joint_index         = primitive_struct.add_uint ("base_joint_index"        )->offset_in_parent()
+        .base_joint_index         = primitive_struct.add_uint ("base_joint_index"        )->offset_in_parent(),
+        .morph_vertex_offset      = primitive_struct.add_int  ("morph_vertex_offset"     )->offset_in_parent(),
+        .morph_factor             = primitive_struct.add_float("morph_factor"            )->offset_in_parent()
     }
 {
     const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "renderer");
@@ -45,6 +48,11 @@ Primitive_buffer::Primitive_buffer(erhe::graphics::Instance& graphics_instance,
     );
 }
 
+void Primitive_buffer::set_morph_buffer(const Morph_buffer* const morph_buffer)
+{
+    m_morph_buffer = morph_buffer;
+}
+
 void Primitive_buffer::reset_id_ranges()
 {
     m_id_offset = 0;
@@ -61,6 +69,108 @@ auto Primitive_buffer::id_ranges() const -> const std::vector<Id_range>&
     return m_id_ranges;
 }
 
+void Primitive_buffer::write_mesh_primitives(
+    erhe::scene::Mesh&                  mesh,
+    const glm::mat4&                    world_from_node,
+    const glm::mat4&                    world_from_node_cofactor,
+    erhe::primitive::Primitive_mode     primitive_mode,
+    const Primitive_interface_settings& settings,
+    const std::span<std::byte>          primitive_gpu_data,
+    std::size_t&                        out_primitive_count,
+    const bool                          use_id_ranges
+)
+{
+    auto&       buffer     = current_buffer();
+    const auto  entry_size = m_primitive_interface.primitive_struct.size_bytes();
+    const auto& offsets    = m_primitive_interface.offsets;
+
+    std::size_t mesh_primitive_index{0};
+    for (const auto& primitive : mesh.get_primitives()) {
+        if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
+            log_render->critical("primitive buffer capacity {} exceeded", buffer.capacity_byte_count());
+            ERHE_FATAL("primitive buffer capacity exceeded");
+            break;
+        }
+
+        const erhe::primitive::Buffer_mesh* buffer_mesh = primitive.get_renderable_mesh();
+        ERHE_VERIFY(buffer_mesh != nullptr);
+        const erhe::primitive::Index_range  index_range = buffer_mesh->index_range(primitive_mode);
+        const uint32_t count = static_cast<uint32_t>(index_range.index_count);
+        if (count == 0) {
+            continue;
+        }
+        const uint32_t power_of_two = erhe::math::next_power_of_two(count);
+        const uint32_t mask         = power_of_two - 1;
+        const uint32_t current_bits = m_id_offset & mask;
+        if (current_bits != 0) {
+            const auto add = power_of_two - current_bits;
+            m_id_offset += add;
+        }
+
+        erhe::primitive::Material* material = primitive.material.get();
+        const glm::vec4 wireframe_color  = glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}; //// mesh.get_wireframe_color();
+        const glm::vec3 id_offset_vec3   = erhe::math::vec3_from_uint(m_id_offset);
+        const glm::vec4 id_offset_vec4   = glm::vec4{id_offset_vec3, 0.0f};
+        const uint32_t  material_index   = (material != nullptr) ? material->material_buffer_index : 0u;
+        const auto&     skin             = mesh.skin;
+        const float     skinning_factor  = skin ? 1.0f : 0.0f;
+        const uint32_t  base_joint_index = skin ? skin->skin_data.joint_buffer_index : 0;
+
+        const std::size_t primitive_index     = static_cast<std::size_t>(&primitive - mesh.get_primitives().data());
+        const uint32_t    morph_vertex_index  = (m_morph_buffer != nullptr) ? m_morph_buffer->get_morph_vertex_index(mesh, primitive_index) : Morph_buffer::c_no_morph_vertex_index;
+        const bool        has_morph           = (morph_vertex_index != Morph_buffer::c_no_morph_vertex_index);
+        const int32_t     morph_vertex_offset = has_morph ? static_cast<int32_t>(morph_vertex_index) - static_cast<int32_t>(buffer_mesh->base_vertex()) : 0;
+        const float       morph_factor        = has_morph ? 1.0f : 0.0f;
+
+        SPDLOG_LOGGER_TRACE(
+            log_primitive_buffer,
+            "mesh {}, material {}, mat. idx = {}, offset = {}",
+            mesh.get_name(),
+            (material != nullptr) ? material->get_name() : std::string{},
+            material_index,
+            m_writer.write_offset
+        );
+
+        using erhe::graphics::as_span;
+        const auto color_span =
+            (settings.color_source == Primitive_color_source::id_offset           ) ? as_span(id_offset_vec4         ) :
+            (settings.color_source == Primitive_color_source::mesh_wireframe_color) ? as_span(wireframe_color        ) :
+                                                                                      as_span(settings.constant_color);
+        const auto size_span =
+            (settings.size_source == Primitive_size_source::mesh_point_size) ? as_span(mesh.point_size      ) :
+            (settings.size_source == Primitive_size_source::mesh_line_width) ? as_span(mesh.line_width      ) :
+                                                                               as_span(settings.constant_size);
+        {
+            using erhe::graphics::write;
+            write(primitive_gpu_data, m_writer.write_offset + offsets.world_from_node,          as_span(world_from_node         ));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.world_from_node_cofactor, as_span(world_from_node_cofactor));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.color,                    color_span                       );
+            write(primitive_gpu_data, m_writer.write_offset + offsets.material_index,           as_span(material_index          ));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.size,                     size_span                        );
+            write(primitive_gpu_data, m_writer.write_offset + offsets.skinning_factor,          as_span(skinning_factor         ));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.base_joint_index,         as_span(base_joint_index        ));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.morph_vertex_offset,      as_span(morph_vertex_offset     ));
+            write(primitive_gpu_data, m_writer.write_offset + offsets.morph_factor,             as_span(morph_factor            ));
+        }
+        m_writer.write_offset += entry_size;
+        ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
+
+        if (use_id_ranges) {
+            m_id_ranges.push_back(
+                Id_range{
+                    .offset          = m_id_offset,
+                    .length          = count,
+                    .mesh            = &mesh,
+                    .primitive_index = mesh_primitive_index++
+                }
+            );
+
+            m_id_offset += count;
+        }
+        ++out_primitive_count;
+    }
+}
+
 auto Primitive_buffer::update(
     const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
     erhe::primitive::Primitive_mode                            primitive_mode,
@@ -72,20 +182,11 @@ auto Primitive_buffer::update(
 {
     ERHE_PROFILE_FUNCTION();
 
-    // SPDLOG_LOGGER_TRACE(
-    //     log_primitive_buffer,
-    //     "meshes.size() = {}, write_offset = {}",
-    //     meshes.size(),
-    //     m_writer.write_offset
-    // );
-
     out_primitive_count = 0;
 
     std::size_t primitive_count = 0;
-    std::size_t mesh_index = 0;
     for (const auto& mesh : meshes) {
         ERHE_VERIFY(mesh);
-        ++mesh_index;
         const auto* node = mesh->get_node();
 
         // TODO Re-enable this after fixing example to use nodes
@@ -97,7 +198,6 @@ auto Primitive_buffer::update(
         }
 
         if (!filter(mesh->get_flag_bits())) {
-            // SPDLOG_LOGGER_TRACE(log_primitive_buffer, "node = {}, mesh = {} does not pass filter", node->get_name(), mesh->get_name());
             continue;
         }
 
@@ -106,14 +206,9 @@ auto Primitive_buffer::update(
 
     auto&             buffer             = current_buffer();
     const auto        entry_size         = m_primitive_interface.primitive_struct.size_bytes();
-    const auto&       offsets            = m_primitive_interface.offsets;
     const std::size_t max_byte_count     = primitive_count * entry_size;
     const auto        primitive_gpu_data = m_writer.begin(&buffer, max_byte_count);
-    std::size_t primitive_index    = 0;
-    mesh_index = 0;
     for (const auto& mesh : meshes) {
-        ++mesh_index;
-
         ERHE_VERIFY(mesh);
 
         const auto* node = mesh->get_node();
@@ -125,105 +220,55 @@ auto Primitive_buffer::update(
             continue;
         }
 
-        if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-            log_render->critical("primitive buffer capacity {} exceeded", buffer.capacity_byte_count());
-            ERHE_FATAL("primitive buffer capacity exceeded");
-            break;
-        }
-
         const glm::mat4 world_from_node = node->world_from_node();
 
         // TODO Use compute shader
         const glm::mat4 world_from_node_cofactor = erhe::math::compute_cofactor(world_from_node);
 
-        std::size_t mesh_primitive_index{0};
-        for (const auto& primitive : mesh->get_primitives()) {
-            if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
-                log_render->critical("primitive buffer capacity {} exceeded", buffer.capacity_byte_count());
-                ERHE_FATAL("primitive buffer capacity exceeded");
-                break;
-            }
-
-            const erhe::primitive::Buffer_mesh* buffer_mesh = primitive.get_renderable_mesh();
-            ERHE_VERIFY(buffer_mesh != nullptr);
-            const erhe::primitive::Index_range  index_range = buffer_mesh->index_range(primitive_mode);
-            const uint32_t count = static_cast<uint32_t>(index_range.index_count);
-            if (count == 0) {
-                continue;
-            }
-            const uint32_t power_of_two = erhe::math::next_power_of_two(count);
-            const uint32_t mask         = power_of_two - 1;
-            const uint32_t current_bits = m_id_offset & mask;
-            if (current_bits != 0) {
-                const auto add = power_of_two - current_bits;
-                m_id_offset += add;
-            }
-
-            erhe::primitive::Material* material = primitive.material.get();
-            const glm::vec4 wireframe_color  = glm::vec4{1.0f, 1.0f, 1.0f, 1.0f}; //// mesh->get_wireframe_color();
-            const glm::vec3 id_offset_vec3   = erhe::math::vec3_from_uint(m_id_offset);
-            const glm::vec4 id_offset_vec4   = glm::vec4{id_offset_vec3, 0.0f};
-            const uint32_t  material_index   = (material != nullptr) ? material->material_buffer_index : 0u;
-            const auto&     skin             = mesh->skin;
-            const float     skinning_factor  = skin ? 1.0f : 0.0f;
-            const uint32_t  base_joint_index = skin ? skin->skin_data.joint_buffer_index : 0;
-
-            SPDLOG_LOGGER_TRACE(
-                log_primitive_buffer, 
-                "[{}] node {}, mesh {}, material {}, mat. idx = {}, offset = {}",
-                primitive_index,
-                node->describe(),
-                mesh_index - 1,
-                (material != nullptr) ? material->get_name() : std::string{},
-                material_index,
-                m_writer.write_offset
-            );
+        write_mesh_primitives(*mesh.get(), world_from_node, world_from_node_cofactor, primitive_mode, settings, primitive_gpu_data, out_primitive_count, use_id_ranges);
+    }
+
+    m_writer.end();
+
+    return m_writer.range;
+}
+
+auto Primitive_buffer::update(
+    const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+    const std::span<const Render_list::Mesh_record>            mesh_records,
+    const std::span<const uint32_t>                            mesh_indices,
+    erhe::primitive::Primitive_mode                            primitive_mode,
+    const Primitive_interface_settings&                        settings,
+    std::size_t&                                               out_primitive_count
+) -> erhe::renderer::Buffer_range
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(mesh_records.size() == meshes.size());
+
+    out_primitive_count = 0;
+
+    std::size_t primitive_count = 0;
+    for (const uint32_t i : mesh_indices) {
+        if (mesh_records[i].has_node) {
+            primitive_count += meshes[i]->get_primitives().size();
+        }
+    }
 
-            using erhe::graphics::as_span;
-            const auto color_span =
-                (settings.color_source == Primitive_color_source::id_offset           ) ? as_span(id_offset_vec4         ) :
-                (settings.color_source == Primitive_color_source::mesh_wireframe_color) ? as_span(wireframe_color        ) :
-                                                                                          as_span(settings.constant_color);
-            const auto size_span =
-                (settings.size_source == Primitive_size_source::mesh_point_size) ? as_span(mesh->point_size      ) :
-                (settings.size_source == Primitive_size_source::mesh_line_width) ? as_span(mesh->line_width      ) :
-                                                                                   as_span(settings.constant_size);
-            //memset(reinterpret_cast<uint8_t*>(model_gpu_data.data()) + offset, 0, entry_size);
-            {
-                //ZoneScopedN("write");
-                using erhe::graphics::write;
-                write(primitive_gpu_data, m_writer.write_offset + offsets.world_from_node,          as_span(world_from_node         ));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.world_from_node_cofactor, as_span(world_from_node_cofactor));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.color,                    color_span                       );
-                write(primitive_gpu_data, m_writer.write_offset + offsets.material_index,           as_span(material_index          ));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.size,                     size_span                        );
-                write(primitive_gpu_data, m_writer.write_offset + offsets.skinning_factor,          as_span(skinning_factor         ));
-                write(primitive_gpu_data, m_writer.write_offset + offsets.base_joint_index,         as_span(base_joint_index        ));
-
-            }
-            m_writer.write_offset += entry_size;
-            ERHE_VERIFY(m_writer.write_offset <= m_writer.write_end);
-
-            if (use_id_ranges) {
-                m_id_ranges.push_back(
-                    Id_range{
-                        .offset          = m_id_offset,
-                        .length          = count,
-                        .mesh            = mesh.get(),
-                        .primitive_index = mesh_primitive_index++
-                    }
-                );
-
-                m_id_offset += count;
-            }
-            ++primitive_index;
-            ++out_primitive_count;
+    auto&             buffer             = current_buffer();
+    const auto        entry_size         = m_primitive_interface.primitive_struct.size_bytes();
+    const std::size_t max_byte_count     = primitive_count * entry_size;
+    const auto        primitive_gpu_data = m_writer.begin(&buffer, max_byte_count);
+    for (const uint32_t i : mesh_indices) {
+        const Render_list::Mesh_record& record = mesh_records[i];
+        if (!record.has_node) {
+            continue;
         }
+        write_mesh_primitives(*meshes[i].get(), record.world_from_node, record.world_from_node_cofactor, primitive_mode, settings, primitive_gpu_data, out_primitive_count, false);
     }
 
     m_writer.end();
 
-    // SPDLOG_LOGGER_TRACE(log_primitive_buffer, "wrote {} entries to primitive buffer", primitive_index);
     return m_writer.range;
 }
 
@@ -3,6 +3,7 @@
 #include "erhe_graphics/shader_resource.hpp"
 #include "erhe_renderer/multi_buffer.hpp"
 #include "erhe_primitive/enums.hpp"
+#include "erhe_scene_renderer/render_list.hpp"
 
 #include <array>
 #include <vector>
@@ -18,6 +19,8 @@ namespace erhe::scene {
 namespace erhe::scene_renderer
 {
 
+class Morph_buffer;
+
 class Primitive_struct
 {
 public:
@@ -28,6 +31,8 @@ public:
     std::size_t size;                       // float 1 * 4 bytes - point size / line width
     std::size_t skinning_factor;            // float 1 * 4 bytes
     std::size_t base_joint_index;           // uint  1 * 4 bytes
+    std::size_t morph_vertex_offset;        // int   1 * 4 bytes - added to gl_VertexID for morph buffer
+    std::size_t morph_factor;               // float 1 * 4 bytes
 };
 
 class Primitive_interface
@@ -113,6 +118,17 @@ public:
         bool                                                       use_id_ranges = false
     ) -> erhe::renderer::Buffer_range;
 
+    // Writes primitives of meshes selected by mesh_indices, using world
+    // transforms from Render_list records. Filtering is done by the caller.
+    auto update(
+        const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
+        std::span<const Render_list::Mesh_record>                  mesh_records,
+        std::span<const uint32_t>                                  mesh_indices,
+        erhe::primitive::Primitive_mode                            primitive_mode,
+        const Primitive_interface_settings&                        settings,
+        std::size_t&                                               out_primitive_count
+    ) -> erhe::renderer::Buffer_range;
+
     class Id_range
     {
     public:
@@ -122,12 +138,28 @@ public:
         std::size_t        primitive_index{0};
     };
 
+    // Morph vertex offsets are taken from morph_buffer, which must be
+    // updated for the meshes before primitives are written
+    void set_morph_buffer(const Morph_buffer* morph_buffer);
+
     void reset_id_ranges();
     [[nodiscard]] auto id_offset() const -> uint32_t;
     [[nodiscard]] auto id_ranges() const -> const std::vector<Id_range>&;
 
 private:
+    void write_mesh_primitives(
+        erhe::scene::Mesh&                  mesh,
+        const glm::mat4&                    world_from_node,
+        const glm::mat4&                    world_from_node_cofactor,
+        erhe::primitive::Primitive_mode     primitive_mode,
+        const Primitive_interface_settings& settings,
+        std::span<std::byte>                primitive_gpu_data,
+        std::size_t&                        out_primitive_count,
+        bool                                use_id_ranges
+    );
+
     Primitive_interface&  m_primitive_interface;
+    const Morph_buffer*   m_morph_buffer{nullptr};
     uint32_t              m_id_offset{0};
     std::vector<Id_range> m_id_ranges;
 };
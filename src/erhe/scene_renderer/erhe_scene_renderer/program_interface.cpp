@@ -121,6 +121,7 @@ Program_interface::Program_interface(erhe::graphics::Instance& graphics_instance
     , joint_interface    {graphics_instance}
     , light_interface    {graphics_instance}
     , material_interface {graphics_instance}
+    , morph_interface    {graphics_instance}
     , primitive_interface{graphics_instance}
 {
 }
@@ -158,6 +159,7 @@ auto Program_interface::make_prototype(
     create_info.struct_types.push_back(&camera_interface.camera_struct);
     create_info.struct_types.push_back(&primitive_interface.primitive_struct);
     create_info.struct_types.push_back(&joint_interface.joint_struct);
+    create_info.struct_types.push_back(&morph_interface.morph_vertex_struct);
     // TODO: This will be (eventually) for compute shaders.
     // create_info.struct_types.push_back(&g_mesh_memory->get_vertex_data_in());
     // create_info.struct_types.push_back(&g_mesh_memory->get_vertex_data_out());
@@ -167,6 +169,10 @@ auto Program_interface::make_prototype(
     create_info.add_interface_block(&camera_interface.camera_block);
     create_info.add_interface_block(&primitive_interface.primitive_block);
     create_info.add_interface_block(&joint_interface.joint_block);
+    create_info.add_interface_block(&morph_interface.morph_block);
+    if (joint_interface.compact_joint_palette) {
+        create_info.defines.emplace_back("ERHE_COMPACT_JOINT_PALETTE", "1");
+    }
 
     if (graphics_instance.info.gl_version < 430) {
         ERHE_VERIFY(gl::is_extension_supported(gl::Extension::Extension_GL_ARB_shader_storage_buffer_object));
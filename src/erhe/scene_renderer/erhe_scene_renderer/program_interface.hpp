@@ -7,6 +7,7 @@
 #include "erhe_scene_renderer/joint_buffer.hpp"
 #include "erhe_scene_renderer/light_buffer.hpp"
 #include "erhe_scene_renderer/material_buffer.hpp"
+#include "erhe_scene_renderer/morph_buffer.hpp"
 #include "erhe_scene_renderer/primitive_buffer.hpp"
 
 namespace erhe::graphics {
@@ -48,6 +49,7 @@ public:
     Joint_interface     joint_interface;
     Light_interface     light_interface;
     Material_interface  material_interface;
+    Morph_interface     morph_interface;
     Primitive_interface primitive_interface;
 };
 
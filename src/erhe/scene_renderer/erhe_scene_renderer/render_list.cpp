@@ -0,0 +1,105 @@
+#include "erhe_scene_renderer/render_list.hpp"
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_math/math_util.hpp"
+#include "erhe_scene/mesh.hpp"
+#include "erhe_scene/node.hpp"
+#include "erhe_profile/profile.hpp"
+
+#include <algorithm>
+
+namespace erhe::scene_renderer {
+
+namespace {
+
+// Minimum number of meshes per task when updating records in parallel
+constexpr std::size_t s_mesh_record_grain = 512;
+
+}
+
+void Render_list::next_frame()
+{
+    // Drop records for spans which were not rendered during this or the previous frame
+    const uint64_t frame = m_frame;
+    m_span_records.erase(
+        std::remove_if(
+            m_span_records.begin(),
+            m_span_records.end(),
+            [frame](const std::unique_ptr<Span_records>& span_records) {
+                return span_records->used_frame + 1 < frame;
+            }
+        ),
+        m_span_records.end()
+    );
+    ++m_frame;
+}
+
+void Render_list::set_thread_pool(erhe::concurrency::Thread_pool* const thread_pool)
+{
+    m_thread_pool = thread_pool;
+}
+
+auto Render_list::get_mesh_records(const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes) -> std::span<const Mesh_record>
+{
+    Span_records* span_records = nullptr;
+    for (const auto& entry : m_span_records) {
+        if ((entry->data == meshes.data()) && (entry->size == meshes.size())) {
+            span_records = entry.get();
+            break;
+        }
+    }
+    if (span_records == nullptr) {
+        span_records = m_span_records.emplace_back(std::make_unique<Span_records>()).get();
+        span_records->data = meshes.data();
+        span_records->size = meshes.size();
+    }
+    span_records->used_frame = m_frame;
+    if (span_records->validated_frame != m_frame) {
+        update(*span_records, meshes);
+        span_records->validated_frame = m_frame;
+    }
+    return span_records->records;
+}
+
+void Render_list::update(Span_records& span_records, const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t mesh_count = meshes.size();
+    if (span_records.meshes.size() != mesh_count) {
+        span_records.meshes .assign(mesh_count, nullptr);
+        span_records.records.assign(mesh_count, Mesh_record{});
+    }
+
+    const auto update_range = [&span_records, &meshes](const std::size_t first, const std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            const erhe::scene::Mesh* const mesh   = meshes[i].get();
+            const erhe::scene::Node* const node   = mesh->get_node();
+            Mesh_record&                   record = span_records.records[i];
+            if (node == nullptr) {
+                span_records.meshes[i] = mesh;
+                record = Mesh_record{};
+                continue;
+            }
+            const uint64_t serial = node->node_data.transforms.world_from_node_serial;
+            if ((span_records.meshes[i] == mesh) && record.has_node && (serial != 0) && (record.node_serial == serial)) {
+                continue;
+            }
+            span_records.meshes[i]          = mesh;
+            record.world_from_node          = node->world_from_node();
+            record.world_from_node_cofactor = erhe::math::compute_cofactor(record.world_from_node);
+            record.node_serial              = serial;
+            record.has_node                 = true;
+        }
+    };
+
+    if ((m_thread_pool == nullptr) || (mesh_count < 2 * s_mesh_record_grain)) {
+        update_range(0, mesh_count);
+    } else {
+        erhe::concurrency::Concurrent_queue queue{*m_thread_pool, "render_list"};
+        queue.enqueue_range(0, mesh_count, s_mesh_record_grain, update_range);
+        queue.wait();
+    }
+}
+
+} // namespace erhe::scene_renderer
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace erhe::concurrency {
+    class Thread_pool;
+}
+namespace erhe::scene {
+    class Mesh;
+}
+
+namespace erhe::scene_renderer {
+
+// Per mesh data which does not depend on render pass or view. Records for a
+// mesh span are updated once per frame and shared by all render calls which
+// render the span during the frame. Records of nodes whose world transform
+// serial has not changed are reused from the previous frame.
+class Render_list
+{
+public:
+    class Mesh_record
+    {
+    public:
+        glm::mat4 world_from_node         {1.0f};
+        glm::mat4 world_from_node_cofactor{1.0f};
+        uint64_t  node_serial             {0};
+        bool      has_node                {false};
+    };
+
+    void next_frame     ();
+    void set_thread_pool(erhe::concurrency::Thread_pool* thread_pool);
+
+    // Returned records are indexed like meshes and stay valid until next_frame()
+    [[nodiscard]] auto get_mesh_records(const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes) -> std::span<const Mesh_record>;
+
+private:
+    class Span_records
+    {
+    public:
+        const std::shared_ptr<erhe::scene::Mesh>* data           {nullptr};
+        std::size_t                               size           {0};
+        uint64_t                                  validated_frame{0};
+        uint64_t                                  used_frame     {0};
+        std::vector<const erhe::scene::Mesh*>     meshes;
+        std::vector<Mesh_record>                  records;
+    };
+
+    void update(Span_records& span_records, const std::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes);
+
+    erhe::concurrency::Thread_pool*            m_thread_pool{nullptr};
+    uint64_t                                   m_frame      {1};
+    std::vector<std::unique_ptr<Span_records>> m_span_records;
+};
+
+} // namespace erhe::scene_renderer
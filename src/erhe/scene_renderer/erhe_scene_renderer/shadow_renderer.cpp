@@ -56,11 +56,13 @@ Shadow_renderer::Shadow_renderer(erhe::graphics::Instance& graphics_instance, Pr
     , m_draw_indirect_buffers{graphics_instance}
     , m_joint_buffers        {graphics_instance, program_interface.joint_interface}
     , m_light_buffers        {graphics_instance, program_interface.light_interface}
+    , m_morph_buffers        {graphics_instance, program_interface.morph_interface}
     , m_primitive_buffers    {graphics_instance, program_interface.primitive_interface}
     , m_gpu_timer            {"Shadow_renderer"}
 {
     ERHE_PROFILE_FUNCTION();
     m_pipeline_cache_entries.resize(8);
+    m_primitive_buffers.set_morph_buffer(&m_morph_buffers);
 }
 
 auto Shadow_renderer::get_pipeline(const Vertex_input_state* vertex_input_state) -> erhe::graphics::Pipeline&
@@ -101,8 +103,26 @@ void Shadow_renderer::next_frame()
 {
     m_joint_buffers        .next_frame();
     m_light_buffers        .next_frame();
+    m_morph_buffers        .next_frame();
     m_draw_indirect_buffers.next_frame();
     m_primitive_buffers    .next_frame();
+    m_frustum_culler       .next_frame();
+    m_render_list          .next_frame();
+}
+
+auto Shadow_renderer::get_culling_statistics() const -> const Culling_statistics&
+{
+    return m_culling_statistics;
+}
+
+auto Shadow_renderer::get_render_list() -> Render_list&
+{
+    return m_render_list;
+}
+
+auto Shadow_renderer::get_joint_buffer() -> Joint_buffer&
+{
+    return m_joint_buffers;
 }
 
 auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
@@ -162,6 +182,9 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
     );
     m_joint_buffers.bind(joint_range);
 
+    const auto morph_range = m_morph_buffers.update({mesh_spans.begin(), mesh_spans.size()});
+    m_morph_buffers.bind(morph_range);
+
     const auto light_range = m_light_buffers.update(
         lights,
         &parameters.light_projections,
@@ -171,11 +194,30 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
 
     log_shadow_renderer->trace("Rendering shadow map to '{}'", parameters.texture->debug_label());
 
+    m_light_frustums.clear();
+    for (const auto& light : lights) {
+        if (!light->cast_shadow) {
+            continue;
+        }
+        const auto* light_projection_transform = parameters.light_projections.get_light_projection_transforms_for_light(light.get());
+        if (light_projection_transform == nullptr) {
+            continue;
+        }
+        m_light_frustums.emplace_back(light_projection_transform->clip_from_world.get_matrix());
+    }
+    m_culling_statistics = Culling_statistics{};
+
     const erhe::primitive::Primitive_mode primitive_mode{erhe::primitive::Primitive_mode::polygon_fill};
-    for (const auto& meshes : mesh_spans) {
+    for (const auto& mesh_span : mesh_spans) {
+        m_visible_mesh_indices.clear();
+        if (!m_light_frustums.empty()) {
+            m_frustum_culler.cull(mesh_span, m_light_frustums, shadow_filter, m_visible_mesh_indices, m_culling_statistics);
+        }
+
+        const auto  mesh_records = m_render_list.get_mesh_records(mesh_span);
         std::size_t primitive_count{0};
-        const auto primitive_range = m_primitive_buffers.update(meshes, primitive_mode, shadow_filter, Primitive_interface_settings{}, primitive_count);
-        const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, primitive_mode, shadow_filter);
+        const auto primitive_range = m_primitive_buffers.update(mesh_span, mesh_records, m_visible_mesh_indices, primitive_mode, Primitive_interface_settings{}, primitive_count);
+        const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(mesh_span, m_visible_mesh_indices, primitive_mode);
         if (primitive_count != draw_indirect_buffer_range.draw_indirect_count) {
             log_render->warn("primitive_range != draw_indirect_buffer_range.draw_indirect_count");
         }
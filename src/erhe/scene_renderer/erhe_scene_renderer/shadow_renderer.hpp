@@ -8,9 +8,12 @@
 #include "erhe_dataformat/dataformat.hpp"
 #include "erhe_renderer/draw_indirect_buffer.hpp"
 #include "erhe_math/viewport.hpp"
+#include "erhe_scene_renderer/frustum_culler.hpp"
 #include "erhe_scene_renderer/joint_buffer.hpp"
 #include "erhe_scene_renderer/light_buffer.hpp"
+#include "erhe_scene_renderer/morph_buffer.hpp"
 #include "erhe_scene_renderer/primitive_buffer.hpp"
+#include "erhe_scene_renderer/render_list.hpp"
 
 #include <initializer_list>
 
@@ -68,6 +71,13 @@ public:
     auto render    (const Render_parameters& parameters) -> bool;
     void next_frame();
 
+    // Statistics from the most recent render() call. Meshes are culled
+    // against the union of shadow casting light frustums, as all lights
+    // share the same draw list.
+    [[nodiscard]] auto get_culling_statistics() const -> const Culling_statistics&;
+    [[nodiscard]] auto get_render_list       () -> Render_list&;
+    [[nodiscard]] auto get_joint_buffer      () -> Joint_buffer&;
+
 private:
     class Pipeline_cache_entry
     {
@@ -78,17 +88,23 @@ private:
 
     [[nodiscard]] auto get_pipeline(const erhe::graphics::Vertex_input_state* vertex_input_state) -> erhe::graphics::Pipeline&;
 
-    erhe::graphics::Instance&                m_graphics_instance;
-    uint64_t                                 m_pipeline_cache_serial{0};
-    std::vector<Pipeline_cache_entry>        m_pipeline_cache_entries;
-    erhe::graphics::Reloadable_shader_stages m_shader_stages;
-    erhe::graphics::Sampler                  m_nearest_sampler;
-    erhe::graphics::Vertex_input_state       m_vertex_input;
-    erhe::renderer::Draw_indirect_buffer     m_draw_indirect_buffers;
-    Joint_buffer                             m_joint_buffers;
-    Light_buffer                             m_light_buffers;
-    Primitive_buffer                         m_primitive_buffers;
-    erhe::graphics::Gpu_timer                m_gpu_timer;
+    erhe::graphics::Instance&                       m_graphics_instance;
+    uint64_t                                        m_pipeline_cache_serial{0};
+    std::vector<Pipeline_cache_entry>               m_pipeline_cache_entries;
+    erhe::graphics::Reloadable_shader_stages        m_shader_stages;
+    erhe::graphics::Sampler                         m_nearest_sampler;
+    erhe::graphics::Vertex_input_state              m_vertex_input;
+    erhe::renderer::Draw_indirect_buffer            m_draw_indirect_buffers;
+    Joint_buffer                                    m_joint_buffers;
+    Light_buffer                                    m_light_buffers;
+    Morph_buffer                                    m_morph_buffers;
+    Primitive_buffer                                m_primitive_buffers;
+    erhe::graphics::Gpu_timer                       m_gpu_timer;
+    Frustum_culler                                  m_frustum_culler;
+    Culling_statistics                              m_culling_statistics;
+    Render_list                                     m_render_list;
+    std::vector<Frustum>                            m_light_frustums;
+    std::vector<uint32_t>                           m_visible_mesh_indices;
 };
 
 
@@ -143,7 +143,6 @@ public:
     {
         const auto tick_end_time = std::chrono::steady_clock::now();
         m_camera_controller->tick(tick_end_time);
-        m_camera_controller->update_transform();
         m_scene.update_node_transforms();
 
         gl::enable(gl::Enable_cap::framebuffer_srgb);
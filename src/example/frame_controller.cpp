@@ -129,18 +129,16 @@ void Frame_controller::handle_node_update(erhe::scene::Node* old_node, erhe::sce
     get_transform_from_node(new_node);
 }
 
+// Notification caused by update_transform() itself is skipped; writing
+// the transform back here would re-dirty the node every frame.
 void Frame_controller::handle_node_transform_update()
 {
-    if (m_transform_update) {
+    if (m_pending_transform_write) {
+        m_pending_transform_write = false;
         return;
     }
 
-    auto* node = get_node();
-    if (node == nullptr) {
-        return;
-    }
-    get_transform_from_node(node);
-    update_transform();
+    get_transform_from_node(get_node());
 }
 
 void Frame_controller::reset()
@@ -168,9 +166,8 @@ void Frame_controller::update_transform()
     // Put translation to column 3
     parent_from_local[3] = vec4{m_position, 1.0f};
 
-    m_transform_update = true;
+    m_pending_transform_write = true;
     node->set_parent_from_node(parent_from_local);
-    m_transform_update = false;
 }
 
 auto Frame_controller::get_axis_x() const -> vec3
@@ -203,19 +200,24 @@ void Frame_controller::tick(std::chrono::steady_clock::time_point timestamp)
 
     const float speed_scale = 1.0f + speed_modifier.get_value();
 
+    bool moved = false;
     if (translate_x.get_tick_distance() != 0.0f) {
         m_position += get_axis_x() * translate_x.get_tick_distance() * speed_scale;
+        moved = true;
     }
 
     if (translate_y.get_tick_distance() != 0.0f) {
         m_position += get_axis_y() * translate_y.get_tick_distance() * speed_scale;
+        moved = true;
     }
 
     if (translate_z.get_tick_distance() != 0.0f) {
         m_position += get_axis_z() * translate_z.get_tick_distance() * speed_scale;
+        moved = true;
     }
 
     if ((rotate_x.get_tick_distance() != 0.0f) || (rotate_y.get_tick_distance() != 0.0f)) {
+        moved = true;
         m_heading += rotate_y.get_tick_distance();
         m_elevation += rotate_x.get_tick_distance();
         const mat4 elevation_matrix = erhe::math::create_rotation(m_elevation, erhe::math::vector_types<float>::vec3_unit_x());
@@ -223,7 +225,10 @@ void Frame_controller::tick(std::chrono::steady_clock::time_point timestamp)
         m_rotation_matrix = m_heading_matrix * elevation_matrix;
     }
 
-    update_transform();
+    // Still camera leaves its node untouched
+    if (moved) {
+        update_transform();
+    }
 }
 
 auto is_frame_controller(const erhe::Item_base* const item) -> bool
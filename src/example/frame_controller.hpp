@@ -61,12 +61,12 @@ public:
     erhe::math::Input_axis speed_modifier;
 
 private:
-    float     m_elevation       {0.0f};
-    float     m_heading         {0.0f};
-    glm::mat4 m_heading_matrix  {1.0f};
-    glm::mat4 m_rotation_matrix {1.0f};
-    glm::vec3 m_position        {0.0f};
-    bool      m_transform_update{false};
+    float     m_elevation              {0.0f};
+    float     m_heading                {0.0f};
+    glm::mat4 m_heading_matrix         {1.0f};
+    glm::mat4 m_rotation_matrix        {1.0f};
+    glm::vec3 m_position               {0.0f};
+    bool      m_pending_transform_write{false}; // set by update_transform(), cleared by the notification it causes
 };
 
 auto is_frame_controller(const erhe::Item_base* item) -> bool;
@@ -23,6 +23,14 @@ auto Mesh_memory::get_index_buffer_size() const -> std::size_t
     return index_buffer_size * 1024 * 1024;
 }
 
+auto Mesh_memory::get_staging_buffer_size() const -> std::size_t
+{
+    int staging_buffer_size{16}; // in megabytes
+    const auto& ini = erhe::configuration::get_ini_file_section("erhe.ini", "mesh_memory");
+    ini.get("staging_buffer_size", staging_buffer_size);
+    return staging_buffer_size * 1024 * 1024;
+}
+
 Mesh_memory::Mesh_memory(
     erhe::graphics::Instance&                graphics_instance,
     erhe::scene_renderer::Program_interface& program_interface
@@ -47,6 +55,7 @@ Mesh_memory::Mesh_memory(
         get_index_buffer_size(),
         storage_mask
     }
+    , gl_buffer_transfer_queue{graphics_instance, get_staging_buffer_size()}
     , gl_buffer_sink{
         gl_buffer_transfer_queue,
         gl_vertex_buffer,
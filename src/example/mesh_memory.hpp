@@ -48,6 +48,7 @@ public:
 private:
     [[nodiscard]] auto get_vertex_buffer_size() const -> std::size_t;
     [[nodiscard]] auto get_index_buffer_size() const -> std::size_t;
+    [[nodiscard]] auto get_staging_buffer_size() const -> std::size_t;
 };
 
 } // namespace example